@@ -14,12 +14,16 @@ uniform vec3 uMaterialDiffuse;
 uniform vec3 uMaterialSpecular;
 uniform float uMaterialShininess;
 
-// Lighting
-uniform vec3 uLightDir;
-uniform vec3 uLightColor;
-uniform float uLightIntensity;
-uniform vec3 uAmbientLight;
-uniform vec3 uViewPos;
+// Per-frame data (std140, written once per frame by the renderer)
+layout (std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProjection;
+    vec3 uLightDir;
+    float uLightIntensity;
+    vec3 uLightColor;
+    vec3 uAmbientLight;
+    vec3 uViewPos;
+};
 
 // Textures (optional)
 uniform sampler2D uDiffuseMap;
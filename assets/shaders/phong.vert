@@ -6,22 +6,38 @@ layout (location = 1) in vec3 aNormal;
 layout (location = 2) in vec3 aColor;
 layout (location = 3) in vec2 aTexCoord;
 
+// Per-instance attributes (divisor 1)
+layout (location = 4) in mat4 aModel; // Locations 4-7
+layout (location = 8) in vec4 aInstanceColor;
+
 // Output to fragment shader
 out vec3 FragPos;
 out vec3 Normal;
 out vec3 VertexColor;
 out vec2 TexCoord;
 
-// Uniforms
-uniform mat4 uModel;
-uniform mat4 uView;
-uniform mat4 uProjection;
-uniform mat3 uNormalMatrix;
+// Per-frame data (std140, written once per frame by the renderer)
+layout (std140) uniform FrameData {
+    mat4 uView;
+    mat4 uProjection;
+    vec3 uLightDir;
+    float uLightIntensity;
+    vec3 uLightColor;
+    vec3 uAmbientLight;
+    vec3 uViewPos;
+};
 
 void main() {
-    FragPos = vec3(uModel * vec4(aPos, 1.0));
-    Normal = uNormalMatrix * aNormal;
-    VertexColor = aColor;
+    FragPos = vec3(aModel * vec4(aPos, 1.0));
+
+    // Model matrices are translate * rotate * scale, so the inverse transpose
+    // of the upper 3x3 is each column divided by its squared length (exact
+    // unless a rotated child sits under a non-uniformly scaled parent)
+    mat3 model = mat3(aModel);
+    vec3 inverseScaleSq = 1.0 / vec3(dot(model[0], model[0]), dot(model[1], model[1]), dot(model[2], model[2]));
+    Normal = model * (aNormal * inverseScaleSq);
+
+    VertexColor = aColor * aInstanceColor.rgb;
     TexCoord = aTexCoord;
     
     gl_Position = uProjection * uView * vec4(FragPos, 1.0);
@@ -0,0 +1,188 @@
+#include "AISystem.h"
+#include "../Core/JobSystem.h"
+#include "../Events/EventManager.h"
+#include <algorithm>
+#include <cmath>
+
+namespace Nilos {
+
+namespace {
+
+// Agents per job in the scheduling pass (cheap per agent) and the think passes
+constexpr size_t SCHEDULE_GRAIN = 1024;
+constexpr size_t THINK_GRAIN = 64;
+
+constexpr float MIN_IMPORTANCE = 0.001f;
+
+/**
+ * @brief Fixed phase in [0, 1) for an entity (golden-ratio sequence over its index)
+ *
+ * Consecutive indices land far apart, so agents created together are
+ * spread over the whole interval.
+ */
+double GetPhase(Entity entity) {
+    double value = static_cast<double>(GetEntityIndex(entity)) * 0.6180339887498949;
+    return value - std::floor(value);
+}
+
+} // namespace
+
+void AISystem::Initialize() {
+    NILOS_INFO("AISystem initialized");
+}
+
+void AISystem::Update(float deltaTime) {
+    World* world = GetWorld();
+    double previousTime = m_Time;
+    m_Time += deltaTime;
+
+    // Gather the agents into dense arrays
+    m_Entities.clear();
+    m_Agents.clear();
+    m_Transforms.clear();
+    m_Positions.clear();
+    world->Each<AIAgentComponent, TransformComponent>(
+        [this](Entity entity, AIAgentComponent& agent, TransformComponent& transform) {
+            m_Entities.push_back(entity);
+            m_Agents.push_back(&agent);
+            m_Transforms.push_back(&transform);
+            m_Positions.push_back(transform.Position);
+        });
+
+    size_t count = m_Entities.size();
+    m_Due.resize(count);
+    m_AgentHash.Build(m_Positions.data(), m_Entities.data(), count);
+
+    // LOD and due ticks; each agent only touches its own entries
+    const double time = m_Time;
+    JobSystem::Get().ParallelFor(count, SCHEDULE_GRAIN,
+        [this, deltaTime, time, previousTime](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                AIAgentComponent& agent = *m_Agents[i];
+                if (!agent.IsActive) {
+                    m_Due[i] = 0;
+                    continue;
+                }
+
+                float distance = glm::length(m_Positions[i] - m_LODOrigin) /
+                                 std::max(agent.Importance, MIN_IMPORTANCE);
+                uint8_t level = 0;
+                while (level < LOD_LEVEL_COUNT - 1 && distance >= m_LODDistances[level]) {
+                    ++level;
+                }
+                agent.LODLevel = level;
+                agent.TimeSinceLastUpdate += deltaTime;
+
+                // Due when the agent's phase point passed during this frame, or
+                // when it is overdue (deferred by the think cap, or the LOD changed)
+                double interval = std::max(static_cast<double>(agent.UpdateInterval), 1e-4) *
+                                  static_cast<double>(1u << level);
+                double phase = GetPhase(m_Entities[i]);
+                bool crossed = std::floor(time / interval + phase) != std::floor(previousTime / interval + phase);
+                m_Due[i] = crossed || agent.TimeSinceLastUpdate >= interval;
+            }
+        });
+
+    std::fill(std::begin(m_LODCounts), std::end(m_LODCounts), 0);
+    for (AIAgentComponent* agent : m_Agents) {
+        ++m_LODCounts[agent->LODLevel];
+    }
+
+    // Pick due agents round-robin from the cursor, up to the cap
+    m_Thinking.clear();
+    m_Elapsed.clear();
+    m_Deferred = 0;
+    size_t limit = m_MaxThinksPerFrame ? m_MaxThinksPerFrame : count;
+    if (m_Cursor >= count) {
+        m_Cursor = 0;
+    }
+    for (size_t step = 0; step < count; ++step) {
+        size_t i = (m_Cursor + step) % count;
+        if (!m_Due[i]) {
+            continue;
+        }
+        if (m_Thinking.size() == limit) {
+            ++m_Deferred;
+            continue;
+        }
+        m_Thinking.push_back(static_cast<uint32_t>(i));
+        m_Elapsed.push_back(m_Agents[i]->TimeSinceLastUpdate);
+        m_Agents[i]->TimeSinceLastUpdate = 0.0f;
+    }
+    if (m_Deferred > 0) {
+        // Start after the last agent served so the deferred ones go first
+        m_Cursor = (m_Thinking.back() + 1) % count;
+    }
+
+    Perceive();
+    if (m_Perception) {
+        RunPass(m_Perception);
+    }
+    if (m_Decision) {
+        RunPass(m_Decision);
+    }
+
+    // Events last: subscribers run on this thread and see the decisions
+    for (size_t k = 0; k < m_Thinking.size(); ++k) {
+        if (!m_NewTarget[k]) {
+            continue;
+        }
+        const AIAgentComponent& agent = *m_Agents[m_Thinking[k]];
+        EventManager::Get().Dispatch(AIPerceptionEvent(m_Entities[m_Thinking[k]], agent.PerceivedEntity,
+                                                       agent.PerceivedDistance));
+    }
+}
+
+void AISystem::Shutdown() {
+    m_Entities.clear();
+    m_Agents.clear();
+    m_Transforms.clear();
+    m_Positions.clear();
+    m_AgentHash.Clear();
+    m_Thinking.clear();
+    NILOS_INFO("AISystem shutdown");
+}
+
+void AISystem::SetLODDistances(float level1, float level2, float level3) {
+    m_LODDistances[0] = level1;
+    m_LODDistances[1] = std::max(level2, level1);
+    m_LODDistances[2] = std::max(level3, m_LODDistances[1]);
+}
+
+void AISystem::Perceive() {
+    m_NewTarget.assign(m_Thinking.size(), 0);
+    JobSystem::Get().ParallelFor(m_Thinking.size(), THINK_GRAIN, [this](size_t begin, size_t end) {
+        for (size_t k = begin; k < end; ++k) {
+            uint32_t i = m_Thinking[k];
+            AIAgentComponent& agent = *m_Agents[i];
+            Entity self = m_Entities[i];
+            Entity previous = agent.PerceivedEntity;
+
+            Entity nearest = NULL_ENTITY;
+            float nearestSq = 0.0f;
+            m_AgentHash.ForEachInRadius(m_Positions[i], agent.PerceptionRadius,
+                [&](uint32_t id, const glm::vec3&, float distanceSq) {
+                    if (id != self && (nearest == NULL_ENTITY || distanceSq < nearestSq)) {
+                        nearest = id;
+                        nearestSq = distanceSq;
+                    }
+                });
+
+            agent.PerceivedEntity = nearest;
+            agent.PerceivedDistance = std::sqrt(nearestSq);
+            m_NewTarget[k] = nearest != NULL_ENTITY && nearest != previous;
+        }
+    });
+}
+
+void AISystem::RunPass(const AgentFunction& function) {
+    JobSystem::Get().ParallelFor(m_Thinking.size(), THINK_GRAIN,
+        [this, &function](size_t begin, size_t end) {
+            for (size_t k = begin; k < end; ++k) {
+                uint32_t i = m_Thinking[k];
+                function(m_Entities[i], *m_Agents[i], *m_Transforms[i], m_Elapsed[k]);
+            }
+        });
+}
+
+} // namespace Nilos
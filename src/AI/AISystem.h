@@ -3,7 +3,10 @@
 #include "../ECS/System.h"
 #include "../ECS/World.h"
 #include "../Core/Logger.h"
+#include "../Core/SpatialHash.h"
+#include "BehaviorTree.h"
 
+#include <functional>
 #include <string>
 #include <vector>
 #include <unordered_map>
@@ -11,116 +14,178 @@
 namespace Nilos {
 
 /**
- * @brief AI System for NPC behavior and decision making (Placeholder for Phase 5)
- * 
+ * @brief Schedules AI agent think ticks: time-sliced, distance LOD, parallel
+ *
+ * Agents (AIAgentComponent + TransformComponent) think every
+ * UpdateInterval seconds at LOD 0. Each farther LOD level, measured from
+ * the LOD origin (usually the camera) and divided by the agent's
+ * Importance, doubles the interval. Every agent also has a fixed phase
+ * within its interval (derived from its entity index), so agents with the
+ * same interval are spread evenly over the frames instead of all firing
+ * together.
+ *
+ * Each frame the agents are gathered into dense arrays, then LODs and due
+ * ticks are computed in parallel chunks. At most MaxThinksPerFrame due
+ * agents are picked, round-robin, so the cost of a frame is bounded
+ * however many NPCs exist; the rest keep their elapsed time and go first
+ * next frame. The picked agents then run two passes on the job system:
+ * perception, then decision. All perception work is finished before any
+ * decision starts, so decisions see a consistent snapshot.
+ *
+ * Built-in perception finds each thinking agent's nearest other agent
+ * within its PerceptionRadius through a spatial hash of all agents,
+ * rebuilt every frame (so the cost is O(n), not O(n^2)). The result goes
+ * into PerceivedEntity/PerceivedDistance, and an AIPerceptionEvent is
+ * dispatched (on the calling thread, after the passes) when an agent
+ * perceives a new entity. The hash is available to the callbacks through
+ * GetAgentHash() for their own queries, e.g. separation steering.
+ *
+ * The perception and decision functions run on worker threads. They may
+ * change only the agent it was called for (its AIAgentComponent), read
+ * any TransformComponent, and must not dispatch events or make structural
+ * changes. The system declares no component access and therefore runs
+ * alone in its frame stage.
+ *
+ * Usage:
+ *   auto* ai = world->RegisterSystem<AISystem>();
+ *   ai->SetDecisionFunction([](Entity npc, AIAgentComponent& agent,
+ *                              const TransformComponent& transform, float elapsed) {
+ *       // Decide what to do; elapsed is the time since this agent last thought
+ *   });
+ *   ai->SetLODOrigin(cameraPosition);  // Every frame
+ *
+ * Behavior trees are in BehaviorTree.h: call BehaviorTreeGroup::TickAgent
+ * from the decision function to run an agent's tree at its LOD rate.
+ *
  * Future implementation will include:
  * 
- * 1. Behavior Trees:
- *    - Composite nodes (Sequence, Selector, Parallel)
- *    - Decorator nodes (Inverter, Repeater, Condition)
- *    - Leaf nodes (Actions, Conditions)
- * 
- * 2. GOAP (Goal-Oriented Action Planning):
+ * 1. GOAP (Goal-Oriented Action Planning):
  *    - Action planning based on current state and goals
  *    - Dynamic replanning when conditions change
  *    - Integration with world state
  * 
- * 3. External AI Integration:
+ * 2. External AI Integration:
  *    - REST API clients for OpenAI, Anthropic, etc.
  *    - Local model support (llama.cpp, ONNX Runtime)
  *    - Prompt management and context building
  *    - Token budget management
  * 
- * 4. Memory System:
+ * 3. Memory System:
  *    - Short-term memory (recent events)
  *    - Long-term memory (persistent storage)
  *    - Embedding-based retrieval (vector database)
  *    - Memory consolidation and importance scoring
  * 
- * 5. Sensory System:
+ * 4. Sensory System:
  *    - Visual perception (raycast-based line of sight)
  *    - Audio perception (sound propagation)
  *    - Touch/collision sensing
  *    - Perception filtering and attention
  * 
- * 6. Learning and Adaptation:
+ * 5. Learning and Adaptation:
  *    - Reinforcement learning integration
  *    - Behavior evolution based on outcomes
  *    - Skill acquisition and improvement
- * 
- * Current status: Basic placeholder structure only
  */
 class AISystem : public System {
 public:
-    AISystem() = default;
+    /**
+     * @brief Per-agent work: (entity, agent, transform, seconds since it last thought)
+     */
+    using AgentFunction = std::function<void(Entity, AIAgentComponent&, const TransformComponent&, float)>;
 
-    void Initialize() override {
-        NILOS_INFO("AISystem initialized (placeholder mode)");
-        NILOS_INFO("  Future: Behavior trees, GOAP, external AI APIs");
-    }
+    static constexpr int LOD_LEVEL_COUNT = 4;
+    static constexpr size_t DEFAULT_MAX_THINKS_PER_FRAME = 4096;
 
-    void Update(float deltaTime) override {
-        // Placeholder for AI update loop
-        
-        // Future implementation:
-        // 1. Update perception for all AI agents
-        // 2. Process sensory data and update world knowledge
-        // 3. Run decision-making systems (behavior tree/GOAP)
-        // 4. Execute actions based on decisions
-        // 5. Update memory systems
-        // 6. Handle AI-to-AI communication
-        
-        // Example structure:
-        // auto agents = m_World->GetEntitiesWithComponent<AIAgentComponent>();
-        // for (auto entity : agents) {
-        //     auto* agent = m_World->GetComponent<AIAgentComponent>(entity);
-        //     
-        //     // Update at specified intervals to save CPU
-        //     agent->TimeSinceLastUpdate += deltaTime;
-        //     if (agent->TimeSinceLastUpdate >= agent->UpdateInterval) {
-        //         UpdatePerception(entity, agent);
-        //         ProcessDecisions(entity, agent);
-        //         agent->TimeSinceLastUpdate = 0.0f;
-        //     }
-        // }
-    }
+    AISystem() = default;
 
-    void Shutdown() override {
-        NILOS_INFO("AISystem shutdown");
-    }
+    void Initialize() override;
+    void Update(float deltaTime) override;
+    void Shutdown() override;
 
     const char* GetName() const override {
         return "AISystem";
     }
 
+    /**
+     * @brief Extra perception (runs for every agent thinking this frame after the built-in
+     *        perception, before any decision)
+     */
+    void SetPerceptionFunction(AgentFunction function) { m_Perception = std::move(function); }
+
+    /**
+     * @brief Decision pass (runs after all perception of the frame)
+     */
+    void SetDecisionFunction(AgentFunction function) { m_Decision = std::move(function); }
+
+    /**
+     * @brief Point LOD distances are measured from
+     */
+    void SetLODOrigin(const glm::vec3& origin) { m_LODOrigin = origin; }
+    const glm::vec3& GetLODOrigin() const { return m_LODOrigin; }
+
+    /**
+     * @brief Distances where LOD levels 1, 2 and 3 start (ascending)
+     */
+    void SetLODDistances(float level1, float level2, float level3);
+
+    /**
+     * @brief Cell size of the agent hash; best close to the typical PerceptionRadius
+     */
+    void SetPerceptionCellSize(float cellSize) { m_AgentHash.SetCellSize(cellSize); }
+
+    /**
+     * @brief Positions of all agents (IDs are entities), rebuilt at the start of each Update
+     */
+    const SpatialHash& GetAgentHash() const { return m_AgentHash; }
+
+    /**
+     * @brief Upper bound on agents thinking in one frame (0 = unlimited)
+     */
+    void SetMaxThinksPerFrame(size_t count) { m_MaxThinksPerFrame = count; }
+    size_t GetMaxThinksPerFrame() const { return m_MaxThinksPerFrame; }
+
+    // Statistics of the last Update
+    size_t GetAgentCount() const { return m_Entities.size(); }
+    size_t GetThinkCount() const { return m_Thinking.size(); }
+    size_t GetDeferredCount() const { return m_Deferred; }
+    size_t GetLODCount(int level) const { return m_LODCounts[level]; }
+
 private:
-    // Future members:
-    // std::unique_ptr<BehaviorTreeManager> m_BehaviorTrees;
-    // std::unique_ptr<GOAPPlanner> m_GOAPPlanner;
-    // std::unique_ptr<AIMemoryDatabase> m_MemorySystem;
-    // std::unique_ptr<AIApiClient> m_ExternalAIClient;
-    // PerceptionManager m_PerceptionManager;
-};
+    /**
+     * @brief Run a pass over the agents thinking this frame, in parallel chunks
+     */
+    void RunPass(const AgentFunction& function);
 
-/**
- * @brief Behavior tree node types (Placeholder)
- * 
- * This demonstrates the structure for future behavior tree implementation.
- */
-enum class BehaviorNodeType {
-    // Composite nodes
-    Sequence,      // Execute children in order, fail if any fails
-    Selector,      // Execute children until one succeeds
-    Parallel,      // Execute multiple children simultaneously
-    
-    // Decorator nodes
-    Inverter,      // Invert result of child
-    Repeater,      // Repeat child N times or forever
-    Condition,     // Only execute if condition is met
-    
-    // Leaf nodes
-    Action,        // Execute an action
-    Wait          // Wait for specified time
+    /**
+     * @brief Nearest agent within each thinking agent's PerceptionRadius (parallel)
+     */
+    void Perceive();
+
+    AgentFunction m_Perception;
+    AgentFunction m_Decision;
+
+    glm::vec3 m_LODOrigin = glm::vec3(0.0f);
+    float m_LODDistances[LOD_LEVEL_COUNT - 1] = { 30.0f, 60.0f, 120.0f };
+    size_t m_MaxThinksPerFrame = DEFAULT_MAX_THINKS_PER_FRAME;
+
+    // Seconds since the system started (double: phases stay exact in long sessions)
+    double m_Time = 0.0;
+
+    // Dense agent arrays, regathered every frame (no structural changes happen during Update)
+    std::vector<Entity> m_Entities;
+    std::vector<AIAgentComponent*> m_Agents;
+    std::vector<const TransformComponent*> m_Transforms;
+    std::vector<glm::vec3> m_Positions;
+    std::vector<uint8_t> m_Due;
+    SpatialHash m_AgentHash;
+
+    std::vector<uint32_t> m_Thinking;  // Indices into the dense arrays
+    std::vector<float> m_Elapsed;      // Per thinking agent, captured before the passes
+    std::vector<uint8_t> m_NewTarget;  // Per thinking agent, perceived a different entity this frame
+    size_t m_Cursor = 0;               // Where the round-robin pick starts next frame
+    size_t m_Deferred = 0;
+    size_t m_LODCounts[LOD_LEVEL_COUNT] = {};
 };
 
 /**
@@ -0,0 +1,451 @@
+#include "BehaviorTree.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Logger.h"
+#include <algorithm>
+
+namespace Nilos {
+
+namespace {
+
+// Agents per job in BehaviorTreeGroup::Tick
+constexpr size_t TICK_GRAIN = 128;
+
+// Parallel state words: finished children, succeeded children, then one resume per child
+constexpr uint32_t PARALLEL_DONE = 0;
+constexpr uint32_t PARALLEL_SUCCEEDED = 1;
+constexpr uint32_t PARALLEL_RESUME = 2;
+
+uint32_t EncodeResume(uint32_t node, bool fresh) {
+    return (node << 1) | (fresh ? 1u : 0u);
+}
+
+uint32_t CountBits(uint32_t value) {
+    uint32_t count = 0;
+    for (; value; value &= value - 1) {
+        ++count;
+    }
+    return count;
+}
+
+bool IsDecorator(BehaviorNodeType type) {
+    return type == BehaviorNodeType::Inverter || type == BehaviorNodeType::Repeater ||
+           type == BehaviorNodeType::Condition;
+}
+
+} // namespace
+
+// -----------------------------------------------------------------------------
+// BehaviorTree
+// -----------------------------------------------------------------------------
+
+BehaviorStatus BehaviorTree::Run(Entity entity, Blackboard& blackboard, uint32_t* state, float deltaTime,
+                                 uint32_t node, bool fresh, uint32_t top, uint32_t& resume) const {
+    uint32_t current = node;
+    bool entering = fresh;
+
+    for (;;) {
+        const Node& n = m_Nodes[current];
+        BehaviorStatus status;
+
+        // Go down through composites and decorators to a leaf (or a parallel),
+        // or resume the one that was running. Only leaves, parallels and
+        // fresh entries are ever stored as resume points.
+        switch (n.Type) {
+            case BehaviorNodeType::Sequence:
+            case BehaviorNodeType::Selector:
+                if (n.ChildCount > 0) {
+                    ++current;
+                    continue;
+                }
+                status = n.Type == BehaviorNodeType::Sequence ? BehaviorStatus::Success : BehaviorStatus::Failure;
+                break;
+
+            case BehaviorNodeType::Inverter:
+                ++current;
+                continue;
+
+            case BehaviorNodeType::Repeater:
+                state[n.State] = 0;
+                ++current;
+                continue;
+
+            case BehaviorNodeType::Condition: {
+                bool passed = m_Conditions[n.Param](entity, blackboard);
+                if (passed && n.ChildCount > 0) {
+                    ++current;
+                    continue;
+                }
+                status = passed ? BehaviorStatus::Success : BehaviorStatus::Failure;
+                break;
+            }
+
+            case BehaviorNodeType::Parallel:
+                status = TickParallel(entity, blackboard, state, deltaTime, current, entering);
+                break;
+
+            case BehaviorNodeType::Action:
+                status = m_Actions[n.Param](entity, blackboard, deltaTime);
+                break;
+
+            case BehaviorNodeType::Wait: {
+                float elapsed = 0.0f;
+                if (!entering) {
+                    std::memcpy(&elapsed, &state[n.State], sizeof(elapsed));
+                }
+                elapsed += deltaTime;
+                std::memcpy(&state[n.State], &elapsed, sizeof(elapsed));
+                status = elapsed >= n.Seconds ? BehaviorStatus::Success : BehaviorStatus::Running;
+                break;
+            }
+
+            default:
+                status = BehaviorStatus::Failure;
+                break;
+        }
+
+        if (status == BehaviorStatus::Running) {
+            resume = EncodeResume(current, false);
+            return status;
+        }
+
+        // Climb until a composite moves on to its next child or the top completes
+        bool advanced = false;
+        while (!advanced) {
+            if (current == top) {
+                resume = EncodeResume(top, true);
+                return status;
+            }
+
+            uint32_t parentIndex = m_Nodes[current].Parent;
+            const Node& parent = m_Nodes[parentIndex];
+            switch (parent.Type) {
+                case BehaviorNodeType::Sequence:
+                case BehaviorNodeType::Selector: {
+                    BehaviorStatus moveOn = parent.Type == BehaviorNodeType::Sequence ? BehaviorStatus::Success
+                                                                                      : BehaviorStatus::Failure;
+                    uint32_t next = m_Nodes[current].End;
+                    if (status == moveOn && next < parent.End) {
+                        current = next;
+                        entering = true;
+                        advanced = true;
+                        continue;
+                    }
+                    break;
+                }
+
+                case BehaviorNodeType::Inverter:
+                    status = status == BehaviorStatus::Success ? BehaviorStatus::Failure : BehaviorStatus::Success;
+                    break;
+
+                case BehaviorNodeType::Repeater:
+                    if (status == BehaviorStatus::Success) {
+                        uint32_t count = ++state[parent.State];
+                        if (parent.Param == 0 || count < parent.Param) {
+                            resume = EncodeResume(parentIndex + 1, true);
+                            return BehaviorStatus::Running;
+                        }
+                    }
+                    break;
+
+                default:
+                    // Guards pass the child's status through
+                    break;
+            }
+            current = parentIndex;
+        }
+    }
+}
+
+BehaviorStatus BehaviorTree::TickParallel(Entity entity, Blackboard& blackboard, uint32_t* state, float deltaTime,
+                                          uint32_t node, bool fresh) const {
+    const Node& n = m_Nodes[node];
+    uint32_t* words = state + n.State;
+
+    if (fresh) {
+        words[PARALLEL_DONE] = 0;
+        words[PARALLEL_SUCCEEDED] = 0;
+        uint32_t i = 0;
+        for (uint32_t child = node + 1; child < n.End; child = m_Nodes[child].End, ++i) {
+            words[PARALLEL_RESUME + i] = EncodeResume(child, true);
+        }
+    }
+
+    uint32_t i = 0;
+    for (uint32_t child = node + 1; child < n.End; child = m_Nodes[child].End, ++i) {
+        uint32_t bit = 1u << i;
+        if (words[PARALLEL_DONE] & bit) {
+            continue;
+        }
+        uint32_t& childResume = words[PARALLEL_RESUME + i];
+        BehaviorStatus status = Run(entity, blackboard, state, deltaTime, childResume >> 1, (childResume & 1u) != 0,
+                                    child, childResume);
+        if (status != BehaviorStatus::Running) {
+            words[PARALLEL_DONE] |= bit;
+            if (status == BehaviorStatus::Success) {
+                words[PARALLEL_SUCCEEDED] |= bit;
+            }
+        }
+    }
+
+    uint32_t needed = n.Param == 0 ? n.ChildCount : std::min(n.Param, n.ChildCount);
+    uint32_t succeeded = CountBits(words[PARALLEL_SUCCEEDED]);
+    uint32_t failed = CountBits(words[PARALLEL_DONE] & ~words[PARALLEL_SUCCEEDED]);
+    if (succeeded >= needed) {
+        return BehaviorStatus::Success;
+    }
+    if (failed > n.ChildCount - needed) {
+        return BehaviorStatus::Failure;
+    }
+    return BehaviorStatus::Running;
+}
+
+// -----------------------------------------------------------------------------
+// BehaviorTreeBuilder
+// -----------------------------------------------------------------------------
+
+BehaviorTreeBuilder& BehaviorTreeBuilder::Sequence() {
+    m_Open.push_back(AddNode(BehaviorNodeType::Sequence));
+    return *this;
+}
+
+BehaviorTreeBuilder& BehaviorTreeBuilder::Selector() {
+    m_Open.push_back(AddNode(BehaviorNodeType::Selector));
+    return *this;
+}
+
+BehaviorTreeBuilder& BehaviorTreeBuilder::Parallel(uint32_t successCount) {
+    m_Open.push_back(AddNode(BehaviorNodeType::Parallel, successCount));
+    return *this;
+}
+
+BehaviorTreeBuilder& BehaviorTreeBuilder::End() {
+    if (m_Failed) {
+        return *this;
+    }
+    if (m_Open.empty() || IsDecorator(m_Tree.m_Nodes[m_Open.back()].Type)) {
+        NILOS_ERROR("BehaviorTreeBuilder: End() without an open composite");
+        m_Failed = true;
+        return *this;
+    }
+
+    BehaviorTree::Node& node = m_Tree.m_Nodes[m_Open.back()];
+    m_Open.pop_back();
+    node.End = static_cast<uint32_t>(m_Tree.m_Nodes.size());
+    if (node.Type == BehaviorNodeType::Parallel) {
+        node.State = m_Tree.m_StateSize;
+        m_Tree.m_StateSize += PARALLEL_RESUME + node.ChildCount;
+    }
+    CloseDecorators();
+    return *this;
+}
+
+BehaviorTreeBuilder& BehaviorTreeBuilder::Inverter() {
+    m_Open.push_back(AddNode(BehaviorNodeType::Inverter));
+    return *this;
+}
+
+BehaviorTreeBuilder& BehaviorTreeBuilder::Repeater(uint32_t count) {
+    m_Open.push_back(AddNode(BehaviorNodeType::Repeater, count));
+    return *this;
+}
+
+BehaviorTreeBuilder& BehaviorTreeBuilder::Guard(BehaviorCondition condition) {
+    uint32_t index = static_cast<uint32_t>(m_Tree.m_Conditions.size());
+    m_Tree.m_Conditions.push_back(std::move(condition));
+    m_Open.push_back(AddNode(BehaviorNodeType::Condition, index));
+    return *this;
+}
+
+BehaviorTreeBuilder& BehaviorTreeBuilder::Condition(BehaviorCondition condition) {
+    uint32_t index = static_cast<uint32_t>(m_Tree.m_Conditions.size());
+    m_Tree.m_Conditions.push_back(std::move(condition));
+    AddNode(BehaviorNodeType::Condition, index);
+    CloseDecorators();
+    return *this;
+}
+
+BehaviorTreeBuilder& BehaviorTreeBuilder::Action(BehaviorAction action) {
+    uint32_t index = static_cast<uint32_t>(m_Tree.m_Actions.size());
+    m_Tree.m_Actions.push_back(std::move(action));
+    AddNode(BehaviorNodeType::Action, index);
+    CloseDecorators();
+    return *this;
+}
+
+BehaviorTreeBuilder& BehaviorTreeBuilder::Wait(float seconds) {
+    AddNode(BehaviorNodeType::Wait, 0, std::max(seconds, 0.0f));
+    CloseDecorators();
+    return *this;
+}
+
+bool BehaviorTreeBuilder::Build(BehaviorTree& tree) {
+    bool valid = !m_Failed;
+    if (valid && m_Tree.m_Nodes.empty()) {
+        NILOS_ERROR("BehaviorTreeBuilder: empty tree");
+        valid = false;
+    } else if (valid && !m_Open.empty()) {
+        NILOS_ERROR("BehaviorTreeBuilder: ", m_Open.size(), " node(s) not closed");
+        valid = false;
+    }
+
+    if (valid) {
+        tree = std::move(m_Tree);
+    }
+    m_Tree = BehaviorTree();
+    m_Open.clear();
+    m_Failed = false;
+    return valid;
+}
+
+uint32_t BehaviorTreeBuilder::AddNode(BehaviorNodeType type, uint32_t param, float seconds) {
+    std::vector<BehaviorTree::Node>& nodes = m_Tree.m_Nodes;
+    if (m_Failed) {
+        return BehaviorTree::NO_NODE;
+    }
+    if (m_Open.empty() && !nodes.empty()) {
+        NILOS_ERROR("BehaviorTreeBuilder: a tree has exactly one root");
+        m_Failed = true;
+        return BehaviorTree::NO_NODE;
+    }
+
+    uint32_t parent = m_Open.empty() ? BehaviorTree::NO_NODE : m_Open.back();
+    if (parent != BehaviorTree::NO_NODE) {
+        BehaviorTree::Node& parentNode = nodes[parent];
+        if (parentNode.Type == BehaviorNodeType::Parallel &&
+            parentNode.ChildCount == BehaviorTree::MAX_PARALLEL_CHILDREN) {
+            NILOS_ERROR("BehaviorTreeBuilder: a parallel node takes at most ",
+                        BehaviorTree::MAX_PARALLEL_CHILDREN, " children");
+            m_Failed = true;
+            return BehaviorTree::NO_NODE;
+        }
+        ++parentNode.ChildCount;
+    }
+
+    uint32_t index = static_cast<uint32_t>(nodes.size());
+    BehaviorTree::Node node{};
+    node.Type = type;
+    node.End = index + 1;  // Composites and decorators are fixed up when they close
+    node.Parent = parent;
+    node.Param = param;
+    node.Seconds = seconds;
+    if (type == BehaviorNodeType::Repeater || type == BehaviorNodeType::Wait) {
+        node.State = m_Tree.m_StateSize++;
+    }
+    nodes.push_back(node);
+    return index;
+}
+
+void BehaviorTreeBuilder::CloseDecorators() {
+    // The innermost open node is a decorator only once its single child is complete
+    while (!m_Failed && !m_Open.empty()) {
+        BehaviorTree::Node& node = m_Tree.m_Nodes[m_Open.back()];
+        if (!IsDecorator(node.Type) || node.ChildCount == 0) {
+            break;
+        }
+        node.End = static_cast<uint32_t>(m_Tree.m_Nodes.size());
+        m_Open.pop_back();
+    }
+}
+
+// -----------------------------------------------------------------------------
+// BehaviorTreeGroup
+// -----------------------------------------------------------------------------
+
+BehaviorTreeGroup::BehaviorTreeGroup(const BehaviorTree& tree)
+    : m_Tree(tree), m_StateSize(tree.GetStateSize()) {
+}
+
+bool BehaviorTreeGroup::Add(Entity entity) {
+    auto [it, inserted] = m_Index.try_emplace(entity, static_cast<uint32_t>(m_Entities.size()));
+    if (!inserted) {
+        return false;
+    }
+    m_Entities.push_back(entity);
+    m_Blackboards.emplace_back();
+    m_Resume.push_back(EncodeResume(0, true));
+    m_Status.push_back(BehaviorStatus::Running);
+    m_State.resize(m_State.size() + m_StateSize, 0);
+    return true;
+}
+
+bool BehaviorTreeGroup::Remove(Entity entity) {
+    auto it = m_Index.find(entity);
+    if (it == m_Index.end()) {
+        return false;
+    }
+
+    // Swap with the last agent to keep the arrays dense
+    uint32_t index = it->second;
+    uint32_t last = static_cast<uint32_t>(m_Entities.size() - 1);
+    m_Index.erase(it);
+    if (index != last) {
+        m_Entities[index] = m_Entities[last];
+        m_Blackboards[index] = m_Blackboards[last];
+        m_Resume[index] = m_Resume[last];
+        m_Status[index] = m_Status[last];
+        std::copy_n(m_State.begin() + static_cast<size_t>(last) * m_StateSize, m_StateSize,
+                    m_State.begin() + static_cast<size_t>(index) * m_StateSize);
+        m_Index[m_Entities[index]] = index;
+    }
+    m_Entities.pop_back();
+    m_Blackboards.pop_back();
+    m_Resume.pop_back();
+    m_Status.pop_back();
+    m_State.resize(m_State.size() - m_StateSize);
+    return true;
+}
+
+void BehaviorTreeGroup::Clear() {
+    m_Entities.clear();
+    m_Blackboards.clear();
+    m_Resume.clear();
+    m_Status.clear();
+    m_State.clear();
+    m_Index.clear();
+}
+
+void BehaviorTreeGroup::Reset(Entity entity) {
+    auto it = m_Index.find(entity);
+    if (it != m_Index.end()) {
+        m_Resume[it->second] = EncodeResume(0, true);
+    }
+}
+
+void BehaviorTreeGroup::Tick(float deltaTime) {
+    if (m_Tree.IsEmpty()) {
+        return;
+    }
+    JobSystem::Get().ParallelFor(m_Entities.size(), TICK_GRAIN, [this, deltaTime](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            TickIndex(i, deltaTime);
+        }
+    });
+}
+
+BehaviorStatus BehaviorTreeGroup::TickAgent(Entity entity, float deltaTime) {
+    auto it = m_Index.find(entity);
+    if (it == m_Index.end() || m_Tree.IsEmpty()) {
+        return BehaviorStatus::Failure;
+    }
+    TickIndex(it->second, deltaTime);
+    return m_Status[it->second];
+}
+
+Blackboard* BehaviorTreeGroup::GetBlackboard(Entity entity) {
+    auto it = m_Index.find(entity);
+    return it != m_Index.end() ? &m_Blackboards[it->second] : nullptr;
+}
+
+BehaviorStatus BehaviorTreeGroup::GetStatus(Entity entity) const {
+    auto it = m_Index.find(entity);
+    return it != m_Index.end() ? m_Status[it->second] : BehaviorStatus::Failure;
+}
+
+void BehaviorTreeGroup::TickIndex(size_t index, float deltaTime) {
+    uint32_t& resume = m_Resume[index];
+    uint32_t* state = m_StateSize ? &m_State[index * m_StateSize] : nullptr;
+    m_Status[index] = m_Tree.Run(m_Entities[index], m_Blackboards[index], state, deltaTime,
+                                 resume >> 1, (resume & 1u) != 0, 0, resume);
+}
+
+} // namespace Nilos
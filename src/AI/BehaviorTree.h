@@ -0,0 +1,296 @@
+#pragma once
+
+#include "../ECS/Entity.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Behavior tree node types
+ */
+enum class BehaviorNodeType {
+    // Composite nodes
+    Sequence,      // Execute children in order, fail if any fails
+    Selector,      // Execute children until one succeeds
+    Parallel,      // Execute multiple children simultaneously
+
+    // Decorator nodes
+    Inverter,      // Invert result of child
+    Repeater,      // Repeat child N times or forever
+    Condition,     // Only execute if condition is met
+
+    // Leaf nodes
+    Action,        // Execute an action
+    Wait          // Wait for specified time
+};
+
+enum class BehaviorStatus : uint8_t {
+    Success,
+    Failure,
+    Running
+};
+
+/**
+ * @brief Fixed-size per-agent memory of a behavior tree (64 bytes)
+ *
+ * Keys are slot indices chosen by the game (an enum works well). Each
+ * slot holds one 32-bit value read as float, integer or Entity; flags are
+ * 32 separate bits.
+ */
+struct Blackboard {
+    static constexpr uint32_t SLOT_COUNT = 15;
+    static constexpr uint32_t FLAG_COUNT = 32;
+
+    float GetFloat(uint32_t slot) const {
+        float value;
+        std::memcpy(&value, &Slots[slot], sizeof(value));
+        return value;
+    }
+    void SetFloat(uint32_t slot, float value) { std::memcpy(&Slots[slot], &value, sizeof(value)); }
+
+    uint32_t GetInt(uint32_t slot) const { return Slots[slot]; }
+    void SetInt(uint32_t slot, uint32_t value) { Slots[slot] = value; }
+
+    Entity GetEntity(uint32_t slot) const { return static_cast<Entity>(Slots[slot]); }
+    void SetEntity(uint32_t slot, Entity entity) { Slots[slot] = static_cast<uint32_t>(entity); }
+
+    bool GetFlag(uint32_t flag) const { return (Flags >> flag) & 1u; }
+    void SetFlag(uint32_t flag, bool value) {
+        Flags = value ? (Flags | (1u << flag)) : (Flags & ~(1u << flag));
+    }
+
+    uint32_t Slots[SLOT_COUNT] = {};
+    uint32_t Flags = 0;
+};
+
+static_assert(sizeof(Blackboard) == 64, "Blackboard should stay one cache line");
+
+/**
+ * @brief Leaf callbacks; they may run on worker threads, one agent per call
+ */
+using BehaviorAction = std::function<BehaviorStatus(Entity, Blackboard&, float deltaTime)>;
+using BehaviorCondition = std::function<bool(Entity, const Blackboard&)>;
+
+/**
+ * @brief Immutable behavior tree compiled into a flat node array
+ *
+ * Nodes are stored depth first, so a node's first child directly follows
+ * it and its subtree ends at a stored index (the next sibling). Ticking
+ * walks this array by index; no per-node objects or virtual calls.
+ *
+ * Create trees with BehaviorTreeBuilder and run them with
+ * BehaviorTreeGroup, which keeps all per-agent state. One tree can be
+ * shared by any number of groups.
+ */
+class BehaviorTree {
+public:
+    static constexpr uint32_t NO_NODE = UINT32_MAX;
+    static constexpr uint32_t MAX_PARALLEL_CHILDREN = 32;
+
+    size_t GetNodeCount() const { return m_Nodes.size(); }
+    bool IsEmpty() const { return m_Nodes.empty(); }
+
+    /**
+     * @brief 32-bit state words each agent needs (timers, counters, parallel bookkeeping)
+     */
+    uint32_t GetStateSize() const { return m_StateSize; }
+
+private:
+    friend class BehaviorTreeBuilder;
+    friend class BehaviorTreeGroup;
+
+    struct Node {
+        BehaviorNodeType Type;
+        uint32_t ChildCount;
+        uint32_t End;     // One past the last node of the subtree
+        uint32_t Parent;  // NO_NODE for the root
+        uint32_t Param;   // Action/condition index, repeat count, parallel success threshold
+        uint32_t State;   // First state word of the node, if it uses any
+        float Seconds;    // Wait duration
+    };
+
+    /**
+     * @brief Tick one agent from a node until its subtree top completes or something runs
+     *
+     * @param resume Receives where to continue next tick: a node index
+     *        shifted left by one, with the low bit set when the node must
+     *        be entered fresh rather than resumed
+     */
+    BehaviorStatus Run(Entity entity, Blackboard& blackboard, uint32_t* state, float deltaTime,
+                       uint32_t node, bool fresh, uint32_t top, uint32_t& resume) const;
+
+    /**
+     * @brief Tick the unfinished children of a parallel node
+     */
+    BehaviorStatus TickParallel(Entity entity, Blackboard& blackboard, uint32_t* state, float deltaTime,
+                                uint32_t node, bool fresh) const;
+
+    std::vector<Node> m_Nodes;
+    std::vector<BehaviorAction> m_Actions;
+    std::vector<BehaviorCondition> m_Conditions;
+    uint32_t m_StateSize = 0;
+};
+
+/**
+ * @brief Describes a behavior tree and compiles it into a BehaviorTree
+ *
+ * Composites (Sequence, Selector, Parallel) collect children until End().
+ * Decorators (Inverter, Repeater, Guard) wrap exactly the next child and
+ * close on their own. Condition, Action and Wait are leaves.
+ *
+ * Usage:
+ *   BehaviorTreeBuilder builder;
+ *   builder.Selector()
+ *              .Sequence()
+ *                  .Condition(canSeeEnemy)
+ *                  .Action(attack)
+ *              .End()
+ *              .Sequence()
+ *                  .Action(pickPatrolPoint)
+ *                  .Action(moveToPatrolPoint)
+ *                  .Wait(2.0f)
+ *              .End()
+ *          .End();
+ *   BehaviorTree tree;
+ *   builder.Build(tree);
+ */
+class BehaviorTreeBuilder {
+public:
+    BehaviorTreeBuilder& Sequence();
+    BehaviorTreeBuilder& Selector();
+
+    /**
+     * @brief Runs all children each tick; succeeds once successCount of them have (0 = all)
+     *
+     * Fails as soon as enough children failed that successCount can no
+     * longer be reached. Finished children are not ticked again.
+     */
+    BehaviorTreeBuilder& Parallel(uint32_t successCount = 0);
+
+    /**
+     * @brief Close the innermost composite
+     */
+    BehaviorTreeBuilder& End();
+
+    BehaviorTreeBuilder& Inverter();
+
+    /**
+     * @brief Run the child count times (0 = forever); fails if the child fails
+     *
+     * Each repetition starts on the next tick, so a child that finishes
+     * instantly cannot stall the frame.
+     */
+    BehaviorTreeBuilder& Repeater(uint32_t count = 0);
+
+    /**
+     * @brief Run the child only if the condition holds when the guard is entered
+     */
+    BehaviorTreeBuilder& Guard(BehaviorCondition condition);
+
+    BehaviorTreeBuilder& Condition(BehaviorCondition condition);
+    BehaviorTreeBuilder& Action(BehaviorAction action);
+    BehaviorTreeBuilder& Wait(float seconds);
+
+    /**
+     * @brief Compile the description into tree and reset the builder
+     * @return False (tree left unchanged) if the description is incomplete or invalid
+     */
+    bool Build(BehaviorTree& tree);
+
+private:
+    /**
+     * @brief Append a node under the current scope
+     */
+    uint32_t AddNode(BehaviorNodeType type, uint32_t param = 0, float seconds = 0.0f);
+
+    /**
+     * @brief Close decorators whose child is complete
+     */
+    void CloseDecorators();
+
+    BehaviorTree m_Tree;
+    std::vector<uint32_t> m_Open;  // Nodes still collecting children, innermost last
+    bool m_Failed = false;
+};
+
+/**
+ * @brief Agents running one behavior tree, ticked together
+ *
+ * All per-agent state sits in flat arrays: a blackboard, the node to
+ * resume and the tree's state words. A running action or wait is resumed
+ * directly on the next tick instead of walking down from the root again;
+ * once it finishes, the result climbs the parent links and the
+ * surrounding composites carry on from there. When the root completes,
+ * the next tick starts over from the root.
+ *
+ * Tick() updates every agent in parallel on the job system, so leaf
+ * callbacks must only touch their own agent (or be otherwise
+ * thread-safe). TickAgent() updates one agent and may be called for
+ * different agents concurrently, e.g. from an AISystem decision function.
+ * Adding and removing agents is not thread-safe.
+ *
+ * Children of a Parallel each keep their own resume point, so any
+ * subtree may run under one.
+ */
+class BehaviorTreeGroup {
+public:
+    explicit BehaviorTreeGroup(const BehaviorTree& tree);
+
+    /**
+     * @brief Add an agent with a cleared blackboard
+     * @return False if it is already in the group
+     */
+    bool Add(Entity entity);
+    bool Remove(Entity entity);
+    bool Contains(Entity entity) const { return m_Index.count(entity) != 0; }
+    void Clear();
+
+    /**
+     * @brief Restart an agent from the root on its next tick (keeps the blackboard)
+     */
+    void Reset(Entity entity);
+
+    /**
+     * @brief Tick every agent
+     */
+    void Tick(float deltaTime);
+
+    /**
+     * @brief Tick one agent
+     * @return The root's status (Failure if the agent is not in the group)
+     */
+    BehaviorStatus TickAgent(Entity entity, float deltaTime);
+
+    /**
+     * @brief Per-agent blackboard (nullptr if not in the group); invalidated by Add/Remove
+     */
+    Blackboard* GetBlackboard(Entity entity);
+
+    /**
+     * @brief Root status after the agent's last tick
+     */
+    BehaviorStatus GetStatus(Entity entity) const;
+
+    size_t GetAgentCount() const { return m_Entities.size(); }
+    const BehaviorTree& GetTree() const { return m_Tree; }
+
+private:
+    void TickIndex(size_t index, float deltaTime);
+
+    const BehaviorTree& m_Tree;
+    uint32_t m_StateSize;
+
+    std::vector<Entity> m_Entities;
+    std::vector<Blackboard> m_Blackboards;
+    std::vector<uint32_t> m_Resume;  // Encoded like BehaviorTree::Run's resume
+    std::vector<BehaviorStatus> m_Status;
+    std::vector<uint32_t> m_State;   // m_StateSize words per agent
+    std::unordered_map<Entity, uint32_t> m_Index;
+};
+
+} // namespace Nilos
@@ -0,0 +1,404 @@
+#include "FlowField.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Logger.h"
+#include "../Core/Memory.h"
+#include <algorithm>
+
+namespace Nilos {
+
+namespace {
+
+struct Direction {
+    int DX, DZ;
+    uint32_t Cost;
+};
+
+// Same order as Pathfinding's neighbour offsets
+constexpr Direction DIRECTIONS[8] = {
+    {  1,  0, FlowField::STRAIGHT_COST }, { -1,  0, FlowField::STRAIGHT_COST },
+    {  0,  1, FlowField::STRAIGHT_COST }, {  0, -1, FlowField::STRAIGHT_COST },
+    {  1,  1, FlowField::DIAGONAL_COST }, {  1, -1, FlowField::DIAGONAL_COST },
+    { -1,  1, FlowField::DIAGONAL_COST }, { -1, -1, FlowField::DIAGONAL_COST }
+};
+
+constexpr float INV_SQRT2 = 0.70710678f;
+
+// Unit world-space vector for each direction index; NO_DIRECTION maps to zero
+const glm::vec3 DIRECTION_VECTORS[FlowField::NO_DIRECTION + 1] = {
+    {  1.0f, 0.0f,  0.0f }, { -1.0f, 0.0f,  0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f },
+    {  INV_SQRT2, 0.0f,  INV_SQRT2 }, {  INV_SQRT2, 0.0f, -INV_SQRT2 },
+    { -INV_SQRT2, 0.0f,  INV_SQRT2 }, { -INV_SQRT2, 0.0f, -INV_SQRT2 },
+    {  0.0f, 0.0f,  0.0f }
+};
+
+// Step costs are below this, so a wavefront at cost c only ever pushes
+// into the next BUCKET_COUNT - 1 buckets and a ring of them suffices
+constexpr uint32_t BUCKET_COUNT = FlowField::DIAGONAL_COST + 1;
+
+// Rows per job in the parallel passes
+constexpr size_t ROWS_PER_JOB = 32;
+
+/**
+ * @brief Per-thread ring of cost buckets (Dial's algorithm), reused across builds
+ *
+ * Only used by the serial integration pass: a thread waiting in one of the
+ * parallel passes may pick up another field's build.
+ */
+struct WavefrontScratch {
+    std::vector<int> Buckets[BUCKET_COUNT];
+};
+
+thread_local WavefrontScratch t_Wavefront;
+
+/**
+ * @brief Legal moves for each combination of blocked neighbours
+ *
+ * Indexed by a byte whose bit i is set if the neighbour in DIRECTIONS[i]
+ * is blocked. A straight move needs its target free; a diagonal one also
+ * both cells beside it (no squeezing between blocked cells or around a
+ * corner).
+ */
+struct MoveTable {
+    uint8_t Moves[256];
+
+    MoveTable() {
+        for (int blocked = 0; blocked < 256; ++blocked) {
+            auto isFree = [blocked](int dx, int dz) {
+                for (int i = 0; i < 8; ++i) {
+                    if (DIRECTIONS[i].DX == dx && DIRECTIONS[i].DZ == dz) {
+                        return !(blocked & (1 << i));
+                    }
+                }
+                return true;
+            };
+            uint8_t moves = 0;
+            for (int i = 0; i < 8; ++i) {
+                int dx = DIRECTIONS[i].DX;
+                int dz = DIRECTIONS[i].DZ;
+                if (isFree(dx, dz) && (dx == 0 || dz == 0 || (isFree(dx, 0) && isFree(0, dz)))) {
+                    moves |= static_cast<uint8_t>(1 << i);
+                }
+            }
+            Moves[blocked] = moves;
+        }
+    }
+};
+
+const MoveTable MOVE_TABLE;
+
+} // namespace
+
+bool FlowField::Build(const NavGrid& grid, int goalCell) {
+    m_Grid = &grid;
+    m_GoalCell = -1;
+    m_Reached = GridRect{};
+
+    size_t cellCount = static_cast<size_t>(grid.GetCellCount());
+    m_Costs.assign(cellCount, UNREACHABLE);
+    m_Directions.resize(cellCount);
+
+    if (goalCell < 0 || goalCell >= grid.GetCellCount() || grid.IsBlocked(goalCell)) {
+        std::fill(m_Directions.begin(), m_Directions.end(), NO_DIRECTION);
+        return false;
+    }
+    m_GoalCell = goalCell;
+
+    // Legal moves of every cell, so the passes below test one bit instead
+    // of up to three neighbours per direction. They are kept in
+    // m_Directions until the direction pass replaces them.
+    std::vector<uint8_t>& moves = m_Directions;
+    int width = grid.GetWidth();
+    JobSystem::Get().ParallelFor(static_cast<size_t>(grid.GetHeight()), ROWS_PER_JOB,
+        [&grid, &moves, width](size_t begin, size_t end) {
+            for (int z = static_cast<int>(begin); z < static_cast<int>(end); ++z) {
+                for (int x = 0; x < width; ++x) {
+                    uint32_t blocked = 0;
+                    for (int i = 0; i < 8; ++i) {
+                        blocked |= static_cast<uint32_t>(
+                            grid.IsBlocked(x + DIRECTIONS[i].DX, z + DIRECTIONS[i].DZ)) << i;
+                    }
+                    moves[grid.GetIndex(x, z)] = MOVE_TABLE.Moves[blocked];
+                }
+            }
+        });
+
+    int offsets[8];
+    for (int i = 0; i < 8; ++i) {
+        offsets[i] = DIRECTIONS[i].DZ * width + DIRECTIONS[i].DX;
+    }
+
+    // Integration: Dijkstra from the goal with a ring of cost buckets.
+    // Moves are symmetric, so costs from the goal equal costs to it.
+    std::vector<int>* buckets = t_Wavefront.Buckets;
+    for (uint32_t i = 0; i < BUCKET_COUNT; ++i) {
+        buckets[i].clear();
+    }
+
+    int goalX = grid.GetX(goalCell);
+    int minCell = goalCell;
+    int maxCell = goalCell;
+    m_Costs[goalCell] = 0;
+    buckets[0].push_back(goalCell);
+    size_t queued = 1;
+
+    for (uint32_t cost = 0; queued > 0; ++cost) {
+        // Pushes always land in later buckets, never in the one being read
+        std::vector<int>& bucket = buckets[cost % BUCKET_COUNT];
+        queued -= bucket.size();
+        for (int cell : bucket) {
+            if (m_Costs[cell] != cost) {
+                continue;  // Improved after it was queued
+            }
+            minCell = std::min(minCell, cell);
+            maxCell = std::max(maxCell, cell);
+
+            uint32_t mask = moves[cell];
+            for (int i = 0; mask != 0; ++i, mask >>= 1) {
+                if (!(mask & 1u)) {
+                    continue;
+                }
+                int neighbor = cell + offsets[i];
+                uint32_t newCost = cost + DIRECTIONS[i].Cost;
+                if (newCost < m_Costs[neighbor]) {
+                    m_Costs[neighbor] = newCost;
+                    buckets[newCost % BUCKET_COUNT].push_back(neighbor);
+                    ++queued;
+                }
+            }
+        }
+        bucket.clear();
+    }
+
+    // Reached rows from the lowest and highest reached index, columns from a scan of those rows
+    int minZ = minCell / width;
+    int maxZ = maxCell / width;
+    int minX = goalX;
+    int maxX = goalX;
+    for (int z = minZ; z <= maxZ; ++z) {
+        const uint32_t* row = &m_Costs[static_cast<size_t>(z) * width];
+        for (int x = 0; x < minX; ++x) {
+            if (row[x] != UNREACHABLE) {
+                minX = x;
+                break;
+            }
+        }
+        for (int x = width - 1; x > maxX; --x) {
+            if (row[x] != UNREACHABLE) {
+                maxX = x;
+                break;
+            }
+        }
+    }
+    m_Reached = { minX, minZ, maxX, maxZ };
+
+    // Directions: independent per cell (each reads only its own moves), so
+    // rows are split across jobs. Blocked cells bordering the reached area
+    // get one too; everything further away has none.
+    GridRect area = { minX - 1, minZ - 1, maxX + 1, maxZ + 1 };
+    JobSystem::Get().ParallelFor(static_cast<size_t>(grid.GetHeight()), ROWS_PER_JOB,
+        [this, &grid, &offsets, area, width](size_t begin, size_t end) {
+            for (int z = static_cast<int>(begin); z < static_cast<int>(end); ++z) {
+                for (int x = 0; x < width; ++x) {
+                    int cell = grid.GetIndex(x, z);
+                    m_Directions[cell] = area.Contains(x, z)
+                        ? FindDirection(cell, m_Directions[cell], offsets)
+                        : NO_DIRECTION;
+                }
+            }
+        });
+
+    return true;
+}
+
+uint8_t FlowField::FindDirection(int cell, uint8_t moves, const int* offsets) const {
+    if (cell == m_GoalCell) {
+        return NO_DIRECTION;
+    }
+
+    uint8_t best = NO_DIRECTION;
+    uint32_t bestCost = UNREACHABLE;
+    for (uint8_t i = 0; i < 8; ++i) {
+        if (!(moves & (1u << i))) {
+            continue;
+        }
+        uint32_t cost = m_Costs[cell + offsets[i]];
+        if (cost != UNREACHABLE && cost + DIRECTIONS[i].Cost < bestCost) {
+            bestCost = cost + DIRECTIONS[i].Cost;
+            best = i;
+        }
+    }
+    return best;
+}
+
+glm::vec3 FlowField::GetDirection(const glm::vec3& world) const {
+    int x, z;
+    if (!IsValid() || !m_Grid->WorldToGrid(world, x, z)) {
+        return glm::vec3(0.0f);
+    }
+    return DIRECTION_VECTORS[m_Directions[m_Grid->GetIndex(x, z)]];
+}
+
+float FlowField::GetDistance(const glm::vec3& world) const {
+    int x, z;
+    if (!IsValid() || !m_Grid->WorldToGrid(world, x, z)) {
+        return -1.0f;
+    }
+
+    int cell = m_Grid->GetIndex(x, z);
+    uint32_t cost = m_Costs[cell];
+    if (cost == UNREACHABLE) {
+        // Blocked cell next to the reachable area: one step out, then the field
+        uint8_t index = m_Directions[cell];
+        if (index == NO_DIRECTION) {
+            return -1.0f;
+        }
+        const Direction& direction = DIRECTIONS[index];
+        cost = m_Costs[m_Grid->GetIndex(x + direction.DX, z + direction.DZ)] + direction.Cost;
+    }
+    return static_cast<float>(cost) / static_cast<float>(STRAIGHT_COST) * m_Grid->GetCellSize();
+}
+
+bool FlowField::IsReachable(const glm::vec3& world) const {
+    int x, z;
+    if (!IsValid() || !m_Grid->WorldToGrid(world, x, z)) {
+        return false;
+    }
+    int cell = m_Grid->GetIndex(x, z);
+    return cell == m_GoalCell || m_Directions[cell] != NO_DIRECTION;
+}
+
+bool FlowField::IsAffectedBy(const GridRect& rect) const {
+    if (!IsValid()) {
+        return true;
+    }
+
+    // A cell matters if it or one of its neighbours was reached: it was on
+    // the way, could become part of it, or is a corner of a diagonal step
+    GridRect area = { std::max(rect.MinX - 1, m_Reached.MinX), std::max(rect.MinZ - 1, m_Reached.MinZ),
+                      std::min(rect.MaxX + 1, m_Reached.MaxX), std::min(rect.MaxZ + 1, m_Reached.MaxZ) };
+    for (int z = area.MinZ; z <= area.MaxZ; ++z) {
+        for (int x = area.MinX; x <= area.MaxX; ++x) {
+            if (m_Costs[m_Grid->GetIndex(x, z)] != UNREACHABLE) {
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+FlowFieldCache::FlowFieldCache(const NavGrid& grid)
+    : m_Grid(grid), m_GridVersion(grid.GetVersion()) {
+}
+
+const FlowField* FlowFieldCache::GetField(const glm::vec3& goal) {
+    int x, z;
+    if (!m_Grid.WorldToGrid(goal, x, z)) {
+        return nullptr;
+    }
+    return GetField(m_Grid.GetIndex(x, z));
+}
+
+const FlowField* FlowFieldCache::GetField(int goalCell) {
+    if (goalCell < 0 || goalCell >= m_Grid.GetCellCount() || m_Grid.IsBlocked(goalCell)) {
+        return nullptr;
+    }
+    CheckVersion();
+
+    Entry& entry = Touch(goalCell);
+    if (entry.Dirty) {
+        entry.Field.Build(m_Grid, goalCell);
+        entry.Dirty = false;
+    }
+    return &entry.Field;
+}
+
+void FlowFieldCache::Prefetch(const std::vector<int>& goalCells) {
+    CheckVersion();
+
+    ScratchScope scratch;
+    ArenaVector<Entry*> builds = scratch.MakeVector<Entry*>();
+    size_t touched = 0;
+    for (int goalCell : goalCells) {
+        if (touched >= m_Capacity) {
+            break;  // Anything more could evict the fields being built
+        }
+        if (goalCell < 0 || goalCell >= m_Grid.GetCellCount() || m_Grid.IsBlocked(goalCell)) {
+            continue;
+        }
+        Entry& entry = Touch(goalCell);
+        ++touched;
+        if (entry.Dirty && std::find(builds.begin(), builds.end(), &entry) == builds.end()) {
+            builds.push_back(&entry);
+        }
+    }
+
+    JobSystem::Get().ParallelFor(builds.size(), 1, [this, &builds](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i) {
+            builds[i]->Field.Build(m_Grid, builds[i]->GoalCell);
+            builds[i]->Dirty = false;
+        }
+    });
+}
+
+void FlowFieldCache::OnCellsChanged(const GridRect& rect) {
+    for (Entry& entry : m_Fields) {
+        if (!entry.Dirty && entry.Field.IsAffectedBy(rect)) {
+            entry.Dirty = true;
+        }
+    }
+    m_GridVersion = m_Grid.GetVersion();
+}
+
+void FlowFieldCache::SetCapacity(size_t capacity) {
+    m_Capacity = std::max<size_t>(capacity, 1);
+    while (m_Fields.size() > m_Capacity) {
+        m_Index.erase(m_Fields.back().GoalCell);
+        m_Fields.pop_back();
+    }
+}
+
+void FlowFieldCache::Clear() {
+    m_Fields.clear();
+    m_Index.clear();
+}
+
+FlowFieldCache::Entry& FlowFieldCache::Touch(int goalCell) {
+    auto it = m_Index.find(goalCell);
+    if (it != m_Index.end()) {
+        m_Fields.splice(m_Fields.begin(), m_Fields, it->second);
+        if (it->second->Dirty) {
+            ++m_Rebuilds;
+        } else {
+            ++m_Hits;
+        }
+        return *it->second;
+    }
+
+    ++m_Misses;
+    if (m_Fields.size() >= m_Capacity) {
+        // Recycle the oldest field's memory
+        m_Index.erase(m_Fields.back().GoalCell);
+        m_Fields.splice(m_Fields.begin(), m_Fields, std::prev(m_Fields.end()));
+        m_Fields.front().GoalCell = goalCell;
+        m_Fields.front().Dirty = true;
+    } else {
+        m_Fields.push_front({ goalCell, true, FlowField() });
+    }
+    m_Index[goalCell] = m_Fields.begin();
+    return m_Fields.front();
+}
+
+void FlowFieldCache::CheckVersion() {
+    if (m_Grid.GetVersion() == m_GridVersion) {
+        return;
+    }
+    if (!m_Fields.empty()) {
+        NILOS_WARNING("NavGrid changed without OnCellsChanged, rebuilding all flow fields");
+    }
+    for (Entry& entry : m_Fields) {
+        entry.Dirty = true;
+    }
+    m_GridVersion = m_Grid.GetVersion();
+}
+
+} // namespace Nilos
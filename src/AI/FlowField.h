@@ -0,0 +1,189 @@
+#pragma once
+
+#include "NavGrid.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Flow field towards one goal cell on a NavGrid
+ *
+ * Built once per goal: an integration pass stores every reachable cell's
+ * travel cost to the goal, then a direction pass points each cell at its
+ * cheapest neighbour. Any number of agents then steer by sampling the
+ * direction under their position, O(1) each, instead of running one
+ * search per agent. Moves follow the same rules as Pathfinding (8 ways,
+ * no corner cutting); blocked cells next to the reachable area point out
+ * of the obstacle, so agents brushing one are not stranded.
+ *
+ * Costs are integers (10 per straight step, 14 per diagonal), which lets
+ * the integration pass use a bucket queue instead of a heap.
+ *
+ * Usage:
+ *   FlowField field;
+ *   field.Build(grid, grid.GetIndex(goalX, goalZ));
+ *   velocity = field.GetDirection(unitPosition) * speed;
+ */
+class FlowField {
+public:
+    static constexpr uint32_t UNREACHABLE = UINT32_MAX;
+    static constexpr uint8_t NO_DIRECTION = 8;  // Goal, unreachable or isolated cell
+
+    static constexpr uint32_t STRAIGHT_COST = 10;
+    static constexpr uint32_t DIAGONAL_COST = 14;
+
+    /**
+     * @brief Compute the field for a goal cell (the grid is kept by reference)
+     * @return False if the goal is outside the grid or blocked (the field is then empty)
+     */
+    bool Build(const NavGrid& grid, int goalCell);
+
+    /**
+     * @brief Unit XZ direction to move in from a world position
+     * @return Zero vector at the goal, outside the grid or where the goal is unreachable
+     */
+    glm::vec3 GetDirection(const glm::vec3& world) const;
+
+    /**
+     * @brief Direction index of a cell (into the 8 neighbour offsets, or NO_DIRECTION)
+     */
+    uint8_t GetDirection(int cell) const { return m_Directions[cell]; }
+
+    /**
+     * @brief Integer travel cost from a cell to the goal (UNREACHABLE if none)
+     */
+    uint32_t GetCost(int cell) const { return m_Costs[cell]; }
+
+    /**
+     * @brief Travel distance to the goal in world units (-1 if unreachable or outside the grid)
+     */
+    float GetDistance(const glm::vec3& world) const;
+
+    /**
+     * @brief True if following the field from this position reaches the goal
+     */
+    bool IsReachable(const glm::vec3& world) const;
+
+    /**
+     * @brief True if changing the cells in rect could change this field
+     *
+     * Only edits touching the reachable area matter; a field whose goal is
+     * walled off from the edit stays valid.
+     */
+    bool IsAffectedBy(const GridRect& rect) const;
+
+    bool IsValid() const { return m_GoalCell >= 0; }
+    int GetGoalCell() const { return m_GoalCell; }
+    const NavGrid* GetGrid() const { return m_Grid; }
+
+    /**
+     * @brief Bounding rectangle of the reachable cells
+     */
+    const GridRect& GetReachedBounds() const { return m_Reached; }
+
+    size_t GetMemorySize() const { return m_Costs.capacity() * sizeof(uint32_t) + m_Directions.capacity(); }
+
+private:
+    /**
+     * @brief Neighbour on the cheapest way to the goal (NO_DIRECTION if none)
+     * @param moves Bit mask of the directions the cell may step in
+     * @param offsets Index offset of each direction's neighbour
+     */
+    uint8_t FindDirection(int cell, uint8_t moves, const int* offsets) const;
+
+    const NavGrid* m_Grid = nullptr;
+    int m_GoalCell = -1;
+    GridRect m_Reached;
+
+    std::vector<uint32_t> m_Costs;
+    std::vector<uint8_t> m_Directions;
+};
+
+/**
+ * @brief Flow fields for recently used goals, repaired by region when obstacles change
+ *
+ * Fields are built on first use of their goal and kept in an LRU cache.
+ * OnCellsChanged only marks the fields whose reachable area touches the
+ * edit; they are rebuilt (reusing their memory) the next time they are
+ * requested. Prefetch builds several missing fields in parallel on the
+ * job system.
+ *
+ * Returned fields stay valid until the next GetField, Prefetch,
+ * SetCapacity or Clear call, which may evict or rebuild them.
+ *
+ * Not thread-safe (fields themselves may be sampled from any thread).
+ */
+class FlowFieldCache {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 16;
+
+    explicit FlowFieldCache(const NavGrid& grid);
+
+    /**
+     * @brief Field towards the cell containing a world position
+     * @return nullptr if the goal is outside the grid or blocked
+     */
+    const FlowField* GetField(const glm::vec3& goal);
+    const FlowField* GetField(int goalCell);
+
+    /**
+     * @brief Build the fields of several goals at once (in parallel), up to the capacity
+     */
+    void Prefetch(const std::vector<int>& goalCells);
+
+    /**
+     * @brief Invalidate the fields affected by a change of the cells in rect
+     *
+     * If the grid changes without this call, the next request rebuilds
+     * every field (with a warning).
+     */
+    void OnCellsChanged(const GridRect& rect);
+
+    /**
+     * @brief Maximum fields kept (at least 1)
+     */
+    void SetCapacity(size_t capacity);
+    size_t GetCapacity() const { return m_Capacity; }
+    void Clear();
+
+    size_t GetFieldCount() const { return m_Fields.size(); }
+    size_t GetHits() const { return m_Hits; }
+    size_t GetMisses() const { return m_Misses; }
+    size_t GetRebuilds() const { return m_Rebuilds; }
+
+private:
+    struct Entry {
+        int GoalCell;
+        bool Dirty;
+        FlowField Field;
+    };
+
+    /**
+     * @brief Entry for a goal moved to the front, created (evicting the oldest) if missing
+     */
+    Entry& Touch(int goalCell);
+
+    /**
+     * @brief Mark every field dirty if the grid changed behind our back
+     */
+    void CheckVersion();
+
+    const NavGrid& m_Grid;
+    uint32_t m_GridVersion;
+
+    // Most recently used first
+    std::list<Entry> m_Fields;
+    std::unordered_map<int, std::list<Entry>::iterator> m_Index;
+    size_t m_Capacity = DEFAULT_CAPACITY;
+
+    size_t m_Hits = 0;
+    size_t m_Misses = 0;
+    size_t m_Rebuilds = 0;
+};
+
+} // namespace Nilos
@@ -0,0 +1,620 @@
+#include "HierarchicalPathfinder.h"
+#include "Pathfinding.h"
+#include "../Core/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+
+namespace Nilos {
+
+namespace {
+
+constexpr float SQRT2 = 1.41421356f;
+constexpr float UNREACHABLE = std::numeric_limits<float>::infinity();
+
+// Entrances at least this wide get a portal at each end instead of one in the middle
+constexpr int LONG_ENTRANCE = 6;
+
+struct Direction {
+    int DX, DZ;
+    float Cost;
+};
+
+constexpr Direction DIRECTIONS[8] = {
+    {  1,  0, 1.0f }, { -1,  0, 1.0f }, {  0,  1, 1.0f }, {  0, -1, 1.0f },
+    {  1,  1, SQRT2 }, {  1, -1, SQRT2 }, { -1,  1, SQRT2 }, { -1, -1, SQRT2 }
+};
+
+using HeapEntry = std::pair<float, int>;
+
+/**
+ * @brief Dijkstra from one cell over the cells of rect (same move rules as Pathfinding)
+ * @param costs Indexed by (x - MinX) + (z - MinZ) * width, UNREACHABLE if not reached
+ */
+void ClusterDistances(const NavGrid& grid, const GridRect& rect, int sourceCell, std::vector<float>& costs) {
+    thread_local std::vector<HeapEntry> heap;
+
+    int width = rect.MaxX - rect.MinX + 1;
+    int height = rect.MaxZ - rect.MinZ + 1;
+    costs.assign(static_cast<size_t>(width) * height, UNREACHABLE);
+
+    auto local = [&](int x, int z) { return (x - rect.MinX) + (z - rect.MinZ) * width; };
+    int source = local(grid.GetX(sourceCell), grid.GetZ(sourceCell));
+    costs[source] = 0.0f;
+    heap.clear();
+    heap.push_back({ 0.0f, source });
+
+    while (!heap.empty()) {
+        std::pop_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+        HeapEntry entry = heap.back();
+        heap.pop_back();
+        if (entry.first > costs[entry.second]) {
+            continue; // Stale entry
+        }
+
+        int x = rect.MinX + entry.second % width;
+        int z = rect.MinZ + entry.second / width;
+        for (const Direction& direction : DIRECTIONS) {
+            int nx = x + direction.DX;
+            int nz = z + direction.DZ;
+            if (!rect.Contains(nx, nz) || grid.IsBlocked(nx, nz)) {
+                continue;
+            }
+            if (direction.DX != 0 && direction.DZ != 0 &&
+                (grid.IsBlocked(nx, z) || grid.IsBlocked(x, nz))) {
+                continue;
+            }
+            float cost = entry.first + direction.Cost;
+            int neighbor = local(nx, nz);
+            if (cost < costs[neighbor]) {
+                costs[neighbor] = cost;
+                heap.push_back({ cost, neighbor });
+                std::push_heap(heap.begin(), heap.end(), std::greater<HeapEntry>());
+            }
+        }
+    }
+}
+
+/**
+ * @brief Per-thread state of the abstract search (same generation trick as Pathfinding)
+ */
+struct AbstractScratch {
+    std::vector<float> G;
+    std::vector<int> Parent;
+    std::vector<uint32_t> Stamp;
+    std::vector<uint8_t> Closed;
+    std::vector<HeapEntry> Heap;
+    uint32_t Generation = 0;
+
+    void Begin(size_t nodeCount) {
+        if (Stamp.size() < nodeCount) {
+            G.resize(nodeCount);
+            Parent.resize(nodeCount);
+            Stamp.resize(nodeCount, 0);
+            Closed.resize(nodeCount);
+        }
+        Heap.clear();
+        if (++Generation == 0) {
+            std::fill(Stamp.begin(), Stamp.end(), 0);
+            Generation = 1;
+        }
+    }
+};
+
+thread_local AbstractScratch t_Abstract;
+
+template<typename LinkVector>
+bool HasLink(const LinkVector& links, int node) {
+    return std::any_of(links.begin(), links.end(), [node](const auto& link) { return link.Node == node; });
+}
+
+} // namespace
+
+HierarchicalPathfinder::HierarchicalPathfinder(int clusterSize)
+    : m_ClusterSize(std::max(clusterSize, 2)) {
+}
+
+void HierarchicalPathfinder::Build(const NavGrid& grid) {
+    m_Grid = &grid;
+    m_ClustersX = (grid.GetWidth() + m_ClusterSize - 1) / m_ClusterSize;
+    m_ClustersZ = (grid.GetHeight() + m_ClusterSize - 1) / m_ClusterSize;
+
+    m_Clusters.assign(static_cast<size_t>(m_ClustersX) * m_ClustersZ, Cluster());
+    for (int cz = 0; cz < m_ClustersZ; ++cz) {
+        for (int cx = 0; cx < m_ClustersX; ++cx) {
+            GridRect& rect = m_Clusters[cz * m_ClustersX + cx].Rect;
+            rect.MinX = cx * m_ClusterSize;
+            rect.MinZ = cz * m_ClusterSize;
+            rect.MaxX = std::min(rect.MinX + m_ClusterSize, grid.GetWidth()) - 1;
+            rect.MaxZ = std::min(rect.MinZ + m_ClusterSize, grid.GetHeight()) - 1;
+        }
+    }
+    m_Nodes.clear();
+    m_FreeNodes.clear();
+
+    for (int cz = 0; cz < m_ClustersZ; ++cz) {
+        for (int cx = 0; cx < m_ClustersX; ++cx) {
+            int cluster = cz * m_ClustersX + cx;
+            if (cx + 1 < m_ClustersX) {
+                RebuildBorder(cluster, cluster + 1);
+            }
+            if (cz + 1 < m_ClustersZ) {
+                RebuildBorder(cluster, cluster + m_ClustersX);
+            }
+        }
+    }
+    for (int cluster = 0; cluster < GetClusterCount(); ++cluster) {
+        RebuildIntraEdges(cluster);
+    }
+
+    ClearCache();
+    m_GridVersion = grid.GetVersion();
+    NILOS_INFO("Pathfinding hierarchy built: ", m_ClustersX, "x", m_ClustersZ, " clusters of ",
+               m_ClusterSize, " cells, ", GetPortalCount(), " portals");
+}
+
+void HierarchicalPathfinder::OnCellsChanged(const GridRect& rect) {
+    if (!m_Grid) {
+        return;
+    }
+
+    GridRect bounds = m_Grid->GetBounds();
+    if (!rect.Overlaps(bounds)) {
+        m_GridVersion = m_Grid->GetVersion();
+        return;
+    }
+    int cx0 = std::max(rect.MinX, 0) / m_ClusterSize;
+    int cz0 = std::max(rect.MinZ, 0) / m_ClusterSize;
+    int cx1 = std::min(rect.MaxX, bounds.MaxX) / m_ClusterSize;
+    int cz1 = std::min(rect.MaxZ, bounds.MaxZ) / m_ClusterSize;
+
+    // Every border of a touched cluster is re-detected; both sides of a
+    // border then need their intra-cluster edges recomputed
+    std::vector<uint8_t> changed(m_Clusters.size(), 0);
+    auto index = [this](int cx, int cz) { return cz * m_ClustersX + cx; };
+    for (int cz = cz0; cz <= cz1; ++cz) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            changed[index(cx, cz)] = 1;
+        }
+    }
+    for (int cz = cz0; cz <= cz1; ++cz) {
+        for (int cx = std::max(cx0 - 1, 0); cx <= std::min(cx1, m_ClustersX - 2); ++cx) {
+            RebuildBorder(index(cx, cz), index(cx + 1, cz));
+            changed[index(cx, cz)] = changed[index(cx + 1, cz)] = 1;
+        }
+    }
+    for (int cz = std::max(cz0 - 1, 0); cz <= std::min(cz1, m_ClustersZ - 2); ++cz) {
+        for (int cx = cx0; cx <= cx1; ++cx) {
+            RebuildBorder(index(cx, cz), index(cx, cz + 1));
+            changed[index(cx, cz)] = changed[index(cx, cz + 1)] = 1;
+        }
+    }
+    for (int cluster = 0; cluster < GetClusterCount(); ++cluster) {
+        if (changed[cluster]) {
+            RebuildIntraEdges(cluster);
+        }
+    }
+
+    // Drop cached routes that start, end or pass through a rebuilt cluster
+    for (auto it = m_Cache.begin(); it != m_Cache.end();) {
+        int startCluster = static_cast<int>(it->Key >> 32);
+        int goalCluster = static_cast<int>(it->Key & 0xFFFFFFFFu);
+        bool stale = changed[startCluster] || changed[goalCluster] ||
+                     std::any_of(it->Nodes.begin(), it->Nodes.end(), [this, &changed](int node) {
+                         return m_Nodes[node].Cluster < 0 || changed[m_Nodes[node].Cluster];
+                     });
+        if (stale) {
+            m_CacheIndex.erase(it->Key);
+            it = m_Cache.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    m_GridVersion = m_Grid->GetVersion();
+}
+
+bool HierarchicalPathfinder::FindPath(const glm::vec3& start, const glm::vec3& goal, std::vector<glm::vec3>& path) {
+    path.clear();
+    if (!m_Grid) {
+        return false;
+    }
+
+    int startX, startZ, goalX, goalZ;
+    if (!m_Grid->WorldToGrid(start, startX, startZ) || !m_Grid->WorldToGrid(goal, goalX, goalZ)) {
+        return false;
+    }
+
+    thread_local std::vector<int> cells;
+    if (!FindPath(m_Grid->GetIndex(startX, startZ), m_Grid->GetIndex(goalX, goalZ), cells)) {
+        return false;
+    }
+
+    path.reserve(cells.size());
+    for (int cell : cells) {
+        path.push_back(m_Grid->GridToWorld(m_Grid->GetX(cell), m_Grid->GetZ(cell)));
+    }
+    return true;
+}
+
+bool HierarchicalPathfinder::FindPath(int startCell, int goalCell, std::vector<int>& cells) {
+    cells.clear();
+    if (!m_Grid) {
+        return false;
+    }
+    if (m_Grid->GetVersion() != m_GridVersion) {
+        NILOS_WARNING("NavGrid changed without OnCellsChanged, rebuilding the pathfinding hierarchy");
+        Build(*m_Grid);
+    }
+
+    int cellCount = m_Grid->GetCellCount();
+    if (startCell < 0 || startCell >= cellCount || goalCell < 0 || goalCell >= cellCount ||
+        m_Grid->IsBlocked(goalCell)) {
+        return false;
+    }
+
+    int startCluster = GetClusterIndex(startCell);
+    int goalCluster = GetClusterIndex(goalCell);
+
+    // Nearby: flat search over the clusters around both ends. If that
+    // fails the way round is longer, so fall through to the graph
+    int startCX = startCluster % m_ClustersX, startCZ = startCluster / m_ClustersX;
+    int goalCX = goalCluster % m_ClustersX, goalCZ = goalCluster / m_ClustersX;
+    if (std::abs(startCX - goalCX) <= 1 && std::abs(startCZ - goalCZ) <= 1) {
+        GridRect area;
+        area.MinX = (std::max(std::min(startCX, goalCX) - 1, 0)) * m_ClusterSize;
+        area.MinZ = (std::max(std::min(startCZ, goalCZ) - 1, 0)) * m_ClusterSize;
+        area.MaxX = std::min((std::max(startCX, goalCX) + 2) * m_ClusterSize, m_Grid->GetWidth()) - 1;
+        area.MaxZ = std::min((std::max(startCZ, goalCZ) + 2) * m_ClusterSize, m_Grid->GetHeight()) - 1;
+        if (Pathfinding::FindPath(*m_Grid, startCell, goalCell, cells, area)) {
+            return true;
+        }
+    }
+
+    thread_local std::vector<Link> startLinks;
+    thread_local std::vector<Link> goalLinks;
+    LinkToPortals(startCell, startLinks);
+    LinkToPortals(goalCell, goalLinks);
+    if (startLinks.empty() || goalLinks.empty()) {
+        return false;
+    }
+
+    thread_local std::vector<int> route;
+    uint64_t key = (uint64_t(uint32_t(startCluster)) << 32) | uint32_t(goalCluster);
+    const std::vector<int>* cached = FindCachedRoute(key);
+    if (cached && HasLink(startLinks, cached->front()) && HasLink(goalLinks, cached->back())) {
+        route = *cached;
+        ++m_CacheHits;
+    } else {
+        ++m_CacheMisses;
+        if (!SearchAbstract(goalCell, goalCluster, startLinks, goalLinks, route)) {
+            return false;
+        }
+        StoreRoute(key, route);
+    }
+
+    // Refine: local paths inside clusters, single steps across borders
+    auto first = std::find_if(startLinks.begin(), startLinks.end(),
+                              [](const Link& link) { return link.Node == route.front(); });
+    if (first->Via != startCell) {
+        cells.push_back(startCell);
+    }
+    bool refined = AppendSegment(first->Via, m_Nodes[route.front()].Cell, GetClusterIndex(first->Via), cells);
+    for (size_t i = 0; refined && i + 1 < route.size(); ++i) {
+        const Node& from = m_Nodes[route[i]];
+        const Node& to = m_Nodes[route[i + 1]];
+        if (from.Cluster != to.Cluster) {
+            cells.push_back(to.Cell);
+        } else {
+            refined = AppendSegment(from.Cell, to.Cell, from.Cluster, cells);
+        }
+    }
+    refined = refined && AppendSegment(m_Nodes[route.back()].Cell, goalCell, goalCluster, cells);
+
+    if (!refined) {
+        NILOS_ERROR("Hierarchical path refinement failed (graph out of date?)");
+        cells.clear();
+        return false;
+    }
+    return true;
+}
+
+void HierarchicalPathfinder::SetCacheCapacity(size_t capacity) {
+    m_CacheCapacity = capacity;
+    while (m_Cache.size() > m_CacheCapacity) {
+        m_CacheIndex.erase(m_Cache.back().Key);
+        m_Cache.pop_back();
+    }
+}
+
+void HierarchicalPathfinder::ClearCache() {
+    m_Cache.clear();
+    m_CacheIndex.clear();
+}
+
+int HierarchicalPathfinder::GetClusterIndex(int cell) const {
+    int cx = m_Grid->GetX(cell) / m_ClusterSize;
+    int cz = m_Grid->GetZ(cell) / m_ClusterSize;
+    return cz * m_ClustersX + cx;
+}
+
+void HierarchicalPathfinder::RebuildBorder(int clusterA, int clusterB) {
+    // Remove the portal pairs currently on this border
+    std::vector<int> existing = m_Clusters[clusterA].Nodes;
+    for (int node : existing) {
+        int partner = m_Nodes[node].Partner;
+        if (partner >= 0 && m_Nodes[partner].Cluster == clusterB) {
+            RemoveNode(node);
+            RemoveNode(partner);
+        }
+    }
+
+    // B is to the right of A (vertical border) or above it (horizontal border)
+    const GridRect& a = m_Clusters[clusterA].Rect;
+    bool vertical = a.MaxX + 1 == m_Clusters[clusterB].Rect.MinX;
+    int length = vertical ? a.MaxZ - a.MinZ + 1 : a.MaxX - a.MinX + 1;
+
+    auto cellsAt = [&](int i, int& cellA, int& cellB) {
+        if (vertical) {
+            cellA = m_Grid->GetIndex(a.MaxX, a.MinZ + i);
+            cellB = m_Grid->GetIndex(a.MaxX + 1, a.MinZ + i);
+        } else {
+            cellA = m_Grid->GetIndex(a.MinX + i, a.MaxZ);
+            cellB = m_Grid->GetIndex(a.MinX + i, a.MaxZ + 1);
+        }
+    };
+    auto addAt = [&](int i) {
+        int cellA, cellB;
+        cellsAt(i, cellA, cellB);
+        AddPortal(clusterA, cellA, clusterB, cellB);
+    };
+
+    // Each maximal run of cells walkable on both sides is one entrance
+    int runStart = -1;
+    for (int i = 0; i <= length; ++i) {
+        bool open = false;
+        if (i < length) {
+            int cellA, cellB;
+            cellsAt(i, cellA, cellB);
+            open = !m_Grid->IsBlocked(cellA) && !m_Grid->IsBlocked(cellB);
+        }
+        if (open && runStart < 0) {
+            runStart = i;
+        } else if (!open && runStart >= 0) {
+            int runEnd = i - 1;
+            if (runEnd - runStart + 1 >= LONG_ENTRANCE) {
+                addAt(runStart);
+                addAt(runEnd);
+            } else {
+                addAt((runStart + runEnd) / 2);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+void HierarchicalPathfinder::AddPortal(int clusterA, int cellA, int clusterB, int cellB) {
+    auto allocate = [this](int cluster, int cell) {
+        int node;
+        if (!m_FreeNodes.empty()) {
+            node = m_FreeNodes.back();
+            m_FreeNodes.pop_back();
+        } else {
+            node = static_cast<int>(m_Nodes.size());
+            m_Nodes.emplace_back();
+        }
+        m_Nodes[node].Cell = cell;
+        m_Nodes[node].Cluster = cluster;
+        m_Clusters[cluster].Nodes.push_back(node);
+        return node;
+    };
+
+    int a = allocate(clusterA, cellA);
+    int b = allocate(clusterB, cellB);
+    m_Nodes[a].Partner = b;
+    m_Nodes[b].Partner = a;
+}
+
+void HierarchicalPathfinder::RemoveNode(int node) {
+    Node& removed = m_Nodes[node];
+    std::vector<int>& nodes = m_Clusters[removed.Cluster].Nodes;
+    nodes.erase(std::remove(nodes.begin(), nodes.end(), node), nodes.end());
+
+    // Edges pointing here from the same cluster go when its edges are rebuilt
+    removed.Cell = -1;
+    removed.Cluster = -1;
+    removed.Partner = -1;
+    removed.Edges.clear();
+    m_FreeNodes.push_back(node);
+}
+
+void HierarchicalPathfinder::RebuildIntraEdges(int cluster) {
+    thread_local std::vector<float> costs;
+
+    const Cluster& c = m_Clusters[cluster];
+    for (int node : c.Nodes) {
+        m_Nodes[node].Edges.clear();
+    }
+
+    // Costs are symmetric: one Dijkstra per portal covers it and every later one
+    int width = c.Rect.MaxX - c.Rect.MinX + 1;
+    for (size_t i = 0; i + 1 < c.Nodes.size(); ++i) {
+        int from = c.Nodes[i];
+        ClusterDistances(*m_Grid, c.Rect, m_Nodes[from].Cell, costs);
+        for (size_t j = i + 1; j < c.Nodes.size(); ++j) {
+            int to = c.Nodes[j];
+            int cell = m_Nodes[to].Cell;
+            float cost = costs[(m_Grid->GetX(cell) - c.Rect.MinX) + (m_Grid->GetZ(cell) - c.Rect.MinZ) * width];
+            if (cost != UNREACHABLE) {
+                m_Nodes[from].Edges.push_back({ to, cost });
+                m_Nodes[to].Edges.push_back({ from, cost });
+            }
+        }
+    }
+}
+
+void HierarchicalPathfinder::LinkToPortals(int cell, std::vector<Link>& links) const {
+    links.clear();
+    if (!m_Grid->IsBlocked(cell)) {
+        AddLinks(cell, 0.0f, cell, links);
+        return;
+    }
+
+    int x = m_Grid->GetX(cell);
+    int z = m_Grid->GetZ(cell);
+    for (const Direction& direction : DIRECTIONS) {
+        int nx = x + direction.DX;
+        int nz = z + direction.DZ;
+        if (m_Grid->IsBlocked(nx, nz) ||
+            (direction.DX != 0 && direction.DZ != 0 && (m_Grid->IsBlocked(nx, z) || m_Grid->IsBlocked(x, nz)))) {
+            continue;
+        }
+        int neighbor = m_Grid->GetIndex(nx, nz);
+        AddLinks(neighbor, direction.Cost, neighbor, links);
+    }
+}
+
+void HierarchicalPathfinder::AddLinks(int cell, float baseCost, int via, std::vector<Link>& links) const {
+    thread_local std::vector<float> costs;
+
+    const Cluster& c = m_Clusters[GetClusterIndex(cell)];
+    ClusterDistances(*m_Grid, c.Rect, cell, costs);
+
+    int width = c.Rect.MaxX - c.Rect.MinX + 1;
+    for (int node : c.Nodes) {
+        int portalCell = m_Nodes[node].Cell;
+        float cost = costs[(m_Grid->GetX(portalCell) - c.Rect.MinX) + (m_Grid->GetZ(portalCell) - c.Rect.MinZ) * width];
+        if (cost == UNREACHABLE) {
+            continue;
+        }
+        cost += baseCost;
+        auto existing = std::find_if(links.begin(), links.end(), [node](const Link& link) { return link.Node == node; });
+        if (existing == links.end()) {
+            links.push_back({ node, cost, via });
+        } else if (cost < existing->Cost) {
+            *existing = { node, cost, via };
+        }
+    }
+}
+
+bool HierarchicalPathfinder::SearchAbstract(int goalCell, int goalCluster, const std::vector<Link>& startLinks,
+                                            const std::vector<Link>& goalLinks, std::vector<int>& route) const {
+    route.clear();
+
+    // Start and goal are temporary nodes after the portals
+    const int startNode = static_cast<int>(m_Nodes.size());
+    const int goalNode = startNode + 1;
+
+    AbstractScratch& s = t_Abstract;
+    s.Begin(m_Nodes.size() + 2);
+
+    int goalX = m_Grid->GetX(goalCell);
+    int goalZ = m_Grid->GetZ(goalCell);
+    auto heuristic = [&](int node) {
+        if (node == goalNode) {
+            return 0.0f;
+        }
+        int cell = m_Nodes[node].Cell;
+        return Pathfinding::OctileDistance(m_Grid->GetX(cell) - goalX, m_Grid->GetZ(cell) - goalZ);
+    };
+    auto relax = [&](int node, int parent, float g) {
+        if (s.Stamp[node] != s.Generation) {
+            s.Stamp[node] = s.Generation;
+            s.Closed[node] = 0;
+        } else if (s.Closed[node] || g >= s.G[node]) {
+            return;
+        }
+        s.G[node] = g;
+        s.Parent[node] = parent;
+        s.Heap.push_back({ g + heuristic(node), node });
+        std::push_heap(s.Heap.begin(), s.Heap.end(), std::greater<HeapEntry>());
+    };
+
+    s.Stamp[startNode] = s.Generation;
+    s.Closed[startNode] = 1;
+    s.G[startNode] = 0.0f;
+    s.Parent[startNode] = -1;
+    for (const Link& link : startLinks) {
+        relax(link.Node, startNode, link.Cost);
+    }
+
+    while (!s.Heap.empty()) {
+        std::pop_heap(s.Heap.begin(), s.Heap.end(), std::greater<HeapEntry>());
+        int current = s.Heap.back().second;
+        s.Heap.pop_back();
+        if (s.Closed[current]) {
+            continue; // Stale entry
+        }
+        s.Closed[current] = 1;
+
+        if (current == goalNode) {
+            for (int node = s.Parent[goalNode]; node != startNode; node = s.Parent[node]) {
+                route.push_back(node);
+            }
+            std::reverse(route.begin(), route.end());
+            return true;
+        }
+
+        const Node& node = m_Nodes[current];
+        float g = s.G[current];
+        relax(node.Partner, current, g + 1.0f); // Borders are crossed orthogonally
+        for (const Edge& edge : node.Edges) {
+            relax(edge.To, current, g + edge.Cost);
+        }
+        if (node.Cluster == goalCluster) {
+            for (const Link& link : goalLinks) {
+                if (link.Node == current) {
+                    relax(goalNode, current, g + link.Cost);
+                }
+            }
+        }
+    }
+    return false;
+}
+
+bool HierarchicalPathfinder::AppendSegment(int fromCell, int toCell, int cluster, std::vector<int>& cells) const {
+    thread_local std::vector<int> segment;
+    if (!Pathfinding::FindPath(*m_Grid, fromCell, toCell, segment, m_Clusters[cluster].Rect)) {
+        return false;
+    }
+    auto first = segment.begin();
+    if (!cells.empty() && cells.back() == *first) {
+        ++first;
+    }
+    cells.insert(cells.end(), first, segment.end());
+    return true;
+}
+
+const std::vector<int>* HierarchicalPathfinder::FindCachedRoute(uint64_t key) {
+    auto it = m_CacheIndex.find(key);
+    if (it == m_CacheIndex.end()) {
+        return nullptr;
+    }
+    m_Cache.splice(m_Cache.begin(), m_Cache, it->second);
+    return &it->second->Nodes;
+}
+
+void HierarchicalPathfinder::StoreRoute(uint64_t key, const std::vector<int>& route) {
+    if (m_CacheCapacity == 0) {
+        return;
+    }
+
+    auto it = m_CacheIndex.find(key);
+    if (it != m_CacheIndex.end()) {
+        it->second->Nodes = route;
+        m_Cache.splice(m_Cache.begin(), m_Cache, it->second);
+        return;
+    }
+
+    m_Cache.push_front({ key, route });
+    m_CacheIndex[key] = m_Cache.begin();
+    if (m_Cache.size() > m_CacheCapacity) {
+        m_CacheIndex.erase(m_Cache.back().Key);
+        m_Cache.pop_back();
+    }
+}
+
+} // namespace Nilos
@@ -0,0 +1,186 @@
+#pragma once
+
+#include "NavGrid.h"
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Hierarchical A* (HPA*) over a NavGrid
+ *
+ * The grid is split into square clusters. Where two clusters share a run
+ * of walkable border cells, a portal pair is placed (one at the middle of
+ * short runs, one at each end of long ones). Portals in a cluster are
+ * joined by edges whose cost is the exact shortest path between them
+ * inside the cluster. The result is a small abstract graph.
+ *
+ * A query links start and goal to the portals of their clusters, searches
+ * the abstract graph, then refines each hop with a flat A* confined to
+ * one cluster. Long searches thus cost one short graph search plus a few
+ * cluster-sized searches; paths are typically a few percent longer than
+ * optimal. Queries between neighbouring clusters run a flat A* over the
+ * surrounding 3x3 clusters instead, which is exact for nearly all of them.
+ *
+ * Routes (portal sequences) between recent cluster pairs are kept in an
+ * LRU cache: agents crossing the map between the same areas skip the
+ * abstract search and only refine their ends.
+ *
+ * When obstacles change, call OnCellsChanged with the edited rectangle.
+ * Only the clusters it touches and their neighbours are rebuilt, and only
+ * their cached routes are dropped.
+ *
+ * Not thread-safe: the graph and cache are shared state (search scratch
+ * itself is per-thread).
+ */
+class HierarchicalPathfinder {
+public:
+    static constexpr int DEFAULT_CLUSTER_SIZE = 16;
+    static constexpr size_t DEFAULT_CACHE_CAPACITY = 256;
+
+    explicit HierarchicalPathfinder(int clusterSize = DEFAULT_CLUSTER_SIZE);
+
+    /**
+     * @brief Build the abstract graph for a grid (kept by reference)
+     */
+    void Build(const NavGrid& grid);
+
+    /**
+     * @brief Repair the graph after the cells in rect changed
+     *
+     * If the grid changes without this call, the next query rebuilds
+     * everything (with a warning).
+     */
+    void OnCellsChanged(const GridRect& rect);
+
+    /**
+     * @brief Find path between two world positions
+     * @param path Receives cell centers from start to goal (cleared first)
+     * @return False if either end is outside the grid, the goal is blocked or unreachable
+     */
+    bool FindPath(const glm::vec3& start, const glm::vec3& goal, std::vector<glm::vec3>& path);
+
+    /**
+     * @brief Find path between two cells (NavGrid indices)
+     */
+    bool FindPath(int startCell, int goalCell, std::vector<int>& cells);
+
+    /**
+     * @brief Maximum cached cluster-to-cluster routes (0 disables the cache)
+     */
+    void SetCacheCapacity(size_t capacity);
+    size_t GetCacheCapacity() const { return m_CacheCapacity; }
+    void ClearCache();
+
+    size_t GetCacheHits() const { return m_CacheHits; }
+    size_t GetCacheMisses() const { return m_CacheMisses; }
+
+    int GetClusterSize() const { return m_ClusterSize; }
+    int GetClusterCount() const { return static_cast<int>(m_Clusters.size()); }
+    size_t GetPortalCount() const { return m_Nodes.size() - m_FreeNodes.size(); }
+
+private:
+    struct Edge {
+        int To;
+        float Cost;
+    };
+
+    /**
+     * @brief Portal: a border cell with one crossing edge (to Partner)
+     */
+    struct Node {
+        int Cell = -1;
+        int Cluster = -1;
+        int Partner = -1;  // Node across the border; -1 once removed
+        std::vector<Edge> Edges;
+    };
+
+    struct Cluster {
+        GridRect Rect;
+        std::vector<int> Nodes;
+    };
+
+    struct Link {
+        int Node;
+        float Cost;
+        int Via;  // Cell the path leaves the start through (the start itself unless it is blocked)
+    };
+
+    /**
+     * @brief Cached portal sequence from a start cluster to a goal cluster
+     */
+    struct CachedRoute {
+        uint64_t Key;
+        std::vector<int> Nodes;
+    };
+
+    int GetClusterIndex(int cell) const;
+
+    /**
+     * @brief Remove and re-detect the portals between two neighbouring clusters
+     */
+    void RebuildBorder(int clusterA, int clusterB);
+
+    /**
+     * @brief Portal pair at cells a (in clusterA) and b (in clusterB)
+     */
+    void AddPortal(int clusterA, int cellA, int clusterB, int cellB);
+
+    void RemoveNode(int node);
+
+    /**
+     * @brief Recompute the edges between a cluster's portals
+     */
+    void RebuildIntraEdges(int cluster);
+
+    /**
+     * @brief Costs from a cell to every portal of its cluster reachable inside it
+     *
+     * A blocked start may be left towards any walkable neighbour, also
+     * across a border where there is no portal; it is linked through each
+     * of them instead.
+     */
+    void LinkToPortals(int cell, std::vector<Link>& links) const;
+
+    /**
+     * @brief Add links from cell (reached at baseCost) within its cluster, keeping the cheapest per portal
+     */
+    void AddLinks(int cell, float baseCost, int via, std::vector<Link>& links) const;
+
+    /**
+     * @brief A* over the abstract graph between the linked start and goal
+     */
+    bool SearchAbstract(int goalCell, int goalCluster, const std::vector<Link>& startLinks,
+                        const std::vector<Link>& goalLinks, std::vector<int>& route) const;
+
+    /**
+     * @brief Append the in-cluster path from one cell to another (skipping a repeated first cell)
+     */
+    bool AppendSegment(int fromCell, int toCell, int cluster, std::vector<int>& cells) const;
+
+    const std::vector<int>* FindCachedRoute(uint64_t key);
+    void StoreRoute(uint64_t key, const std::vector<int>& route);
+
+    const NavGrid* m_Grid = nullptr;
+    uint32_t m_GridVersion = 0;
+    int m_ClusterSize;
+    int m_ClustersX = 0;
+    int m_ClustersZ = 0;
+
+    std::vector<Cluster> m_Clusters;
+    std::vector<Node> m_Nodes;
+    std::vector<int> m_FreeNodes;
+
+    // Most recently used first
+    std::list<CachedRoute> m_Cache;
+    std::unordered_map<uint64_t, std::list<CachedRoute>::iterator> m_CacheIndex;
+    size_t m_CacheCapacity = DEFAULT_CACHE_CAPACITY;
+    size_t m_CacheHits = 0;
+    size_t m_CacheMisses = 0;
+};
+
+} // namespace Nilos
@@ -0,0 +1,64 @@
+#include "NavGrid.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Nilos {
+
+NavGrid::NavGrid(int width, int height, float cellSize, const glm::vec3& origin) {
+    Resize(width, height, cellSize, origin);
+}
+
+void NavGrid::Resize(int width, int height, float cellSize, const glm::vec3& origin) {
+    m_Width = std::max(width, 0);
+    m_Height = std::max(height, 0);
+    m_CellSize = cellSize;
+    m_Origin = origin;
+    m_Blocked.assign((static_cast<size_t>(m_Width) * m_Height + 63) / 64, 0);
+    ++m_Version;
+}
+
+void NavGrid::Build(const std::vector<glm::vec3>& obstacles) {
+    std::fill(m_Blocked.begin(), m_Blocked.end(), 0);
+    for (const glm::vec3& obstacle : obstacles) {
+        int x, z;
+        if (WorldToGrid(obstacle, x, z)) {
+            int index = GetIndex(x, z);
+            m_Blocked[static_cast<size_t>(index) >> 6] |= uint64_t(1) << (index & 63);
+        }
+    }
+    ++m_Version;
+}
+
+void NavGrid::SetBlocked(int x, int z, bool blocked) {
+    if (!Contains(x, z)) {
+        return;
+    }
+    int index = GetIndex(x, z);
+    uint64_t bit = uint64_t(1) << (index & 63);
+    uint64_t& word = m_Blocked[static_cast<size_t>(index) >> 6];
+    uint64_t updated = blocked ? (word | bit) : (word & ~bit);
+    if (updated != word) {
+        word = updated;
+        ++m_Version;
+    }
+}
+
+void NavGrid::ClearObstacles() {
+    std::fill(m_Blocked.begin(), m_Blocked.end(), 0);
+    ++m_Version;
+}
+
+bool NavGrid::WorldToGrid(const glm::vec3& world, int& x, int& z) const {
+    x = static_cast<int>(std::floor((world.x - m_Origin.x) / m_CellSize));
+    z = static_cast<int>(std::floor((world.z - m_Origin.z) / m_CellSize));
+    return Contains(x, z);
+}
+
+glm::vec3 NavGrid::GridToWorld(int x, int z) const {
+    return glm::vec3(m_Origin.x + (x + 0.5f) * m_CellSize,
+                     m_Origin.y,
+                     m_Origin.z + (z + 0.5f) * m_CellSize);
+}
+
+} // namespace Nilos
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Inclusive rectangle of grid cells
+ */
+struct GridRect {
+    int MinX = 0;
+    int MinZ = 0;
+    int MaxX = -1;
+    int MaxZ = -1;
+
+    bool Contains(int x, int z) const { return x >= MinX && x <= MaxX && z >= MinZ && z <= MaxZ; }
+    bool Overlaps(const GridRect& other) const {
+        return MinX <= other.MaxX && other.MinX <= MaxX && MinZ <= other.MaxZ && other.MinZ <= MaxZ;
+    }
+};
+
+/**
+ * @brief Walkability grid on the XZ plane
+ *
+ * A fixed-size grid of square cells with one occupancy bit per cell,
+ * built once from the obstacles and queried by Pathfinding. Cell (0, 0)
+ * starts at Origin; cells outside the grid count as blocked. Cells are
+ * also addressed by index = z * width + x.
+ *
+ * Usage:
+ *   NavGrid grid(512, 512, 1.0f);
+ *   grid.Build(obstacles);
+ *   std::vector<glm::vec3> path;
+ *   Pathfinding::FindPath(grid, start, goal, path);
+ */
+class NavGrid {
+public:
+    NavGrid() = default;
+    NavGrid(int width, int height, float cellSize = 1.0f, const glm::vec3& origin = glm::vec3(0.0f));
+
+    /**
+     * @brief Change the grid dimensions (all cells become walkable)
+     */
+    void Resize(int width, int height, float cellSize = 1.0f, const glm::vec3& origin = glm::vec3(0.0f));
+
+    /**
+     * @brief Clear the grid, then block every cell containing an obstacle position
+     */
+    void Build(const std::vector<glm::vec3>& obstacles);
+
+    /**
+     * @brief Block or free one cell (ignored outside the grid)
+     */
+    void SetBlocked(int x, int z, bool blocked);
+
+    /**
+     * @brief Make every cell walkable
+     */
+    void ClearObstacles();
+
+    bool IsBlocked(int x, int z) const {
+        if (!Contains(x, z)) {
+            return true;
+        }
+        return IsBlocked(GetIndex(x, z));
+    }
+
+    bool IsBlocked(int index) const {
+        return (m_Blocked[static_cast<size_t>(index) >> 6] >> (index & 63)) & 1u;
+    }
+
+    bool Contains(int x, int z) const {
+        return static_cast<unsigned>(x) < static_cast<unsigned>(m_Width) &&
+               static_cast<unsigned>(z) < static_cast<unsigned>(m_Height);
+    }
+
+    /**
+     * @brief Cell containing a world position
+     * @return False if the position is outside the grid (x/z are still set)
+     */
+    bool WorldToGrid(const glm::vec3& world, int& x, int& z) const;
+
+    /**
+     * @brief World position of a cell's center (Y = Origin.y)
+     */
+    glm::vec3 GridToWorld(int x, int z) const;
+
+    int GetIndex(int x, int z) const { return z * m_Width + x; }
+    int GetX(int index) const { return index % m_Width; }
+    int GetZ(int index) const { return index / m_Width; }
+
+    int GetWidth() const { return m_Width; }
+    int GetHeight() const { return m_Height; }
+    int GetCellCount() const { return m_Width * m_Height; }
+    GridRect GetBounds() const { return { 0, 0, m_Width - 1, m_Height - 1 }; }
+    float GetCellSize() const { return m_CellSize; }
+    const glm::vec3& GetOrigin() const { return m_Origin; }
+
+    /**
+     * @brief Incremented whenever a cell changes (lets callers invalidate cached paths)
+     */
+    uint32_t GetVersion() const { return m_Version; }
+
+private:
+    int m_Width = 0;
+    int m_Height = 0;
+    float m_CellSize = 1.0f;
+    glm::vec3 m_Origin = glm::vec3(0.0f);
+    uint32_t m_Version = 0;
+
+    // One bit per cell, 64 cells per word
+    std::vector<uint64_t> m_Blocked;
+};
+
+} // namespace Nilos
@@ -0,0 +1,252 @@
+#include "PathRequestQueue.h"
+#include "../Events/EventManager.h"
+#include <algorithm>
+
+namespace Nilos {
+
+namespace {
+
+// Expansions between budget checks; keeps clock reads off the hot loop
+constexpr size_t STEP_CHUNK = 256;
+
+} // namespace
+
+PathRequestQueue::PathRequestQueue(const NavGrid& grid)
+    : m_Grid(grid) {
+}
+
+PathRequestQueue::~PathRequestQueue() {
+    Flush();
+}
+
+PathTicket PathRequestQueue::Submit(const glm::vec3& start, const glm::vec3& goal) {
+    int startCell = -1;
+    int goalCell = -1;
+    int x, z;
+    if (m_Grid.WorldToGrid(start, x, z)) {
+        startCell = m_Grid.GetIndex(x, z);
+    }
+    if (m_Grid.WorldToGrid(goal, x, z)) {
+        goalCell = m_Grid.GetIndex(x, z);
+    }
+
+    PathTicket ticket = m_NextTicket++;
+    if (m_NextTicket == INVALID_PATH_TICKET) {
+        m_NextTicket = 1;
+    }
+
+    uint64_t key = MakeKey(startCell, goalCell);
+    auto [it, inserted] = m_Requests.try_emplace(key);
+    Request& request = it->second;
+    if (inserted) {
+        request.StartCell = startCell;
+        request.GoalCell = goalCell;
+        m_Waiting.push_back(key);
+    }
+    request.Tickets.push_back(ticket);
+    m_Tickets[ticket] = key;
+    return ticket;
+}
+
+bool PathRequestQueue::Cancel(PathTicket ticket) {
+    auto ticketIt = m_Tickets.find(ticket);
+    if (ticketIt == m_Tickets.end()) {
+        return false;
+    }
+    uint64_t key = ticketIt->second;
+    m_Tickets.erase(ticketIt);
+
+    auto requestIt = m_Requests.find(key);
+    std::vector<PathTicket>& tickets = requestIt->second.Tickets;
+    tickets.erase(std::find(tickets.begin(), tickets.end(), ticket));
+    if (tickets.empty()) {
+        // A running search finishes its slice and is discarded on harvest;
+        // a waiting entry is skipped when it comes up
+        m_Requests.erase(requestIt);
+    }
+    return true;
+}
+
+void PathRequestQueue::Update() {
+    if (!m_Jobs.IsDone()) {
+        return;
+    }
+    // Already done; makes sure the last job has released the counter
+    JobSystem::Get().Wait(m_Jobs);
+
+    while (m_Slots.size() < m_MaxSearches) {
+        m_Slots.push_back(std::make_unique<SearchSlot>());
+    }
+
+    ScratchScope scratch;
+    ArenaVector<Completed> completed = scratch.MakeVector<Completed>();
+    uint32_t gridVersion = m_Grid.GetVersion();
+
+    // Harvest finished searches; restart those that ran on an older grid
+    for (const std::unique_ptr<SearchSlot>& slotPtr : m_Slots) {
+        SearchSlot& slot = *slotPtr;
+        if (!slot.Active) {
+            continue;
+        }
+
+        auto it = m_Requests.find(slot.Key);
+        if (it == m_Requests.end() || !it->second.Searching) {
+            // Cancelled (and possibly submitted again, waiting for a new search)
+            slot.Active = false;
+            continue;
+        }
+
+        if (slot.GridVersion != gridVersion) {
+            slot.GridVersion = gridVersion;
+            slot.Started = false;
+            continue;
+        }
+
+        PathSearch::Status status = slot.Search.GetStatus();
+        if (slot.Started && (status == PathSearch::Status::Found || status == PathSearch::Status::Failed)) {
+            Complete(slot.Key, &slot.Search, completed);
+            slot.Active = false;
+        }
+    }
+
+    // Fill free slots in submission order
+    for (const std::unique_ptr<SearchSlot>& slotPtr : m_Slots) {
+        SearchSlot& slot = *slotPtr;
+        while (!slot.Active && !m_Waiting.empty()) {
+            uint64_t key = m_Waiting.front();
+            m_Waiting.pop_front();
+
+            auto it = m_Requests.find(key);
+            if (it == m_Requests.end() || it->second.Searching) {
+                continue;
+            }
+
+            Request& request = it->second;
+            if (request.StartCell < 0 || request.GoalCell < 0) {
+                Complete(key, nullptr, completed);
+                continue;
+            }
+            request.Searching = true;
+            slot.Key = key;
+            slot.StartCell = request.StartCell;
+            slot.GoalCell = request.GoalCell;
+            slot.GridVersion = gridVersion;
+            slot.Active = true;
+            slot.Started = false;
+        }
+    }
+
+    // Advance running searches; the node budget is split evenly between them
+    size_t running = 0;
+    for (const std::unique_ptr<SearchSlot>& slot : m_Slots) {
+        running += slot->Active ? 1 : 0;
+    }
+    if (running > 0) {
+        size_t share = std::max<size_t>(m_NodeBudget / running, 1);
+        auto deadline = std::chrono::steady_clock::time_point::max();
+        if (m_TimeBudgetMs > 0.0f) {
+            deadline = std::chrono::steady_clock::now() +
+                       std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                           std::chrono::duration<float, std::milli>(m_TimeBudgetMs));
+        }
+
+        for (const std::unique_ptr<SearchSlot>& slotPtr : m_Slots) {
+            if (!slotPtr->Active) {
+                continue;
+            }
+            SearchSlot* slot = slotPtr.get();
+            const NavGrid* grid = &m_Grid;
+            JobSystem::Get().Execute([slot, grid, share, deadline] {
+                RunSlice(*slot, *grid, share, deadline);
+            }, &m_Jobs);
+        }
+    }
+
+    // Dispatch last: subscribers may submit or cancel requests
+    for (const Completed& result : completed) {
+        for (PathTicket ticket : result.Tickets) {
+            EventManager::Get().Dispatch(PathResultEvent(ticket, result.Found, result.Path));
+        }
+    }
+}
+
+void PathRequestQueue::Flush() {
+    JobSystem::Get().Wait(m_Jobs);
+}
+
+void PathRequestQueue::Clear() {
+    Flush();
+    m_Requests.clear();
+    m_Tickets.clear();
+    m_Waiting.clear();
+    for (const std::unique_ptr<SearchSlot>& slot : m_Slots) {
+        slot->Active = false;
+    }
+}
+
+void PathRequestQueue::SetNodeBudget(size_t expansions) {
+    m_NodeBudget = std::max<size_t>(expansions, 1);
+}
+
+void PathRequestQueue::SetMaxConcurrentSearches(size_t count) {
+    count = std::max<size_t>(count, 1);
+    Flush();
+
+    // Searches in removed slots start over once a slot frees up
+    for (size_t i = count; i < m_Slots.size(); ++i) {
+        if (!m_Slots[i]->Active) {
+            continue;
+        }
+        auto it = m_Requests.find(m_Slots[i]->Key);
+        if (it != m_Requests.end() && it->second.Searching) {
+            it->second.Searching = false;
+            m_Waiting.push_front(m_Slots[i]->Key);
+        }
+    }
+    if (m_Slots.size() > count) {
+        m_Slots.resize(count);
+    }
+    m_MaxSearches = count;
+}
+
+void PathRequestQueue::Complete(uint64_t key, const PathSearch* search, ArenaVector<Completed>& completed) {
+    auto it = m_Requests.find(key);
+    Completed result;
+    result.Tickets = std::move(it->second.Tickets);
+    result.Found = search && search->GetStatus() == PathSearch::Status::Found;
+    if (result.Found) {
+        search->GetPath(m_Cells);
+        result.Path.reserve(m_Cells.size());
+        for (int cell : m_Cells) {
+            result.Path.push_back(m_Grid.GridToWorld(m_Grid.GetX(cell), m_Grid.GetZ(cell)));
+        }
+    }
+
+    for (PathTicket ticket : result.Tickets) {
+        m_Tickets.erase(ticket);
+    }
+    m_Requests.erase(it);
+    completed.push_back(std::move(result));
+}
+
+void PathRequestQueue::RunSlice(SearchSlot& slot, const NavGrid& grid, size_t expansions,
+                                std::chrono::steady_clock::time_point deadline) {
+    if (!slot.Started) {
+        slot.Started = true;
+        if (!slot.Search.Begin(grid, slot.StartCell, slot.GoalCell)) {
+            return;
+        }
+    }
+    while (expansions > 0) {
+        size_t chunk = std::min(expansions, STEP_CHUNK);
+        if (slot.Search.Step(chunk) != PathSearch::Status::InProgress) {
+            return;
+        }
+        expansions -= chunk;
+        if (std::chrono::steady_clock::now() >= deadline) {
+            return;
+        }
+    }
+}
+
+} // namespace Nilos
@@ -0,0 +1,180 @@
+#pragma once
+
+#include "Pathfinding.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Memory.h"
+
+#include <glm/glm.hpp>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Handle of a submitted path request (0 is never a valid ticket)
+ */
+using PathTicket = uint32_t;
+constexpr PathTicket INVALID_PATH_TICKET = 0;
+
+/**
+ * @brief Asynchronous path requests searched on the job system under a per-frame budget
+ *
+ * Agents submit start/goal pairs and get a ticket back; the path arrives
+ * later as a PathResultEvent carrying that ticket. Requests between the
+ * same start and goal cells share one search while it is pending, however
+ * many agents asked.
+ *
+ * Each Update (main thread, once per frame) delivers the searches that
+ * finished, fills free search slots from the waiting requests in
+ * submission order, then launches one job per running search. The jobs
+ * stop once they have used the frame's node budget (expansions, split
+ * between the running searches) or time budget and resume next frame, so
+ * a long search spreads over several frames instead of causing a hitch.
+ * Update never waits for the jobs: if last frame's are still running (a
+ * busy pool), it returns and tries again next frame.
+ *
+ * The grid is read by the jobs without locking. Call Flush() before
+ * changing it; searches still in progress afterwards are restarted on the
+ * new grid.
+ *
+ * Usage:
+ *   PathRequestQueue paths(grid);
+ *   EventManager::Get().Subscribe<PathResultEvent>([](const PathResultEvent& e) {
+ *       if (e.Found) FollowPath(e.Ticket, e.Path);
+ *   });
+ *   PathTicket ticket = paths.Submit(npcPosition, targetPosition);
+ *   ...
+ *   paths.Update();  // Every frame
+ */
+class PathRequestQueue {
+public:
+    static constexpr size_t DEFAULT_NODE_BUDGET = 20000;
+    static constexpr float DEFAULT_TIME_BUDGET_MS = 1.0f;
+    static constexpr size_t DEFAULT_MAX_CONCURRENT_SEARCHES = 4;
+
+    explicit PathRequestQueue(const NavGrid& grid);
+    ~PathRequestQueue();
+
+    PathRequestQueue(const PathRequestQueue&) = delete;
+    PathRequestQueue& operator=(const PathRequestQueue&) = delete;
+
+    /**
+     * @brief Request a path between two world positions
+     *
+     * Always returns a valid ticket; a request with an end outside the
+     * grid is answered (not found) on the next Update.
+     */
+    PathTicket Submit(const glm::vec3& start, const glm::vec3& goal);
+
+    /**
+     * @brief Drop a request; no event is sent for it
+     * @return False if the ticket is unknown or already answered
+     */
+    bool Cancel(PathTicket ticket);
+
+    /**
+     * @brief True until the ticket's result has been dispatched (or it was cancelled)
+     */
+    bool IsPending(PathTicket ticket) const { return m_Tickets.count(ticket) != 0; }
+
+    /**
+     * @brief Deliver finished paths, start waiting requests and advance searches (main thread)
+     */
+    void Update();
+
+    /**
+     * @brief Wait for the search jobs in flight (call before editing the grid)
+     */
+    void Flush();
+
+    /**
+     * @brief Drop every request without sending events
+     */
+    void Clear();
+
+    /**
+     * @brief Cell expansions per Update, shared by all running searches
+     */
+    void SetNodeBudget(size_t expansions);
+    size_t GetNodeBudget() const { return m_NodeBudget; }
+
+    /**
+     * @brief Wall-clock limit for each Update's search jobs (0 = node budget only)
+     */
+    void SetTimeBudget(float milliseconds) { m_TimeBudgetMs = milliseconds; }
+    float GetTimeBudget() const { return m_TimeBudgetMs; }
+
+    /**
+     * @brief Searches run in parallel; each keeps state sized to the grid
+     */
+    void SetMaxConcurrentSearches(size_t count);
+    size_t GetMaxConcurrentSearches() const { return m_MaxSearches; }
+
+    /**
+     * @brief Requests not answered yet (shared searches count once)
+     */
+    size_t GetRequestCount() const { return m_Requests.size(); }
+
+private:
+    struct Request {
+        int StartCell = -1;
+        int GoalCell = -1;
+        bool Searching = false;  // Assigned to a slot
+        std::vector<PathTicket> Tickets;
+    };
+
+    struct SearchSlot {
+        PathSearch Search;
+        uint64_t Key = 0;
+        int StartCell = -1;
+        int GoalCell = -1;
+        uint32_t GridVersion = 0;
+        bool Active = false;
+        bool Started = false;  // Begin ran (in the job, which also sizes the search state)
+    };
+
+    struct Completed {
+        std::vector<PathTicket> Tickets;
+        bool Found;
+        std::vector<glm::vec3> Path;
+    };
+
+    static uint64_t MakeKey(int startCell, int goalCell) {
+        return (static_cast<uint64_t>(static_cast<uint32_t>(startCell)) << 32) |
+               static_cast<uint32_t>(goalCell);
+    }
+
+    /**
+     * @brief Move a request's tickets into completed and forget it
+     */
+    void Complete(uint64_t key, const PathSearch* search, ArenaVector<Completed>& completed);
+
+    /**
+     * @brief Run one search until it finishes or a budget is used up (worker thread)
+     */
+    static void RunSlice(SearchSlot& slot, const NavGrid& grid, size_t expansions,
+                         std::chrono::steady_clock::time_point deadline);
+
+    const NavGrid& m_Grid;
+    PathTicket m_NextTicket = 1;
+
+    std::unordered_map<uint64_t, Request> m_Requests;
+    std::unordered_map<PathTicket, uint64_t> m_Tickets;
+    std::deque<uint64_t> m_Waiting;  // Keys in submission order, may hold stale entries
+
+    // Slots are heap-allocated so jobs keep valid references if the vector grows
+    std::vector<std::unique_ptr<SearchSlot>> m_Slots;
+    size_t m_MaxSearches = DEFAULT_MAX_CONCURRENT_SEARCHES;
+    JobCounter m_Jobs;
+
+    size_t m_NodeBudget = DEFAULT_NODE_BUDGET;
+    float m_TimeBudgetMs = DEFAULT_TIME_BUDGET_MS;
+
+    std::vector<int> m_Cells;  // Path buffer for delivery
+};
+
+} // namespace Nilos
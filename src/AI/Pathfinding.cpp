@@ -2,144 +2,262 @@
 #include "../Core/Logger.h"
 #include <algorithm>
 #include <cmath>
+#include <cstdint>
+#include <cstdlib>
 
 namespace Nilos {
 
+namespace {
+
+constexpr float SQRT2 = 1.41421356f;
+
+// Cells of margin around the obstacle-list search area, so paths can go
+// around obstacles at its edge
+constexpr int LEGACY_GRID_MARGIN = 16;
+
+// Per-thread search and path buffer used by the static FindPath overloads
+thread_local PathSearch t_Search;
+thread_local std::vector<int> t_Cells;
+
+struct Direction {
+    int DX, DZ;
+    float Cost;
+};
+
+constexpr Direction DIRECTIONS[8] = {
+    {  1,  0, 1.0f }, { -1,  0, 1.0f }, {  0,  1, 1.0f }, {  0, -1, 1.0f },
+    {  1,  1, SQRT2 }, {  1, -1, SQRT2 }, { -1,  1, SQRT2 }, { -1, -1, SQRT2 }
+};
+
+} // namespace
+
 std::vector<glm::vec3> Pathfinding::FindPath(const glm::vec3& start, const glm::vec3& goal,
                                                const std::vector<glm::vec3>& obstacles) {
-    // Convert world positions to grid
+    // Grid covering everything involved, in cells of m_CellSize
+    auto toCell = [this](float value) { return static_cast<int>(std::floor(value / m_CellSize)); };
+    int minX = std::min(toCell(start.x), toCell(goal.x));
+    int maxX = std::max(toCell(start.x), toCell(goal.x));
+    int minZ = std::min(toCell(start.z), toCell(goal.z));
+    int maxZ = std::max(toCell(start.z), toCell(goal.z));
+    for (const glm::vec3& obstacle : obstacles) {
+        minX = std::min(minX, toCell(obstacle.x));
+        maxX = std::max(maxX, toCell(obstacle.x));
+        minZ = std::min(minZ, toCell(obstacle.z));
+        maxZ = std::max(maxZ, toCell(obstacle.z));
+    }
+    minX -= LEGACY_GRID_MARGIN;
+    minZ -= LEGACY_GRID_MARGIN;
+    maxX += LEGACY_GRID_MARGIN;
+    maxZ += LEGACY_GRID_MARGIN;
+
+    m_Grid.Resize(maxX - minX + 1, maxZ - minZ + 1, m_CellSize,
+                  glm::vec3(minX * m_CellSize, 0.0f, minZ * m_CellSize));
+    m_Grid.Build(obstacles);
+
+    std::vector<glm::vec3> path;
+    FindPath(m_Grid, start, goal, path);
+    return path;
+}
+
+bool Pathfinding::FindPath(const NavGrid& grid, const glm::vec3& start, const glm::vec3& goal,
+                           std::vector<glm::vec3>& path) {
+    path.clear();
+
     int startX, startZ, goalX, goalZ;
-    WorldToGrid(start, startX, startZ);
-    WorldToGrid(goal, goalX, goalZ);
+    if (!grid.WorldToGrid(start, startX, startZ) || !grid.WorldToGrid(goal, goalX, goalZ)) {
+        return false;
+    }
+
+    std::vector<int>& cells = t_Cells;
+    if (!FindPath(grid, grid.GetIndex(startX, startZ), grid.GetIndex(goalX, goalZ), cells)) {
+        return false;
+    }
 
-    Node startNode(startX, startZ);
-    Node goalNode(goalX, goalZ);
+    path.reserve(cells.size());
+    for (int cell : cells) {
+        path.push_back(grid.GridToWorld(grid.GetX(cell), grid.GetZ(cell)));
+    }
+    return true;
+}
 
-    // Priority queue for open list (min-heap by F score)
-    auto compare = [](const Node* a, const Node* b) { return a->F > b->F; };
-    std::priority_queue<Node*, std::vector<Node*>, decltype(compare)> openList(compare);
+bool Pathfinding::FindPath(const NavGrid& grid, int startCell, int goalCell, std::vector<int>& cells) {
+    return FindPath(grid, startCell, goalCell, cells, grid.GetBounds());
+}
 
-    // Closed list (visited nodes)
-    std::unordered_map<Node, bool, NodeHash> closedList;
+bool Pathfinding::FindPath(const NavGrid& grid, int startCell, int goalCell, std::vector<int>& cells,
+                           const GridRect& bounds) {
+    cells.clear();
+    if (!t_Search.Begin(grid, startCell, goalCell, bounds) ||
+        t_Search.Step() != PathSearch::Status::Found) {
+        return false;
+    }
+    t_Search.GetPath(cells);
+    return true;
+}
 
-    // All nodes (for memory management)
-    std::vector<Node*> allNodes;
+float Pathfinding::OctileDistance(int dx, int dz) {
+    int ax = std::abs(dx);
+    int az = std::abs(dz);
+    int diagonal = std::min(ax, az);
+    return static_cast<float>(std::max(ax, az) - diagonal) + SQRT2 * static_cast<float>(diagonal);
+}
 
-    Node* start_ptr = new Node(startNode);
-    allNodes.push_back(start_ptr);
-    openList.push(start_ptr);
+bool PathSearch::Begin(const NavGrid& grid, int startCell, int goalCell) {
+    return Begin(grid, startCell, goalCell, grid.GetBounds());
+}
 
-    Node* goalFound = nullptr;
+bool PathSearch::Begin(const NavGrid& grid, int startCell, int goalCell, const GridRect& bounds) {
+    m_Grid = &grid;
+    m_Bounds = bounds;
+    m_StartCell = startCell;
+    m_GoalCell = goalCell;
+    m_Expanded = 0;
+    m_Heap.clear();
 
-    // A* main loop
-    while (!openList.empty()) {
-        Node* current = openList.top();
-        openList.pop();
+    int cellCount = grid.GetCellCount();
+    if (startCell < 0 || startCell >= cellCount || goalCell < 0 || goalCell >= cellCount ||
+        grid.IsBlocked(goalCell) ||
+        !bounds.Contains(grid.GetX(startCell), grid.GetZ(startCell)) ||
+        !bounds.Contains(grid.GetX(goalCell), grid.GetZ(goalCell))) {
+        m_Status = Status::Failed;
+        return false;
+    }
 
-        // Check if we reached the goal
-        if (current->X == goalNode.X && current->Z == goalNode.Z) {
-            goalFound = current;
-            break;
+    if (m_State.size() < static_cast<size_t>(cellCount)) {
+        m_State.resize(static_cast<size_t>(cellCount), CellState{ 0.0f, 0.0f, -1, CLOSED, 0 });
+        m_Heap.reserve(static_cast<size_t>(cellCount));
+    }
+    if (++m_Generation == 0) {
+        // Wrapped around: old stamps could match again
+        for (CellState& state : m_State) {
+            state.Stamp = 0;
         }
+        m_Generation = 1;
+    }
 
-        closedList[*current] = true;
+    m_State[startCell] = { 0.0f,
+                           Pathfinding::OctileDistance(grid.GetX(startCell) - grid.GetX(goalCell),
+                                                       grid.GetZ(startCell) - grid.GetZ(goalCell)),
+                           -1, CLOSED, m_Generation };
+    Push(startCell);
+    m_Status = Status::InProgress;
+    return true;
+}
 
-        // Check neighbors
-        std::vector<Node> neighbors = GetNeighbors(*current);
-        for (const Node& neighbor : neighbors) {
-            // Skip if blocked or already visited
-            if (IsBlocked(neighbor.X, neighbor.Z, obstacles) || closedList[neighbor]) {
-                continue;
-            }
+PathSearch::Status PathSearch::Step(size_t maxExpansions) {
+    if (m_Status != Status::InProgress) {
+        return m_Status;
+    }
 
-            float tentativeG = current->G + 1.0f; // Cost to move to neighbor
+    const NavGrid& grid = *m_Grid;
+    int goalX = grid.GetX(m_GoalCell);
+    int goalZ = grid.GetZ(m_GoalCell);
 
-            // Create new node or find existing
-            Node* neighborNode = nullptr;
-            for (Node* node : allNodes) {
-                if (node->X == neighbor.X && node->Z == neighbor.Z) {
-                    neighborNode = node;
-                    break;
-                }
-            }
+    for (size_t expansion = 0; expansion < maxExpansions; ++expansion) {
+        if (m_Heap.empty()) {
+            m_Status = Status::Failed;
+            return m_Status;
+        }
 
-            if (!neighborNode) {
-                neighborNode = new Node(neighbor.X, neighbor.Z);
-                allNodes.push_back(neighborNode);
-            }
+        int32_t current = Pop();
+        ++m_Expanded;
+        if (current == m_GoalCell) {
+            m_Status = Status::Found;
+            return m_Status;
+        }
 
-            // Update if this path is better
-            if (neighborNode->G == 0 || tentativeG < neighborNode->G) {
-                neighborNode->G = tentativeG;
-                neighborNode->H = Heuristic(*neighborNode, goalNode);
-                neighborNode->F = neighborNode->G + neighborNode->H;
-                neighborNode->Parent = current;
-                openList.push(neighborNode);
+        int x = grid.GetX(current);
+        int z = grid.GetZ(current);
+        float currentG = m_State[current].G;
+
+        for (const Direction& direction : DIRECTIONS) {
+            int nx = x + direction.DX;
+            int nz = z + direction.DZ;
+            if (!m_Bounds.Contains(nx, nz) || grid.IsBlocked(nx, nz)) {
+                continue;
+            }
+            // No squeezing diagonally between two blocked cells or around a corner
+            if (direction.DX != 0 && direction.DZ != 0 &&
+                (grid.IsBlocked(nx, z) || grid.IsBlocked(x, nz))) {
+                continue;
             }
-        }
-    }
 
-    // Reconstruct path
-    std::vector<glm::vec3> path;
-    if (goalFound) {
-        Node* current = goalFound;
-        while (current) {
-            path.push_back(GridToWorld(current->X, current->Z));
-            current = current->Parent;
-        }
-        std::reverse(path.begin(), path.end());
-    }
+            int32_t neighbor = grid.GetIndex(nx, nz);
+            float tentativeG = currentG + direction.Cost;
 
-    // Cleanup
-    for (Node* node : allNodes) {
-        delete node;
+            CellState& state = m_State[neighbor];
+            if (state.Stamp != m_Generation) {
+                state = { tentativeG, tentativeG + Pathfinding::OctileDistance(nx - goalX, nz - goalZ),
+                          current, CLOSED, m_Generation };
+                Push(neighbor);
+            } else if (state.HeapIndex != CLOSED && tentativeG < state.G) {
+                // Octile distance is consistent, so closed cells never improve
+                state.F -= state.G - tentativeG;
+                state.G = tentativeG;
+                state.Parent = current;
+                SiftUp(static_cast<size_t>(state.HeapIndex));
+            }
+        }
     }
 
-    return path;
-}
-
-void Pathfinding::WorldToGrid(const glm::vec3& world, int& gridX, int& gridZ) const {
-    gridX = static_cast<int>(std::floor(world.x / m_CellSize));
-    gridZ = static_cast<int>(std::floor(world.z / m_CellSize));
+    return m_Status;
 }
 
-glm::vec3 Pathfinding::GridToWorld(int gridX, int gridZ) const {
-    return glm::vec3(gridX * m_CellSize + m_CellSize * 0.5f,
-                     0.0f,
-                     gridZ * m_CellSize + m_CellSize * 0.5f);
+void PathSearch::GetPath(std::vector<int>& cells) const {
+    cells.clear();
+    if (m_Status != Status::Found) {
+        return;
+    }
+    for (int32_t cell = m_GoalCell; cell != -1; cell = m_State[cell].Parent) {
+        cells.push_back(cell);
+    }
+    std::reverse(cells.begin(), cells.end());
 }
 
-float Pathfinding::Heuristic(const Node& a, const Node& b) const {
-    // Manhattan distance
-    return static_cast<float>(std::abs(a.X - b.X) + std::abs(a.Z - b.Z));
+void PathSearch::SiftUp(size_t position) {
+    int32_t cell = m_Heap[position];
+    while (position > 0) {
+        size_t parent = (position - 1) / 2;
+        if (!Less(cell, m_Heap[parent])) {
+            break;
+        }
+        Place(position, m_Heap[parent]);
+        position = parent;
+    }
+    Place(position, cell);
 }
 
-std::vector<Pathfinding::Node> Pathfinding::GetNeighbors(const Node& node) const {
-    std::vector<Node> neighbors;
-    
-    // 4-directional (up, down, left, right)
-    neighbors.emplace_back(node.X + 1, node.Z);
-    neighbors.emplace_back(node.X - 1, node.Z);
-    neighbors.emplace_back(node.X, node.Z + 1);
-    neighbors.emplace_back(node.X, node.Z - 1);
-
-    return neighbors;
+void PathSearch::Push(int32_t cell) {
+    m_Heap.push_back(cell);
+    SiftUp(m_Heap.size() - 1);
 }
 
-bool Pathfinding::IsBlocked(int gridX, int gridZ, const std::vector<glm::vec3>& obstacles) const {
-    glm::vec3 worldPos = GridToWorld(gridX, gridZ);
-    
-    // Check if this grid cell overlaps with any obstacle
-    for (const glm::vec3& obstacle : obstacles) {
-        int obsX, obsZ;
-        WorldToGrid(obstacle, obsX, obsZ);
-        if (obsX == gridX && obsZ == gridZ) {
-            return true;
+int32_t PathSearch::Pop() {
+    int32_t top = m_Heap.front();
+    int32_t last = m_Heap.back();
+    m_Heap.pop_back();
+    if (!m_Heap.empty()) {
+        // Sift the last cell down from the root
+        size_t position = 0;
+        size_t count = m_Heap.size();
+        while (true) {
+            size_t child = position * 2 + 1;
+            if (child >= count) {
+                break;
+            }
+            if (child + 1 < count && Less(m_Heap[child + 1], m_Heap[child])) {
+                ++child;
+            }
+            if (!Less(m_Heap[child], last)) {
+                break;
+            }
+            Place(position, m_Heap[child]);
+            position = child;
         }
+        Place(position, last);
     }
-    
-    return false;
+    m_State[top].HeapIndex = CLOSED;
+    return top;
 }
 
 } // namespace Nilos
-
@@ -1,85 +1,178 @@
 #pragma once
 
+#include "NavGrid.h"
+
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
-#include <queue>
-#include <unordered_map>
-#include <functional>
 
 namespace Nilos {
 
 /**
- * @brief Simple grid-based A* pathfinding
- * 
- * Lightweight pathfinding for NPCs.
- * Uses a 2D grid projected on XZ plane (Y is ignored).
+ * @brief Resumable A* search on a NavGrid
+ *
+ * Holds the open/closed state of one search, so it can be advanced a
+ * bounded number of expansions at a time and resumed later (from any
+ * thread, one at a time). The per-cell state is sized to the grid and
+ * reused by the next Begin: entries are stamped with a search generation
+ * instead of being cleared, so a warm PathSearch does not allocate.
+ *
+ * The grid must not change while a search is in progress.
+ *
+ * Usage:
+ *   PathSearch search;
+ *   search.Begin(grid, startCell, goalCell);
+ *   while (search.Step(1000) == PathSearch::Status::InProgress) {
+ *       // yield, resume next frame
+ *   }
+ *   if (search.GetStatus() == PathSearch::Status::Found) search.GetPath(cells);
  */
-class Pathfinding {
+class PathSearch {
 public:
-    struct Node {
-        int X, Z;
-        float G, H, F; // G = cost from start, H = heuristic, F = G + H
-        Node* Parent;
+    enum class Status {
+        Idle,        // No search started
+        InProgress,
+        Found,
+        Failed       // Unreachable, or invalid start/goal
+    };
 
-        Node(int x, int z) : X(x), Z(z), G(0), H(0), F(0), Parent(nullptr) {}
+    /**
+     * @brief Start a search (the previous one is discarded)
+     *
+     * The start cell may be blocked (an agent brushing an obstacle): it is
+     * only left, never entered. The goal must be walkable.
+     * @return False (status Failed) if a cell is outside the grid or bounds, or the goal is blocked
+     */
+    bool Begin(const NavGrid& grid, int startCell, int goalCell);
+    bool Begin(const NavGrid& grid, int startCell, int goalCell, const GridRect& bounds);
 
-        bool operator==(const Node& other) const {
-            return X == other.X && Z == other.Z;
-        }
-    };
+    /**
+     * @brief Expand up to maxExpansions cells
+     */
+    Status Step(size_t maxExpansions = SIZE_MAX);
 
-    struct NodeHash {
-        size_t operator()(const Node& node) const {
-            return std::hash<int>()(node.X) ^ (std::hash<int>()(node.Z) << 1);
-        }
+    /**
+     * @brief Cells from start to goal once Found (cleared first)
+     */
+    void GetPath(std::vector<int>& cells) const;
+
+    Status GetStatus() const { return m_Status; }
+    int GetStartCell() const { return m_StartCell; }
+    int GetGoalCell() const { return m_GoalCell; }
+
+    /**
+     * @brief Cells expanded since Begin
+     */
+    size_t GetExpandedCount() const { return m_Expanded; }
+
+private:
+    static constexpr int32_t CLOSED = -1;
+
+    // Everything a search touches per cell, kept together for locality
+    struct CellState {
+        float G;
+        float F;
+        int32_t Parent;
+        int32_t HeapIndex;  // Position in m_Heap, CLOSED once expanded
+        uint32_t Stamp;     // Cell belongs to this search only if == m_Generation
     };
 
+    // Lower F first; on ties prefer the cell further along (higher G)
+    bool Less(int32_t a, int32_t b) const {
+        const CellState& sa = m_State[a];
+        const CellState& sb = m_State[b];
+        return sa.F < sb.F || (sa.F == sb.F && sa.G > sb.G);
+    }
+
+    void Place(size_t position, int32_t cell) {
+        m_Heap[position] = cell;
+        m_State[cell].HeapIndex = static_cast<int32_t>(position);
+    }
+
+    void SiftUp(size_t position);
+    void Push(int32_t cell);
+    int32_t Pop();
+
+    const NavGrid* m_Grid = nullptr;
+    GridRect m_Bounds;
+    int m_StartCell = -1;
+    int m_GoalCell = -1;
+    Status m_Status = Status::Idle;
+    size_t m_Expanded = 0;
+
+    std::vector<CellState> m_State;
+    std::vector<int32_t> m_Heap;  // Binary min-heap of open cells by F
+    uint32_t m_Generation = 0;
+};
+
+/**
+ * @brief Grid-based A* pathfinding
+ *
+ * Lightweight pathfinding for NPCs on a NavGrid (XZ plane, Y is ignored).
+ * Moves in 8 directions (diagonals cost sqrt(2) and may not cut blocked
+ * corners) guided by the octile distance, so paths are optimal.
+ *
+ * The static searches run a per-thread PathSearch to completion, so
+ * after the first search on a grid of a given size FindPath does not
+ * allocate, and different threads can search the same grid at once.
+ */
+class Pathfinding {
+public:
     Pathfinding(float cellSize = 1.0f) : m_CellSize(cellSize) {}
 
     /**
-     * @brief Find path from start to goal
+     * @brief Find path from start to goal around a list of obstacles
+     *
+     * Convenience path: builds a grid spanning start, goal and obstacles
+     * (plus a margin) on every call. Keep a NavGrid and use the overloads
+     * below when the obstacles do not change every search.
      * @param start Starting world position
      * @param goal Goal world position
      * @param obstacles List of obstacle positions (world space)
-     * @return List of waypoints (world space)
+     * @return List of waypoints (world space), empty if unreachable
      */
     std::vector<glm::vec3> FindPath(const glm::vec3& start, const glm::vec3& goal,
                                      const std::vector<glm::vec3>& obstacles = {});
 
     /**
-     * @brief Set grid cell size
+     * @brief Find path between two world positions on a grid
+     * @param path Receives cell centers from start to goal (cleared first)
+     * @return False if either end is outside the grid, the goal is blocked or unreachable
      */
-    void SetCellSize(float size) { m_CellSize = size; }
-    float GetCellSize() const { return m_CellSize; }
-
-private:
-    float m_CellSize;
+    static bool FindPath(const NavGrid& grid, const glm::vec3& start, const glm::vec3& goal,
+                         std::vector<glm::vec3>& path);
 
     /**
-     * @brief Convert world position to grid coordinates
+     * @brief Find path between two cells (NavGrid indices)
+     * @param cells Receives cell indices from start to goal (cleared first)
      */
-    void WorldToGrid(const glm::vec3& world, int& gridX, int& gridZ) const;
+    static bool FindPath(const NavGrid& grid, int startCell, int goalCell, std::vector<int>& cells);
 
     /**
-     * @brief Convert grid coordinates to world position
+     * @brief Find path between two cells without leaving bounds
+     *
+     * Used to refine hierarchical paths inside one cluster.
      */
-    glm::vec3 GridToWorld(int gridX, int gridZ) const;
+    static bool FindPath(const NavGrid& grid, int startCell, int goalCell, std::vector<int>& cells,
+                         const GridRect& bounds);
 
     /**
-     * @brief Heuristic function (Manhattan distance)
+     * @brief Octile distance in cells: exact cost of an unobstructed 8-way path
      */
-    float Heuristic(const Node& a, const Node& b) const;
+    static float OctileDistance(int dx, int dz);
 
     /**
-     * @brief Get neighboring grid cells
+     * @brief Set grid cell size
      */
-    std::vector<Node> GetNeighbors(const Node& node) const;
+    void SetCellSize(float size) { m_CellSize = size; }
+    float GetCellSize() const { return m_CellSize; }
 
-    /**
-     * @brief Check if a grid cell is blocked
-     */
-    bool IsBlocked(int gridX, int gridZ, const std::vector<glm::vec3>& obstacles) const;
+private:
+    float m_CellSize;
+
+    // Reused by the obstacle-list FindPath
+    NavGrid m_Grid;
 };
 
 } // namespace Nilos
-
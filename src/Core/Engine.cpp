@@ -1,10 +1,18 @@
 #include "Engine.h"
 #include "Logger.h"
 #include "Time.h"
+#include "JobSystem.h"
+#include "Profiler.h"
+#include "Memory.h"
 #include "../Window/Window.h"
 #include "../Rendering/Renderer.h"
 #include "../Rendering/Camera.h"
+#include "../Rendering/FrustumCuller.h"
+#include "../Rendering/Texture.h"
+#include "../Rendering/ShaderCache.h"
+#include "../Rendering/RenderThread.h"
 #include "../ECS/World.h"
+#include "../ECS/TransformHierarchy.h"
 #include "../ECS/Component.h"
 #include "../Input/Input.h"
 #include "../Events/EventManager.h"
@@ -12,7 +20,10 @@
 #include "../Physics/PhysicsWorld.h"
 
 #include <GLFW/glfw3.h>
+#include <chrono>
 #include <thread>
+#include <algorithm>
+#include <cmath>
 
 namespace Nilos {
 
@@ -42,6 +53,69 @@ bool Engine::Initialize() {
     EventManager::Get().Initialize();
     NILOS_INFO("Event system initialized");
 
+    // Start worker threads (main thread also participates while waiting)
+    uint32_t workerCount = 0;
+    if (m_Config.WorkerThreads >= 0) {
+        workerCount = static_cast<uint32_t>(m_Config.WorkerThreads);
+    } else {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+    JobSystem::Get().Initialize(workerCount);
+
+    FrameArena::Get().Initialize(static_cast<size_t>(m_Config.FrameArenaMB * 1024.0f * 1024.0f));
+
+    Profiler::Get().SetThreadName("Main");
+
+    if (m_Config.Headless) {
+        NILOS_INFO("Headless mode: no window, renderer or input");
+    } else if (!InitializePresentation()) {
+        return false;
+    }
+
+    m_TransformHierarchy = std::make_unique<TransformHierarchy>();
+
+    TextureManager::Get().SetUploadBudget(static_cast<size_t>(m_Config.TextureUploadBudgetMB * 1024.0f * 1024.0f));
+
+    // Create ECS world
+    m_World = std::make_unique<World>();
+    m_World->Initialize();
+    NILOS_INFO("ECS World initialized");
+
+    // Initialize Physics World (Phase 3)
+    m_PhysicsWorld = std::make_unique<PhysicsWorld>(m_World.get());
+    m_PhysicsWorld->SetGravity(glm::vec3(0.0f, -9.81f, 0.0f));
+    NILOS_INFO("Physics World initialized");
+
+    // Setup demo scene
+    SetupDemoScene();
+    NILOS_INFO("Demo scene created");
+
+    if (!m_Config.Headless) {
+        // Subscribe to window events
+        EventManager::Get().Subscribe<WindowCloseEvent>([this](const WindowCloseEvent&) {
+            RequestShutdown();
+        });
+        EventManager::Get().Subscribe<WindowResizeEvent>([this](const WindowResizeEvent& event) {
+            // Minimized windows report 0x0; keep the last size
+            if (event.Width > 0 && event.Height > 0) {
+                m_Config.WindowWidth = event.Width;
+                m_Config.WindowHeight = event.Height;
+                m_Renderer->SetViewport(event.Width, event.Height);
+            }
+        });
+
+        // From here on GL calls belong to the render thread (or Invoke)
+        RenderThread::Get().Initialize(m_Renderer.get(), m_Window.get(), m_Config.ThreadedRendering);
+    }
+
+    m_Initialized = true;
+    NILOS_INFO("=== Engine Initialization Complete ===");
+    
+    return true;
+}
+
+bool Engine::InitializePresentation() {
     // Create window
     WindowConfig windowConfig;
     windowConfig.Title = m_Config.WindowTitle;
@@ -61,36 +135,19 @@ bool Engine::Initialize() {
     Input::Get().Initialize(m_Window->GetNativeWindow());
     NILOS_INFO("Input system initialized");
 
-    // Create renderer
+    // Create renderer (loads its shaders through the cache)
+    ShaderCache::Get().SetDirectory(m_Config.ShaderCacheDirectory);
     m_Renderer = std::make_unique<Renderer>();
     if (!m_Renderer->Initialize()) {
         NILOS_CRITICAL("Failed to initialize renderer");
         return false;
     }
+    m_Renderer->SetViewport(m_Config.WindowWidth, m_Config.WindowHeight);
     NILOS_INFO("Renderer initialized");
 
-    // Create ECS world
-    m_World = std::make_unique<World>();
-    m_World->Initialize();
-    NILOS_INFO("ECS World initialized");
-
-    // Initialize Physics World (Phase 3)
-    m_PhysicsWorld = std::make_unique<PhysicsWorld>();
-    m_PhysicsWorld->SetGravity(glm::vec3(0.0f, -9.81f, 0.0f));
-    NILOS_INFO("Physics World initialized");
-
-    // Setup demo scene
-    SetupDemoScene();
-    NILOS_INFO("Demo scene created");
-
-    // Subscribe to window events
-    EventManager::Get().Subscribe<WindowCloseEvent>([this](const WindowCloseEvent&) {
-        RequestShutdown();
-    });
+    Profiler::Get().InitializeGpu();
 
-    m_Initialized = true;
-    NILOS_INFO("=== Engine Initialization Complete ===");
-    
+    m_FrustumCuller = std::make_unique<FrustumCuller>();
     return true;
 }
 
@@ -105,12 +162,32 @@ void Engine::Run() {
 
     float frameTimeAccumulator = 0.0f;
     uint32_t frameCountForFPS = 0;
-
-    while (m_Running && !m_Window->ShouldClose()) {
-        // Update time
-        Time::Get().Update();
+#if NILOS_TRACK_ALLOCATIONS
+    uint64_t heapAllocations = GetMemoryStats().HeapAllocations;
+#endif
+    uint64_t frameCount = 0;
+
+    // Headless frames are paced by the clock instead of vsync
+    const bool headless = m_Config.Headless;
+    const auto headlessStep = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<float>(m_Config.HeadlessTimeStep));
+    auto nextFrame = std::chrono::steady_clock::now();
+
+    while (m_Running && (headless || !m_Window->ShouldClose())) {
+        Profiler::Get().BeginFrame();
+        FrameArena::Get().BeginFrame();
+
+        // Update time (headless frames simulate a fixed step, however long they take)
+        if (headless) {
+            Time::Get().Advance(m_Config.HeadlessTimeStep);
+        } else {
+            Time::Get().Update();
+        }
         float deltaTime = Time::Get().GetDeltaTime();
 
+        // Deliver the events queued during the last frame
+        EventManager::Get().ProcessQueue();
+
         // Display FPS periodically
         if (m_Config.ShowFPS) {
             frameTimeAccumulator += deltaTime;
@@ -118,22 +195,60 @@ void Engine::Run() {
             if (frameTimeAccumulator >= 1.0f) {
                 float fps = Time::Get().GetFPS();
                 NILOS_DEBUG("FPS: ", static_cast<int>(fps), " | Frame time: ", 
-                           (deltaTime * 1000.0f), "ms");
+                           (deltaTime * 1000.0f), "ms | ", Profiler::Get().FormatOverlay());
                 frameTimeAccumulator = 0.0f;
             }
         }
 
         // Process input
-        ProcessInput();
+        if (!headless) {
+            NILOS_PROFILE_SCOPE("ProcessInput");
+            ProcessInput();
+        }
 
         // Update all systems
-        Update(deltaTime);
+        {
+            NILOS_PROFILE_SCOPE("Update");
+            Update(deltaTime);
+        }
 
-        // Render
-        Render();
+        if (!headless) {
+            // Render
+            {
+                NILOS_PROFILE_SCOPE("Render");
+                Render();
+            }
+
+            // Poll window events
+            m_Window->PollEvents();
+        }
 
-        // Poll window events
-        m_Window->PollEvents();
+        MemoryStats memory = GetMemoryStats();
+#if NILOS_TRACK_ALLOCATIONS
+        Profiler::Get().SetCounter("Heap allocs", static_cast<double>(memory.HeapAllocations - heapAllocations));
+        heapAllocations = memory.HeapAllocations;
+#endif
+        Profiler::Get().SetCounter("Frame arena KB", static_cast<double>(memory.FrameArenaUsed / 1024));
+        Profiler::Get().SetCounter("Transforms updated", static_cast<double>(m_TransformHierarchy->GetUpdatedCount()));
+
+        Profiler::Get().EndFrame();
+
+        if (m_Config.MaxFrames > 0 && ++frameCount >= m_Config.MaxFrames) {
+            NILOS_INFO("Reached ", m_Config.MaxFrames, " frames");
+            RequestShutdown();
+        }
+
+        if (headless && m_Config.HeadlessRealtime) {
+            // Sleep out the rest of the step; after a long stall resume
+            // from now rather than rushing through the missed frames
+            nextFrame += headlessStep;
+            auto now = std::chrono::steady_clock::now();
+            if (nextFrame > now) {
+                std::this_thread::sleep_until(nextFrame);
+            } else if (now - nextFrame > headlessStep * m_Config.MaxPhysicsSubsteps) {
+                nextFrame = now;
+            }
+        }
     }
 
     NILOS_INFO("Main loop ended");
@@ -142,11 +257,23 @@ void Engine::Run() {
 void Engine::Shutdown() {
     NILOS_INFO("=== Engine Shutdown ===");
 
+    // Finish the frame in flight and take the GL context back
+    RenderThread::Get().Shutdown();
+
+    m_FrustumCuller.reset();
+    m_TransformHierarchy.reset();
+
     if (m_World) {
         m_World->Shutdown();
         m_World.reset();
     }
 
+    // GL objects go before the context; waits for texture decodes in flight
+    TextureManager::Get().Clear();
+
+    Profiler::Get().EndCapture();
+    Profiler::Get().ShutdownGpu();
+
     if (m_Renderer) {
         m_Renderer->Shutdown();
         m_Renderer.reset();
@@ -157,6 +284,7 @@ void Engine::Shutdown() {
         m_Window.reset();
     }
 
+    JobSystem::Get().Shutdown();
     EventManager::Get().Shutdown();
 
     m_Initialized = false;
@@ -171,6 +299,16 @@ void Engine::ProcessInput() {
         RequestShutdown();
     }
 
+    // F9 to start/stop a profiler capture
+    if (Input::Get().IsKeyPressed(GLFW_KEY_F9)) {
+        Profiler& profiler = Profiler::Get();
+        if (profiler.IsCapturing()) {
+            profiler.EndCapture();
+        } else {
+            profiler.BeginCapture(m_Config.ProfileCapturePath, m_Config.ProfileCaptureFrames);
+        }
+    }
+
     // Camera controls
     auto* transform = m_World->GetComponent<TransformComponent>(m_CameraEntity);
     auto* camera = m_World->GetComponent<CameraComponent>(m_CameraEntity);
@@ -226,7 +364,10 @@ void Engine::Update(float deltaTime) {
     m_World->Update(deltaTime);
 
     // Update physics (Phase 3)
-    m_PhysicsWorld->Update(deltaTime);
+    {
+        NILOS_PROFILE_SCOPE("Physics");
+        UpdatePhysics(deltaTime);
+    }
 
     // Update camera
     auto* camera = m_World->GetComponent<CameraComponent>(m_CameraEntity);
@@ -234,10 +375,38 @@ void Engine::Update(float deltaTime) {
         camera->UpdateVectors();
     }
 
+    // World matrices of whatever moved this frame, physics poses included
+    m_TransformHierarchy->Update(*m_World);
+
     // No automatic rotation - objects only move with physics
     // Physical objects are controlled by RigidbodyComponent
 }
 
+void Engine::UpdatePhysics(float deltaTime) {
+    float step = m_Config.PhysicsTimeStep;
+    if (step <= 0.0f) {
+        m_PhysicsWorld->Update(deltaTime);
+        return;
+    }
+
+    m_PhysicsAccumulator += std::min(deltaTime, m_Config.MaxFrameTime);
+
+    uint32_t substeps = 0;
+    while (m_PhysicsAccumulator >= step && substeps < m_Config.MaxPhysicsSubsteps) {
+        m_PhysicsWorld->Update(step);
+        m_PhysicsAccumulator -= step;
+        ++substeps;
+    }
+
+    // Still behind after MaxPhysicsSubsteps: drop the backlog instead of
+    // simulating ever more steps per frame (spiral of death)
+    if (m_PhysicsAccumulator >= step) {
+        m_PhysicsAccumulator = std::fmod(m_PhysicsAccumulator, step);
+    }
+
+    m_PhysicsWorld->InterpolateTransforms(m_PhysicsAccumulator / step);
+}
+
 void Engine::Render() {
     // Get camera data
     auto* cameraTransform = m_World->GetComponent<TransformComponent>(m_CameraEntity);
@@ -249,42 +418,41 @@ void Engine::Render() {
                       static_cast<float>(m_Config.WindowHeight);
         camera->UpdateProjectionMatrix(aspect);
 
-        // Begin frame
-        m_Renderer->BeginFrame();
+        // Record the frame's command list (no GL calls on this thread)
+        m_Renderer->BeginFrame(*camera, *cameraTransform);
 
-        // Render all entities with MeshComponent
-        auto entities = m_World->GetEntitiesWithComponent<MeshComponent>();
-        for (uint32_t entity : entities) {
-            auto* mesh = m_World->GetComponent<MeshComponent>(entity);
-            auto* transform = m_World->GetComponent<TransformComponent>(entity);
-            
-            if (mesh && transform) {
-                m_Renderer->RenderMesh(*mesh, *transform, *camera, *cameraTransform);
-            }
+        // Queue the MeshComponent + TransformComponent entities inside the
+        // view frustum (sorted and batched when the frame executes)
+        glm::mat4 viewProjection = camera->ProjectionMatrix * camera->GetViewMatrix(cameraTransform->Position);
+        Frustum frustum = Frustum::FromMatrix(viewProjection);
+        for (const auto& visible : m_FrustumCuller->Cull(*m_World, frustum)) {
+            m_Renderer->RenderMesh(*visible.Mesh, *visible.Transform);
         }
 
-        // End frame
         m_Renderer->EndFrame();
     }
 
-    // Swap buffers
-    m_Window->SwapBuffers();
+    // Sync point: waits for the previous frame, then the render thread
+    // draws and swaps this one while the next frame simulates
+    RenderThread::Get().Submit();
 }
 
 void Engine::SetupDemoScene() {
     // Setup Phong lighting (Phase 2 feature)
-    DirectionalLight dirLight;
-    dirLight.Direction = glm::normalize(glm::vec3(-1.0f, -1.2f, -0.8f));
-    dirLight.Color = glm::vec3(1.0f, 0.95f, 0.85f); // Warm sunlight
-    dirLight.Intensity = 1.8f; // Stronger light to see effect
-    m_Renderer->SetDirectionalLight(dirLight);
-    
-    AmbientLight ambLight;
-    ambLight.Color = glm::vec3(0.15f, 0.18f, 0.25f); // Cool ambient
-    ambLight.Intensity = 0.2f; // Low ambient for dramatic lighting
-    m_Renderer->SetAmbientLight(ambLight);
-    
-    NILOS_INFO("Phong lighting configured: Directional + Ambient");
+    if (m_Renderer) {
+        DirectionalLight dirLight;
+        dirLight.Direction = glm::normalize(glm::vec3(-1.0f, -1.2f, -0.8f));
+        dirLight.Color = glm::vec3(1.0f, 0.95f, 0.85f); // Warm sunlight
+        dirLight.Intensity = 1.8f; // Stronger light to see effect
+        m_Renderer->SetDirectionalLight(dirLight);
+        
+        AmbientLight ambLight;
+        ambLight.Color = glm::vec3(0.15f, 0.18f, 0.25f); // Cool ambient
+        ambLight.Intensity = 0.2f; // Low ambient for dramatic lighting
+        m_Renderer->SetAmbientLight(ambLight);
+        
+        NILOS_INFO("Phong lighting configured: Directional + Ambient");
+    }
     
     // Create camera entity
     m_CameraEntity = m_World->CreateEntity("MainCamera");
@@ -302,9 +470,10 @@ void Engine::SetupDemoScene() {
     // ========================================
     Entity ground = m_World->CreateEntity("Ground");
     auto* groundTransform = m_World->AddComponent<TransformComponent>(ground);
-    // Make ground THIN (0.1m thick) with top surface exactly at Y=0
-    groundTransform->Position = glm::vec3(0.0f, -0.05f, 0.0f); // Center at -0.05m (top at Y=0)
-    groundTransform->Scale = glm::vec3(1000.0f, 0.1f, 1000.0f); // 1km x 0.1m x 1km
+    // Ground is a regular static box collider with its top surface exactly at Y=0.
+    // 1m thick so fast bodies cannot pass through it within a single step.
+    groundTransform->Position = glm::vec3(0.0f, -0.5f, 0.0f); // Center at -0.5m (top at Y=0)
+    groundTransform->Scale = glm::vec3(1000.0f, 1.0f, 1000.0f); // 1km x 1m x 1km
     
     auto* groundMesh = m_World->AddComponent<MeshComponent>(ground);
     groundMesh->CreateCube();
@@ -316,9 +485,9 @@ void Engine::SetupDemoScene() {
     groundCollider->Size = glm::vec3(1.0f); // Will be scaled by transform
     
     // Ground is static (never moves)
-    m_PhysicsWorld->RegisterStaticCollider(groundCollider, groundTransform);
+    m_PhysicsWorld->RegisterStaticCollider(ground);
     
-    NILOS_INFO("Ground platform: 1km² x 10cm thick, surface at Y=0");
+    NILOS_INFO("Ground platform: 1km² x 1m thick, surface at Y=0");
     
     // ========================================
     // BASKETBALL (Dynamic - Falls with realistic physics)
@@ -343,7 +512,7 @@ void Engine::SetupDemoScene() {
     ballCollider->Radius = 0.5f; // Sphere mesh is 0.5 radius, scaled by transform (0.24)
     // Note: Size is ignored for spheres, only Radius is used
     
-    m_PhysicsWorld->RegisterRigidbody(ballRB, ballCollider, ballTransform);
+    m_PhysicsWorld->RegisterRigidbody(basketball);
     
     // ========================================
     // LEFT CUBE (Dynamic - Falls from 3m)
@@ -365,7 +534,7 @@ void Engine::SetupDemoScene() {
     leftCollider->ColliderType = ColliderComponent::Type::Box;  // CRITICAL: Set collider type!
     leftCollider->Size = glm::vec3(1.0f);
     
-    m_PhysicsWorld->RegisterRigidbody(leftRB, leftCollider, leftTransform);
+    m_PhysicsWorld->RegisterRigidbody(leftCube);
     
     // ========================================
     // RIGHT CUBE (Dynamic - Falls from 4m)
@@ -387,13 +556,13 @@ void Engine::SetupDemoScene() {
     rightCollider->ColliderType = ColliderComponent::Type::Box;  // CRITICAL: Set collider type!
     rightCollider->Size = glm::vec3(1.0f);
     
-    m_PhysicsWorld->RegisterRigidbody(rightRB, rightCollider, rightTransform);
+    m_PhysicsWorld->RegisterRigidbody(rightCube);
     
     // Center cube is now the demo cube entity
     m_CubeEntity = leftCube;
     
     NILOS_INFO("Realistic physics scene created:");
-    NILOS_INFO("  - Ground: 1km² x 10cm platform at Y=0 (static)");
+    NILOS_INFO("  - Ground: 1km² x 1m platform at Y=0 (static)");
     NILOS_INFO("  - Basketball: 0.62kg at 5m (bounces 0.75)");
     NILOS_INFO("  - Cubes: 10kg at 3-4m (bounces 0.3)");
     NILOS_INFO("Tip: Fly below Y=0 to verify objects don't penetrate ground!");
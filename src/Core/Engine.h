@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <memory>
 #include <string>
 
@@ -10,6 +11,8 @@ class Window;
 class Renderer;
 class World;
 class PhysicsWorld;
+class FrustumCuller;
+class TransformHierarchy;
 
 /**
  * @brief Engine configuration structure
@@ -22,6 +25,26 @@ struct EngineConfig {
     bool Fullscreen = false;
     uint32_t TargetFPS = 60;
     bool ShowFPS = true;
+    int WorkerThreads = -1;  // JobSystem workers: -1 = hardware threads - 1, 0 = run jobs inline
+    bool ThreadedRendering = true;  // GL work on a RenderThread, overlapping the next frame's simulation
+    float TextureUploadBudgetMB = 8.0f;  // Streamed texture data uploaded per frame (TextureManager::LoadAsync)
+    float FrameArenaMB = 2.0f;           // Starting size of each FrameArena buffer (grows if a frame needs more)
+    std::string ShaderCacheDirectory = "cache/shaders";  // Linked program binaries (ShaderCache), empty = disabled
+
+    // Physics runs at a fixed rate, decoupled from the frame rate
+    float PhysicsTimeStep = 1.0f / 60.0f;  // Seconds per physics step
+    uint32_t MaxPhysicsSubsteps = 4;       // Steps per frame before the backlog is dropped
+    float MaxFrameTime = 0.25f;            // Frame deltas are clamped to this (hitches, debugger breaks)
+
+    // Headless: no window, GL or input, only the World and physics (dedicated servers, batch runs)
+    bool Headless = false;
+    float HeadlessTimeStep = 1.0f / 60.0f;  // Simulated seconds per headless frame
+    bool HeadlessRealtime = true;           // Pace headless frames to the wall clock; false = as fast as possible
+    uint64_t MaxFrames = 0;                 // Stop after this many frames, 0 = run until shutdown
+
+    // F9 writes a Chrome trace of the next frames (chrome://tracing, Perfetto, Tracy import-chrome)
+    std::string ProfileCapturePath = "nilos_profile.json";
+    uint32_t ProfileCaptureFrames = 300;   // 0 = until F9 is pressed again
 };
 
 /**
@@ -77,7 +100,12 @@ public:
      */
     bool IsRunning() const { return m_Running; }
 
-    // Subsystem accessors
+    /**
+     * @brief Running without window, renderer and input (EngineConfig::Headless)
+     */
+    bool IsHeadless() const { return m_Config.Headless; }
+
+    // Subsystem accessors (window and renderer are null when headless)
     Window* GetWindow() const { return m_Window.get(); }
     Renderer* GetRenderer() const { return m_Renderer.get(); }
     World* GetWorld() const { return m_World.get(); }
@@ -94,7 +122,20 @@ private:
     void Update(float deltaTime);
 
     /**
-     * @brief Render the current frame
+     * @brief Run as many fixed physics steps as the accumulated time allows
+     * 
+     * Leftover time (less than one step) is carried to the next frame and
+     * used to interpolate rendered transforms between the last two steps.
+     */
+    void UpdatePhysics(float deltaTime);
+
+    /**
+     * @brief Create the window, input and renderer (skipped when headless)
+     */
+    bool InitializePresentation();
+
+    /**
+     * @brief Record the current frame and hand it to the RenderThread
      */
     void Render();
 
@@ -112,6 +153,11 @@ private:
     std::unique_ptr<Renderer> m_Renderer;
     std::unique_ptr<World> m_World;
     std::unique_ptr<PhysicsWorld> m_PhysicsWorld;
+    std::unique_ptr<FrustumCuller> m_FrustumCuller;
+    std::unique_ptr<TransformHierarchy> m_TransformHierarchy;
+
+    // Unsimulated time carried between frames (seconds, < PhysicsTimeStep)
+    float m_PhysicsAccumulator = 0.0f;
 
     // Demo scene entities (Phase 1)
     uint32_t m_CameraEntity;
@@ -0,0 +1,231 @@
+#include "JobSystem.h"
+#include "Logger.h"
+#include "Profiler.h"
+#include <algorithm>
+
+namespace Nilos {
+
+// Worker index of the current thread (-1 = not a worker)
+static thread_local int t_WorkerIndex = -1;
+
+int JobSystem::GetCurrentWorkerIndex() {
+    return t_WorkerIndex;
+}
+
+void JobSystem::Initialize(uint32_t workerCount) {
+    if (IsRunning()) {
+        NILOS_WARNING("JobSystem already initialized");
+        return;
+    }
+
+    m_Queues.clear();
+    for (uint32_t i = 0; i < workerCount + 1; ++i) {
+        m_Queues.push_back(std::make_unique<WorkQueue>());
+    }
+
+    if (workerCount == 0) {
+        NILOS_INFO("JobSystem initialized (no workers, jobs run inline)");
+        return;
+    }
+
+    m_Running.store(true, std::memory_order_release);
+    m_Workers.reserve(workerCount);
+    for (uint32_t i = 0; i < workerCount; ++i) {
+        m_Workers.emplace_back(&JobSystem::WorkerLoop, this, i);
+    }
+
+    NILOS_INFO("JobSystem initialized with ", workerCount, " worker threads");
+}
+
+void JobSystem::Shutdown() {
+    if (!IsRunning()) return;
+
+    {
+        std::lock_guard<std::mutex> lock(m_WakeMutex);
+        m_Running.store(false, std::memory_order_release);
+    }
+    m_WakeCondition.notify_all();
+
+    for (auto& worker : m_Workers) {
+        worker.join();
+    }
+    m_Workers.clear();
+
+    // Workers drain the queues before exiting; run anything submitted late
+    while (TryRunJob(static_cast<uint32_t>(m_Queues.size() - 1))) {}
+
+    NILOS_INFO("JobSystem shutdown");
+}
+
+void JobSystem::Execute(Job job, JobCounter* counter) {
+    if (counter) {
+        counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+    }
+    Submit(std::move(job), counter);
+}
+
+void JobSystem::ExecuteAfter(JobCounter& dependency, Job job, JobCounter* counter) {
+    if (counter) {
+        counter->m_Count.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    {
+        // Release() decrements under the same lock, so the check cannot race it
+        std::lock_guard<std::mutex> lock(dependency.m_Mutex);
+        if (!dependency.IsDone()) {
+            dependency.m_Continuations.emplace_back(std::move(job), counter);
+            return;
+        }
+    }
+
+    Submit(std::move(job), counter);
+}
+
+void JobSystem::Wait(JobCounter& counter) {
+    uint32_t queueIndex = GetQueueIndexForThisThread();
+    while (!counter.IsDone()) {
+        if (!TryRunJob(queueIndex)) {
+            std::this_thread::yield();
+        }
+    }
+
+    // The last Release() may still hold the mutex; let it finish before the caller destroys the counter
+    std::lock_guard<std::mutex> lock(counter.m_Mutex);
+}
+
+void JobSystem::Submit(Job job, JobCounter* counter) {
+    if (!IsRunning()) {
+        job();
+        if (counter) {
+            Release(*counter);
+        }
+        return;
+    }
+
+    WorkQueue& queue = *m_Queues[GetQueueIndexForThisThread()];
+    {
+        std::lock_guard<std::mutex> lock(queue.Mutex);
+        queue.PushBack({std::move(job), counter});
+    }
+    m_PendingJobs.fetch_add(1, std::memory_order_release);
+
+    WakeWorker();
+}
+
+void JobSystem::Release(JobCounter& counter) {
+    std::vector<std::pair<Job, JobCounter*>> continuations;
+    {
+        std::lock_guard<std::mutex> lock(counter.m_Mutex);
+        if (counter.m_Count.fetch_sub(1, std::memory_order_acq_rel) != 1) {
+            return;
+        }
+        continuations.swap(counter.m_Continuations);
+    }
+
+    // The counter may be destroyed from here on; only touch the local copies
+    for (auto& continuation : continuations) {
+        Submit(std::move(continuation.first), continuation.second);
+    }
+}
+
+void JobSystem::WorkerLoop(uint32_t workerIndex) {
+    t_WorkerIndex = static_cast<int>(workerIndex);
+    Profiler::Get().SetThreadName(("Worker " + std::to_string(workerIndex)).c_str());
+
+    while (true) {
+        if (TryRunJob(workerIndex)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(m_WakeMutex);
+        m_WakeCondition.wait(lock, [this] {
+            return !m_Running.load(std::memory_order_acquire) ||
+                   m_PendingJobs.load(std::memory_order_acquire) > 0;
+        });
+
+        if (!m_Running.load(std::memory_order_acquire) &&
+            m_PendingJobs.load(std::memory_order_acquire) == 0) {
+            break;
+        }
+    }
+
+    t_WorkerIndex = -1;
+}
+
+bool JobSystem::TryRunJob(uint32_t queueIndex) {
+    if (m_Queues.empty()) return false;
+
+    QueuedJob job;
+    if (!PopLocal(queueIndex, job) && !Steal(queueIndex, job)) {
+        return false;
+    }
+
+    m_PendingJobs.fetch_sub(1, std::memory_order_acq_rel);
+    job.Work();
+    if (job.Counter) {
+        Release(*job.Counter);
+    }
+    return true;
+}
+
+bool JobSystem::PopLocal(uint32_t queueIndex, QueuedJob& job) {
+    WorkQueue& queue = *m_Queues[queueIndex];
+    std::lock_guard<std::mutex> lock(queue.Mutex);
+    return queue.PopBack(job);
+}
+
+bool JobSystem::Steal(uint32_t thiefIndex, QueuedJob& job) {
+    uint32_t queueCount = static_cast<uint32_t>(m_Queues.size());
+
+    // Start with the neighbour so thieves spread across victims
+    for (uint32_t offset = 1; offset < queueCount; ++offset) {
+        WorkQueue& victim = *m_Queues[(thiefIndex + offset) % queueCount];
+        std::unique_lock<std::mutex> lock(victim.Mutex, std::try_to_lock);
+        if (lock.owns_lock() && victim.PopFront(job)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+uint32_t JobSystem::GetQueueIndexForThisThread() const {
+    return (t_WorkerIndex >= 0) ? static_cast<uint32_t>(t_WorkerIndex)
+                                : static_cast<uint32_t>(m_Queues.size() - 1);
+}
+
+void JobSystem::WakeWorker() {
+    // Taking the lock orders this wake-up after a worker's predicate check
+    { std::lock_guard<std::mutex> lock(m_WakeMutex); }
+    m_WakeCondition.notify_one();
+}
+
+void JobSystem::WorkQueue::PushBack(QueuedJob job) {
+    if (Count == Ring.size()) {
+        // Unroll into a ring twice the size
+        std::vector<QueuedJob> grown(std::max<size_t>(Ring.size() * 2, 64));
+        for (size_t i = 0; i < Count; ++i) {
+            grown[i] = std::move(Ring[(Head + i) % Ring.size()]);
+        }
+        Ring.swap(grown);
+        Head = 0;
+    }
+    Ring[(Head + Count) % Ring.size()] = std::move(job);
+    ++Count;
+}
+
+bool JobSystem::WorkQueue::PopBack(QueuedJob& job) {
+    if (Count == 0) return false;
+    --Count;
+    job = std::move(Ring[(Head + Count) % Ring.size()]);
+    return true;
+}
+
+bool JobSystem::WorkQueue::PopFront(QueuedJob& job) {
+    if (Count == 0) return false;
+    job = std::move(Ring[Head]);
+    Head = (Head + 1) % Ring.size();
+    --Count;
+    return true;
+}
+
+} // namespace Nilos
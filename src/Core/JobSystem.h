@@ -0,0 +1,236 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Completion counter for a group of jobs
+ *
+ * Incremented when a job is submitted with this counter and decremented
+ * when the job finishes. Wait on it with JobSystem::Wait(), or chain work
+ * with JobSystem::ExecuteAfter().
+ *
+ * A counter must outlive its jobs: destroy it only after Wait() returned
+ * (polling IsDone() alone is not enough, the last job may still be
+ * releasing the counter).
+ */
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    /**
+     * @brief True when every job attached to this counter has finished
+     */
+    bool IsDone() const { return m_Count.load(std::memory_order_acquire) == 0; }
+
+private:
+    friend class JobSystem;
+
+    std::atomic<uint32_t> m_Count{0};
+
+    // Jobs released when the count drops to zero (see ExecuteAfter)
+    std::mutex m_Mutex;
+    std::vector<std::pair<std::function<void()>, JobCounter*>> m_Continuations;
+};
+
+/**
+ * @brief Work-stealing thread pool shared by all engine subsystems
+ *
+ * Each worker owns a deque: it pushes and pops jobs at the back (LIFO,
+ * cache friendly) while idle workers steal from the front of other deques
+ * (FIFO, takes the oldest and usually largest work). Threads that are not
+ * workers (e.g. the main thread) submit into a shared injection queue.
+ *
+ * Waiting never blocks a thread outright: Wait() keeps executing pending
+ * jobs until the counter reaches zero, so jobs may submit and wait on
+ * nested jobs without deadlocking the pool.
+ *
+ * With zero workers (or before Initialize) jobs run inline on submission,
+ * which keeps single-threaded builds and tools working unchanged.
+ *
+ * Usage:
+ *   JobCounter counter;
+ *   JobSystem::Get().Execute([] { DoWork(); }, &counter);
+ *   JobSystem::Get().Wait(counter);
+ *
+ *   // Split a range into chunks and block until all are done
+ *   JobSystem::Get().ParallelFor(bodies.size(), 256, [&](size_t begin, size_t end) {
+ *       for (size_t i = begin; i < end; ++i) Integrate(bodies[i]);
+ *   });
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    /**
+     * @brief Get the singleton instance
+     */
+    static JobSystem& Get() {
+        static JobSystem instance;
+        return instance;
+    }
+
+    /**
+     * @brief Start worker threads
+     * @param workerCount Number of worker threads (0 = run jobs inline)
+     */
+    void Initialize(uint32_t workerCount);
+
+    /**
+     * @brief Finish queued jobs and join all workers
+     */
+    void Shutdown();
+
+    /**
+     * @brief Submit a job
+     * @param job Work to execute
+     * @param counter Optional counter incremented now and decremented when the job finishes
+     */
+    void Execute(Job job, JobCounter* counter = nullptr);
+
+    /**
+     * @brief Submit a job that starts only once dependency has reached zero
+     * @param dependency Counter of the jobs that must finish first
+     * @param job Work to execute
+     * @param counter Optional counter for the new job (counts immediately, not when released)
+     *
+     * Submitted right away if the dependency is already done.
+     */
+    void ExecuteAfter(JobCounter& dependency, Job job, JobCounter* counter = nullptr);
+
+    /**
+     * @brief Block until counter reaches zero, running other jobs meanwhile
+     */
+    void Wait(JobCounter& counter);
+
+    /**
+     * @brief Run func(begin, end) over [0, count) in chunks and wait for all of them
+     * @param count Number of elements
+     * @param grainSize Elements per chunk (0 = pick one from the worker count)
+     * @param func Callable taking (size_t begin, size_t end)
+     *
+     * The calling thread executes one chunk itself and helps with the rest
+     * while waiting. Runs as a single inline call when there are no workers
+     * or the range fits in one chunk.
+     */
+    template<typename Func>
+    void ParallelFor(size_t count, size_t grainSize, Func&& func) {
+        if (count == 0) return;
+
+        if (grainSize == 0) {
+            // A few chunks per thread so stealing can balance uneven work
+            size_t chunks = static_cast<size_t>(GetWorkerCount() + 1) * 4;
+            grainSize = (count + chunks - 1) / chunks;
+        }
+
+        if (!IsRunning() || count <= grainSize) {
+            func(size_t(0), count);
+            return;
+        }
+
+        // Chunk jobs capture two words, so std::function keeps them inline (no allocation)
+        struct Range {
+            Func& Body;
+            size_t Count;
+            size_t Grain;
+        } range{func, count, grainSize};
+
+        JobCounter counter;
+        for (size_t begin = grainSize; begin < count; begin += grainSize) {
+            Execute([&range, begin] {
+                size_t end = (range.Count - begin > range.Grain) ? begin + range.Grain : range.Count;
+                range.Body(begin, end);
+            }, &counter);
+        }
+        func(size_t(0), grainSize);
+        Wait(counter);
+    }
+
+    /**
+     * @brief Number of worker threads (0 when jobs run inline)
+     */
+    uint32_t GetWorkerCount() const { return static_cast<uint32_t>(m_Workers.size()); }
+
+    /**
+     * @brief Check if worker threads are running
+     */
+    bool IsRunning() const { return m_Running.load(std::memory_order_acquire); }
+
+    /**
+     * @brief Index of the calling worker thread, or -1 for non-worker threads
+     */
+    static int GetCurrentWorkerIndex();
+
+private:
+    JobSystem() = default;
+    ~JobSystem() { Shutdown(); }
+
+    /**
+     * @brief Per-thread job deque (owner uses the back, thieves the front)
+     */
+    struct QueuedJob {
+        Job Work;
+        JobCounter* Counter = nullptr;  // Released after Work ran
+    };
+
+    struct WorkQueue {
+        std::mutex Mutex;
+        std::vector<QueuedJob> Ring;  // Circular, doubled when full; never shrinks, so steady use does not allocate
+        size_t Head = 0;              // Front element
+        size_t Count = 0;
+
+        void PushBack(QueuedJob job);
+        bool PopBack(QueuedJob& job);
+        bool PopFront(QueuedJob& job);
+    };
+
+    void WorkerLoop(uint32_t workerIndex);
+
+    /**
+     * @brief Pop from own queue or steal from another, then run the job
+     * @return True if a job was executed
+     */
+    bool TryRunJob(uint32_t queueIndex);
+
+    bool PopLocal(uint32_t queueIndex, QueuedJob& job);
+    bool Steal(uint32_t thiefIndex, QueuedJob& job);
+
+    /**
+     * @brief Queue used by the calling thread (workers: own, others: injection queue)
+     */
+    uint32_t GetQueueIndexForThisThread() const;
+
+    void WakeWorker();
+
+    /**
+     * @brief Push a job onto the calling thread's queue and wake a worker (inline without workers)
+     * @param counter Released once the job ran (may be null)
+     */
+    void Submit(Job job, JobCounter* counter);
+
+    /**
+     * @brief Decrement a counter, releasing its continuations when it reaches zero
+     */
+    void Release(JobCounter& counter);
+
+    // Queues [0, workerCount) belong to workers, the last one is the injection queue
+    std::vector<std::unique_ptr<WorkQueue>> m_Queues;
+    std::vector<std::thread> m_Workers;
+
+    std::mutex m_WakeMutex;
+    std::condition_variable m_WakeCondition;
+    std::atomic<uint32_t> m_PendingJobs{0};
+    std::atomic<bool> m_Running{false};
+};
+
+} // namespace Nilos
@@ -0,0 +1,269 @@
+#include "Logger.h"
+#include <cinttypes>
+#include <ctime>
+
+namespace Nilos {
+
+namespace {
+
+constexpr size_t RING_MASK = Logger::RING_SIZE - 1;
+static_assert((Logger::RING_SIZE & RING_MASK) == 0, "RING_SIZE must be a power of two");
+
+// Writer thread polls this often when idle; Error and up wake it at once
+constexpr auto IDLE_WAIT = std::chrono::milliseconds(5);
+
+// Writer batches up to this much text per console/file write
+constexpr size_t BATCH_BYTES = 64 * 1024;
+
+const char* GetLevelName(LogLevel level) {
+    switch (level) {
+        case LogLevel::Trace:    return "TRACE";
+        case LogLevel::Debug:    return "DEBUG";
+        case LogLevel::Info:     return "INFO";
+        case LogLevel::Warning:  return "WARNING";
+        case LogLevel::Error:    return "ERROR";
+        case LogLevel::Critical: return "CRITICAL";
+    }
+    return "LOG";
+}
+
+template<typename V>
+V ReadValue(const char* data) {
+    V value;
+    std::memcpy(&value, data, sizeof(V));
+    return value;
+}
+
+} // namespace
+
+Logger::Logger() : m_MinLevel(LogLevel::Trace) {
+    m_Ring = new Slot[RING_SIZE];
+    for (size_t i = 0; i < RING_SIZE; ++i) {
+        m_Ring[i].Sequence.store(i, std::memory_order_relaxed);
+    }
+    m_Thread = std::thread([this]() { Run(); });
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(m_Mutex);
+        m_Stop = true;
+    }
+    m_Wake.notify_one();
+    m_Thread.join();
+
+    if (m_File) {
+        std::fclose(m_File);
+    }
+    delete[] m_Ring;
+}
+
+bool Logger::SetLogFile(const std::string& path) {
+    Flush();
+
+    FILE* file = nullptr;
+    if (!path.empty()) {
+        file = std::fopen(path.c_str(), "w");
+        if (!file) {
+            Error("Failed to open log file: ", path);
+            return false;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_Mutex);
+    if (m_File) {
+        std::fclose(m_File);
+    }
+    m_File = file;
+    return true;
+}
+
+void Logger::Flush() {
+    size_t target = m_Head.load(std::memory_order_acquire);
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Wake.notify_one();
+    m_Done.wait(lock, [this, target]() { return m_Written.load(std::memory_order_acquire) >= target || m_Stop; });
+}
+
+Logger::Slot* Logger::Claim(LogLevel level, size_t& position) {
+    // Bounded MPMC queue (Vyukov): a slot is free for position p when its
+    // sequence equals p, and filled for the reader when it equals p + 1
+    position = m_Head.load(std::memory_order_relaxed);
+    for (;;) {
+        Slot& slot = m_Ring[position & RING_MASK];
+        size_t sequence = slot.Sequence.load(std::memory_order_acquire);
+        intptr_t difference = static_cast<intptr_t>(sequence) - static_cast<intptr_t>(position);
+        if (difference == 0) {
+            if (m_Head.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                return &slot;
+            }
+        } else if (difference < 0) {
+            // Full
+            if (level < LogLevel::Warning) {
+                m_Dropped.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            m_Wake.notify_one();
+            std::this_thread::yield();
+            position = m_Head.load(std::memory_order_relaxed);
+        } else {
+            position = m_Head.load(std::memory_order_relaxed);
+        }
+    }
+}
+
+void Logger::Publish(Slot& slot, size_t position, LogLevel level) {
+    slot.Sequence.store(position + 1, std::memory_order_release);
+    if (level >= LogLevel::Error) {
+        m_Wake.notify_one();
+    }
+    if (level == LogLevel::Critical) {
+        Flush();
+    }
+}
+
+void Logger::Run() {
+    std::string out;
+    std::string err;
+    out.reserve(BATCH_BYTES);
+    err.reserve(BATCH_BYTES);
+    uint64_t reportedDrops = 0;
+
+    auto write = [this](std::string& text, FILE* console) {
+        if (text.empty()) {
+            return;
+        }
+        std::fwrite(text.data(), 1, text.size(), console);
+        std::fflush(console);
+        if (m_File) {
+            std::fwrite(text.data(), 1, text.size(), m_File);
+            std::fflush(m_File);
+        }
+        text.clear();
+    };
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    for (;;) {
+        lock.unlock();
+
+        // Drain what is ready; keep console order by switching streams only between batches
+        size_t drained = 0;
+        for (;;) {
+            Slot& slot = m_Ring[m_Tail & RING_MASK];
+            if (slot.Sequence.load(std::memory_order_acquire) != m_Tail + 1) {
+                break;  // Empty, or the producer is still filling it
+            }
+
+            bool isError = slot.Level >= LogLevel::Error;
+            std::string& target = isError ? err : out;
+            std::string& other = isError ? out : err;
+            if (!other.empty() || target.size() >= BATCH_BYTES) {
+                lock.lock();
+                write(other, isError ? stdout : stderr);
+                write(target, isError ? stderr : stdout);
+                lock.unlock();
+            }
+            Format(slot, target);
+
+            slot.Sequence.store(m_Tail + RING_SIZE, std::memory_order_release);
+            ++m_Tail;
+            ++drained;
+        }
+
+        uint64_t drops = m_Dropped.load(std::memory_order_relaxed);
+        if (drops != reportedDrops) {
+            out += "[WARNING] " + std::to_string(drops - reportedDrops) + " log message(s) dropped (ring full)\n";
+            reportedDrops = drops;
+        }
+
+        lock.lock();
+        write(out, stdout);
+        write(err, stderr);
+        m_Written.store(m_Tail, std::memory_order_release);
+        m_Done.notify_all();
+
+        if (drained == 0) {
+            if (m_Stop) {
+                break;
+            }
+            m_Wake.wait_for(lock, IDLE_WAIT);
+        }
+    }
+}
+
+void Logger::Format(const Slot& slot, std::string& out) {
+    using namespace std::chrono;
+    system_clock::duration sinceEpoch(slot.Time);
+    int64_t milliseconds = duration_cast<std::chrono::milliseconds>(sinceEpoch).count();
+    int64_t second = milliseconds / 1000;
+
+    if (second != m_CachedSecond) {
+        std::time_t time = static_cast<std::time_t>(second);
+        std::tm tm;
+        #ifdef _WIN32
+            localtime_s(&tm, &time);
+        #else
+            localtime_r(&time, &tm);
+        #endif
+        std::strftime(m_CachedTime, sizeof(m_CachedTime), "%H:%M:%S", &tm);
+        m_CachedSecond = second;
+    }
+
+    char number[64];
+    int length = std::snprintf(number, sizeof(number), "[%s.%03d] [", m_CachedTime,
+                               static_cast<int>(milliseconds % 1000));
+    out.append(number, static_cast<size_t>(length));
+    out += GetLevelName(slot.Level);
+    out += "] ";
+
+    const char* data = slot.Payload;
+    const char* end = data + slot.Size;
+    while (data < end) {
+        ArgTag tag = static_cast<ArgTag>(*data++);
+        switch (tag) {
+            case TAG_INT:
+                length = std::snprintf(number, sizeof(number), "%" PRId64, ReadValue<int64_t>(data));
+                data += sizeof(int64_t);
+                break;
+            case TAG_UINT:
+                length = std::snprintf(number, sizeof(number), "%" PRIu64, ReadValue<uint64_t>(data));
+                data += sizeof(uint64_t);
+                break;
+            case TAG_DOUBLE:
+                // %g with 6 digits is what a default ostream prints
+                length = std::snprintf(number, sizeof(number), "%g", ReadValue<double>(data));
+                data += sizeof(double);
+                break;
+            case TAG_CHAR:
+                number[0] = *data++;
+                length = 1;
+                break;
+            case TAG_POINTER:
+                length = std::snprintf(number, sizeof(number), "%p", ReadValue<const void*>(data));
+                data += sizeof(const void*);
+                break;
+            case TAG_STRING: {
+                uint16_t size = ReadValue<uint16_t>(data);
+                data += sizeof(uint16_t);
+                out.append(data, size);
+                data += size;
+                length = 0;
+                break;
+            }
+            default:
+                data = end;
+                length = 0;
+                break;
+        }
+        if (length > 0) {
+            out.append(number, static_cast<size_t>(length));
+        }
+    }
+
+    if (slot.Truncated) {
+        out += " [...]";
+    }
+    out += '\n';
+}
+
+} // namespace Nilos
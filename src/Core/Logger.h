@@ -1,10 +1,32 @@
 #pragma once
 
-#include <iostream>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <chrono>
+#include <mutex>
 #include <sstream>
 #include <string>
-#include <chrono>
-#include <iomanip>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+
+/**
+ * @brief Lowest level compiled in (0 = Trace ... 5 = Critical)
+ *
+ * Calls below it compile to nothing, arguments included. Defaults to
+ * keeping everything in debug builds and dropping Trace and Debug when
+ * NDEBUG is defined.
+ */
+#ifndef NILOS_LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define NILOS_LOG_MIN_LEVEL 2
+#else
+#define NILOS_LOG_MIN_LEVEL 0
+#endif
+#endif
 
 namespace Nilos {
 
@@ -21,13 +43,28 @@ enum class LogLevel {
 };
 
 /**
- * @brief Simple logging system for engine diagnostics
- * 
- * Provides formatted console output with timestamps and log levels.
- * Future enhancement: file logging, colored output, log filtering
+ * @brief Asynchronous logging system for engine diagnostics
+ *
+ * A log call only copies its arguments, in a compact tagged binary form,
+ * into a slot of a lock-free ring buffer, along with the raw time. A
+ * background thread turns the slots into text ("[HH:MM:SS.mmm] [LEVEL]
+ * message"), formatting timestamps and numbers there, and writes them in
+ * batches to the console (stderr from Error up) and optionally a file.
+ *
+ * Arguments are printed like operator<< would. Strings, numbers, chars
+ * and pointers are serialized as they are; any other streamable type is
+ * formatted on the calling thread (slower, but it works). Messages that
+ * do not fit a slot are cut off.
+ *
+ * If the ring is full, Trace to Info messages are dropped (and counted);
+ * Warning and up wait for room. Critical messages, and Flush(), wait
+ * until everything logged before them has been written.
  */
 class Logger {
 public:
+    static constexpr size_t RING_SIZE = 4096;    // Slots, a power of two
+    static constexpr size_t SLOT_PAYLOAD = 480;  // Bytes of serialized arguments per message
+
     /**
      * @brief Get the singleton instance
      */
@@ -36,19 +73,40 @@ public:
         return instance;
     }
 
+    ~Logger();
+
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+
     /**
      * @brief Set the minimum log level to display
      */
     void SetLogLevel(LogLevel level) {
-        m_MinLevel = level;
+        m_MinLevel.store(level, std::memory_order_relaxed);
     }
 
+    /**
+     * @brief Also write to a file (truncated); empty path to stop
+     * @return False if the file could not be opened
+     */
+    bool SetLogFile(const std::string& path);
+
+    /**
+     * @brief Block until every message logged so far has been written
+     */
+    void Flush();
+
+    /**
+     * @brief Messages dropped because the ring was full
+     */
+    uint64_t GetDroppedCount() const { return m_Dropped.load(std::memory_order_relaxed); }
+
     /**
      * @brief Log a trace message (most verbose)
      */
     template<typename... Args>
     void Trace(Args&&... args) {
-        Log(LogLevel::Trace, "TRACE", std::forward<Args>(args)...);
+        Log(LogLevel::Trace, std::forward<Args>(args)...);
     }
 
     /**
@@ -56,7 +114,7 @@ public:
      */
     template<typename... Args>
     void Debug(Args&&... args) {
-        Log(LogLevel::Debug, "DEBUG", std::forward<Args>(args)...);
+        Log(LogLevel::Debug, std::forward<Args>(args)...);
     }
 
     /**
@@ -64,7 +122,7 @@ public:
      */
     template<typename... Args>
     void Info(Args&&... args) {
-        Log(LogLevel::Info, "INFO", std::forward<Args>(args)...);
+        Log(LogLevel::Info, std::forward<Args>(args)...);
     }
 
     /**
@@ -72,7 +130,7 @@ public:
      */
     template<typename... Args>
     void Warning(Args&&... args) {
-        Log(LogLevel::Warning, "WARNING", std::forward<Args>(args)...);
+        Log(LogLevel::Warning, std::forward<Args>(args)...);
     }
 
     /**
@@ -80,7 +138,7 @@ public:
      */
     template<typename... Args>
     void Error(Args&&... args) {
-        Log(LogLevel::Error, "ERROR", std::forward<Args>(args)...);
+        Log(LogLevel::Error, std::forward<Args>(args)...);
     }
 
     /**
@@ -88,56 +146,191 @@ public:
      */
     template<typename... Args>
     void Critical(Args&&... args) {
-        Log(LogLevel::Critical, "CRITICAL", std::forward<Args>(args)...);
+        Log(LogLevel::Critical, std::forward<Args>(args)...);
     }
 
 private:
-    Logger() : m_MinLevel(LogLevel::Trace) {}
-    
+    Logger();
+
+    // Argument tags in a slot's payload
+    enum ArgTag : uint8_t {
+        TAG_INT,      // int64_t
+        TAG_UINT,     // uint64_t
+        TAG_DOUBLE,   // double
+        TAG_CHAR,     // char
+        TAG_POINTER,  // const void*
+        TAG_STRING    // uint16_t length, then the bytes
+    };
+
+    struct Slot {
+        std::atomic<size_t> Sequence;
+        int64_t Time;  // system_clock ticks since the epoch
+        LogLevel Level;
+        bool Truncated;
+        uint16_t Size;
+        char Payload[SLOT_PAYLOAD];
+    };
+
+    /**
+     * @brief Appends tagged arguments to a claimed slot
+     */
+    class SlotWriter {
+    public:
+        explicit SlotWriter(Slot& slot) : m_Slot(slot) {}
+
+        template<typename T>
+        void Write(const T& value) {
+            using Type = std::decay_t<T>;
+            if constexpr (std::is_same_v<Type, bool>) {
+                WriteValue(TAG_INT, static_cast<int64_t>(value));
+            } else if constexpr (std::is_same_v<Type, char> || std::is_same_v<Type, signed char> ||
+                                 std::is_same_v<Type, unsigned char>) {
+                WriteValue(TAG_CHAR, static_cast<char>(value));
+            } else if constexpr (std::is_enum_v<Type>) {
+                Write(static_cast<std::underlying_type_t<Type>>(value));
+            } else if constexpr (std::is_integral_v<Type> && std::is_signed_v<Type>) {
+                WriteValue(TAG_INT, static_cast<int64_t>(value));
+            } else if constexpr (std::is_integral_v<Type>) {
+                WriteValue(TAG_UINT, static_cast<uint64_t>(value));
+            } else if constexpr (std::is_floating_point_v<Type>) {
+                WriteValue(TAG_DOUBLE, static_cast<double>(value));
+            } else if constexpr (std::is_array_v<T>) {
+                WriteString(std::string_view(value));
+            } else if constexpr (std::is_same_v<Type, const char*> || std::is_same_v<Type, char*>) {
+                WriteString(value ? std::string_view(value) : std::string_view("(null)"));
+            } else if constexpr (std::is_convertible_v<const T&, std::string_view>) {
+                WriteString(std::string_view(value));
+            } else if constexpr (std::is_pointer_v<Type>) {
+                WriteValue(TAG_POINTER, static_cast<const void*>(value));
+            } else {
+                // Anything else streamable: format here
+                std::ostringstream oss;
+                oss << value;
+                WriteString(oss.str());
+            }
+        }
+
+    private:
+        template<typename V>
+        void WriteValue(ArgTag tag, V value) {
+            if (m_Slot.Size + 1 + sizeof(V) > SLOT_PAYLOAD) {
+                m_Slot.Truncated = true;
+                return;
+            }
+            m_Slot.Payload[m_Slot.Size] = static_cast<char>(tag);
+            std::memcpy(&m_Slot.Payload[m_Slot.Size + 1], &value, sizeof(V));
+            m_Slot.Size = static_cast<uint16_t>(m_Slot.Size + 1 + sizeof(V));
+        }
+
+        void WriteString(std::string_view text) {
+            size_t room = SLOT_PAYLOAD - m_Slot.Size;
+            if (room <= 1 + sizeof(uint16_t)) {
+                m_Slot.Truncated = true;
+                return;
+            }
+            size_t length = text.size();
+            if (length > room - 1 - sizeof(uint16_t)) {
+                length = room - 1 - sizeof(uint16_t);
+                m_Slot.Truncated = true;
+            }
+            uint16_t stored = static_cast<uint16_t>(length);
+            char* out = &m_Slot.Payload[m_Slot.Size];
+            out[0] = static_cast<char>(TAG_STRING);
+            std::memcpy(out + 1, &stored, sizeof(stored));
+            std::memcpy(out + 1 + sizeof(stored), text.data(), length);
+            m_Slot.Size = static_cast<uint16_t>(m_Slot.Size + 1 + sizeof(stored) + length);
+        }
+
+        Slot& m_Slot;
+    };
+
     template<typename... Args>
-    void Log(LogLevel level, const char* levelStr, Args&&... args) {
-        if (level < m_MinLevel) return;
-
-        // Get current time
-        auto now = std::chrono::system_clock::now();
-        auto time = std::chrono::system_clock::to_time_t(now);
-        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
-            now.time_since_epoch()) % 1000;
-
-        std::tm tm;
-        #ifdef _WIN32
-            localtime_s(&tm, &time);
-        #else
-            localtime_r(&time, &tm);
-        #endif
-
-        // Build message
-        std::ostringstream oss;
-        oss << "[" << std::put_time(&tm, "%H:%M:%S") << "." 
-            << std::setfill('0') << std::setw(3) << ms.count() << "] "
-            << "[" << levelStr << "] ";
-        
-        // Concatenate all arguments
-        ((oss << std::forward<Args>(args)), ...);
-        
-        // Output to console (stderr for errors)
-        if (level >= LogLevel::Error) {
-            std::cerr << oss.str() << std::endl;
-        } else {
-            std::cout << oss.str() << std::endl;
+    void Log(LogLevel level, Args&&... args) {
+        if (level < m_MinLevel.load(std::memory_order_relaxed)) return;
+
+        size_t position;
+        Slot* slot = Claim(level, position);
+        if (!slot) {
+            return;
         }
+        slot->Time = std::chrono::system_clock::now().time_since_epoch().count();
+        slot->Level = level;
+        slot->Truncated = false;
+        slot->Size = 0;
+
+        SlotWriter writer(*slot);
+        (writer.Write(args), ...);
+        Publish(*slot, position, level);
     }
 
-    LogLevel m_MinLevel;
+    /**
+     * @brief Reserve the next ring slot (nullptr if full and the message may be dropped)
+     */
+    Slot* Claim(LogLevel level, size_t& position);
+
+    /**
+     * @brief Hand a filled slot to the writer thread
+     */
+    void Publish(Slot& slot, size_t position, LogLevel level);
+
+    /**
+     * @brief Writer thread: drain the ring, format, write in batches
+     */
+    void Run();
+
+    /**
+     * @brief Append one slot's message as a text line
+     */
+    void Format(const Slot& slot, std::string& out);
+
+    std::atomic<LogLevel> m_MinLevel;
+
+    Slot* m_Ring;
+    std::atomic<size_t> m_Head{0};     // Next position to claim
+    size_t m_Tail = 0;                 // Next position to write (writer thread only)
+    std::atomic<size_t> m_Written{0};  // Positions written so far
+    std::atomic<uint64_t> m_Dropped{0};
+
+    std::thread m_Thread;
+    std::mutex m_Mutex;                // Guards the wake-ups, the file and the flags below
+    std::condition_variable m_Wake;    // Writer: work or stop requested
+    std::condition_variable m_Done;    // Flush: a batch was written
+    bool m_Stop = false;
+    FILE* m_File = nullptr;
+
+    // Writer thread's cache of the formatted current second
+    int64_t m_CachedSecond = -1;
+    char m_CachedTime[16] = {};
 };
 
-// Convenience macros
+// Convenience macros; levels below NILOS_LOG_MIN_LEVEL are compiled out
+#define NILOS_LOG_STRIPPED(...) do { if (false) { ::Nilos::Logger::Get().Trace(__VA_ARGS__); } } while (0)
+
+#if NILOS_LOG_MIN_LEVEL <= 0
 #define NILOS_TRACE(...)    ::Nilos::Logger::Get().Trace(__VA_ARGS__)
+#else
+#define NILOS_TRACE(...)    NILOS_LOG_STRIPPED(__VA_ARGS__)
+#endif
+
+#if NILOS_LOG_MIN_LEVEL <= 1
 #define NILOS_DEBUG(...)    ::Nilos::Logger::Get().Debug(__VA_ARGS__)
+#else
+#define NILOS_DEBUG(...)    NILOS_LOG_STRIPPED(__VA_ARGS__)
+#endif
+
+#if NILOS_LOG_MIN_LEVEL <= 2
 #define NILOS_INFO(...)     ::Nilos::Logger::Get().Info(__VA_ARGS__)
+#else
+#define NILOS_INFO(...)     NILOS_LOG_STRIPPED(__VA_ARGS__)
+#endif
+
+#if NILOS_LOG_MIN_LEVEL <= 3
 #define NILOS_WARNING(...)  ::Nilos::Logger::Get().Warning(__VA_ARGS__)
+#else
+#define NILOS_WARNING(...)  NILOS_LOG_STRIPPED(__VA_ARGS__)
+#endif
+
 #define NILOS_ERROR(...)    ::Nilos::Logger::Get().Error(__VA_ARGS__)
 #define NILOS_CRITICAL(...) ::Nilos::Logger::Get().Critical(__VA_ARGS__)
 
 } // namespace Nilos
-
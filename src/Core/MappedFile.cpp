@@ -0,0 +1,123 @@
+#include "MappedFile.h"
+#include "Logger.h"
+
+#ifdef _WIN32
+    #ifndef WIN32_LEAN_AND_MEAN
+        #define WIN32_LEAN_AND_MEAN
+    #endif
+    #ifndef NOMINMAX
+        #define NOMINMAX
+    #endif
+    #include <windows.h>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+namespace Nilos {
+
+MappedFile::~MappedFile() {
+    Close();
+}
+
+#ifdef _WIN32
+
+bool MappedFile::Open(const std::string& filepath) {
+    Close();
+
+    HANDLE file = CreateFileA(filepath.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                              FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        NILOS_ERROR("Failed to open file: ", filepath);
+        return false;
+    }
+    m_File = file;
+
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size) || size.QuadPart == 0) {
+        NILOS_ERROR("Cannot map empty file: ", filepath);
+        Close();
+        return false;
+    }
+
+    HANDLE mapping = CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    if (!mapping) {
+        NILOS_ERROR("Failed to map file: ", filepath);
+        Close();
+        return false;
+    }
+    m_Mapping = mapping;
+
+    m_Data = static_cast<const uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+    if (!m_Data) {
+        NILOS_ERROR("Failed to map file: ", filepath);
+        Close();
+        return false;
+    }
+    m_Size = static_cast<size_t>(size.QuadPart);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_Data) {
+        UnmapViewOfFile(m_Data);
+        m_Data = nullptr;
+    }
+    if (m_Mapping) {
+        CloseHandle(static_cast<HANDLE>(m_Mapping));
+        m_Mapping = nullptr;
+    }
+    if (m_File) {
+        CloseHandle(static_cast<HANDLE>(m_File));
+        m_File = nullptr;
+    }
+    m_Size = 0;
+}
+
+#else
+
+bool MappedFile::Open(const std::string& filepath) {
+    Close();
+
+    m_File = open(filepath.c_str(), O_RDONLY);
+    if (m_File < 0) {
+        NILOS_ERROR("Failed to open file: ", filepath);
+        return false;
+    }
+
+    struct stat info;
+    if (fstat(m_File, &info) != 0 || info.st_size == 0) {
+        NILOS_ERROR("Cannot map empty file: ", filepath);
+        Close();
+        return false;
+    }
+
+    void* data = mmap(nullptr, static_cast<size_t>(info.st_size), PROT_READ, MAP_PRIVATE, m_File, 0);
+    if (data == MAP_FAILED) {
+        NILOS_ERROR("Failed to map file: ", filepath);
+        Close();
+        return false;
+    }
+
+    m_Data = static_cast<const uint8_t*>(data);
+    m_Size = static_cast<size_t>(info.st_size);
+    return true;
+}
+
+void MappedFile::Close() {
+    if (m_Data) {
+        munmap(const_cast<uint8_t*>(m_Data), m_Size);
+        m_Data = nullptr;
+    }
+    if (m_File >= 0) {
+        close(m_File);
+        m_File = -1;
+    }
+    m_Size = 0;
+}
+
+#endif
+
+} // namespace Nilos
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace Nilos {
+
+/**
+ * @brief Read-only memory mapping of a whole file
+ *
+ * Lets loaders hand file contents straight to the GPU (or parse them in
+ * place) without reading them into a heap buffer first; the OS pages the
+ * data in on demand. The mapping is released on destruction.
+ *
+ * Usage:
+ *   MappedFile file;
+ *   if (file.Open("assets/models/crate.nmesh")) {
+ *       const uint8_t* bytes = file.GetData();
+ *   }
+ */
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /**
+     * @brief Map a file (closes any file mapped before)
+     * @return False if the file cannot be opened or mapped
+     */
+    bool Open(const std::string& filepath);
+
+    /**
+     * @brief Unmap the file
+     */
+    void Close();
+
+    bool IsOpen() const { return m_Data != nullptr; }
+    const uint8_t* GetData() const { return m_Data; }
+    size_t GetSize() const { return m_Size; }
+
+private:
+    const uint8_t* m_Data = nullptr;
+    size_t m_Size = 0;
+
+#ifdef _WIN32
+    void* m_File = nullptr;    // HANDLE
+    void* m_Mapping = nullptr; // HANDLE
+#else
+    int m_File = -1;
+#endif
+};
+
+} // namespace Nilos
@@ -0,0 +1,208 @@
+#include "Memory.h"
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+namespace Nilos {
+
+namespace {
+
+std::atomic<uint64_t> g_HeapAllocations{0};
+std::atomic<uint64_t> g_HeapFrees{0};
+std::atomic<uint64_t> g_ArenaOverflows{0};
+
+char* AlignUp(char* pointer, size_t alignment) {
+    uintptr_t address = reinterpret_cast<uintptr_t>(pointer);
+    return reinterpret_cast<char*>((address + alignment - 1) & ~static_cast<uintptr_t>(alignment - 1));
+}
+
+} // namespace
+
+MemoryStats GetMemoryStats() {
+    MemoryStats stats;
+    stats.HeapAllocations = g_HeapAllocations.load(std::memory_order_relaxed);
+    stats.HeapFrees = g_HeapFrees.load(std::memory_order_relaxed);
+    stats.ArenaOverflows = g_ArenaOverflows.load(std::memory_order_relaxed);
+    stats.FrameArenaUsed = FrameArena::Get().GetCurrent().GetUsed();
+    stats.FrameArenaCapacity = FrameArena::Get().GetCurrent().GetCapacity();
+    return stats;
+}
+
+// -----------------------------------------------------------------------------
+// LinearArena
+// -----------------------------------------------------------------------------
+
+LinearArena::LinearArena(size_t capacity) {
+    Reserve(capacity);
+}
+
+LinearArena::~LinearArena() {
+    for (const Overflow& overflow : m_Overflows) {
+        std::free(overflow.Memory);
+    }
+    std::free(m_Block);
+}
+
+void* LinearArena::Allocate(size_t size, size_t alignment) {
+    if (m_Offset <= m_Capacity) {
+        char* pointer = AlignUp(m_Block + m_Offset, alignment);
+        size_t end = static_cast<size_t>(pointer - m_Block) + size;
+        if (m_Block && end <= m_Capacity) {
+            m_Offset = end;
+            m_HighWater = std::max(m_HighWater, m_Offset);
+            return pointer;
+        }
+    }
+
+    // Full: from the heap until the next complete reset grows the block
+    g_ArenaOverflows.fetch_add(1, std::memory_order_relaxed);
+    void* memory = std::malloc(size + alignment);
+    if (!memory) {
+        throw std::bad_alloc();
+    }
+    m_Overflows.push_back({ m_Offset, memory });
+    m_Offset = std::max(m_Offset, m_Capacity) + size + alignment;
+    m_HighWater = std::max(m_HighWater, m_Offset);
+    return AlignUp(static_cast<char*>(memory), alignment);
+}
+
+void LinearArena::ResetToMarker(size_t marker) {
+    while (!m_Overflows.empty() && m_Overflows.back().Offset >= marker) {
+        std::free(m_Overflows.back().Memory);
+        m_Overflows.pop_back();
+    }
+    m_Offset = std::min(marker, m_Offset);
+
+    if (marker == 0 && m_HighWater > m_Capacity) {
+        Reserve(std::max(m_HighWater, m_Capacity * 2));
+    }
+}
+
+void LinearArena::Reserve(size_t capacity) {
+    if (capacity <= m_Capacity || m_Offset != 0) {
+        return;
+    }
+    std::free(m_Block);
+    m_Block = static_cast<char*>(std::malloc(capacity));
+    if (!m_Block) {
+        throw std::bad_alloc();
+    }
+    m_Capacity = capacity;
+}
+
+// -----------------------------------------------------------------------------
+// FrameArena / ScratchArena
+// -----------------------------------------------------------------------------
+
+void FrameArena::Initialize(size_t capacity) {
+    for (LinearArena& arena : m_Arenas) {
+        arena.Reset();
+        arena.Reserve(capacity);
+    }
+}
+
+void FrameArena::BeginFrame() {
+    m_Current ^= 1;
+    m_Arenas[m_Current].Reset();
+}
+
+LinearArena& ScratchArena::Get() {
+    static thread_local LinearArena arena(DEFAULT_CAPACITY);
+    return arena;
+}
+
+} // namespace Nilos
+
+#if NILOS_TRACK_ALLOCATIONS
+
+// -----------------------------------------------------------------------------
+// Counting global allocation operators
+// -----------------------------------------------------------------------------
+
+namespace {
+
+void* CountedAllocate(size_t size) {
+    Nilos::g_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    return std::malloc(size ? size : 1);
+}
+
+void* CountedAllocateAligned(size_t size, size_t alignment) {
+    Nilos::g_HeapAllocations.fetch_add(1, std::memory_order_relaxed);
+    size = size ? size : 1;
+    #ifdef _WIN32
+        return _aligned_malloc(size, alignment);
+    #else
+        void* memory = nullptr;
+        return posix_memalign(&memory, std::max(alignment, sizeof(void*)), size) == 0 ? memory : nullptr;
+    #endif
+}
+
+void CountedFree(void* memory) {
+    if (memory) {
+        Nilos::g_HeapFrees.fetch_add(1, std::memory_order_relaxed);
+        std::free(memory);
+    }
+}
+
+void CountedFreeAligned(void* memory) {
+    if (memory) {
+        Nilos::g_HeapFrees.fetch_add(1, std::memory_order_relaxed);
+        #ifdef _WIN32
+            _aligned_free(memory);
+        #else
+            std::free(memory);
+        #endif
+    }
+}
+
+} // namespace
+
+void* operator new(size_t size) {
+    if (void* memory = CountedAllocate(size)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size) {
+    if (void* memory = CountedAllocate(size)) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+void* operator new[](size_t size, const std::nothrow_t&) noexcept { return CountedAllocate(size); }
+
+void* operator new(size_t size, std::align_val_t alignment) {
+    if (void* memory = CountedAllocateAligned(size, static_cast<size_t>(alignment))) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new[](size_t size, std::align_val_t alignment) {
+    if (void* memory = CountedAllocateAligned(size, static_cast<size_t>(alignment))) return memory;
+    throw std::bad_alloc();
+}
+
+void* operator new(size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocateAligned(size, static_cast<size_t>(alignment));
+}
+
+void* operator new[](size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return CountedAllocateAligned(size, static_cast<size_t>(alignment));
+}
+
+void operator delete(void* memory) noexcept { CountedFree(memory); }
+void operator delete[](void* memory) noexcept { CountedFree(memory); }
+void operator delete(void* memory, size_t) noexcept { CountedFree(memory); }
+void operator delete[](void* memory, size_t) noexcept { CountedFree(memory); }
+void operator delete(void* memory, const std::nothrow_t&) noexcept { CountedFree(memory); }
+void operator delete[](void* memory, const std::nothrow_t&) noexcept { CountedFree(memory); }
+
+void operator delete(void* memory, std::align_val_t) noexcept { CountedFreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t) noexcept { CountedFreeAligned(memory); }
+void operator delete(void* memory, size_t, std::align_val_t) noexcept { CountedFreeAligned(memory); }
+void operator delete[](void* memory, size_t, std::align_val_t) noexcept { CountedFreeAligned(memory); }
+void operator delete(void* memory, std::align_val_t, const std::nothrow_t&) noexcept { CountedFreeAligned(memory); }
+void operator delete[](void* memory, std::align_val_t, const std::nothrow_t&) noexcept { CountedFreeAligned(memory); }
+
+#endif // NILOS_TRACK_ALLOCATIONS
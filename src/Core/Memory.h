@@ -0,0 +1,330 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Set to 1 to count every global operator new/delete (see GetMemoryStats)
+ *
+ * Replaces the global allocation operators of the whole program with
+ * counting versions that forward to malloc/free, so it is off by default;
+ * turn it on while hunting allocations (-DNILOS_TRACK_ALLOCATIONS=ON).
+ */
+#ifndef NILOS_TRACK_ALLOCATIONS
+#define NILOS_TRACK_ALLOCATIONS 0
+#endif
+
+namespace Nilos {
+
+/**
+ * @brief Allocation counters since startup
+ */
+struct MemoryStats {
+    uint64_t HeapAllocations = 0;  // Global operator new calls (0 unless NILOS_TRACK_ALLOCATIONS)
+    uint64_t HeapFrees = 0;
+    uint64_t ArenaOverflows = 0;   // Arena allocations that had to fall back to the heap
+    size_t FrameArenaUsed = 0;     // Bytes allocated from the frame arena this frame
+    size_t FrameArenaCapacity = 0;
+};
+
+MemoryStats GetMemoryStats();
+
+/**
+ * @brief Bump allocator over one contiguous block
+ *
+ * Allocation is a pointer increment; nothing is freed individually.
+ * Reset (or ResetToMarker) releases everything allocated after a point
+ * at once, without running destructors, so it holds trivially
+ * destructible data or containers that are destroyed before the reset.
+ *
+ * When the block is full, allocations fall back to the heap (counted in
+ * MemoryStats::ArenaOverflows) instead of failing. The next time the
+ * arena is reset completely, its block grows to the high-water mark, so
+ * after a few frames a steady workload no longer touches the heap.
+ *
+ * Not thread-safe; use one arena per thread (see ScratchArena).
+ */
+class LinearArena {
+public:
+    explicit LinearArena(size_t capacity = 0);
+    ~LinearArena();
+
+    LinearArena(const LinearArena&) = delete;
+    LinearArena& operator=(const LinearArena&) = delete;
+
+    /**
+     * @brief Uninitialized memory, valid until the arena is reset past it
+     */
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t));
+
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        return static_cast<T*>(Allocate(sizeof(T) * count, alignof(T)));
+    }
+
+    /**
+     * @brief Construct an object in the arena (its destructor never runs)
+     */
+    template<typename T, typename... Args>
+    T* New(Args&&... args) {
+        return new (Allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Current position, for ResetToMarker
+     */
+    size_t GetMarker() const { return m_Offset; }
+
+    /**
+     * @brief Release everything allocated since marker was taken
+     */
+    void ResetToMarker(size_t marker);
+
+    /**
+     * @brief Release everything (grows the block if it overflowed)
+     */
+    void Reset() { ResetToMarker(0); }
+
+    /**
+     * @brief Make the block at least capacity bytes (only while empty)
+     */
+    void Reserve(size_t capacity);
+
+    size_t GetUsed() const { return m_Offset; }
+    size_t GetCapacity() const { return m_Capacity; }
+    size_t GetHighWater() const { return m_HighWater; }
+
+private:
+    struct Overflow {
+        size_t Offset;  // Arena position the allocation starts at
+        void* Memory;
+    };
+
+    char* m_Block = nullptr;
+    size_t m_Capacity = 0;
+    size_t m_Offset = 0;      // Bytes in use, overflow included
+    size_t m_HighWater = 0;
+    std::vector<Overflow> m_Overflows;
+};
+
+/**
+ * @brief STL allocator drawing from a LinearArena (deallocate is a no-op)
+ */
+template<typename T>
+class ArenaAllocator {
+public:
+    using value_type = T;
+
+    explicit ArenaAllocator(LinearArena& arena) : m_Arena(&arena) {}
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) : m_Arena(other.GetArena()) {}
+
+    T* allocate(size_t count) { return m_Arena->AllocateArray<T>(count); }
+    void deallocate(T*, size_t) {}
+
+    LinearArena* GetArena() const { return m_Arena; }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const { return m_Arena == other.GetArena(); }
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const { return m_Arena != other.GetArena(); }
+
+private:
+    LinearArena* m_Arena;
+};
+
+/**
+ * @brief std::vector whose storage comes from an arena
+ */
+template<typename T>
+using ArenaVector = std::vector<T, ArenaAllocator<T>>;
+
+/**
+ * @brief Double-buffered per-frame arena (main thread)
+ *
+ * Engine::Run calls BeginFrame once per frame, which resets the older of
+ * two arenas and makes it current. Memory allocated during a frame stays
+ * valid through the next frame, so results can be handed one frame
+ * ahead (e.g. to the renderer) without copying.
+ *
+ * Usage:
+ *   ArenaVector<Entity> entities = FrameArena::Get().MakeVector<Entity>();
+ *   world->GetEntitiesWithComponent<MeshComponent>(entities);
+ */
+class FrameArena {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 2 * 1024 * 1024;  // Bytes per buffer
+
+    static FrameArena& Get() {
+        static FrameArena instance;
+        return instance;
+    }
+
+    /**
+     * @brief Set the starting size of both buffers (they still grow on overflow)
+     */
+    void Initialize(size_t capacity);
+
+    /**
+     * @brief Switch buffers and reset the new current one
+     */
+    void BeginFrame();
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        return GetCurrent().Allocate(size, alignment);
+    }
+
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        return GetCurrent().AllocateArray<T>(count);
+    }
+
+    template<typename T>
+    ArenaVector<T> MakeVector() {
+        return ArenaVector<T>(ArenaAllocator<T>(GetCurrent()));
+    }
+
+    LinearArena& GetCurrent() { return m_Arenas[m_Current]; }
+    const LinearArena& GetCurrent() const { return m_Arenas[m_Current]; }
+
+private:
+    FrameArena() = default;
+
+    LinearArena m_Arenas[2];
+    uint32_t m_Current = 0;
+};
+
+/**
+ * @brief Per-thread scratch arena, for temporaries of one function call
+ *
+ * Any thread, job system workers included, gets its own arena on first
+ * use. Allocate inside a ScratchScope, which rewinds the arena when it
+ * goes out of scope; scopes nest.
+ *
+ * Usage:
+ *   ScratchScope scratch;
+ *   ArenaVector<Entry*> builds = scratch.MakeVector<Entry*>();
+ */
+class ScratchArena {
+public:
+    static constexpr size_t DEFAULT_CAPACITY = 256 * 1024;  // Bytes per thread
+
+    /**
+     * @brief The calling thread's arena
+     */
+    static LinearArena& Get();
+};
+
+/**
+ * @brief Rewinds the calling thread's scratch arena on destruction
+ */
+class ScratchScope {
+public:
+    ScratchScope() : m_Arena(ScratchArena::Get()), m_Marker(m_Arena.GetMarker()) {}
+    ~ScratchScope() { m_Arena.ResetToMarker(m_Marker); }
+
+    ScratchScope(const ScratchScope&) = delete;
+    ScratchScope& operator=(const ScratchScope&) = delete;
+
+    void* Allocate(size_t size, size_t alignment = alignof(std::max_align_t)) {
+        return m_Arena.Allocate(size, alignment);
+    }
+
+    template<typename T>
+    T* AllocateArray(size_t count) {
+        return m_Arena.AllocateArray<T>(count);
+    }
+
+    template<typename T>
+    ArenaVector<T> MakeVector() {
+        return ArenaVector<T>(ArenaAllocator<T>(m_Arena));
+    }
+
+    LinearArena& GetArena() { return m_Arena; }
+
+private:
+    LinearArena& m_Arena;
+    size_t m_Marker;
+};
+
+/**
+ * @brief Fixed-size pool of T, for objects created and destroyed often
+ *
+ * Slots come from chunks of CHUNK_SIZE objects and are recycled through a
+ * free list, so Create/Destroy do not touch the heap once enough chunks
+ * exist (Reserve them up front). Objects never move. Objects still alive
+ * when the pool is destroyed are not destructed.
+ *
+ * Not thread-safe.
+ *
+ * Usage:
+ *   Pool<PathNode> nodes;
+ *   PathNode* node = nodes.Create(cell, cost);
+ *   nodes.Destroy(node);
+ */
+template<typename T, size_t CHUNK_SIZE = 256>
+class Pool {
+public:
+    Pool() = default;
+    Pool(const Pool&) = delete;
+    Pool& operator=(const Pool&) = delete;
+
+    template<typename... Args>
+    T* Create(Args&&... args) {
+        if (!m_Free) {
+            AddChunk();
+        }
+        Slot* slot = m_Free;
+        m_Free = slot->Next;
+        ++m_Live;
+        return new (slot->Storage) T(std::forward<Args>(args)...);
+    }
+
+    void Destroy(T* object) {
+        if (!object) return;
+        object->~T();
+        Slot* slot = reinterpret_cast<Slot*>(object);
+        slot->Next = m_Free;
+        m_Free = slot;
+        --m_Live;
+    }
+
+    /**
+     * @brief Make room for count live objects
+     */
+    void Reserve(size_t count) {
+        while (GetCapacity() < count) {
+            AddChunk();
+        }
+    }
+
+    size_t GetLiveCount() const { return m_Live; }
+    size_t GetCapacity() const { return m_Chunks.size() * CHUNK_SIZE; }
+
+private:
+    union Slot {
+        Slot* Next;
+        alignas(T) unsigned char Storage[sizeof(T)];
+    };
+
+    void AddChunk() {
+        m_Chunks.emplace_back(new Slot[CHUNK_SIZE]);
+        Slot* chunk = m_Chunks.back().get();
+        for (size_t i = CHUNK_SIZE; i-- > 0;) {
+            chunk[i].Next = m_Free;
+            m_Free = &chunk[i];
+        }
+    }
+
+    std::vector<std::unique_ptr<Slot[]>> m_Chunks;
+    Slot* m_Free = nullptr;
+    size_t m_Live = 0;
+};
+
+} // namespace Nilos
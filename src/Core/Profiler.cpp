@@ -0,0 +1,428 @@
+#include "Profiler.h"
+#include "Logger.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+
+namespace Nilos {
+
+namespace {
+
+// A thread that records without anyone calling EndFrame stops here
+constexpr size_t MAX_RECORDS_PER_THREAD = 1 << 20;
+
+constexpr const char* FRAME_SCOPE = "Frame";
+constexpr const char* GPU_KEY_PREFIX = "gpu:";
+
+thread_local void* t_ThreadBuffer = nullptr;
+
+/**
+ * @brief Write a JSON string body (without quotes)
+ */
+void WriteEscaped(FILE* file, const char* text) {
+    for (const char* c = text; *c; ++c) {
+        if (*c == '"' || *c == '\\') {
+            std::fputc('\\', file);
+            std::fputc(*c, file);
+        } else if (static_cast<unsigned char>(*c) < 0x20) {
+            std::fprintf(file, "\\u%04x", static_cast<unsigned>(*c));
+        } else {
+            std::fputc(*c, file);
+        }
+    }
+}
+
+} // namespace
+
+Profiler::Profiler() {
+    m_Stats.reserve(64);
+    m_History.reserve(64);
+    m_GpuResults.reserve(MAX_GPU_SCOPES * GPU_FRAMES_IN_FLIGHT);
+    m_GpuCollected.reserve(MAX_GPU_SCOPES * GPU_FRAMES_IN_FLIGHT);
+}
+
+Profiler::~Profiler() {
+    EndCapture();
+}
+
+void Profiler::SetThreadName(const char* name) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.Mutex);
+    buffer.Name = name;
+}
+
+Profiler::ThreadBuffer& Profiler::GetThreadBuffer() {
+    if (!t_ThreadBuffer) {
+        std::lock_guard<std::mutex> lock(m_ThreadsMutex);
+        m_Threads.push_back(std::make_unique<ThreadBuffer>());
+        ThreadBuffer& buffer = *m_Threads.back();
+        buffer.Id = static_cast<uint32_t>(m_Threads.size());
+        buffer.Name = "Thread " + std::to_string(buffer.Id);
+        buffer.Records.reserve(1024);
+        t_ThreadBuffer = &buffer;
+    }
+    return *static_cast<ThreadBuffer*>(t_ThreadBuffer);
+}
+
+void Profiler::RecordScope(const char* name, int64_t begin, int64_t end) {
+    ThreadBuffer& buffer = GetThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer.Mutex);
+    if (buffer.Records.size() < MAX_RECORDS_PER_THREAD) {
+        buffer.Records.push_back({name, begin, end});
+    }
+}
+
+void Profiler::BeginFrame() {
+    m_FrameBegin = Now();
+}
+
+void Profiler::EndFrame() {
+    int64_t frameEnd = Now();
+    bool enabled = IsEnabled();
+
+    // Take every thread's records
+    m_Collected.clear();
+    m_CollectedThreads.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_ThreadsMutex);
+        for (const std::unique_ptr<ThreadBuffer>& buffer : m_Threads) {
+            std::lock_guard<std::mutex> bufferLock(buffer->Mutex);
+            if (m_CaptureFile) {
+                m_CollectedThreads.insert(m_CollectedThreads.end(), buffer->Records.size(), buffer->Id);
+            }
+            m_Collected.insert(m_Collected.end(), buffer->Records.begin(), buffer->Records.end());
+            buffer->Records.clear();
+        }
+    }
+
+    if (enabled) {
+        Accumulate(FRAME_SCOPE, false, static_cast<double>(frameEnd - m_FrameBegin) * 1e-6);
+    }
+    for (size_t i = 0; i < m_Collected.size(); ++i) {
+        const Record& record = m_Collected[i];
+        Accumulate(record.Name, false, static_cast<double>(record.End - record.Begin) * 1e-6);
+        if (m_CaptureFile) {
+            WriteCaptureEvent(record.Name, m_CollectedThreads[i], record.Begin, record.End);
+        }
+    }
+    if (m_CaptureFile && enabled) {
+        WriteCaptureEvent(FRAME_SCOPE, GetThreadBuffer().Id, m_FrameBegin, frameEnd);
+        for (const ProfileCounter& counter : m_Counters) {
+            WriteCaptureCounter(counter, frameEnd);
+        }
+    }
+
+    // GPU scopes the GL thread has read back since the last frame
+    m_GpuCollected.clear();
+    {
+        std::lock_guard<std::mutex> lock(m_GpuResultsMutex);
+        m_GpuCollected.swap(m_GpuResults);
+    }
+    for (const GpuResult& result : m_GpuCollected) {
+        // Lands in the statistics of the frame in which it resolves
+        Accumulate(result.Name, true, static_cast<double>(result.End - result.Begin) * 1e-6);
+        if (m_CaptureFile) {
+            WriteCaptureEvent(result.Name, 0, result.Begin, result.End);
+        }
+    }
+
+    // Roll this frame's totals into the window
+    for (size_t i = 0; i < m_Stats.size(); ++i) {
+        ProfileStats& stats = m_Stats[i];
+        StatsHistory& history = m_History[i];
+        if (!history.Seen) {
+            stats.LastMs = 0.0;
+            history.Calls = 0;
+        }
+        history.Samples[m_HistoryCursor] = stats.LastMs;
+        stats.CallsPerFrame = history.Calls;
+        history.Seen = false;
+        history.Calls = 0;
+    }
+    m_HistoryCursor = (m_HistoryCursor + 1) % STATS_WINDOW;
+    m_HistoryCount = std::min(m_HistoryCount + 1, STATS_WINDOW);
+
+    for (size_t i = 0; i < m_Stats.size(); ++i) {
+        const StatsHistory& history = m_History[i];
+        double sum = 0.0;
+        double maximum = 0.0;
+        for (uint32_t sample = 0; sample < m_HistoryCount; ++sample) {
+            sum += history.Samples[sample];
+            maximum = std::max(maximum, history.Samples[sample]);
+        }
+        m_Stats[i].AverageMs = m_HistoryCount ? sum / m_HistoryCount : 0.0;
+        m_Stats[i].MaxMs = maximum;
+    }
+
+    ++m_FrameIndex;
+    if (m_CaptureFile && m_CaptureFramesLeft > 0 && --m_CaptureFramesLeft == 0) {
+        EndCapture();
+    }
+}
+
+void Profiler::Accumulate(const char* name, bool gpu, double milliseconds) {
+    // Names are literals, so the pointer finds a scope without hashing the text
+    auto cached = m_NameIndex[gpu].find(name);
+    size_t index;
+    if (cached != m_NameIndex[gpu].end()) {
+        index = cached->second;
+    } else {
+        std::string key = gpu ? std::string(GPU_KEY_PREFIX) + name : std::string(name);
+        auto [it, inserted] = m_StatsIndex.try_emplace(std::move(key), m_Stats.size());
+        if (inserted) {
+            ProfileStats stats;
+            stats.Name = name;
+            stats.Gpu = gpu;
+            m_Stats.push_back(std::move(stats));
+            m_History.emplace_back();
+        }
+        index = it->second;
+        m_NameIndex[gpu].emplace(name, index);
+    }
+
+    ProfileStats& stats = m_Stats[index];
+    StatsHistory& history = m_History[index];
+    if (!history.Seen) {
+        stats.LastMs = 0.0;
+        history.Seen = true;
+    }
+    stats.LastMs += milliseconds;
+    ++history.Calls;
+}
+
+void Profiler::SetCounter(const char* name, double value) {
+    for (ProfileCounter& counter : m_Counters) {
+        if (counter.Name == name) {
+            counter.Value = value;
+            return;
+        }
+    }
+    m_Counters.push_back({name, value});
+}
+
+const ProfileStats* Profiler::FindStats(const char* name, bool gpu) const {
+    std::string key = gpu ? std::string(GPU_KEY_PREFIX) + name : std::string(name);
+    auto it = m_StatsIndex.find(key);
+    return it != m_StatsIndex.end() ? &m_Stats[it->second] : nullptr;
+}
+
+std::string Profiler::FormatOverlay(size_t maxScopes) const {
+    const ProfileStats* frame = FindStats(FRAME_SCOPE);
+    if (!frame) {
+        return std::string();
+    }
+
+    std::vector<const ProfileStats*> scopes;
+    for (const ProfileStats& stats : m_Stats) {
+        if (&stats != frame) {
+            scopes.push_back(&stats);
+        }
+    }
+    size_t count = std::min(maxScopes, scopes.size());
+    std::partial_sort(scopes.begin(), scopes.begin() + count, scopes.end(),
+        [](const ProfileStats* a, const ProfileStats* b) { return a->AverageMs > b->AverageMs; });
+
+    char text[64];
+    std::snprintf(text, sizeof(text), "Frame %.2f ms (max %.2f)", frame->AverageMs, frame->MaxMs);
+    std::string overlay = text;
+    for (size_t i = 0; i < count; ++i) {
+        std::snprintf(text, sizeof(text), " | %s%s %.2f", scopes[i]->Gpu ? "GPU " : "",
+                      scopes[i]->Name.c_str(), scopes[i]->AverageMs);
+        overlay += text;
+    }
+    for (const ProfileCounter& counter : m_Counters) {
+        std::snprintf(text, sizeof(text), " | %s %g", counter.Name.c_str(), counter.Value);
+        overlay += text;
+    }
+    return overlay;
+}
+
+// -----------------------------------------------------------------------------
+// GPU queries
+// -----------------------------------------------------------------------------
+
+void Profiler::InitializeGpu() {
+    if (m_GpuReady) {
+        return;
+    }
+    for (GpuFrame& frame : m_GpuFrames) {
+        glGenQueries(MAX_GPU_SCOPES * 2, frame.Queries);
+        frame.Count = 0;
+        frame.Pending = false;
+    }
+
+    CalibrateGpuClock();
+    m_GpuReady = true;
+    NILOS_DEBUG("Profiler GPU timer queries ready (", GPU_FRAMES_IN_FLIGHT, " frames x ", MAX_GPU_SCOPES, " scopes)");
+}
+
+void Profiler::CalibrateGpuClock() {
+    // The clocks drift apart over time, so captures recalibrate
+    GLint64 gpuNow = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuNow);
+    m_GpuClockOffset = Now() - static_cast<int64_t>(gpuNow);
+}
+
+void Profiler::ShutdownGpu() {
+    if (!m_GpuReady) {
+        return;
+    }
+    for (GpuFrame& frame : m_GpuFrames) {
+        glDeleteQueries(MAX_GPU_SCOPES * 2, frame.Queries);
+        frame.Pending = false;
+    }
+    m_CurrentGpuFrame = nullptr;
+    m_GpuReady = false;
+}
+
+void Profiler::BeginGpuFrame() {
+    if (!m_GpuReady) {
+        return;
+    }
+    if (m_RecalibrateGpuClock.exchange(false, std::memory_order_relaxed)) {
+        CalibrateGpuClock();
+    }
+
+    // Reuse the oldest frame of the ring; its results are normally in by now
+    GpuFrame& frame = m_GpuFrames[m_GpuFrameIndex % GPU_FRAMES_IN_FLIGHT];
+    if (frame.Pending) {
+        ResolveGpuFrame(frame, true);
+    }
+    frame.Count = 0;
+    frame.Open = 0;
+    m_CurrentGpuFrame = IsEnabled() ? &frame : nullptr;
+}
+
+void Profiler::EndGpuFrame() {
+    if (!m_GpuReady) {
+        return;
+    }
+    if (m_CurrentGpuFrame) {
+        m_CurrentGpuFrame->Pending = m_CurrentGpuFrame->Count > 0;
+        m_CurrentGpuFrame = nullptr;
+    }
+    ++m_GpuFrameIndex;
+
+    // Results that arrived (without waiting)
+    for (GpuFrame& frame : m_GpuFrames) {
+        if (frame.Pending) {
+            ResolveGpuFrame(frame, false);
+        }
+    }
+}
+
+uint32_t Profiler::BeginGpuScope(const char* name) {
+    GpuFrame* frame = m_CurrentGpuFrame;
+    if (!frame || frame->Count == MAX_GPU_SCOPES) {
+        return INVALID_GPU_SCOPE;
+    }
+    uint32_t scope = frame->Count++;
+    frame->Names[scope] = name;
+    ++frame->Open;
+    glQueryCounter(frame->Queries[scope * 2], GL_TIMESTAMP);
+    return scope;
+}
+
+void Profiler::EndGpuScope(uint32_t scope) {
+    GpuFrame* frame = m_CurrentGpuFrame;
+    if (!frame || scope == INVALID_GPU_SCOPE) {
+        return;
+    }
+    glQueryCounter(frame->Queries[scope * 2 + 1], GL_TIMESTAMP);
+    --frame->Open;
+}
+
+void Profiler::ResolveGpuFrame(GpuFrame& frame, bool wait) {
+    frame.Pending = false;
+    if (frame.Open != 0) {
+        return;  // A scope was never closed; its queries hold nothing useful
+    }
+    if (!wait) {
+        // Queries complete in order: the last end stamp being in means all are
+        GLint available = 0;
+        glGetQueryObjectiv(frame.Queries[frame.Count * 2 - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            frame.Pending = true;
+            return;
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(m_GpuResultsMutex);
+    for (uint32_t scope = 0; scope < frame.Count; ++scope) {
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(frame.Queries[scope * 2], GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(frame.Queries[scope * 2 + 1], GL_QUERY_RESULT, &end);
+        if (end < begin) {
+            continue;
+        }
+        m_GpuResults.push_back({ frame.Names[scope], static_cast<int64_t>(begin) + m_GpuClockOffset,
+                                 static_cast<int64_t>(end) + m_GpuClockOffset });
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Capture
+// -----------------------------------------------------------------------------
+
+bool Profiler::BeginCapture(const std::string& path, uint32_t frameCount) {
+    EndCapture();
+    m_CaptureFile = std::fopen(path.c_str(), "w");
+    if (!m_CaptureFile) {
+        NILOS_ERROR("Failed to open profiler capture: ", path);
+        return false;
+    }
+    m_CaptureFramesLeft = frameCount;
+    m_CaptureFirstEvent = true;
+    std::fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n", m_CaptureFile);
+
+    // This may not be the GL thread: BeginGpuFrame recalibrates
+    m_RecalibrateGpuClock.store(true, std::memory_order_relaxed);
+    NILOS_INFO("Profiler capture started: ", path);
+    return true;
+}
+
+void Profiler::EndCapture() {
+    if (!m_CaptureFile) {
+        return;
+    }
+
+    // Thread names as metadata events; thread 0 is the GPU timeline
+    std::fprintf(m_CaptureFile, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":0,"
+                 "\"args\":{\"name\":\"GPU\"}}", m_CaptureFirstEvent ? "" : ",\n");
+    {
+        std::lock_guard<std::mutex> lock(m_ThreadsMutex);
+        for (const std::unique_ptr<ThreadBuffer>& buffer : m_Threads) {
+            std::lock_guard<std::mutex> bufferLock(buffer->Mutex);
+            std::fprintf(m_CaptureFile, ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,\"tid\":%u,"
+                         "\"args\":{\"name\":\"", buffer->Id);
+            WriteEscaped(m_CaptureFile, buffer->Name.c_str());
+            std::fputs("\"}}", m_CaptureFile);
+        }
+    }
+    std::fputs("\n]}\n", m_CaptureFile);
+    std::fclose(m_CaptureFile);
+    m_CaptureFile = nullptr;
+    NILOS_INFO("Profiler capture written (", m_FrameIndex, " frames profiled so far)");
+}
+
+void Profiler::WriteCaptureEvent(const char* name, uint32_t threadId, int64_t begin, int64_t end) {
+    // Complete events; timestamps in microseconds with nanosecond decimals
+    std::fputs(m_CaptureFirstEvent ? "{\"name\":\"" : ",\n{\"name\":\"", m_CaptureFile);
+    m_CaptureFirstEvent = false;
+    WriteEscaped(m_CaptureFile, name);
+    std::fprintf(m_CaptureFile, "\",\"ph\":\"X\",\"pid\":0,\"tid\":%u,\"ts\":%" PRId64 ".%03d,\"dur\":%" PRId64 ".%03d}",
+                 threadId, begin / 1000, static_cast<int>(begin % 1000),
+                 (end - begin) / 1000, static_cast<int>((end - begin) % 1000));
+}
+
+void Profiler::WriteCaptureCounter(const ProfileCounter& counter, int64_t time) {
+    std::fputs(m_CaptureFirstEvent ? "{\"name\":\"" : ",\n{\"name\":\"", m_CaptureFile);
+    m_CaptureFirstEvent = false;
+    WriteEscaped(m_CaptureFile, counter.Name.c_str());
+    std::fprintf(m_CaptureFile, "\",\"ph\":\"C\",\"pid\":0,\"ts\":%" PRId64 ".%03d,\"args\":{\"value\":%g}}",
+                 time / 1000, static_cast<int>(time % 1000), counter.Value);
+}
+
+} // namespace Nilos
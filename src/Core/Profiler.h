@@ -0,0 +1,320 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Set to 0 to compile every profiling macro out
+ */
+#ifndef NILOS_ENABLE_PROFILER
+#define NILOS_ENABLE_PROFILER 1
+#endif
+
+namespace Nilos {
+
+/**
+ * @brief Rolling statistics of one profiled scope
+ */
+struct ProfileStats {
+    std::string Name;
+    bool Gpu = false;
+    double AverageMs = 0.0;  // Per frame (all calls summed), over the stats window
+    double MaxMs = 0.0;
+    double LastMs = 0.0;
+    uint32_t CallsPerFrame = 0;  // In the last frame
+};
+
+/**
+ * @brief A value reported once per frame (allocation counts, memory use, ...)
+ */
+struct ProfileCounter {
+    std::string Name;
+    double Value = 0.0;
+};
+
+/**
+ * @brief Hierarchical CPU/GPU frame profiler
+ *
+ * CPU scopes (NILOS_PROFILE_SCOPE) take two steady-clock timestamps
+ * (nanoseconds) and append one record to a buffer owned by the calling
+ * thread, so any thread, job system workers included, can profile
+ * without contending. GPU scopes (NILOS_PROFILE_GPU_SCOPE) write
+ * GL_TIMESTAMP queries into a ring a few frames deep and are read back
+ * once the GPU is done with them, so they never stall the pipeline.
+ * They belong to the thread that owns the GL context, which brackets its
+ * frames with BeginGpuFrame/EndGpuFrame. Nesting comes from the
+ * timestamps alone.
+ *
+ * EndFrame (main thread, once per frame) collects every thread's
+ * records, updates rolling per-scope statistics over the last
+ * STATS_WINDOW frames (for an on-screen overlay, see FormatOverlay) and,
+ * while capturing, streams them to a Chrome trace file (chrome://tracing,
+ * Perfetto, or Tracy through its import-chrome tool).
+ *
+ * Scope names must outlive the profiler (string literals).
+ *
+ * Usage:
+ *   void PhysicsWorld::Update(float dt) {
+ *       NILOS_PROFILE_SCOPE("Physics");
+ *       ...
+ *   }
+ *   Profiler::Get().BeginCapture("trace.json", 300);  // Next 300 frames
+ */
+class Profiler {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    static constexpr uint32_t STATS_WINDOW = 120;        // Frames averaged by the stats
+    static constexpr uint32_t GPU_FRAMES_IN_FLIGHT = 4;  // Query ring depth
+    static constexpr uint32_t MAX_GPU_SCOPES = 32;       // Per frame
+    static constexpr uint32_t INVALID_GPU_SCOPE = UINT32_MAX;
+
+    static Profiler& Get() {
+        static Profiler instance;
+        return instance;
+    }
+
+    ~Profiler();
+
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+
+    /**
+     * @brief Timestamp in nanoseconds (steady clock)
+     */
+    static int64_t Now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now().time_since_epoch()).count();
+    }
+
+    /**
+     * @brief Turn recording on or off (on by default); scopes cost one flag check while off
+     */
+    void SetEnabled(bool enabled) { m_Enabled.store(enabled, std::memory_order_relaxed); }
+    bool IsEnabled() const { return m_Enabled.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Name the calling thread in captures
+     */
+    void SetThreadName(const char* name);
+
+    /**
+     * @brief Frame boundaries (main thread)
+     */
+    void BeginFrame();
+    void EndFrame();
+
+    /**
+     * @brief Append a finished CPU scope to the calling thread's buffer
+     */
+    void RecordScope(const char* name, int64_t begin, int64_t end);
+
+    /**
+     * @brief Report a per-frame value (main thread); shown in the overlay and as a counter track in captures
+     */
+    void SetCounter(const char* name, double value);
+    const std::vector<ProfileCounter>& GetCounters() const { return m_Counters; }
+
+    /**
+     * @brief Create the GPU query ring (needs a current GL context)
+     */
+    void InitializeGpu();
+    void ShutdownGpu();
+
+    /**
+     * @brief GPU frame boundaries around the frame's GL commands (GL thread)
+     *
+     * Separate from BeginFrame/EndFrame so the GL work may run on a render
+     * thread; results are handed over and land in the next EndFrame.
+     */
+    void BeginGpuFrame();
+    void EndGpuFrame();
+
+    /**
+     * @brief Start a GPU scope (GL thread only)
+     * @return Handle for EndGpuScope, INVALID_GPU_SCOPE if unavailable or the frame is full
+     */
+    uint32_t BeginGpuScope(const char* name);
+    void EndGpuScope(uint32_t scope);
+
+    /**
+     * @brief Stream the next frames to a Chrome trace JSON file
+     *
+     * Main thread only (the thread calling EndFrame), as is EndCapture; the
+     * GPU clock is recalibrated at the start of the next GPU frame.
+     * @param frameCount Frames to capture, 0 until EndCapture
+     * @return False if the file could not be opened
+     */
+    bool BeginCapture(const std::string& path, uint32_t frameCount = 0);
+    void EndCapture();
+    bool IsCapturing() const { return m_CaptureFile != nullptr; }
+
+    /**
+     * @brief Rolling statistics, frame first, then CPU and GPU scopes by first appearance
+     */
+    const std::vector<ProfileStats>& GetStats() const { return m_Stats; }
+
+    /**
+     * @brief Statistics of one scope (nullptr if never seen)
+     */
+    const ProfileStats* FindStats(const char* name, bool gpu = false) const;
+
+    /**
+     * @brief One line summary for an overlay: frame time, then the costliest scopes
+     */
+    std::string FormatOverlay(size_t maxScopes = 4) const;
+
+    uint64_t GetFrameIndex() const { return m_FrameIndex; }
+
+private:
+    Profiler();
+
+    struct Record {
+        const char* Name;
+        int64_t Begin;
+        int64_t End;
+    };
+
+    /**
+     * @brief Records of one thread since the last EndFrame
+     */
+    struct ThreadBuffer {
+        std::mutex Mutex;  // Shared only with EndFrame
+        std::vector<Record> Records;
+        std::string Name;
+        uint32_t Id = 0;
+    };
+
+    /**
+     * @brief A resolved GPU scope waiting for EndFrame, on the CPU timeline
+     */
+    struct GpuResult {
+        const char* Name;
+        int64_t Begin;
+        int64_t End;
+    };
+
+    struct GpuFrame {
+        uint32_t Queries[MAX_GPU_SCOPES * 2] = {};
+        const char* Names[MAX_GPU_SCOPES] = {};
+        uint32_t Count = 0;
+        uint32_t Open = 0;
+        bool Pending = false;  // Issued and not read back yet
+    };
+
+    struct StatsHistory {
+        double Samples[STATS_WINDOW] = {};
+        uint32_t Calls = 0;
+        bool Seen = false;  // Recorded this frame
+    };
+
+    ThreadBuffer& GetThreadBuffer();
+
+    /**
+     * @brief Read back a GPU frame's queries if the GPU has finished them
+     * @param wait Block for the results instead of giving up
+     */
+    void ResolveGpuFrame(GpuFrame& frame, bool wait);
+
+    /**
+     * @brief Map GPU timestamps onto the CPU timeline (GL thread)
+     */
+    void CalibrateGpuClock();
+
+    /**
+     * @brief Sum a finished scope into this frame's statistics
+     */
+    void Accumulate(const char* name, bool gpu, double milliseconds);
+
+    void WriteCaptureEvent(const char* name, uint32_t threadId, int64_t begin, int64_t end);
+    void WriteCaptureCounter(const ProfileCounter& counter, int64_t time);
+
+    std::atomic<bool> m_Enabled{true};
+    uint64_t m_FrameIndex = 0;
+    int64_t m_FrameBegin = 0;
+
+    std::mutex m_ThreadsMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> m_Threads;
+    std::vector<Record> m_Collected;  // EndFrame scratch
+    std::vector<uint32_t> m_CollectedThreads;  // Thread ID per collected record, while capturing
+
+    bool m_GpuReady = false;
+    GpuFrame m_GpuFrames[GPU_FRAMES_IN_FLIGHT];
+    GpuFrame* m_CurrentGpuFrame = nullptr;
+    uint64_t m_GpuFrameIndex = 0;
+    int64_t m_GpuClockOffset = 0;  // CPU time minus GPU time, nanoseconds (GL thread)
+    std::atomic<bool> m_RecalibrateGpuClock{false};  // Set by BeginCapture, handled in BeginGpuFrame
+    std::mutex m_GpuResultsMutex;
+    std::vector<GpuResult> m_GpuResults;    // Resolved on the GL thread, taken by EndFrame
+    std::vector<GpuResult> m_GpuCollected;  // EndFrame scratch
+
+    std::vector<ProfileStats> m_Stats;
+    std::vector<StatsHistory> m_History;  // Parallel to m_Stats
+    std::unordered_map<std::string, size_t> m_StatsIndex;  // Name (with a GPU prefix) -> index
+    std::unordered_map<const char*, size_t> m_NameIndex[2];  // Same by name pointer (CPU, GPU), no string built
+    uint32_t m_HistoryCursor = 0;
+    uint32_t m_HistoryCount = 0;
+    std::vector<ProfileCounter> m_Counters;
+
+    FILE* m_CaptureFile = nullptr;
+    uint32_t m_CaptureFramesLeft = 0;
+    bool m_CaptureFirstEvent = true;
+};
+
+/**
+ * @brief Records the enclosing scope's duration on destruction
+ */
+class ProfileScope {
+public:
+    explicit ProfileScope(const char* name)
+        : m_Name(name), m_Begin(Profiler::Get().IsEnabled() ? Profiler::Now() : 0) {}
+
+    ~ProfileScope() {
+        if (m_Begin != 0) {
+            Profiler::Get().RecordScope(m_Name, m_Begin, Profiler::Now());
+        }
+    }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    const char* m_Name;
+    int64_t m_Begin;
+};
+
+/**
+ * @brief GPU timestamps around the enclosing scope's GL commands
+ */
+class GpuProfileScope {
+public:
+    explicit GpuProfileScope(const char* name) : m_Scope(Profiler::Get().BeginGpuScope(name)) {}
+    ~GpuProfileScope() { Profiler::Get().EndGpuScope(m_Scope); }
+
+    GpuProfileScope(const GpuProfileScope&) = delete;
+    GpuProfileScope& operator=(const GpuProfileScope&) = delete;
+
+private:
+    uint32_t m_Scope;
+};
+
+#define NILOS_PROFILE_CONCAT_INNER(a, b) a##b
+#define NILOS_PROFILE_CONCAT(a, b) NILOS_PROFILE_CONCAT_INNER(a, b)
+
+#if NILOS_ENABLE_PROFILER
+#define NILOS_PROFILE_SCOPE(name) ::Nilos::ProfileScope NILOS_PROFILE_CONCAT(profileScope_, __LINE__)(name)
+#define NILOS_PROFILE_GPU_SCOPE(name) ::Nilos::GpuProfileScope NILOS_PROFILE_CONCAT(gpuProfileScope_, __LINE__)(name)
+#define NILOS_PROFILE_FUNCTION() NILOS_PROFILE_SCOPE(__func__)
+#else
+#define NILOS_PROFILE_SCOPE(name) do {} while (0)
+#define NILOS_PROFILE_GPU_SCOPE(name) do {} while (0)
+#define NILOS_PROFILE_FUNCTION() do {} while (0)
+#endif
+
+} // namespace Nilos
@@ -0,0 +1,179 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <new>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define NILOS_SIMD_SSE 1
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+    #include <arm_neon.h>
+    #define NILOS_SIMD_NEON 1
+#else
+    #define NILOS_SIMD_SCALAR 1
+#endif
+
+namespace Nilos {
+
+/**
+ * @brief Minimal 4-wide float SIMD layer
+ *
+ * Maps to SSE2 on x86-64 (always available there, no extra compiler flags),
+ * NEON on ARM and plain scalar code elsewhere, so kernels are written once:
+ *
+ *   for (size_t i = 0; i < count; i += SIMD::WIDTH) {
+ *       SIMD::Float4 v = SIMD::Load(velocity + i);
+ *       SIMD::Store(position + i, SIMD::MulAdd(v, dt, SIMD::Load(position + i)));
+ *   }
+ *
+ * Load/Store require SIMD::ALIGNMENT aligned pointers (use AlignedAllocator)
+ * and arrays padded to a multiple of WIDTH.
+ */
+namespace SIMD {
+
+constexpr size_t WIDTH = 4;
+constexpr size_t ALIGNMENT = 16;
+
+/**
+ * @brief Round count up to a multiple of WIDTH
+ */
+constexpr size_t PadToWidth(size_t count) {
+    return (count + WIDTH - 1) & ~(WIDTH - 1);
+}
+
+#if defined(NILOS_SIMD_SSE)
+
+struct Float4 { __m128 V; };
+
+inline Float4 Load(const float* p) { return { _mm_load_ps(p) }; }
+inline void Store(float* p, Float4 a) { _mm_store_ps(p, a.V); }
+inline Float4 Set1(float s) { return { _mm_set1_ps(s) }; }
+inline Float4 Set(float x, float y, float z, float w) { return { _mm_setr_ps(x, y, z, w) }; }
+inline Float4 Add(Float4 a, Float4 b) { return { _mm_add_ps(a.V, b.V) }; }
+inline Float4 Sub(Float4 a, Float4 b) { return { _mm_sub_ps(a.V, b.V) }; }
+inline Float4 Mul(Float4 a, Float4 b) { return { _mm_mul_ps(a.V, b.V) }; }
+inline Float4 Div(Float4 a, Float4 b) { return { _mm_div_ps(a.V, b.V) }; }
+inline Float4 Min(Float4 a, Float4 b) { return { _mm_min_ps(a.V, b.V) }; }
+inline Float4 Max(Float4 a, Float4 b) { return { _mm_max_ps(a.V, b.V) }; }
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return Add(Mul(a, b), c); }
+
+/**
+ * @brief Lane-wise a <= b, as a 4-bit mask (bit i = lane i)
+ */
+inline int LessEqualMask(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmple_ps(a.V, b.V)); }
+
+/**
+ * @brief Lane-wise a < b, as a 4-bit mask (bit i = lane i)
+ */
+inline int LessMask(Float4 a, Float4 b) { return _mm_movemask_ps(_mm_cmplt_ps(a.V, b.V)); }
+
+#elif defined(NILOS_SIMD_NEON)
+
+struct Float4 { float32x4_t V; };
+
+inline Float4 Load(const float* p) { return { vld1q_f32(p) }; }
+inline void Store(float* p, Float4 a) { vst1q_f32(p, a.V); }
+inline Float4 Set1(float s) { return { vdupq_n_f32(s) }; }
+inline Float4 Set(float x, float y, float z, float w) {
+    alignas(16) float values[4] = { x, y, z, w };
+    return { vld1q_f32(values) };
+}
+inline Float4 Add(Float4 a, Float4 b) { return { vaddq_f32(a.V, b.V) }; }
+inline Float4 Sub(Float4 a, Float4 b) { return { vsubq_f32(a.V, b.V) }; }
+inline Float4 Mul(Float4 a, Float4 b) { return { vmulq_f32(a.V, b.V) }; }
+inline Float4 Div(Float4 a, Float4 b) {
+    // Two Newton-Raphson steps on the reciprocal estimate
+    float32x4_t r = vrecpeq_f32(b.V);
+    r = vmulq_f32(vrecpsq_f32(b.V, r), r);
+    r = vmulq_f32(vrecpsq_f32(b.V, r), r);
+    return { vmulq_f32(a.V, r) };
+}
+inline Float4 Min(Float4 a, Float4 b) { return { vminq_f32(a.V, b.V) }; }
+inline Float4 Max(Float4 a, Float4 b) { return { vmaxq_f32(a.V, b.V) }; }
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return { vmlaq_f32(c.V, a.V, b.V) }; }
+
+inline int LessEqualMask(Float4 a, Float4 b) {
+    uint32x4_t cmp = vcleq_f32(a.V, b.V);
+    return (vgetq_lane_u32(cmp, 0) & 1) | (vgetq_lane_u32(cmp, 1) & 2) |
+           (vgetq_lane_u32(cmp, 2) & 4) | (vgetq_lane_u32(cmp, 3) & 8);
+}
+
+inline int LessMask(Float4 a, Float4 b) {
+    uint32x4_t cmp = vcltq_f32(a.V, b.V);
+    return (vgetq_lane_u32(cmp, 0) & 1) | (vgetq_lane_u32(cmp, 1) & 2) |
+           (vgetq_lane_u32(cmp, 2) & 4) | (vgetq_lane_u32(cmp, 3) & 8);
+}
+
+#else
+
+struct Float4 { float V[4]; };
+
+inline Float4 Load(const float* p) { return { { p[0], p[1], p[2], p[3] } }; }
+inline void Store(float* p, Float4 a) { for (int i = 0; i < 4; ++i) p[i] = a.V[i]; }
+inline Float4 Set1(float s) { return { { s, s, s, s } }; }
+inline Float4 Set(float x, float y, float z, float w) { return { { x, y, z, w } }; }
+
+#define NILOS_SIMD_SCALAR_OP(name, expr) \
+    inline Float4 name(Float4 a, Float4 b) { \
+        Float4 r; \
+        for (int i = 0; i < 4; ++i) { float x = a.V[i], y = b.V[i]; r.V[i] = (expr); } \
+        return r; \
+    }
+NILOS_SIMD_SCALAR_OP(Add, x + y)
+NILOS_SIMD_SCALAR_OP(Sub, x - y)
+NILOS_SIMD_SCALAR_OP(Mul, x * y)
+NILOS_SIMD_SCALAR_OP(Div, x / y)
+NILOS_SIMD_SCALAR_OP(Min, x < y ? x : y)
+NILOS_SIMD_SCALAR_OP(Max, x > y ? x : y)
+#undef NILOS_SIMD_SCALAR_OP
+
+inline Float4 MulAdd(Float4 a, Float4 b, Float4 c) { return Add(Mul(a, b), c); }
+
+inline int LessEqualMask(Float4 a, Float4 b) {
+    int mask = 0;
+    for (int i = 0; i < 4; ++i) mask |= (a.V[i] <= b.V[i]) ? (1 << i) : 0;
+    return mask;
+}
+
+inline int LessMask(Float4 a, Float4 b) {
+    int mask = 0;
+    for (int i = 0; i < 4; ++i) mask |= (a.V[i] < b.V[i]) ? (1 << i) : 0;
+    return mask;
+}
+
+#endif
+
+} // namespace SIMD
+
+/**
+ * @brief std::allocator replacement returning over-aligned memory
+ *
+ * Used for SIMD arrays: std::vector<float, AlignedAllocator<float>>.
+ */
+template<typename T, size_t Alignment = SIMD::ALIGNMENT>
+struct AlignedAllocator {
+    using value_type = T;
+
+    template<typename U>
+    struct rebind { using other = AlignedAllocator<U, Alignment>; };
+
+    AlignedAllocator() = default;
+    template<typename U>
+    AlignedAllocator(const AlignedAllocator<U, Alignment>&) {}
+
+    T* allocate(size_t count) {
+        return static_cast<T*>(::operator new(count * sizeof(T), std::align_val_t(Alignment)));
+    }
+
+    void deallocate(T* p, size_t) {
+        ::operator delete(p, std::align_val_t(Alignment));
+    }
+
+    template<typename U>
+    bool operator==(const AlignedAllocator<U, Alignment>&) const { return true; }
+    template<typename U>
+    bool operator!=(const AlignedAllocator<U, Alignment>&) const { return false; }
+};
+
+} // namespace Nilos
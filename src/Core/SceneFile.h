@@ -0,0 +1,62 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Nilos {
+
+/**
+ * @brief On-disk layout of scene snapshots (.nscene)
+ *
+ * Written and read by SceneSerializer. Each component pool is stored as
+ * its dense array, so loading copies it into the world's pool with one
+ * memcpy:
+ *
+ *   SceneFile::Header
+ *   Entity handles[EntityCount]      at EntityOffset (as they were when saved)
+ *   SceneFile::Pool[PoolCount]       at PoolTableOffset
+ *   per pool:
+ *     uint32_t owners[Count]         at OwnerOffset (indices into the entity table)
+ *     records[Count]                 at DataOffset (RecordSize bytes each)
+ *   names: NameCount x { uint32_t entity index, uint32_t length, chars }  at NameOffset
+ *
+ * Everything is little-endian and section offsets are multiples of
+ * ALIGNMENT. Pools are identified by the name their component type was
+ * registered under; a pool whose RecordSize no longer matches is skipped.
+ * Bump VERSION whenever this layout changes; older files are rejected.
+ */
+namespace SceneFile {
+
+constexpr uint32_t MAGIC = 0x4E43534E; // "NSCN"
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t ALIGNMENT = 16;
+constexpr uint32_t MAX_NAME_LENGTH = 31;
+
+struct Header {
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t EntityCount;
+    uint32_t PoolCount;
+    uint32_t NameCount;
+    uint32_t Reserved;
+    uint64_t EntityOffset;
+    uint64_t PoolTableOffset;
+    uint64_t NameOffset;
+    uint64_t FileSize;
+};
+static_assert(sizeof(Header) == 56, "SceneFile::Header layout changed; bump VERSION");
+
+/**
+ * @brief One component pool
+ */
+struct Pool {
+    char Name[MAX_NAME_LENGTH + 1];  // Registered type name, zero-terminated
+    uint32_t RecordSize;
+    uint32_t Count;
+    uint64_t OwnerOffset;
+    uint64_t DataOffset;
+};
+static_assert(sizeof(Pool) == 56, "SceneFile::Pool layout changed; bump VERSION");
+
+} // namespace SceneFile
+
+} // namespace Nilos
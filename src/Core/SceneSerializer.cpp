@@ -0,0 +1,397 @@
+#include "SceneSerializer.h"
+#include "Logger.h"
+#include "MappedFile.h"
+#include "Profiler.h"
+#include "../Rendering/MeshManager.h"
+
+#include <fstream>
+
+namespace Nilos {
+
+namespace {
+
+uint64_t AlignUp(uint64_t value) {
+    return (value + SceneFile::ALIGNMENT - 1) & ~static_cast<uint64_t>(SceneFile::ALIGNMENT - 1);
+}
+
+/**
+ * @brief Check that [offset, offset + bytes) lies inside a buffer of size bytes
+ */
+bool InBounds(uint64_t offset, uint64_t bytes, size_t size) {
+    return offset <= size && bytes <= size - offset;
+}
+
+void RemapTransform(TransformComponent& transform, const EntityRemap& entities) {
+    transform.Parent = entities.Map(transform.Parent);
+    transform.CachedParent = entities.Map(transform.CachedParent);
+}
+
+void RemapAgent(AIAgentComponent& agent, const EntityRemap& entities) {
+    agent.PerceivedEntity = entities.Map(agent.PerceivedEntity);
+}
+
+/**
+ * @brief MeshComponent as saved: its shared asset by content hash plus the plain fields
+ */
+struct MeshRecord {
+    uint64_t MeshHash;  // MeshAsset::Hash, 0 if the component has no shared asset
+    float Color[3];
+    uint32_t MaterialID;
+    float BoundsCenter[3];
+    float BoundsExtents[3];
+    uint32_t LayoutMask;
+    uint32_t Flags;
+};
+static_assert(sizeof(MeshRecord) == 56, "MeshRecord layout changed; bump SceneFile::VERSION");
+
+constexpr uint32_t MESH_HAS_BOUNDS = 1u << 0;
+constexpr uint32_t MESH_KEEP_CPU_DATA = 1u << 1;
+
+void SaveMesh(const MeshComponent& mesh, MeshRecord& record) {
+    const MeshAsset* asset = MeshManager::Get().GetMesh(mesh.Mesh);
+    record.MeshHash = asset ? asset->Hash : 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        record.Color[axis] = mesh.Color[axis];
+        record.BoundsCenter[axis] = mesh.BoundsCenter[axis];
+        record.BoundsExtents[axis] = mesh.BoundsExtents[axis];
+    }
+    record.MaterialID = mesh.MaterialID;
+    record.LayoutMask = mesh.Layout.Mask;
+    record.Flags = (mesh.HasBounds ? MESH_HAS_BOUNDS : 0u) | (mesh.KeepCPUData ? MESH_KEEP_CPU_DATA : 0u);
+}
+
+void LoadMesh(const MeshRecord& record, MeshComponent& mesh, const EntityRemap&) {
+    // Unknown hashes (asset not loaded) leave the mesh empty; it is not drawn
+    mesh.Mesh = record.MeshHash ? MeshManager::Get().FindByHash(record.MeshHash) : NULL_MESH;
+    for (int axis = 0; axis < 3; ++axis) {
+        mesh.Color[axis] = record.Color[axis];
+        mesh.BoundsCenter[axis] = record.BoundsCenter[axis];
+        mesh.BoundsExtents[axis] = record.BoundsExtents[axis];
+    }
+    mesh.MaterialID = record.MaterialID;
+    mesh.Layout.Mask = static_cast<uint8_t>(record.LayoutMask);
+    mesh.HasBounds = (record.Flags & MESH_HAS_BOUNDS) != 0;
+    mesh.KeepCPUData = (record.Flags & MESH_KEEP_CPU_DATA) != 0;
+}
+
+} // namespace
+
+SceneSerializer::SceneSerializer() {
+    RegisterComponent<TransformComponent>("Transform", &RemapTransform);
+    RegisterComponent<CameraComponent>("Camera");
+    RegisterComponent<RigidbodyComponent>("Rigidbody");
+    RegisterComponent<ColliderComponent>("Collider");
+    RegisterComponent<AIAgentComponent>("AIAgent", &RemapAgent);
+    RegisterComponent<MeshComponent, MeshRecord>("Mesh", &SaveMesh, &LoadMesh);
+}
+
+void SceneSerializer::AddType(ComponentType type) {
+    if (type.Name.empty() || type.Name.size() > SceneFile::MAX_NAME_LENGTH) {
+        NILOS_ERROR("Scene component name must have 1 to ", SceneFile::MAX_NAME_LENGTH, " characters: '",
+                    type.Name, "'");
+        return;
+    }
+    if (FindType(type.Name.c_str())) {
+        NILOS_ERROR("Scene component '", type.Name, "' registered twice");
+        return;
+    }
+    m_Types.push_back(std::move(type));
+}
+
+const SceneSerializer::ComponentType* SceneSerializer::FindType(const char* name) const {
+    for (const ComponentType& type : m_Types) {
+        if (type.Name == name) {
+            return &type;
+        }
+    }
+    return nullptr;
+}
+
+// -----------------------------------------------------------------------------
+// Save
+// -----------------------------------------------------------------------------
+
+bool SceneSerializer::Save(World& world, const std::string& filepath) {
+    std::vector<uint8_t> bytes;
+    if (!SaveToMemory(world, bytes)) {
+        return false;
+    }
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        NILOS_ERROR("Failed to open for writing: ", filepath);
+        return false;
+    }
+    file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+    if (!file.good()) {
+        NILOS_ERROR("Failed to write scene: ", filepath);
+        return false;
+    }
+
+    NILOS_INFO("Scene saved: ", filepath, " (", m_Saved.size(), " entities, ", bytes.size() / 1024, " KB)");
+    return true;
+}
+
+bool SceneSerializer::SaveToMemory(World& world, std::vector<uint8_t>& bytes) {
+    NILOS_PROFILE_FUNCTION();
+
+    // Saved entities: owners of any registered component, in slot order
+    m_SlotEntities.clear();
+    for (const ComponentType& type : m_Types) {
+        if (const std::vector<Entity>* owners = type.GetOwners(world)) {
+            for (Entity entity : *owners) {
+                uint32_t slot = GetEntityIndex(entity);
+                if (slot >= m_SlotEntities.size()) {
+                    m_SlotEntities.resize(static_cast<size_t>(slot) + 1, NULL_ENTITY);
+                }
+                m_SlotEntities[slot] = entity;
+            }
+        }
+    }
+
+    std::vector<uint32_t>& fileIndexBySlot = m_Remap.m_FileIndexBySlot;
+    fileIndexBySlot.assign(m_SlotEntities.size(), EntityRemap::INVALID_INDEX);
+    m_Saved.clear();
+    for (size_t slot = 0; slot < m_SlotEntities.size(); ++slot) {
+        if (m_SlotEntities[slot] != NULL_ENTITY) {
+            fileIndexBySlot[slot] = static_cast<uint32_t>(m_Saved.size());
+            m_Saved.push_back(m_SlotEntities[slot]);
+        }
+    }
+
+    // Layout: header, entity table, pool table, then each pool's owners and records
+    SceneFile::Header header = {};
+    header.Magic = SceneFile::MAGIC;
+    header.Version = SceneFile::VERSION;
+    header.EntityCount = static_cast<uint32_t>(m_Saved.size());
+    header.EntityOffset = AlignUp(sizeof(header));
+    header.PoolTableOffset = AlignUp(header.EntityOffset + m_Saved.size() * sizeof(Entity));
+
+    std::vector<SceneFile::Pool> pools;
+    std::vector<const ComponentType*> poolTypes;
+    for (const ComponentType& type : m_Types) {
+        const std::vector<Entity>* owners = type.GetOwners(world);
+        if (owners && !owners->empty()) {
+            SceneFile::Pool pool = {};
+            std::memcpy(pool.Name, type.Name.c_str(), type.Name.size());
+            pool.RecordSize = type.RecordSize;
+            pool.Count = static_cast<uint32_t>(owners->size());
+            pools.push_back(pool);
+            poolTypes.push_back(&type);
+        }
+    }
+    header.PoolCount = static_cast<uint32_t>(pools.size());
+
+    uint64_t offset = AlignUp(header.PoolTableOffset + pools.size() * sizeof(SceneFile::Pool));
+    for (SceneFile::Pool& pool : pools) {
+        pool.OwnerOffset = offset;
+        pool.DataOffset = AlignUp(pool.OwnerOffset + uint64_t(pool.Count) * sizeof(uint32_t));
+        offset = AlignUp(pool.DataOffset + uint64_t(pool.Count) * pool.RecordSize);
+    }
+
+    header.NameOffset = offset;
+    for (Entity entity : m_Saved) {
+        if (const std::string* name = world.FindEntityName(entity)) {
+            offset += 2 * sizeof(uint32_t) + name->size();
+            ++header.NameCount;
+        }
+    }
+    header.FileSize = offset;
+
+    bytes.assign(static_cast<size_t>(header.FileSize), 0);
+    uint8_t* out = bytes.data();
+    std::memcpy(out, &header, sizeof(header));
+    std::memcpy(out + header.EntityOffset, m_Saved.data(), m_Saved.size() * sizeof(Entity));
+    std::memcpy(out + header.PoolTableOffset, pools.data(), pools.size() * sizeof(SceneFile::Pool));
+
+    for (size_t i = 0; i < pools.size(); ++i) {
+        const std::vector<Entity>& owners = *poolTypes[i]->GetOwners(world);
+        uint8_t* ownerData = out + pools[i].OwnerOffset;
+        for (size_t j = 0; j < owners.size(); ++j) {
+            uint32_t index = fileIndexBySlot[GetEntityIndex(owners[j])];
+            std::memcpy(ownerData + j * sizeof(uint32_t), &index, sizeof(index));
+        }
+        poolTypes[i]->Write(world, out + pools[i].DataOffset);
+    }
+
+    uint8_t* names = out + header.NameOffset;
+    for (size_t i = 0; i < m_Saved.size(); ++i) {
+        if (const std::string* name = world.FindEntityName(m_Saved[i])) {
+            uint32_t entry[2] = { static_cast<uint32_t>(i), static_cast<uint32_t>(name->size()) };
+            std::memcpy(names, entry, sizeof(entry));
+            std::memcpy(names + sizeof(entry), name->data(), name->size());
+            names += sizeof(entry) + name->size();
+        }
+    }
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// Load
+// -----------------------------------------------------------------------------
+
+bool SceneSerializer::Load(World& world, const std::string& filepath, std::vector<Entity>* created) {
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        NILOS_ERROR("Failed to open scene: ", filepath);
+        return false;
+    }
+    if (!LoadFromMemory(world, file.GetData(), file.GetSize(), created)) {
+        NILOS_ERROR("Failed to load scene: ", filepath);
+        return false;
+    }
+
+    NILOS_INFO("Scene loaded: ", filepath, " (", m_Created.size(), " entities)");
+    return true;
+}
+
+bool SceneSerializer::LoadFromMemory(World& world, const uint8_t* data, size_t size, std::vector<Entity>* created) {
+    NILOS_PROFILE_FUNCTION();
+
+    if (reinterpret_cast<uintptr_t>(data) % SceneFile::ALIGNMENT != 0) {
+        NILOS_ERROR("Scene data must be ", SceneFile::ALIGNMENT, "-byte aligned");
+        return false;
+    }
+
+    SceneFile::Header header;
+    if (size < sizeof(header)) {
+        NILOS_ERROR("Not a scene snapshot (too small)");
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (header.Magic != SceneFile::MAGIC) {
+        NILOS_ERROR("Not a scene snapshot (bad magic)");
+        return false;
+    }
+    if (header.Version != SceneFile::VERSION) {
+        NILOS_ERROR("Scene snapshot version ", header.Version, " is not supported (expected ",
+                    SceneFile::VERSION, "), save it again");
+        return false;
+    }
+
+    // Validate every section before touching the world
+    uint64_t entityBytes = uint64_t(header.EntityCount) * sizeof(Entity);
+    uint64_t poolBytes = uint64_t(header.PoolCount) * sizeof(SceneFile::Pool);
+    if (header.FileSize > size || header.EntityOffset % SceneFile::ALIGNMENT != 0 ||
+        header.PoolTableOffset % SceneFile::ALIGNMENT != 0 ||
+        !InBounds(header.EntityOffset, entityBytes, size) || !InBounds(header.PoolTableOffset, poolBytes, size)) {
+        NILOS_ERROR("Scene snapshot is truncated or corrupt");
+        return false;
+    }
+
+    const Entity* saved = reinterpret_cast<const Entity*>(data + header.EntityOffset);
+    const SceneFile::Pool* pools = reinterpret_cast<const SceneFile::Pool*>(data + header.PoolTableOffset);
+    m_OwnerSeen.assign(header.EntityCount, 0);
+    for (uint32_t i = 0; i < header.PoolCount; ++i) {
+        const SceneFile::Pool& pool = pools[i];
+        bool valid = pool.Name[SceneFile::MAX_NAME_LENGTH] == '\0' && pool.DataOffset % SceneFile::ALIGNMENT == 0 &&
+                     InBounds(pool.OwnerOffset, uint64_t(pool.Count) * sizeof(uint32_t), size) &&
+                     InBounds(pool.DataOffset, uint64_t(pool.Count) * pool.RecordSize, size);
+        // Owners must be in range and unique: a pool holds one component per entity
+        uint32_t checked = 0;
+        for (; valid && checked < pool.Count; ++checked) {
+            uint32_t owner;
+            std::memcpy(&owner, data + pool.OwnerOffset + checked * sizeof(uint32_t), sizeof(owner));
+            valid = owner < header.EntityCount && !m_OwnerSeen[owner];
+            if (valid) {
+                m_OwnerSeen[owner] = 1;
+            }
+        }
+        for (uint32_t j = 0; j < checked; ++j) {
+            uint32_t owner;
+            std::memcpy(&owner, data + pool.OwnerOffset + j * sizeof(uint32_t), sizeof(owner));
+            if (owner < header.EntityCount) {
+                m_OwnerSeen[owner] = 0;
+            }
+        }
+        for (uint32_t j = 0; valid && j < i; ++j) {
+            valid = std::strncmp(pool.Name, pools[j].Name, sizeof(pool.Name)) != 0;
+        }
+        if (!valid) {
+            NILOS_ERROR("Scene snapshot pool ", i, " is corrupt");
+            return false;
+        }
+    }
+
+    uint64_t nameOffset = header.NameOffset;
+    for (uint32_t i = 0; i < header.NameCount; ++i) {
+        uint32_t entry[2];
+        if (!InBounds(nameOffset, sizeof(entry), size)) {
+            NILOS_ERROR("Scene snapshot names are corrupt");
+            return false;
+        }
+        std::memcpy(entry, data + nameOffset, sizeof(entry));
+        nameOffset += sizeof(entry);
+        if (entry[0] >= header.EntityCount || !InBounds(nameOffset, entry[1], size)) {
+            NILOS_ERROR("Scene snapshot names are corrupt");
+            return false;
+        }
+        nameOffset += entry[1];
+    }
+
+    // Entities
+    m_Created.resize(header.EntityCount);
+    size_t createdCount = world.CreateEntities(m_Created.size(), m_Created.data());
+    if (createdCount < m_Created.size()) {
+        for (size_t i = 0; i < createdCount; ++i) {
+            world.DestroyEntity(m_Created[i]);
+        }
+        m_Created.clear();
+        NILOS_ERROR("Scene snapshot has ", header.EntityCount, " entities, more than the world has room for");
+        return false;
+    }
+
+    std::vector<uint32_t>& fileIndexBySlot = m_Remap.m_FileIndexBySlot;
+    fileIndexBySlot.clear();
+    for (uint32_t i = 0; i < header.EntityCount; ++i) {
+        uint32_t slot = GetEntityIndex(saved[i]);
+        if (slot >= fileIndexBySlot.size()) {
+            fileIndexBySlot.resize(static_cast<size_t>(slot) + 1, EntityRemap::INVALID_INDEX);
+        }
+        fileIndexBySlot[slot] = i;
+    }
+    m_Remap.m_Saved = saved;
+    m_Remap.m_Created = m_Created.data();
+
+    // Components, one bulk add per pool
+    for (uint32_t i = 0; i < header.PoolCount; ++i) {
+        const SceneFile::Pool& pool = pools[i];
+        const ComponentType* type = FindType(pool.Name);
+        if (!type) {
+            NILOS_WARNING("Scene snapshot: skipping unregistered component '", pool.Name, "'");
+            continue;
+        }
+        if (type->RecordSize != pool.RecordSize) {
+            NILOS_ERROR("Scene snapshot: skipping '", pool.Name, "', saved with ", pool.RecordSize,
+                        "-byte records, now ", type->RecordSize);
+            continue;
+        }
+
+        m_Owners.resize(pool.Count);
+        for (uint32_t j = 0; j < pool.Count; ++j) {
+            uint32_t owner;
+            std::memcpy(&owner, data + pool.OwnerOffset + j * sizeof(uint32_t), sizeof(owner));
+            m_Owners[j] = m_Created[owner];
+        }
+        type->Read(world, m_Owners.data(), pool.Count, data + pool.DataOffset, m_Remap);
+    }
+
+    nameOffset = header.NameOffset;
+    for (uint32_t i = 0; i < header.NameCount; ++i) {
+        uint32_t entry[2];
+        std::memcpy(entry, data + nameOffset, sizeof(entry));
+        nameOffset += sizeof(entry);
+        world.SetEntityName(m_Created[entry[0]],
+                            std::string(reinterpret_cast<const char*>(data + nameOffset), entry[1]));
+        nameOffset += entry[1];
+    }
+
+    m_Remap.m_Saved = nullptr;
+    m_Remap.m_Created = nullptr;
+    if (created) {
+        created->assign(m_Created.begin(), m_Created.end());
+    }
+    return true;
+}
+
+} // namespace Nilos
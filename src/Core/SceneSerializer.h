@@ -0,0 +1,207 @@
+#pragma once
+
+#include "SceneFile.h"
+#include "../ECS/World.h"
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Translates entity handles stored in a snapshot to the entities created by the load
+ */
+class EntityRemap {
+public:
+    /**
+     * @brief New entity for a handle saved in the snapshot, NULL_ENTITY if it was not saved
+     */
+    Entity Map(Entity saved) const {
+        uint32_t slot = GetEntityIndex(saved);
+        if (saved == NULL_ENTITY || slot >= m_FileIndexBySlot.size()) {
+            return NULL_ENTITY;
+        }
+        uint32_t index = m_FileIndexBySlot[slot];
+        return (index != INVALID_INDEX && m_Saved[index] == saved) ? m_Created[index] : NULL_ENTITY;
+    }
+
+private:
+    friend class SceneSerializer;
+
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+    const Entity* m_Saved = nullptr;    // The snapshot's entity table
+    const Entity* m_Created = nullptr;  // Parallel to m_Saved
+    std::vector<uint32_t> m_FileIndexBySlot;
+};
+
+/**
+ * @brief Saves and loads the ECS state as binary scene snapshots (see SceneFile)
+ *
+ * Component types are registered under a stable name. Trivially copyable
+ * components are stored as raw dense arrays: saving writes the pool's
+ * storage as one blob and loading appends the blob to the pool with a
+ * single copy straight from the memory-mapped file, so there is no
+ * per-component parsing or allocation (an optional remap function fixes
+ * up Entity fields afterwards). Other components are registered with a
+ * trivially copyable Record type and two conversion functions.
+ *
+ * Only entities that own at least one registered component are saved,
+ * together with their names. Loading creates new entities (the world may
+ * already contain others) and remaps every saved handle to them. Loading
+ * into a world that already holds the same entities duplicates them;
+ * destroy them first for level loads and quick-loads.
+ *
+ * The built-in Transform, Camera, Rigidbody, Collider and AIAgent
+ * components are registered as blobs. MeshComponent is saved as a
+ * reference to its MeshManager asset by content hash, so load the scene's
+ * models (or create the shared cube/spheres) before loading it; inline
+ * geometry that was never registered with the MeshManager is not saved.
+ *
+ * Loaded Rigidbody and Collider components are not known to any
+ * PhysicsWorld yet: pass the created entities to
+ * PhysicsWorld::RegisterEntities to simulate them.
+ *
+ * Usage:
+ *   SceneSerializer::Get().RegisterComponent<HealthComponent>("Health");
+ *   SceneSerializer::Get().Save(*world, "saves/quick.nscene");
+ *   std::vector<Entity> loaded;
+ *   SceneSerializer::Get().Load(*world, "saves/quick.nscene", &loaded);
+ *   physics->RegisterEntities(loaded);
+ */
+class SceneSerializer {
+public:
+    static SceneSerializer& Get() {
+        static SceneSerializer instance;
+        return instance;
+    }
+
+    SceneSerializer(const SceneSerializer&) = delete;
+    SceneSerializer& operator=(const SceneSerializer&) = delete;
+
+    /**
+     * @brief Register a trivially copyable component, stored as a raw blob
+     * @param name Stable identifier in files (at most SceneFile::MAX_NAME_LENGTH characters)
+     * @param remap Fixes up Entity fields of a loaded component (optional)
+     */
+    template<typename T>
+    void RegisterComponent(const std::string& name, void (*remap)(T&, const EntityRemap&) = nullptr) {
+        static_assert(std::is_trivially_copyable<T>::value,
+                      "Blob components must be trivially copyable; register a Record type instead");
+        static_assert(alignof(T) <= SceneFile::ALIGNMENT, "Component alignment exceeds SceneFile::ALIGNMENT");
+
+        ComponentType type;
+        type.Name = name;
+        type.RecordSize = sizeof(T);
+        type.GetOwners = &GetOwners<T>;
+        type.Write = [](World& world, uint8_t* records) {
+            const ComponentPool<T>* pool = world.GetComponentPool<T>();
+            std::memcpy(records, pool->Data(), pool->Size() * sizeof(T));
+        };
+        type.Read = [remap](World& world, const Entity* owners, size_t count, const uint8_t* records,
+                            const EntityRemap& entities) {
+            T* components = world.AddComponents<T>(owners, count, reinterpret_cast<const T*>(records));
+            if (remap && components) {
+                for (size_t i = 0; i < count; ++i) {
+                    remap(components[i], entities);
+                }
+            }
+        };
+        AddType(std::move(type));
+    }
+
+    /**
+     * @brief Register a component stored through a trivially copyable Record
+     * @param save Fills a zero-initialized record from a component
+     * @param load Fills a default-constructed component from a record
+     */
+    template<typename T, typename Record>
+    void RegisterComponent(const std::string& name, void (*save)(const T&, Record&),
+                           void (*load)(const Record&, T&, const EntityRemap&)) {
+        static_assert(std::is_trivially_copyable<Record>::value, "Records must be trivially copyable");
+
+        ComponentType type;
+        type.Name = name;
+        type.RecordSize = sizeof(Record);
+        type.GetOwners = &GetOwners<T>;
+        type.Write = [save](World& world, uint8_t* records) {
+            const ComponentPool<T>* pool = world.GetComponentPool<T>();
+            for (size_t i = 0; i < pool->Size(); ++i) {
+                Record record = {};
+                save(pool->Data()[i], record);
+                std::memcpy(records + i * sizeof(Record), &record, sizeof(Record));
+            }
+        };
+        type.Read = [load](World& world, const Entity* owners, size_t count, const uint8_t* records,
+                           const EntityRemap& entities) {
+            T* components = world.AddComponents<T>(owners, count);
+            for (size_t i = 0; components && i < count; ++i) {
+                Record record;
+                std::memcpy(&record, records + i * sizeof(Record), sizeof(Record));
+                load(record, components[i], entities);
+            }
+        };
+        AddType(std::move(type));
+    }
+
+    /**
+     * @brief Write every registered component pool of world to a file
+     * @return False if the file could not be written
+     */
+    bool Save(World& world, const std::string& filepath);
+
+    /**
+     * @brief Same, into memory (quick-saves, network snapshots)
+     */
+    bool SaveToMemory(World& world, std::vector<uint8_t>& bytes);
+
+    /**
+     * @brief Create the entities of a snapshot file in world
+     *
+     * Does not register physics bodies; see PhysicsWorld::RegisterEntities.
+     * @param created Receives the new entities, in saved order (optional)
+     * @return False if the file is missing, corrupt or from another version (world untouched)
+     */
+    bool Load(World& world, const std::string& filepath, std::vector<Entity>* created = nullptr);
+
+    /**
+     * @brief Same, from memory (data must be SceneFile::ALIGNMENT aligned)
+     */
+    bool LoadFromMemory(World& world, const uint8_t* data, size_t size, std::vector<Entity>* created = nullptr);
+
+private:
+    SceneSerializer();
+
+    struct ComponentType {
+        std::string Name;
+        uint32_t RecordSize = 0;
+        const std::vector<Entity>* (*GetOwners)(World&) = nullptr;  // nullptr if the world has no pool
+        std::function<void(World&, uint8_t*)> Write;                 // Records of the whole pool
+        std::function<void(World&, const Entity*, size_t, const uint8_t*, const EntityRemap&)> Read;
+    };
+
+    template<typename T>
+    static const std::vector<Entity>* GetOwners(World& world) {
+        const ComponentPool<T>* pool = world.GetComponentPool<T>();
+        return pool ? &pool->Entities() : nullptr;
+    }
+
+    void AddType(ComponentType type);
+    const ComponentType* FindType(const char* name) const;
+
+    std::vector<ComponentType> m_Types;
+
+    // Scratch reused between calls
+    std::vector<Entity> m_SlotEntities;      // Save: saved entity per slot (NULL_ENTITY if none)
+    std::vector<Entity> m_Saved;             // Entity table of the snapshot
+    std::vector<Entity> m_Created;
+    std::vector<Entity> m_Owners;
+    std::vector<uint8_t> m_OwnerSeen;        // Load: owners of the pool being validated
+    EntityRemap m_Remap;
+};
+
+} // namespace Nilos
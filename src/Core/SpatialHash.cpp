@@ -0,0 +1,162 @@
+#include "SpatialHash.h"
+#include <algorithm>
+
+namespace Nilos {
+
+namespace {
+
+constexpr float MIN_CELL_SIZE = 0.001f;
+constexpr uint32_t MIN_BUCKET_COUNT = 16;
+
+} // namespace
+
+SpatialHash::SpatialHash(float cellSize) {
+    SetCellSize(cellSize);
+}
+
+void SpatialHash::SetCellSize(float cellSize) {
+    m_CellSize = std::max(cellSize, MIN_CELL_SIZE);
+    m_InvCellSize = 1.0f / m_CellSize;
+}
+
+void SpatialHash::Build(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& ids) {
+    Build(positions.data(), ids.data(), std::min(positions.size(), ids.size()));
+}
+
+void SpatialHash::Build(const glm::vec3* positions, const uint32_t* ids, size_t count) {
+    // About two buckets per point keeps unrelated cells from sharing one
+    uint32_t bucketCount = MIN_BUCKET_COUNT;
+    while (bucketCount < count * 2) {
+        bucketCount <<= 1;
+    }
+    m_BucketMask = bucketCount - 1;
+
+    m_BucketStarts.assign(static_cast<size_t>(bucketCount) + 1, 0);
+    m_ItemBuckets.resize(count);
+    m_Items.resize(count);
+
+    m_MinCellX = m_MinCellZ = INT32_MAX;
+    m_MaxCellX = m_MaxCellZ = INT32_MIN;
+
+    // Count points per bucket (shifted by one so the prefix sum yields starts)
+    for (size_t i = 0; i < count; ++i) {
+        int32_t cellX = GetCell(positions[i].x);
+        int32_t cellZ = GetCell(positions[i].z);
+        m_MinCellX = std::min(m_MinCellX, cellX);
+        m_MaxCellX = std::max(m_MaxCellX, cellX);
+        m_MinCellZ = std::min(m_MinCellZ, cellZ);
+        m_MaxCellZ = std::max(m_MaxCellZ, cellZ);
+
+        uint32_t bucket = GetBucket(cellX, cellZ);
+        m_ItemBuckets[i] = bucket;
+        ++m_BucketStarts[bucket + 1];
+    }
+    for (uint32_t bucket = 0; bucket < bucketCount; ++bucket) {
+        m_BucketStarts[bucket + 1] += m_BucketStarts[bucket];
+    }
+
+    // Scatter; m_BucketStarts[b] walks to the end of bucket b, which is the
+    // start of b + 1, so shifting the array back by one restores the starts
+    for (size_t i = 0; i < count; ++i) {
+        uint32_t slot = m_BucketStarts[m_ItemBuckets[i]]++;
+        m_Items[slot] = { positions[i], ids[i], GetCell(positions[i].x), GetCell(positions[i].z) };
+    }
+    std::copy_backward(m_BucketStarts.begin(), m_BucketStarts.end() - 1, m_BucketStarts.end());
+    m_BucketStarts[0] = 0;
+
+    if (count == 0) {
+        Clear();
+    }
+}
+
+void SpatialHash::Clear() {
+    m_Items.clear();
+    m_BucketStarts.assign(static_cast<size_t>(MIN_BUCKET_COUNT) + 1, 0);
+    m_BucketMask = MIN_BUCKET_COUNT - 1;
+    m_MinCellX = m_MinCellZ = 0;
+    m_MaxCellX = m_MaxCellZ = -1;
+}
+
+size_t SpatialHash::QueryRadius(const glm::vec3& center, float radius, std::vector<uint32_t>& ids) const {
+    size_t before = ids.size();
+    ForEachInRadius(center, radius, [&ids](uint32_t id, const glm::vec3&, float) { ids.push_back(id); });
+    return ids.size() - before;
+}
+
+size_t SpatialHash::FindNearest(const glm::vec3& center, size_t k, float maxRadius,
+                                std::vector<SpatialNeighbor>& neighbors, uint32_t excludeId) const {
+    neighbors.clear();
+    if (m_Items.empty() || k == 0 || maxRadius < 0.0f) {
+        return 0;
+    }
+
+    float limitSq = maxRadius * maxRadius;
+    auto consider = [&](const Item& item, float distanceSq) {
+        if (item.Id == excludeId) {
+            return;
+        }
+        if (neighbors.size() == k) {
+            if (distanceSq >= neighbors.back().DistanceSq) {
+                return;
+            }
+            neighbors.pop_back();
+        }
+        auto position = std::upper_bound(neighbors.begin(), neighbors.end(), distanceSq,
+            [](float value, const SpatialNeighbor& neighbor) { return value < neighbor.DistanceSq; });
+        neighbors.insert(position, { item.Id, distanceSq });
+        if (neighbors.size() == k) {
+            limitSq = std::min(limitSq, neighbors.back().DistanceSq);
+        }
+    };
+
+    // Rings of cells around the center's cell, nearest first. Anything in
+    // ring r is at least (r - 1) cells away, so stop once that exceeds the
+    // current k-th distance or the radius, or the rings leave the occupied
+    // cells. A center outside the occupied cells starts at the first ring
+    // that reaches them, and every ring only walks its occupied part.
+    int64_t cellX = static_cast<int64_t>(std::floor(center.x * m_InvCellSize));
+    int64_t cellZ = static_cast<int64_t>(std::floor(center.z * m_InvCellSize));
+    int64_t firstRing = std::max({ int64_t(0), m_MinCellX - cellX, cellX - m_MaxCellX,
+                                   m_MinCellZ - cellZ, cellZ - m_MaxCellZ });
+    int64_t lastRing = std::max(std::max(cellX - m_MinCellX, m_MaxCellX - cellX),
+                                std::max(cellZ - m_MinCellZ, m_MaxCellZ - cellZ));
+
+    auto visitRow = [&](int64_t z, int64_t fromX, int64_t toX) {
+        if (z < m_MinCellZ || z > m_MaxCellZ) {
+            return;
+        }
+        for (int64_t x = std::max<int64_t>(fromX, m_MinCellX), last = std::min<int64_t>(toX, m_MaxCellX); x <= last; ++x) {
+            ForEachInCell(static_cast<int32_t>(x), static_cast<int32_t>(z), center, limitSq, consider);
+        }
+    };
+    auto visitColumn = [&](int64_t x, int64_t fromZ, int64_t toZ) {
+        if (x < m_MinCellX || x > m_MaxCellX) {
+            return;
+        }
+        for (int64_t z = std::max<int64_t>(fromZ, m_MinCellZ), last = std::min<int64_t>(toZ, m_MaxCellZ); z <= last; ++z) {
+            ForEachInCell(static_cast<int32_t>(x), static_cast<int32_t>(z), center, limitSq, consider);
+        }
+    };
+
+    for (int64_t ring = firstRing; ring <= lastRing; ++ring) {
+        if (ring > 1) {
+            float gap = static_cast<float>(ring - 1) * m_CellSize;
+            if (gap * gap > limitSq) {
+                break;
+            }
+        }
+
+        if (ring == 0) {
+            visitRow(cellZ, cellX, cellX);
+            continue;
+        }
+        visitRow(cellZ - ring, cellX - ring, cellX + ring);
+        visitRow(cellZ + ring, cellX - ring, cellX + ring);
+        visitColumn(cellX - ring, cellZ - ring + 1, cellZ + ring - 1);
+        visitColumn(cellX + ring, cellZ - ring + 1, cellZ + ring - 1);
+    }
+
+    return neighbors.size();
+}
+
+} // namespace Nilos
@@ -0,0 +1,181 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Result of a nearest-neighbour query
+ */
+struct SpatialNeighbor {
+    uint32_t Id;
+    float DistanceSq;
+};
+
+/**
+ * @brief Uniform-grid spatial hash of points for radius and k-nearest queries
+ *
+ * Points (with a caller-chosen 32-bit ID, usually an Entity) are binned
+ * into square cells on the XZ plane; distances are full 3D. Build sorts
+ * the points by hashed cell with a counting sort into one flat array, so
+ * a cell's points are contiguous and a query touches a handful of short
+ * runs of memory. Rebuilding every frame is O(n) and does not allocate
+ * once the arrays have grown.
+ *
+ * Pick a cell size close to the typical query radius, so a radius query
+ * visits about 3x3 cells. Different cells may share a hash bucket; each
+ * point remembers its cell so queries still see it exactly once.
+ *
+ * Queries are const and may run concurrently from any number of threads,
+ * but not during Build.
+ *
+ * Usage:
+ *   SpatialHash hash(10.0f);
+ *   hash.Build(positions.data(), ids.data(), positions.size());
+ *   hash.ForEachInRadius(center, 10.0f, [](uint32_t id, const glm::vec3& position, float distanceSq) { ... });
+ *   hash.FindNearest(center, 4, 25.0f, neighbors, selfId);
+ */
+class SpatialHash {
+public:
+    static constexpr float DEFAULT_CELL_SIZE = 10.0f;
+    static constexpr uint32_t NO_ID = UINT32_MAX;
+
+    explicit SpatialHash(float cellSize = DEFAULT_CELL_SIZE);
+
+    /**
+     * @brief Change the cell size (takes effect on the next Build)
+     */
+    void SetCellSize(float cellSize);
+    float GetCellSize() const { return m_CellSize; }
+
+    /**
+     * @brief Replace the contents with count points
+     */
+    void Build(const glm::vec3* positions, const uint32_t* ids, size_t count);
+    void Build(const std::vector<glm::vec3>& positions, const std::vector<uint32_t>& ids);
+
+    void Clear();
+
+    /**
+     * @brief Call func(id, position, distanceSq) for every point within radius of center
+     */
+    template<typename Func>
+    void ForEachInRadius(const glm::vec3& center, float radius, Func&& func) const;
+
+    /**
+     * @brief IDs of the points within radius (appended, unordered)
+     * @return Number of IDs appended
+     */
+    size_t QueryRadius(const glm::vec3& center, float radius, std::vector<uint32_t>& ids) const;
+
+    /**
+     * @brief Up to k nearest points within maxRadius, closest first
+     * @param excludeId Point to skip (the querying agent itself), NO_ID for none
+     * @param neighbors Receives the results (cleared first)
+     * @return Number of neighbours found
+     */
+    size_t FindNearest(const glm::vec3& center, size_t k, float maxRadius,
+                       std::vector<SpatialNeighbor>& neighbors, uint32_t excludeId = NO_ID) const;
+
+    size_t GetCount() const { return m_Items.size(); }
+    bool IsEmpty() const { return m_Items.empty(); }
+
+private:
+    struct Item {
+        glm::vec3 Position;
+        uint32_t Id;
+        int32_t CellX;
+        int32_t CellZ;
+    };
+
+    int32_t GetCell(float value) const {
+        return static_cast<int32_t>(std::floor(value * m_InvCellSize));
+    }
+
+    uint32_t GetBucket(int32_t cellX, int32_t cellZ) const {
+        return ((static_cast<uint32_t>(cellX) * 73856093u) ^ (static_cast<uint32_t>(cellZ) * 19349663u)) &
+               m_BucketMask;
+    }
+
+    /**
+     * @brief Call func(item, distanceSq) for the items of one cell within radiusSq
+     */
+    template<typename Func>
+    void ForEachInCell(int32_t cellX, int32_t cellZ, const glm::vec3& center, float radiusSq, Func& func) const {
+        uint32_t bucket = GetBucket(cellX, cellZ);
+        for (uint32_t i = m_BucketStarts[bucket], end = m_BucketStarts[bucket + 1]; i < end; ++i) {
+            const Item& item = m_Items[i];
+            if (item.CellX != cellX || item.CellZ != cellZ) {
+                continue;  // Another cell sharing the bucket
+            }
+            glm::vec3 offset = item.Position - center;
+            float distanceSq = glm::dot(offset, offset);
+            if (distanceSq <= radiusSq) {
+                func(item, distanceSq);
+            }
+        }
+    }
+
+    float m_CellSize;
+    float m_InvCellSize;
+    uint32_t m_BucketMask = 0;
+
+    // Occupied cell range, bounds the cells a query has to visit
+    int32_t m_MinCellX = 0;
+    int32_t m_MaxCellX = -1;
+    int32_t m_MinCellZ = 0;
+    int32_t m_MaxCellZ = -1;
+
+    std::vector<Item> m_Items;            // Sorted by bucket
+    std::vector<uint32_t> m_BucketStarts; // Items of bucket b: [m_BucketStarts[b], m_BucketStarts[b + 1])
+    std::vector<uint32_t> m_ItemBuckets;  // Build scratch
+};
+
+template<typename Func>
+void SpatialHash::ForEachInRadius(const glm::vec3& center, float radius, Func&& func) const {
+    if (m_Items.empty() || radius < 0.0f) {
+        return;
+    }
+
+    float radiusSq = radius * radius;
+    auto emit = [&func](const Item& item, float distanceSq) { func(item.Id, item.Position, distanceSq); };
+
+    // Clamp to the occupied cells (also keeps huge radii from overflowing)
+    float minX = std::floor((center.x - radius) * m_InvCellSize);
+    float maxX = std::floor((center.x + radius) * m_InvCellSize);
+    float minZ = std::floor((center.z - radius) * m_InvCellSize);
+    float maxZ = std::floor((center.z + radius) * m_InvCellSize);
+    if (maxX < static_cast<float>(m_MinCellX) || minX > static_cast<float>(m_MaxCellX) ||
+        maxZ < static_cast<float>(m_MinCellZ) || minZ > static_cast<float>(m_MaxCellZ)) {
+        return;
+    }
+    int32_t cellMinX = minX < static_cast<float>(m_MinCellX) ? m_MinCellX : static_cast<int32_t>(minX);
+    int32_t cellMaxX = maxX > static_cast<float>(m_MaxCellX) ? m_MaxCellX : static_cast<int32_t>(maxX);
+    int32_t cellMinZ = minZ < static_cast<float>(m_MinCellZ) ? m_MinCellZ : static_cast<int32_t>(minZ);
+    int32_t cellMaxZ = maxZ > static_cast<float>(m_MaxCellZ) ? m_MaxCellZ : static_cast<int32_t>(maxZ);
+
+    // Visiting more cells than there are points: a linear scan is cheaper
+    size_t cellCount = static_cast<size_t>(cellMaxX - cellMinX + 1) * static_cast<size_t>(cellMaxZ - cellMinZ + 1);
+    if (cellCount > m_Items.size()) {
+        for (const Item& item : m_Items) {
+            glm::vec3 offset = item.Position - center;
+            float distanceSq = glm::dot(offset, offset);
+            if (distanceSq <= radiusSq) {
+                emit(item, distanceSq);
+            }
+        }
+        return;
+    }
+
+    for (int32_t cellZ = cellMinZ; cellZ <= cellMaxZ; ++cellZ) {
+        for (int32_t cellX = cellMinX; cellX <= cellMaxX; ++cellX) {
+            ForEachInCell(cellX, cellZ, center, radiusSq, emit);
+        }
+    }
+}
+
+} // namespace Nilos
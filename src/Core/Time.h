@@ -1,6 +1,7 @@
 #pragma once
 
 #include <chrono>
+#include <cstdint>
 
 namespace Nilos {
 
@@ -42,23 +43,20 @@ public:
      * @brief Update time at the beginning of each frame
      */
     void Update() {
-        TimePoint currentTime = Clock::now();
-        Duration delta = currentTime - m_LastFrameTime;
-        m_DeltaTime = delta.count();
-        
+        m_DeltaTime = MeasureFrame();
         m_TotalTime += m_DeltaTime;
-        m_LastFrameTime = currentTime;
-        m_FrameCount++;
+    }
 
-        // Calculate FPS (updated every second)
-        m_FPSAccumulator += m_DeltaTime;
-        m_FPSFrameCount++;
-        
-        if (m_FPSAccumulator >= 1.0f) {
-            m_FPS = static_cast<float>(m_FPSFrameCount) / m_FPSAccumulator;
-            m_FPSAccumulator = 0.0f;
-            m_FPSFrameCount = 0;
-        }
+    /**
+     * @brief Begin a frame that simulates a fixed step instead of the elapsed time
+     *
+     * For headless batch runs that go faster (or slower) than real time;
+     * FPS still reports the real frame rate.
+     */
+    void Advance(float deltaTime) {
+        MeasureFrame();
+        m_DeltaTime = deltaTime;
+        m_TotalTime += m_DeltaTime;
     }
 
     /**
@@ -97,6 +95,28 @@ public:
     float GetScaledDeltaTime() const { return m_DeltaTime * m_TimeScale; }
 
 private:
+    /**
+     * @brief Count a frame and update the FPS from the wall clock
+     * @return Seconds since the previous frame
+     */
+    float MeasureFrame() {
+        TimePoint currentTime = Clock::now();
+        Duration delta = currentTime - m_LastFrameTime;
+        m_LastFrameTime = currentTime;
+        m_FrameCount++;
+
+        // Calculate FPS (updated every second)
+        m_FPSAccumulator += delta.count();
+        m_FPSFrameCount++;
+        
+        if (m_FPSAccumulator >= 1.0f) {
+            m_FPS = static_cast<float>(m_FPSFrameCount) / m_FPSAccumulator;
+            m_FPSAccumulator = 0.0f;
+            m_FPSFrameCount = 0;
+        }
+        return delta.count();
+    }
+
     Time() : m_DeltaTime(0.0f), m_TotalTime(0.0f), m_FrameCount(0), 
              m_FPS(0.0f), m_FPSAccumulator(0.0f), m_FPSFrameCount(0),
              m_TimeScale(1.0f) {}
@@ -5,196 +5,152 @@
 #include <vector>
 #include <string>
 #include <cstdint>
+#include <cmath>
+#include "Entity.h"
 #include "../Physics/Collision.h"
+#include "../Rendering/MeshHandle.h"
+#include "../Rendering/VertexLayout.h"
 
 namespace Nilos {
 
-/**
- * @brief Component type ID generator
- * 
- * Uses template specialization to generate unique IDs for each component type
- */
-class ComponentTypeIdGenerator {
-public:
-    template<typename T>
-    static uint32_t GetId() {
-        static uint32_t id = s_NextId++;
-        return id;
-    }
-
-private:
-    static inline uint32_t s_NextId = 0;
-};
-
 // ============================================================================
 // CORE COMPONENTS
 // ============================================================================
 
 /**
  * @brief Transform component - position, rotation, scale
- * 
+ *
  * Every spatial entity should have this component.
  * Rotation is stored in Euler angles (degrees).
+ *
+ * Position/Rotation/Scale are relative to Parent (world space for roots).
+ * LocalMatrix and WorldMatrix are caches written by TransformHierarchy
+ * once per frame, only for transforms whose values or parent changed
+ * since the last pass; the renderer and the frustum culler read
+ * WorldMatrix. Physics and AI read Position directly, so rigidbodies and
+ * agents should be roots.
  */
 struct TransformComponent {
     glm::vec3 Position = glm::vec3(0.0f);
     glm::vec3 Rotation = glm::vec3(0.0f); // Euler angles in degrees
     glm::vec3 Scale = glm::vec3(1.0f);
+    Entity Parent = NULL_ENTITY;          // Must have a TransformComponent too
+
+    // Cached matrices (managed by TransformHierarchy)
+    alignas(16) glm::mat4 LocalMatrix = glm::mat4(1.0f);  // GetModelMatrix() as of the last pass
+    alignas(16) glm::mat4 WorldMatrix = glm::mat4(1.0f);  // Parent's WorldMatrix * LocalMatrix
+
+    // Values LocalMatrix/WorldMatrix were last built from
+    glm::vec3 CachedPosition = glm::vec3(0.0f);
+    glm::vec3 CachedRotation = glm::vec3(0.0f);
+    glm::vec3 CachedScale = glm::vec3(1.0f);
+    Entity CachedParent = NULL_ENTITY;
 
     /**
-     * @brief Calculate the model matrix from transform data
+     * @brief Calculate the local model matrix (Translation * RotY * RotX * RotZ * Scale)
+     *
+     * Built directly from the six sines and cosines instead of
+     * multiplying four matrices.
      */
     glm::mat4 GetModelMatrix() const {
-        glm::mat4 model = glm::mat4(1.0f);
-        
-        // Apply transformations: Translation * Rotation * Scale
-        model = glm::translate(model, Position);
-        model = glm::rotate(model, glm::radians(Rotation.y), glm::vec3(0.0f, 1.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(Rotation.x), glm::vec3(1.0f, 0.0f, 0.0f));
-        model = glm::rotate(model, glm::radians(Rotation.z), glm::vec3(0.0f, 0.0f, 1.0f));
-        model = glm::scale(model, Scale);
-        
+        float sx = std::sin(glm::radians(Rotation.x)), cx = std::cos(glm::radians(Rotation.x));
+        float sy = std::sin(glm::radians(Rotation.y)), cy = std::cos(glm::radians(Rotation.y));
+        float sz = std::sin(glm::radians(Rotation.z)), cz = std::cos(glm::radians(Rotation.z));
+
+        glm::mat4 model;
+        model[0] = glm::vec4(cy * cz + sy * sx * sz, cx * sz, cy * sx * sz - sy * cz, 0.0f) * Scale.x;
+        model[1] = glm::vec4(sy * sx * cz - cy * sz, cx * cz, sy * sz + cy * sx * cz, 0.0f) * Scale.y;
+        model[2] = glm::vec4(sy * cx, -sx, cy * cx, 0.0f) * Scale.z;
+        model[3] = glm::vec4(Position, 1.0f);
         return model;
     }
+
+    /**
+     * @brief Check if Position/Rotation/Scale changed since LocalMatrix was built
+     *
+     * The fields are public and written directly (gameplay code, physics
+     * interpolation), so changes are detected by comparison, like
+     * PhysicsWorld does for body poses.
+     */
+    bool IsDirty() const {
+        return Position != CachedPosition || Rotation != CachedRotation || Scale != CachedScale;
+    }
+
+    /**
+     * @brief Rebuild LocalMatrix if dirty
+     * @return True if it was rebuilt
+     */
+    bool UpdateLocalMatrix() {
+        if (!IsDirty()) {
+            return false;
+        }
+        LocalMatrix = GetModelMatrix();
+        CachedPosition = Position;
+        CachedRotation = Rotation;
+        CachedScale = Scale;
+        return true;
+    }
+
+    /**
+     * @brief World-space position (valid after the frame's TransformHierarchy pass)
+     */
+    glm::vec3 GetWorldPosition() const { return glm::vec3(WorldMatrix[3]); }
 };
 
 /**
  * @brief Mesh component - renderable geometry data
  * 
- * Contains vertex data and GPU buffer IDs for rendering.
- * Vertex format: Position(3) + Normal(3) + Color(3) + TexCoord(2) = 11 floats
+ * Refers to a shared asset in the MeshManager through Mesh, so entities
+ * with the same geometry share one copy on the CPU and the GPU.
+ *
+ * Custom geometry can still be filled in inline: Vertices are interleaved
+ * floats described by Layout (default Position(3) + Normal(3) + Color(3) +
+ * TexCoord(2) = 11 floats). The renderer registers inline data with the
+ * MeshManager on first use and moves it out of the component unless
+ * KeepCPUData is set.
  */
 struct MeshComponent {
-    std::vector<float> Vertices;  // Interleaved vertex data
+    MeshHandle Mesh = NULL_MESH;
+    std::vector<float> Vertices;  // Inline interleaved vertex data (see above)
+    VertexLayout Layout = VertexLayout::Standard();
     std::vector<uint32_t> Indices;
-    uint32_t VAO = 0; // Vertex Array Object
-    uint32_t VBO = 0; // Vertex Buffer Object
-    uint32_t EBO = 0; // Element Buffer Object
+    bool KeepCPUData = false; // Keep Vertices/Indices after upload (e.g. for physics)
     glm::vec3 Color = glm::vec3(1.0f, 1.0f, 1.0f);
     uint32_t MaterialID = 0; // Optional material reference
 
+    // Local-space bounding box of the vertex positions (see ComputeBounds)
+    glm::vec3 BoundsCenter = glm::vec3(0.0f);
+    glm::vec3 BoundsExtents = glm::vec3(0.0f);
+    bool HasBounds = false;
+
+    // Defined in MeshManager.cpp, so the ECS does not depend on the rendering headers
+
     /**
-     * @brief Create a simple cube mesh with normals (corrected geometry)
+     * @brief Use a shared mesh asset (drops any inline data)
      */
-    void CreateCube() {
-        // Cube with Position(3) + Normal(3) + Color(3) + TexCoord(2) = 11 floats per vertex
-        // All vertices use same color for solid appearance
-        Vertices = {
-            // Front face (+Z) - RED
-            -0.5f, -0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  0.8f, 0.3f, 0.3f,  0.0f, 0.0f,
-             0.5f, -0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  0.8f, 0.3f, 0.3f,  1.0f, 0.0f,
-             0.5f,  0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  0.8f, 0.3f, 0.3f,  1.0f, 1.0f,
-            -0.5f,  0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  0.8f, 0.3f, 0.3f,  0.0f, 1.0f,
-            
-            // Back face (-Z) - GREEN
-            -0.5f, -0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  0.3f, 0.8f, 0.3f,  0.0f, 0.0f,
-             0.5f, -0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  0.3f, 0.8f, 0.3f,  1.0f, 0.0f,
-             0.5f,  0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  0.3f, 0.8f, 0.3f,  1.0f, 1.0f,
-            -0.5f,  0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  0.3f, 0.8f, 0.3f,  0.0f, 1.0f,
-            
-            // Top face (+Y) - BLUE
-            -0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  0.3f, 0.3f, 0.8f,  0.0f, 0.0f,
-             0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  0.3f, 0.3f, 0.8f,  1.0f, 0.0f,
-             0.5f,  0.5f,  0.5f,  0.0f, 1.0f, 0.0f,  0.3f, 0.3f, 0.8f,  1.0f, 1.0f,
-            -0.5f,  0.5f,  0.5f,  0.0f, 1.0f, 0.0f,  0.3f, 0.3f, 0.8f,  0.0f, 1.0f,
-            
-            // Bottom face (-Y) - YELLOW
-            -0.5f, -0.5f, -0.5f,  0.0f, -1.0f, 0.0f,  0.8f, 0.8f, 0.3f,  0.0f, 0.0f,
-             0.5f, -0.5f, -0.5f,  0.0f, -1.0f, 0.0f,  0.8f, 0.8f, 0.3f,  1.0f, 0.0f,
-             0.5f, -0.5f,  0.5f,  0.0f, -1.0f, 0.0f,  0.8f, 0.8f, 0.3f,  1.0f, 1.0f,
-            -0.5f, -0.5f,  0.5f,  0.0f, -1.0f, 0.0f,  0.8f, 0.8f, 0.3f,  0.0f, 1.0f,
-            
-            // Right face (+X) - MAGENTA
-             0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.8f, 0.3f, 0.8f,  0.0f, 0.0f,
-             0.5f,  0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.8f, 0.3f, 0.8f,  1.0f, 0.0f,
-             0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  0.8f, 0.3f, 0.8f,  1.0f, 1.0f,
-             0.5f, -0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  0.8f, 0.3f, 0.8f,  0.0f, 1.0f,
-            
-            // Left face (-X) - CYAN
-            -0.5f, -0.5f, -0.5f,  -1.0f, 0.0f, 0.0f,  0.3f, 0.8f, 0.8f,  0.0f, 0.0f,
-            -0.5f,  0.5f, -0.5f,  -1.0f, 0.0f, 0.0f,  0.3f, 0.8f, 0.8f,  1.0f, 0.0f,
-            -0.5f,  0.5f,  0.5f,  -1.0f, 0.0f, 0.0f,  0.3f, 0.8f, 0.8f,  1.0f, 1.0f,
-            -0.5f, -0.5f,  0.5f,  -1.0f, 0.0f, 0.0f,  0.3f, 0.8f, 0.8f,  0.0f, 1.0f,
-        };
-
-        Indices = {
-            0,  1,  2,   2,  3,  0,   // Front (CCW from outside)
-            4,  5,  6,   6,  7,  4,   // Back
-            8,  9, 10,  10, 11,  8,   // Top
-            12, 13, 14,  14, 15, 12,  // Bottom
-            16, 17, 18,  18, 19, 16,  // Right
-            20, 21, 22,  22, 23, 20   // Left
-        };
-    }
+    void SetMesh(MeshHandle handle);
+
+    /**
+     * @brief Use the shared unit cube
+     */
+    void CreateCube();
 
     /**
-     * @brief Create a sphere mesh (UV sphere)
+     * @brief Use a shared sphere mesh (UV sphere)
      * @param radius Sphere radius
      * @param segments Horizontal segments (longitude)
      * @param rings Vertical rings (latitude)
      */
-    void CreateSphere(float radius = 0.5f, int segments = 32, int rings = 16) {
-        Vertices.clear();
-        Indices.clear();
-        
-        // Generate vertices
-        for (int ring = 0; ring <= rings; ++ring) {
-            float v = (float)ring / (float)rings;
-            float phi = v * glm::pi<float>();
-            
-            for (int seg = 0; seg <= segments; ++seg) {
-                float u = (float)seg / (float)segments;
-                float theta = u * 2.0f * glm::pi<float>();
-                
-                // Position
-                float x = radius * sin(phi) * cos(theta);
-                float y = radius * cos(phi);
-                float z = radius * sin(phi) * sin(theta);
-                
-                // Normal (normalized position for sphere)
-                float nx = sin(phi) * cos(theta);
-                float ny = cos(phi);
-                float nz = sin(phi) * sin(theta);
-                
-                // Color (orange for basketball)
-                float r = 0.9f, g = 0.5f, b = 0.2f;
-                
-                // UV coordinates
-                float tu = u;
-                float tv = v;
-                
-                // Add vertex: Position(3) + Normal(3) + Color(3) + TexCoord(2)
-                Vertices.push_back(x); Vertices.push_back(y); Vertices.push_back(z);
-                Vertices.push_back(nx); Vertices.push_back(ny); Vertices.push_back(nz);
-                Vertices.push_back(r); Vertices.push_back(g); Vertices.push_back(b);
-                Vertices.push_back(tu); Vertices.push_back(tv);
-            }
-        }
-        
-        // Generate indices
-        for (int ring = 0; ring < rings; ++ring) {
-            for (int seg = 0; seg < segments; ++seg) {
-                int current = ring * (segments + 1) + seg;
-                int next = current + segments + 1;
-                
-                // Two triangles per quad
-                Indices.push_back(current);
-                Indices.push_back(next);
-                Indices.push_back(current + 1);
-                
-                Indices.push_back(current + 1);
-                Indices.push_back(next);
-                Indices.push_back(next + 1);
-            }
-        }
-    }
+    void CreateSphere(float radius = 0.5f, int segments = 32, int rings = 16);
 
     /**
-     * @brief Check if mesh has been uploaded to GPU
+     * @brief Compute the local bounding box
+     *
+     * Copies the bounds of the shared asset if there is one, otherwise
+     * computes them from the positions in Vertices. Called lazily by the
+     * frustum culler; call again after editing Vertices.
      */
-    bool IsInitialized() const {
-        return VAO != 0;
-    }
+    void ComputeBounds();
 };
 
 /**
@@ -282,14 +238,19 @@ struct RigidbodyComponent {
     float StaticFriction = 0.6f;          // Friction when not moving
     float DynamicFriction = 0.4f;         // Friction when moving
     
-    // Damping (air resistance)
-    float LinearDamping = 0.01f;          // Velocity decay
-    float AngularDamping = 0.05f;         // Angular velocity decay
+    // Damping (air resistance), applied as v *= 1 / (1 + dt * damping)
+    float LinearDamping = 0.6f;           // Velocity decay per second (1/s)
+    float AngularDamping = 3.0f;          // Angular velocity decay per second (1/s)
     
     // Flags
     bool UseGravity = true;               // Affected by gravity?
     bool IsKinematic = false;             // Moves but ignores forces (for platforms, etc.)
     bool IsStatic = false;                // Never moves (for walls, ground)
+    bool AllowSleep = true;               // May be put to sleep when at rest
+    
+    // Sleep state (managed by PhysicsWorld): sleeping bodies are not simulated
+    bool IsSleeping = false;
+    float SleepTimer = 0.0f;              // Seconds spent below the sleep thresholds
     
     RigidbodyComponent() {
         UpdateInverseMass();
@@ -307,9 +268,15 @@ struct RigidbodyComponent {
     void AddForce(const glm::vec3& force) {
         if (!IsKinematic && !IsStatic) {
             Force += force;
+            WakeUp();
         }
     }
     
+    void WakeUp() {
+        IsSleeping = false;
+        SleepTimer = 0.0f;
+    }
+    
     void ClearForces() {
         Force = glm::vec3(0.0f);
         Torque = glm::vec3(0.0f);
@@ -396,8 +363,12 @@ struct ColliderComponent {
 struct AIAgentComponent {
     bool IsActive = true;
     float PerceptionRadius = 10.0f;
-    float UpdateInterval = 0.1f;          // How often to update AI (seconds)
+    float UpdateInterval = 0.1f;          // How often to update AI at full detail (seconds)
     float TimeSinceLastUpdate = 0.0f;
+    float Importance = 1.0f;              // Divides the LOD distance: 2 keeps full rate twice as far away
+    uint8_t LODLevel = 0;                 // Set by AISystem; the interval doubles per level
+    Entity PerceivedEntity = NULL_ENTITY; // Nearest other agent within PerceptionRadius, set by AISystem
+    float PerceivedDistance = 0.0f;
     
     // Placeholder for future AI state
     // Will include: behavior tree, GOAP planner, memory system, etc.
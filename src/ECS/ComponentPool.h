@@ -0,0 +1,201 @@
+#pragma once
+
+#include "Entity.h"
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Type-erased interface shared by all component pools
+ *
+ * Lets the World operate on pools without knowing the component type,
+ * e.g. to strip every component from an entity that is being destroyed.
+ */
+class IComponentPool {
+public:
+    virtual ~IComponentPool() = default;
+
+    /**
+     * @brief Remove the component owned by an entity (no-op if absent)
+     */
+    virtual void Remove(Entity entity) = 0;
+
+    /**
+     * @brief Check if an entity owns a component in this pool
+     */
+    virtual bool Has(Entity entity) const = 0;
+
+    /**
+     * @brief Number of components stored
+     */
+    virtual size_t Size() const = 0;
+
+    /**
+     * @brief Remove every component
+     */
+    virtual void Clear() = 0;
+};
+
+/**
+ * @brief Dense sparse-set storage for a single component type
+ *
+ * Layout:
+ * - m_Components: every component of this type, packed with no holes
+ * - m_Entities:   owner of m_Components[i] (parallel array)
+ * - m_Sparse:     entity slot index -> index into the dense arrays
+ *
+ * Lookups compare the full handle stored in m_Entities, so a stale handle
+ * whose slot has been recycled (different generation) is reported absent.
+ *
+ * Add, Get, Has and Remove are O(1) and never hash. Iterating the pool is
+ * a linear walk over contiguous memory, which is what systems touching
+ * thousands of components per frame want.
+ *
+ * POINTER STABILITY:
+ * Component pointers and references stay valid only until the next Add or
+ * Remove on the SAME pool. Add may grow the dense vector (reallocation) and
+ * Remove moves the last component into the freed slot. Pools of other
+ * component types are never affected. Do not cache component pointers across
+ * frames - store the Entity and look the component up again instead.
+ */
+template<typename T>
+class ComponentPool : public IComponentPool {
+public:
+    static constexpr uint32_t INVALID_INDEX = std::numeric_limits<uint32_t>::max();
+
+    /**
+     * @brief Add a default-constructed component (resets it if already present)
+     * @return Reference to the stored component
+     */
+    T& Add(Entity entity) {
+        uint32_t slot = GetEntityIndex(entity);
+        if (slot >= m_Sparse.size()) {
+            m_Sparse.resize(static_cast<size_t>(slot) + 1, INVALID_INDEX);
+        }
+
+        uint32_t index = m_Sparse[slot];
+        if (index != INVALID_INDEX) {
+            // Same slot: either the same entity or a stale owner from an older generation
+            m_Entities[index] = entity;
+            m_Components[index] = T{};
+            return m_Components[index];
+        }
+
+        m_Sparse[slot] = static_cast<uint32_t>(m_Components.size());
+        m_Entities.push_back(entity);
+        m_Components.emplace_back();
+        return m_Components.back();
+    }
+
+    /**
+     * @brief Append components for many entities at once
+     * @param entities Owners, none of which may have a component in this pool yet
+     * @param components Values to copy (one bulk copy), or nullptr to default-construct
+     * @return The first of the count new components, contiguous in dense storage
+     */
+    T* AddRange(const Entity* entities, size_t count, const T* components = nullptr) {
+        size_t first = m_Components.size();
+        if (components) {
+            m_Components.insert(m_Components.end(), components, components + count);
+        } else {
+            m_Components.resize(first + count);
+        }
+        m_Entities.insert(m_Entities.end(), entities, entities + count);
+
+        for (size_t i = 0; i < count; ++i) {
+            uint32_t slot = GetEntityIndex(entities[i]);
+            if (slot >= m_Sparse.size()) {
+                m_Sparse.resize(static_cast<size_t>(slot) + 1, INVALID_INDEX);
+            }
+            m_Sparse[slot] = static_cast<uint32_t>(first + i);
+        }
+        return m_Components.data() + first;
+    }
+
+    /**
+     * @brief Get component for an entity
+     * @return Pointer to component, or nullptr if not present
+     */
+    T* Get(Entity entity) {
+        uint32_t index = GetDenseIndex(entity);
+        return (index != INVALID_INDEX) ? &m_Components[index] : nullptr;
+    }
+
+    const T* Get(Entity entity) const {
+        uint32_t index = GetDenseIndex(entity);
+        return (index != INVALID_INDEX) ? &m_Components[index] : nullptr;
+    }
+
+    void Remove(Entity entity) override {
+        uint32_t index = GetDenseIndex(entity);
+        if (index == INVALID_INDEX) return;
+
+        // Swap-and-pop keeps the dense arrays packed
+        uint32_t last = static_cast<uint32_t>(m_Components.size() - 1);
+        if (index != last) {
+            m_Components[index] = std::move(m_Components[last]);
+            m_Entities[index] = m_Entities[last];
+            m_Sparse[GetEntityIndex(m_Entities[index])] = index;
+        }
+
+        m_Components.pop_back();
+        m_Entities.pop_back();
+        m_Sparse[GetEntityIndex(entity)] = INVALID_INDEX;
+    }
+
+    bool Has(Entity entity) const override {
+        return GetDenseIndex(entity) != INVALID_INDEX;
+    }
+
+    size_t Size() const override { return m_Components.size(); }
+
+    void Clear() override {
+        m_Components.clear();
+        m_Entities.clear();
+        m_Sparse.clear();
+    }
+
+    /**
+     * @brief Reserve dense storage to avoid reallocation while populating
+     */
+    void Reserve(size_t count) {
+        m_Components.reserve(count);
+        m_Entities.reserve(count);
+    }
+
+    // ========================================================================
+    // Dense access (linear iteration)
+    // ========================================================================
+
+    T* Data() { return m_Components.data(); }
+    const T* Data() const { return m_Components.data(); }
+
+    /**
+     * @brief Owners of the dense components, Entities()[i] owns Data()[i]
+     */
+    const std::vector<Entity>& Entities() const { return m_Entities; }
+
+    typename std::vector<T>::iterator begin() { return m_Components.begin(); }
+    typename std::vector<T>::iterator end() { return m_Components.end(); }
+    typename std::vector<T>::const_iterator begin() const { return m_Components.begin(); }
+    typename std::vector<T>::const_iterator end() const { return m_Components.end(); }
+
+private:
+    uint32_t GetDenseIndex(Entity entity) const {
+        uint32_t slot = GetEntityIndex(entity);
+        if (slot >= m_Sparse.size()) return INVALID_INDEX;
+
+        uint32_t index = m_Sparse[slot];
+        return (index != INVALID_INDEX && m_Entities[index] == entity) ? index : INVALID_INDEX;
+    }
+
+    std::vector<T> m_Components;
+    std::vector<Entity> m_Entities;
+    std::vector<uint32_t> m_Sparse;
+};
+
+} // namespace Nilos
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <atomic>
+#include <bitset>
 #include <cstdint>
 #include <limits>
 
@@ -7,26 +9,86 @@ namespace Nilos {
 
 /**
  * @brief Entity is just a unique ID
- * 
+ *
  * In pure ECS architecture, entities are lightweight identifiers.
  * All data is stored in components, all logic in systems.
+ *
+ * The 32-bit handle packs a slot index and a generation counter:
+ *   [ generation : 12 bits | index : 20 bits ]
+ * Destroying an entity bumps the generation of its slot, so stale handles
+ * to a recycled slot no longer match and are rejected by the World.
  */
 using Entity = uint32_t;
 
+/**
+ * @brief Bit layout of an Entity handle
+ */
+constexpr uint32_t ENTITY_INDEX_BITS = 20;
+constexpr uint32_t ENTITY_GENERATION_BITS = 32 - ENTITY_INDEX_BITS;
+constexpr uint32_t ENTITY_INDEX_MASK = (1u << ENTITY_INDEX_BITS) - 1;
+constexpr uint32_t ENTITY_GENERATION_MASK = (1u << ENTITY_GENERATION_BITS) - 1;
+
 /**
  * @brief Special value representing an invalid/null entity
  */
 constexpr Entity NULL_ENTITY = std::numeric_limits<Entity>::max();
 
 /**
- * @brief Maximum number of entities supported
+ * @brief Maximum number of entity slots (index 0 is reserved as "no entity")
+ *
+ * The all-ones index used by NULL_ENTITY lies outside this range, so no
+ * live entity can ever compare equal to NULL_ENTITY.
  */
-constexpr uint32_t MAX_ENTITIES = 10000;
+constexpr uint32_t MAX_ENTITIES = ENTITY_INDEX_MASK;
 
 /**
  * @brief Maximum number of component types supported
  */
 constexpr uint32_t MAX_COMPONENTS = 64;
 
-} // namespace Nilos
+/**
+ * @brief Bitmask of the component types owned by an entity
+ */
+using ComponentSignature = std::bitset<MAX_COMPONENTS>;
+
+/**
+ * @brief Component type ID generator
+ * 
+ * Uses template specialization to generate unique IDs for each component type.
+ * IDs index World's pool table and ComponentSignature bits. The counter is
+ * atomic so systems running on worker threads may touch new types safely.
+ */
+class ComponentTypeIdGenerator {
+public:
+    template<typename T>
+    static uint32_t GetId() {
+        static const uint32_t id = s_NextId.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
 
+private:
+    static inline std::atomic<uint32_t> s_NextId{0};
+};
+
+/**
+ * @brief Extract the slot index of an entity handle
+ */
+constexpr uint32_t GetEntityIndex(Entity entity) {
+    return entity & ENTITY_INDEX_MASK;
+}
+
+/**
+ * @brief Extract the generation of an entity handle
+ */
+constexpr uint32_t GetEntityGeneration(Entity entity) {
+    return (entity >> ENTITY_INDEX_BITS) & ENTITY_GENERATION_MASK;
+}
+
+/**
+ * @brief Build an entity handle from slot index and generation
+ */
+constexpr Entity MakeEntity(uint32_t index, uint32_t generation) {
+    return ((generation & ENTITY_GENERATION_MASK) << ENTITY_INDEX_BITS) | (index & ENTITY_INDEX_MASK);
+}
+
+} // namespace Nilos
@@ -1,16 +1,39 @@
 #pragma once
 
+#include "Entity.h"
+#include "../Core/Logger.h"
+
 #include <string>
 
 namespace Nilos {
 
+class World;
+
 /**
  * @brief Base class for all ECS systems
- * 
+ *
  * Systems contain the logic that operates on entities with specific components.
  * Each system should focus on a single responsibility (rendering, physics, AI, etc.)
- * 
+ *
  * Example: PhysicsSystem operates on entities with TransformComponent and RigidbodyComponent
+ *
+ * PARALLEL SCHEDULING:
+ * Systems declare the component types they read and write (usually in the
+ * constructor or Initialize):
+ *
+ *   AnimationSystem() {
+ *       Reads<SkeletonComponent>();
+ *       Writes<TransformComponent>();
+ *   }
+ *
+ * The World runs systems whose declared accesses do not conflict on worker
+ * threads in the same frame stage. Two systems conflict when one writes a
+ * type the other reads or writes. A system that declares nothing is treated
+ * as touching everything and always runs alone, in registration order.
+ *
+ * A system running in parallel must limit itself to its declared types and
+ * must not make structural changes (create/destroy entities, add/remove
+ * components) - queue those and apply them from a serial system instead.
  */
 class System {
 public:
@@ -18,7 +41,7 @@ public:
 
     /**
      * @brief Initialize the system
-     * 
+     *
      * Called once when the system is first created.
      * Use this for resource allocation, loading data, etc.
      */
@@ -26,7 +49,7 @@ public:
 
     /**
      * @brief Update the system
-     * 
+     *
      * Called every frame. This is where the main logic happens.
      * @param deltaTime Time elapsed since last frame (in seconds)
      */
@@ -34,7 +57,7 @@ public:
 
     /**
      * @brief Shutdown the system
-     * 
+     *
      * Called when the system is being destroyed.
      * Use this for cleanup and resource deallocation.
      */
@@ -51,9 +74,78 @@ public:
     void SetEnabled(bool enabled) { m_Enabled = enabled; }
     bool IsEnabled() const { return m_Enabled; }
 
+    // ========================================================================
+    // Component Access (used by the scheduler)
+    // ========================================================================
+
+    const ComponentSignature& GetReadSet() const { return m_ReadSet; }
+    const ComponentSignature& GetWriteSet() const { return m_WriteSet; }
+
+    /**
+     * @brief True if Reads/Writes were declared (otherwise the system runs exclusively)
+     */
+    bool HasDeclaredAccess() const { return m_DeclaredAccess && !m_AccessOverflow; }
+
+    /**
+     * @brief Check if this system may not run concurrently with another
+     */
+    bool ConflictsWith(const System& other) const {
+        if (!HasDeclaredAccess() || !other.HasDeclaredAccess()) {
+            return true;
+        }
+        return (m_WriteSet & (other.m_ReadSet | other.m_WriteSet)).any() ||
+               (other.m_WriteSet & m_ReadSet).any();
+    }
+
 protected:
+    /**
+     * @brief Declare read-only access to component types
+     */
+    template<typename... Ts>
+    void Reads() {
+        (Declare(m_ReadSet, ComponentTypeIdGenerator::GetId<Ts>()), ...);
+        m_DeclaredAccess = true;
+    }
+
+    /**
+     * @brief Declare read-write access to component types
+     */
+    template<typename... Ts>
+    void Writes() {
+        (Declare(m_WriteSet, ComponentTypeIdGenerator::GetId<Ts>()), ...);
+        m_DeclaredAccess = true;
+    }
+
+    /**
+     * @brief Declare that the system touches no components (always parallel-safe)
+     */
+    void AccessesNoComponents() { m_DeclaredAccess = true; }
+
+    /**
+     * @brief World that owns this system (set before Initialize)
+     */
+    World* GetWorld() const { return m_World; }
+
     bool m_Enabled = true;
+    World* m_World = nullptr;
+
+private:
+    friend class World;
+
+    void Declare(ComponentSignature& set, uint32_t typeId) {
+        if (typeId >= MAX_COMPONENTS) {
+            // Not representable in a signature: schedule the system exclusively
+            NILOS_CRITICAL("System access: more than MAX_COMPONENTS (", MAX_COMPONENTS, ") component types");
+            m_AccessOverflow = true;
+            return;
+        }
+        set.set(typeId);
+    }
+
+    ComponentSignature m_ReadSet;
+    ComponentSignature m_WriteSet;
+    bool m_DeclaredAccess = false;
+    bool m_AccessOverflow = false;  // A declared type had no signature bit
 };
 
 } // namespace Nilos
-
@@ -0,0 +1,239 @@
+#pragma once
+
+#include "World.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Logger.h"
+#include "../Core/Profiler.h"
+#include "../Core/SIMD.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Brings every TransformComponent's LocalMatrix and WorldMatrix up to date
+ *
+ * Engine::Update runs Update once per frame, after physics has written its
+ * poses and before culling and rendering. The pass:
+ *   1. Rebuilds LocalMatrix of the transforms whose Position/Rotation/Scale
+ *      changed (see TransformComponent::IsDirty), split across the
+ *      JobSystem for large pools. Roots copy it into WorldMatrix.
+ *   2. If any transform has a parent, orders the children breadth-first
+ *      (by depth, so parents always come first) and sets
+ *      WorldMatrix = parent WorldMatrix * LocalMatrix for those whose local
+ *      matrix, parent, or parent's world matrix changed.
+ * A transform that did not move costs one comparison and no matrix math.
+ *
+ * A Parent that no longer exists (or has no TransformComponent) is treated
+ * as no parent; parent cycles are broken with an error.
+ *
+ * Usage:
+ *   TransformComponent* wheel = world->AddComponent<TransformComponent>(wheelEntity);
+ *   wheel->Parent = car;
+ *   wheel->Position = glm::vec3(1.0f, -0.5f, 1.5f); // Relative to the car
+ */
+class TransformHierarchy {
+public:
+    static constexpr size_t UPDATE_GRAIN = 2048; // Transforms per job in the local pass
+    static constexpr uint32_t MAX_DEPTH = 64;
+
+    void Update(World& world) {
+        NILOS_PROFILE_SCOPE("TransformHierarchy::Update");
+        m_UpdatedCount = 0;
+
+        ComponentPool<TransformComponent>* pool = world.GetComponentPool<TransformComponent>();
+        size_t count = pool ? pool->Size() : 0;
+        if (count == 0) {
+            return;
+        }
+        TransformComponent* transforms = pool->Data();
+
+        // Local matrices (and world matrices of roots), in parallel
+        m_Flags.resize(count);
+        JobSystem::Get().ParallelFor(count, UPDATE_GRAIN, [this, transforms](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i) {
+                TransformComponent& transform = transforms[i];
+                uint8_t flags = transform.UpdateLocalMatrix() ? LOCAL_CHANGED : 0;
+                if (transform.Parent != NULL_ENTITY) {
+                    flags |= HAS_PARENT;
+                } else {
+                    flags |= UpdateRoot(transform, flags);
+                }
+                m_Flags[i] = flags;
+            }
+        });
+
+        // Resolve parents; children whose parent is gone act as roots
+        m_Children.clear();
+        m_ParentIndex.assign(count, INVALID_INDEX);
+        m_Depth.assign(count, 0);
+        for (size_t i = 0; i < count; ++i) {
+            if (!(m_Flags[i] & HAS_PARENT)) continue;
+
+            const TransformComponent* parent = pool->Get(transforms[i].Parent);
+            if (parent && parent != &transforms[i]) {
+                m_ParentIndex[i] = static_cast<uint32_t>(parent - transforms);
+                m_Depth[i] = UNKNOWN_DEPTH;
+                m_Children.push_back(static_cast<uint32_t>(i));
+            } else {
+                m_Flags[i] |= UpdateRoot(transforms[i], m_Flags[i]);
+            }
+        }
+
+        if (!m_Children.empty()) {
+            SortChildrenByDepth();
+
+            for (uint32_t i : m_Order) {
+                TransformComponent& transform = transforms[i];
+                uint32_t parent = m_ParentIndex[i];
+                if (parent == INVALID_INDEX) {
+                    m_Flags[i] |= UpdateRoot(transform, m_Flags[i]);
+                } else if ((m_Flags[i] & LOCAL_CHANGED) || (m_Flags[parent] & WORLD_CHANGED) ||
+                           transform.CachedParent != transform.Parent) {
+                    Multiply(transforms[parent].WorldMatrix, transform.LocalMatrix, transform.WorldMatrix);
+                    transform.CachedParent = transform.Parent;
+                    m_Flags[i] |= WORLD_CHANGED;
+                }
+            }
+        }
+
+        for (uint8_t flags : m_Flags) {
+            m_UpdatedCount += (flags & WORLD_CHANGED) ? 1 : 0;
+        }
+    }
+
+    /**
+     * @brief World matrices rebuilt by the last Update
+     */
+    uint32_t GetUpdatedCount() const { return m_UpdatedCount; }
+
+    /**
+     * @brief result = parent * local (all three 16-byte aligned, result distinct from the inputs)
+     *
+     * Each result column is the parent's columns weighted by the local
+     * column's elements: four broadcasts and multiply-adds per column.
+     */
+    static void Multiply(const glm::mat4& parent, const glm::mat4& local, glm::mat4& result) {
+        const float* p = &parent[0][0];
+        SIMD::Float4 p0 = SIMD::Load(p);
+        SIMD::Float4 p1 = SIMD::Load(p + 4);
+        SIMD::Float4 p2 = SIMD::Load(p + 8);
+        SIMD::Float4 p3 = SIMD::Load(p + 12);
+
+        for (int column = 0; column < 4; ++column) {
+            const float* l = &local[column][0];
+            SIMD::Float4 value = SIMD::Mul(p3, SIMD::Set1(l[3]));
+            value = SIMD::MulAdd(p2, SIMD::Set1(l[2]), value);
+            value = SIMD::MulAdd(p1, SIMD::Set1(l[1]), value);
+            value = SIMD::MulAdd(p0, SIMD::Set1(l[0]), value);
+            SIMD::Store(&result[column][0], value);
+        }
+    }
+
+private:
+    static constexpr uint8_t LOCAL_CHANGED = 1 << 0;
+    static constexpr uint8_t WORLD_CHANGED = 1 << 1;
+    static constexpr uint8_t HAS_PARENT = 1 << 2;
+    static constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+    static constexpr uint32_t UNKNOWN_DEPTH = UINT32_MAX;
+
+    /**
+     * @brief World matrix of a transform without a (valid) parent
+     * @return WORLD_CHANGED if it was rewritten
+     */
+    static uint8_t UpdateRoot(TransformComponent& transform, uint8_t flags) {
+        if (!(flags & LOCAL_CHANGED) && transform.CachedParent == NULL_ENTITY) {
+            return 0;
+        }
+        transform.WorldMatrix = transform.LocalMatrix;
+        transform.CachedParent = NULL_ENTITY;
+        return WORLD_CHANGED;
+    }
+
+    /**
+     * @brief Fill m_Order with m_Children, shallowest first (counting sort by depth)
+     *
+     * Depths are found by walking up to the first ancestor with a known
+     * depth and filling in the path, so each transform is visited about
+     * once. A walk longer than MAX_DEPTH either ran into a parent cycle,
+     * which is broken by detaching the node where the walk stopped (it is
+     * on the cycle), or is absurdly deep, and the child is cut loose.
+     */
+    void SortChildrenByDepth() {
+        uint32_t maxDepth = 0;
+        for (size_t i = 0; i < m_Children.size(); ++i) {
+            uint32_t child = m_Children[i];
+            uint32_t steps = 0;
+            uint32_t node = child;
+            while (m_Depth[node] == UNKNOWN_DEPTH && steps <= MAX_DEPTH) {
+                node = m_ParentIndex[node];
+                ++steps;
+            }
+
+            if (steps > MAX_DEPTH) {
+                if (!m_ReportedCycle) {
+                    NILOS_ERROR("TransformHierarchy: parent cycle or more than ", MAX_DEPTH,
+                                " levels, detaching a transform");
+                    m_ReportedCycle = true;
+                }
+                if (IsOnCycle(node)) {
+                    // Break the cycle and walk this child again
+                    m_ParentIndex[node] = INVALID_INDEX;
+                    m_Depth[node] = 0;
+                    --i;
+                } else {
+                    m_ParentIndex[child] = INVALID_INDEX;
+                    m_Depth[child] = 0;
+                }
+                continue;
+            }
+
+            uint32_t depth = m_Depth[node] + steps;
+            maxDepth = std::max(maxDepth, depth);
+            for (node = child; m_Depth[node] == UNKNOWN_DEPTH; node = m_ParentIndex[node]) {
+                m_Depth[node] = depth--;
+            }
+        }
+
+        m_LevelOffsets.assign(maxDepth + 2, 0);
+        for (uint32_t child : m_Children) {
+            ++m_LevelOffsets[m_Depth[child] + 1];
+        }
+        for (size_t level = 1; level < m_LevelOffsets.size(); ++level) {
+            m_LevelOffsets[level] += m_LevelOffsets[level - 1];
+        }
+        m_Order.resize(m_Children.size());
+        for (uint32_t child : m_Children) {
+            m_Order[m_LevelOffsets[m_Depth[child]]++] = child;
+        }
+    }
+
+    /**
+     * @brief True if following the parents of node leads back to it within MAX_DEPTH + 1 steps
+     */
+    bool IsOnCycle(uint32_t node) const {
+        uint32_t current = node;
+        for (uint32_t steps = 0; steps <= MAX_DEPTH && m_Depth[current] == UNKNOWN_DEPTH; ++steps) {
+            current = m_ParentIndex[current];
+            if (current == node) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // Per-pass scratch, indexed like the TransformComponent pool (storage reused)
+    std::vector<uint8_t> m_Flags;
+    std::vector<uint32_t> m_ParentIndex;
+    std::vector<uint32_t> m_Depth;
+
+    std::vector<uint32_t> m_Children;     // Dense indices of transforms with a parent
+    std::vector<uint32_t> m_Order;        // m_Children, breadth-first
+    std::vector<uint32_t> m_LevelOffsets;
+    uint32_t m_UpdatedCount = 0;
+    bool m_ReportedCycle = false;
+};
+
+} // namespace Nilos
@@ -0,0 +1,166 @@
+#pragma once
+
+#include "Entity.h"
+#include "ComponentPool.h"
+
+#include <cstddef>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Zero-allocation query over every entity owning all of Ts...
+ *
+ * A view just holds pointers to the component pools involved. Iteration
+ * walks the dense entity array of the SMALLEST pool and checks membership
+ * in the others (O(1) sparse lookups, no hashing). Components of the
+ * smallest pool are read straight from its dense array.
+ *
+ * Usage:
+ *   world->Each<TransformComponent, MeshComponent>(
+ *       [](Entity entity, TransformComponent& transform, MeshComponent& mesh) { ... });
+ *
+ *   for (Entity entity : world->View<TransformComponent, RigidbodyComponent>()) { ... }
+ *
+ * Adding or removing components of a viewed type while iterating
+ * invalidates the view (see ComponentPool pointer stability rules).
+ */
+template<typename... Ts>
+class ComponentView {
+    static_assert(sizeof...(Ts) > 0, "ComponentView needs at least one component type");
+
+public:
+    using PoolTuple = std::tuple<ComponentPool<Ts>*...>;
+
+    explicit ComponentView(ComponentPool<Ts>*... pools)
+        : m_Pools(pools...)
+    {
+        m_Valid = ((pools != nullptr) && ...);
+        if (m_Valid) {
+            SelectLeadPool(std::index_sequence_for<Ts...>{});
+        }
+    }
+
+    /**
+     * @brief Invoke func for every matching entity
+     *
+     * func may take (Entity, Ts&...) or just (Ts&...).
+     */
+    template<typename Func>
+    void Each(Func&& func) {
+        if (!m_Valid) return;
+        DispatchEach(func, std::index_sequence_for<Ts...>{});
+    }
+
+    /**
+     * @brief Get a component of a matching entity
+     */
+    template<typename T>
+    T& Get(Entity entity) {
+        return *std::get<ComponentPool<T>*>(m_Pools)->Get(entity);
+    }
+
+    /**
+     * @brief Check if an entity matches this view
+     */
+    bool Contains(Entity entity) const {
+        return m_Valid && std::apply([entity](auto*... pools) {
+            return (pools->Has(entity) && ...);
+        }, m_Pools);
+    }
+
+    /**
+     * @brief Upper bound on the number of matching entities
+     */
+    size_t SizeHint() const { return m_Lead ? m_Lead->size() : 0; }
+
+    // ========================================================================
+    // Range iteration over matching entities
+    // ========================================================================
+
+    class Iterator {
+    public:
+        Iterator(const ComponentView* view, size_t index) : m_View(view), m_Index(index) {
+            SkipNonMatching();
+        }
+
+        Entity operator*() const { return (*m_View->m_Lead)[m_Index]; }
+
+        Iterator& operator++() {
+            ++m_Index;
+            SkipNonMatching();
+            return *this;
+        }
+
+        bool operator==(const Iterator& other) const { return m_Index == other.m_Index; }
+        bool operator!=(const Iterator& other) const { return m_Index != other.m_Index; }
+
+    private:
+        void SkipNonMatching() {
+            const std::vector<Entity>* lead = m_View->m_Lead;
+            if (!lead) return;
+            while (m_Index < lead->size() && !m_View->Contains((*lead)[m_Index])) {
+                ++m_Index;
+            }
+        }
+
+        const ComponentView* m_View;
+        size_t m_Index;
+    };
+
+    Iterator begin() const { return Iterator(this, 0); }
+    Iterator end() const { return Iterator(this, SizeHint()); }
+
+private:
+    template<size_t... Is>
+    void SelectLeadPool(std::index_sequence<Is...>) {
+        size_t smallest = static_cast<size_t>(-1);
+        ((std::get<Is>(m_Pools)->Size() < smallest
+            ? (smallest = std::get<Is>(m_Pools)->Size(), m_LeadIndex = Is, 0)
+            : 0), ...);
+        (void)((m_LeadIndex == Is ? (m_Lead = &std::get<Is>(m_Pools)->Entities(), true) : false) || ...);
+    }
+
+    template<typename Func, size_t... Is>
+    void DispatchEach(Func& func, std::index_sequence<Is...> seq) {
+        (void)((m_LeadIndex == Is ? (EachWithLead<Is>(func, seq), true) : false) || ...);
+    }
+
+    template<size_t Lead, typename Func, size_t... Is>
+    void EachWithLead(Func& func, std::index_sequence<Is...>) {
+        auto* leadPool = std::get<Lead>(m_Pools);
+        const std::vector<Entity>& entities = leadPool->Entities();
+
+        for (size_t i = 0; i < entities.size(); ++i) {
+            Entity entity = entities[i];
+            if (!((Is == Lead || std::get<Is>(m_Pools)->Has(entity)) && ...)) {
+                continue;
+            }
+
+            if constexpr (std::is_invocable_v<Func&, Entity, Ts&...>) {
+                func(entity, Fetch<Is, Lead>(entity, i)...);
+            } else {
+                func(Fetch<Is, Lead>(entity, i)...);
+            }
+        }
+    }
+
+    template<size_t I, size_t Lead>
+    auto& Fetch(Entity entity, size_t denseIndex) {
+        if constexpr (I == Lead) {
+            return std::get<I>(m_Pools)->Data()[denseIndex];
+        } else {
+            return *std::get<I>(m_Pools)->Get(entity);
+        }
+    }
+
+    PoolTuple m_Pools;
+    const std::vector<Entity>* m_Lead = nullptr;
+    size_t m_LeadIndex = 0;
+    bool m_Valid = false;
+};
+
+} // namespace Nilos
@@ -2,14 +2,17 @@
 
 #include "Entity.h"
 #include "Component.h"
+#include "ComponentPool.h"
+#include "View.h"
 #include "System.h"
 #include "../Core/Logger.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Profiler.h"
 
+#include <deque>
 #include <unordered_map>
 #include <vector>
 #include <memory>
-#include <typeindex>
-#include <any>
 #include <algorithm>
 
 namespace Nilos {
@@ -18,10 +21,10 @@ namespace Nilos {
  * @brief The World manages all entities, components, and systems
  * 
  * This is the core of the ECS architecture. It provides:
- * - Entity creation and destruction
+ * - Entity creation and destruction (generational handles, recycled slots)
  * - Component addition, removal, and access
  * - System registration and update
- * - Entity queries by component type
+ * - Entity queries by component type (View/Each)
  * 
  * Usage example:
  *   auto world = std::make_unique<World>();
@@ -31,7 +34,11 @@ namespace Nilos {
  */
 class World {
 public:
-    World() : m_NextEntityId(1) {}
+    World() {
+        // Slot 0 is reserved so that a zero handle never refers to a live entity
+        m_Generations.push_back(0);
+        m_Signatures.emplace_back();
+    }
     ~World() = default;
 
     /**
@@ -43,12 +50,38 @@ public:
 
     /**
      * @brief Update all systems
+     * 
+     * Enabled systems are grouped into stages. A system goes into the stage
+     * after the last earlier system it conflicts with (see
+     * System::ConflictsWith), so registration order is preserved between
+     * conflicting systems. Systems within one stage run concurrently on the
+     * JobSystem; stages run one after another.
      */
     void Update(float deltaTime) {
-        for (auto& system : m_Systems) {
-            if (system->IsEnabled()) {
-                system->Update(deltaTime);
+        NILOS_PROFILE_SCOPE("World::Update");
+        BuildStages();
+
+        JobSystem& jobs = JobSystem::Get();
+        size_t begin = 0;
+        for (size_t stage = 0; stage < m_StageSizes.size(); ++stage) {
+            size_t end = begin + m_StageSizes[stage];
+
+            if (end - begin == 1 || !jobs.IsRunning()) {
+                for (size_t i = begin; i < end; ++i) {
+                    UpdateSystem(m_StageSystems[i], deltaTime);
+                }
+            } else {
+                JobCounter counter;
+                // Keep the first system for the calling thread
+                for (size_t i = begin + 1; i < end; ++i) {
+                    System* system = m_StageSystems[i];
+                    jobs.Execute([system, deltaTime] { UpdateSystem(system, deltaTime); }, &counter);
+                }
+                UpdateSystem(m_StageSystems[begin], deltaTime);
+                jobs.Wait(counter);
             }
+
+            begin = end;
         }
     }
 
@@ -62,6 +95,10 @@ public:
         m_Systems.clear();
         m_ComponentPools.clear();
         m_EntityNames.clear();
+        m_Generations.resize(1);
+        m_Signatures.resize(1);
+        m_FreeIndices.clear();
+        m_AliveCount = 0;
         NILOS_INFO("World shutdown");
     }
 
@@ -72,10 +109,29 @@ public:
     /**
      * @brief Create a new entity
      * @param name Optional name for debugging
-     * @return The entity ID
+     * @return The entity handle, or NULL_ENTITY if MAX_ENTITIES slots are in use
+     * 
+     * Freed slots are recycled in FIFO order once more than
+     * MINIMUM_FREE_INDICES are waiting, which spreads generation bumps over
+     * many slots and keeps stale handles from matching for a long time.
      */
     Entity CreateEntity(const std::string& name = "") {
-        Entity entity = m_NextEntityId++;
+        uint32_t index;
+        if (m_FreeIndices.size() > MINIMUM_FREE_INDICES ||
+            (!m_FreeIndices.empty() && m_Generations.size() >= MAX_ENTITIES)) {
+            index = m_FreeIndices.front();
+            m_FreeIndices.pop_front();
+        } else if (m_Generations.size() < MAX_ENTITIES) {
+            index = static_cast<uint32_t>(m_Generations.size());
+            m_Generations.push_back(0);
+            m_Signatures.emplace_back();
+        } else {
+            NILOS_ERROR("CreateEntity failed: MAX_ENTITIES (", MAX_ENTITIES, ") reached");
+            return NULL_ENTITY;
+        }
+
+        Entity entity = MakeEntity(index, m_Generations[index]);
+        ++m_AliveCount;
         
         if (!name.empty()) {
             m_EntityNames[entity] = name;
@@ -84,18 +140,95 @@ public:
         return entity;
     }
 
+    /**
+     * @brief Create count unnamed entities
+     * @return Number created (less than count once MAX_ENTITIES is reached)
+     */
+    size_t CreateEntities(size_t count, Entity* entities) {
+        size_t fresh = count > m_FreeIndices.size() ? count - m_FreeIndices.size() : 0;
+        m_Generations.reserve(std::min<size_t>(m_Generations.size() + fresh, MAX_ENTITIES));
+        m_Signatures.reserve(std::min<size_t>(m_Signatures.size() + fresh, MAX_ENTITIES));
+
+        for (size_t i = 0; i < count; ++i) {
+            entities[i] = CreateEntity();
+            if (entities[i] == NULL_ENTITY) {
+                return i;
+            }
+        }
+        return count;
+    }
+
     /**
      * @brief Destroy an entity and all its components
+     * 
+     * Only the pools flagged in the entity's signature are touched.
+     * Destroying a stale or already destroyed handle is a no-op.
      */
     void DestroyEntity(Entity entity) {
+        if (!IsAlive(entity)) return;
+
+        uint32_t index = GetEntityIndex(entity);
+        ComponentSignature& signature = m_Signatures[index];
+
         // Remove all components
-        for (auto& [type, pool] : m_ComponentPools) {
-            auto& componentMap = std::any_cast<std::unordered_map<Entity, std::any>&>(pool);
-            componentMap.erase(entity);
+        for (uint32_t typeId = 0; signature.any(); ++typeId) {
+            if (signature.test(typeId)) {
+                m_ComponentPools[typeId]->Remove(entity);
+                signature.reset(typeId);
+            }
         }
         
         // Remove name
         m_EntityNames.erase(entity);
+
+        // Invalidate outstanding handles and recycle the slot
+        m_Generations[index] = (m_Generations[index] + 1) & ENTITY_GENERATION_MASK;
+        m_FreeIndices.push_back(index);
+        --m_AliveCount;
+    }
+
+    /**
+     * @brief Check if a handle refers to a live entity
+     * 
+     * Destroying bumps the slot generation, so a handle issued before the
+     * destroy no longer matches even if the slot has not been reused yet.
+     */
+    bool IsAlive(Entity entity) const {
+        uint32_t index = GetEntityIndex(entity);
+        return index != 0 && index < m_Generations.size() &&
+               m_Generations[index] == GetEntityGeneration(entity);
+    }
+
+    /**
+     * @brief Number of live entities
+     */
+    uint32_t GetEntityCount() const { return m_AliveCount; }
+
+    /**
+     * @brief Get the component signature of a live entity
+     */
+    const ComponentSignature& GetSignature(Entity entity) const {
+        return m_Signatures[GetEntityIndex(entity)];
+    }
+
+    /**
+     * @brief Set or clear (empty name) the debug name of a live entity
+     */
+    void SetEntityName(Entity entity, const std::string& name) {
+        if (!IsAlive(entity)) return;
+        if (name.empty()) {
+            m_EntityNames.erase(entity);
+        } else {
+            m_EntityNames[entity] = name;
+        }
+    }
+
+    /**
+     * @brief Name set for an entity, nullptr if it has none
+     */
+    const std::string* FindEntityName(Entity entity) const {
+        auto it = m_EntityNames.find(entity);
+        return (it != m_EntityNames.end()) ? &it->second : nullptr;
     }
 
     /**
@@ -103,7 +236,7 @@ public:
      */
     std::string GetEntityName(Entity entity) const {
         auto it = m_EntityNames.find(entity);
-        return (it != m_EntityNames.end()) ? it->second : "Entity_" + std::to_string(entity);
+        return (it != m_EntityNames.end()) ? it->second : "Entity_" + std::to_string(GetEntityIndex(entity));
     }
 
     // ========================================================================
@@ -113,23 +246,45 @@ public:
     /**
      * @brief Add a component to an entity
      * @return Pointer to the newly created component
+     * 
+     * The pointer is only valid until the next Add/Remove of the same
+     * component type (see ComponentPool for the stability rules).
      */
     template<typename T>
     T* AddComponent(Entity entity) {
-        std::type_index typeIndex = typeid(T);
-        
-        // Get or create component pool
-        if (m_ComponentPools.find(typeIndex) == m_ComponentPools.end()) {
-            m_ComponentPools[typeIndex] = std::unordered_map<Entity, std::any>();
+        if (!IsAlive(entity)) {
+            NILOS_ERROR("AddComponent on invalid entity ", GetEntityIndex(entity));
+            return nullptr;
         }
-        
-        auto& pool = std::any_cast<std::unordered_map<Entity, std::any>&>(m_ComponentPools[typeIndex]);
-        
-        // Create and store component
-        T component{};
-        pool[entity] = component;
-        
-        return &std::any_cast<T&>(pool[entity]);
+
+        uint32_t typeId = ComponentTypeIdGenerator::GetId<T>();
+        if (typeId >= MAX_COMPONENTS) {
+            NILOS_CRITICAL("AddComponent: more than MAX_COMPONENTS (", MAX_COMPONENTS, ") component types");
+            return nullptr;
+        }
+
+        m_Signatures[GetEntityIndex(entity)].set(typeId);
+        return &GetOrCreatePool<T>().Add(entity);
+    }
+
+    /**
+     * @brief Add one component to each of many entities (e.g. when loading a scene)
+     * @param entities Live entities that do not have a T yet
+     * @param components Values to copy in one go, or nullptr to default-construct
+     * @return The first new component; all count are contiguous in the pool
+     */
+    template<typename T>
+    T* AddComponents(const Entity* entities, size_t count, const T* components = nullptr) {
+        uint32_t typeId = ComponentTypeIdGenerator::GetId<T>();
+        if (typeId >= MAX_COMPONENTS) {
+            NILOS_CRITICAL("AddComponents: more than MAX_COMPONENTS (", MAX_COMPONENTS, ") component types");
+            return nullptr;
+        }
+
+        for (size_t i = 0; i < count; ++i) {
+            m_Signatures[GetEntityIndex(entities[i])].set(typeId);
+        }
+        return GetOrCreatePool<T>().AddRange(entities, count, components);
     }
 
     /**
@@ -137,12 +292,11 @@ public:
      */
     template<typename T>
     void RemoveComponent(Entity entity) {
-        std::type_index typeIndex = typeid(T);
-        
-        auto poolIt = m_ComponentPools.find(typeIndex);
-        if (poolIt != m_ComponentPools.end()) {
-            auto& pool = std::any_cast<std::unordered_map<Entity, std::any>&>(poolIt->second);
-            pool.erase(entity);
+        if (!IsAlive(entity)) return;
+
+        if (auto* pool = GetComponentPool<T>()) {
+            pool->Remove(entity);
+            m_Signatures[GetEntityIndex(entity)].reset(ComponentTypeIdGenerator::GetId<T>());
         }
     }
 
@@ -152,21 +306,8 @@ public:
      */
     template<typename T>
     T* GetComponent(Entity entity) {
-        std::type_index typeIndex = typeid(T);
-        
-        auto poolIt = m_ComponentPools.find(typeIndex);
-        if (poolIt == m_ComponentPools.end()) {
-            return nullptr;
-        }
-        
-        auto& pool = std::any_cast<std::unordered_map<Entity, std::any>&>(poolIt->second);
-        auto componentIt = pool.find(entity);
-        
-        if (componentIt == pool.end()) {
-            return nullptr;
-        }
-        
-        return &std::any_cast<T&>(componentIt->second);
+        auto* pool = GetComponentPool<T>();
+        return pool ? pool->Get(entity) : nullptr;
     }
 
     /**
@@ -174,15 +315,8 @@ public:
      */
     template<typename T>
     bool HasComponent(Entity entity) const {
-        std::type_index typeIndex = typeid(T);
-        
-        auto poolIt = m_ComponentPools.find(typeIndex);
-        if (poolIt == m_ComponentPools.end()) {
-            return false;
-        }
-        
-        const auto& pool = std::any_cast<const std::unordered_map<Entity, std::any>&>(poolIt->second);
-        return pool.find(entity) != pool.end();
+        const auto* pool = GetComponentPool<T>();
+        return pool && pool->Has(entity);
     }
 
     /**
@@ -190,20 +324,69 @@ public:
      */
     template<typename T>
     std::vector<Entity> GetEntitiesWithComponent() {
-        std::vector<Entity> entities;
-        std::type_index typeIndex = typeid(T);
-        
-        auto poolIt = m_ComponentPools.find(typeIndex);
-        if (poolIt != m_ComponentPools.end()) {
-            const auto& pool = std::any_cast<const std::unordered_map<Entity, std::any>&>(poolIt->second);
-            entities.reserve(pool.size());
-            
-            for (const auto& [entity, component] : pool) {
-                entities.push_back(entity);
-            }
+        const auto* pool = GetComponentPool<T>();
+        return pool ? pool->Entities() : std::vector<Entity>();
+    }
+
+    /**
+     * @brief Same, into a caller-provided vector (e.g. an ArenaVector, so no heap allocation)
+     */
+    template<typename T, typename Alloc>
+    void GetEntitiesWithComponent(std::vector<Entity, Alloc>& entities) {
+        const auto* pool = GetComponentPool<T>();
+        entities.clear();
+        if (pool) {
+            entities.assign(pool->Entities().begin(), pool->Entities().end());
         }
-        
-        return entities;
+    }
+
+    /**
+     * @brief Query every entity that has all of the given components
+     * 
+     * Never allocates. Iterates the smallest of the involved pools:
+     *   for (Entity entity : world->View<TransformComponent, MeshComponent>()) { ... }
+     */
+    template<typename... Ts>
+    ComponentView<Ts...> View() {
+        return ComponentView<Ts...>(GetComponentPool<Ts>()...);
+    }
+
+    /**
+     * @brief Invoke func(Entity, Ts&...) or func(Ts&...) for every matching entity
+     * 
+     * Components are passed by reference directly from dense storage, so no
+     * extra GetComponent lookups are needed inside the loop.
+     */
+    template<typename... Ts, typename Func>
+    void Each(Func&& func) {
+        View<Ts...>().Each(std::forward<Func>(func));
+    }
+
+    /**
+     * @brief Get the dense storage for a component type
+     * @return Pool pointer, or nullptr if no component of this type exists yet
+     * 
+     * Use this for linear iteration over every component of a type:
+     *   if (auto* pool = world->GetComponentPool<TransformComponent>()) {
+     *       for (TransformComponent& transform : *pool) { ... }
+     *   }
+     */
+    template<typename T>
+    ComponentPool<T>* GetComponentPool() {
+        uint32_t typeId = ComponentTypeIdGenerator::GetId<T>();
+        if (typeId >= m_ComponentPools.size()) {
+            return nullptr;
+        }
+        return static_cast<ComponentPool<T>*>(m_ComponentPools[typeId].get());
+    }
+
+    template<typename T>
+    const ComponentPool<T>* GetComponentPool() const {
+        uint32_t typeId = ComponentTypeIdGenerator::GetId<T>();
+        if (typeId >= m_ComponentPools.size()) {
+            return nullptr;
+        }
+        return static_cast<const ComponentPool<T>*>(m_ComponentPools[typeId].get());
     }
 
     // ========================================================================
@@ -218,6 +401,7 @@ public:
         auto system = std::make_unique<T>();
         T* systemPtr = system.get();
         
+        system->m_World = this;
         system->Initialize();
         m_Systems.push_back(std::move(system));
         
@@ -240,16 +424,96 @@ public:
     }
 
 private:
-    Entity m_NextEntityId;
+    /**
+     * @brief Update one system inside a profiler scope named after it
+     */
+    static void UpdateSystem(System* system, float deltaTime) {
+        NILOS_PROFILE_SCOPE(system->GetName());
+        system->Update(deltaTime);
+    }
+
+    /**
+     * @brief Assign every enabled system to a stage (m_StageSystems grouped by m_StageSizes)
+     * 
+     * Rebuilt each frame since systems may be toggled; O(n^2) in the number of
+     * systems, which is small, and the scratch vectors are reused.
+     */
+    void BuildStages() {
+        m_StageOf.assign(m_Systems.size(), 0);
+        m_StageSizes.clear();
+
+        size_t stageCount = 0;
+        for (size_t i = 0; i < m_Systems.size(); ++i) {
+            if (!m_Systems[i]->IsEnabled()) continue;
+
+            size_t stage = 0;
+            for (size_t j = 0; j < i; ++j) {
+                if (m_Systems[j]->IsEnabled() && m_Systems[i]->ConflictsWith(*m_Systems[j])) {
+                    stage = std::max(stage, m_StageOf[j] + 1);
+                }
+            }
+            m_StageOf[i] = stage;
+            stageCount = std::max(stageCount, stage + 1);
+        }
+
+        m_StageSizes.resize(stageCount, 0);
+        for (size_t i = 0; i < m_Systems.size(); ++i) {
+            if (m_Systems[i]->IsEnabled()) ++m_StageSizes[m_StageOf[i]];
+        }
+
+        // Counting sort by stage, stable so registration order is kept inside a stage
+        m_StageOffsets.assign(stageCount, 0);
+        for (size_t stage = 1; stage < stageCount; ++stage) {
+            m_StageOffsets[stage] = m_StageOffsets[stage - 1] + m_StageSizes[stage - 1];
+        }
+        m_StageSystems.resize(stageCount ? m_StageOffsets.back() + m_StageSizes.back() : 0);
+        for (size_t i = 0; i < m_Systems.size(); ++i) {
+            if (m_Systems[i]->IsEnabled()) {
+                m_StageSystems[m_StageOffsets[m_StageOf[i]]++] = m_Systems[i].get();
+            }
+        }
+    }
+
+    /**
+     * @brief Get the pool for a component type, creating it on first use
+     */
+    template<typename T>
+    ComponentPool<T>& GetOrCreatePool() {
+        uint32_t typeId = ComponentTypeIdGenerator::GetId<T>();
+        if (typeId >= m_ComponentPools.size()) {
+            m_ComponentPools.resize(typeId + 1);
+        }
+        
+        auto& pool = m_ComponentPools[typeId];
+        if (!pool) {
+            pool = std::make_unique<ComponentPool<T>>();
+        }
+        
+        return *static_cast<ComponentPool<T>*>(pool.get());
+    }
+
+    static constexpr size_t MINIMUM_FREE_INDICES = 1024;
+
+    // Entity allocation: per-slot generation + component signature, FIFO free list
+    std::vector<uint32_t> m_Generations;
+    std::vector<ComponentSignature> m_Signatures;
+    std::deque<uint32_t> m_FreeIndices;
+    uint32_t m_AliveCount = 0;
     
-    // Component storage: type -> (entity -> component)
-    std::unordered_map<std::type_index, std::any> m_ComponentPools;
+    // Component storage: component type ID -> dense pool
+    std::vector<std::unique_ptr<IComponentPool>> m_ComponentPools;
     
     // Entity names for debugging
     std::unordered_map<Entity, std::string> m_EntityNames;
     
     // Registered systems
     std::vector<std::unique_ptr<System>> m_Systems;
+
+    // Per-frame scheduling scratch (see BuildStages)
+    std::vector<size_t> m_StageOf;
+    std::vector<size_t> m_StageSizes;
+    std::vector<size_t> m_StageOffsets;
+    std::vector<System*> m_StageSystems;
 };
 
 } // namespace Nilos
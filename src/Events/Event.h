@@ -1,6 +1,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include <glm/glm.hpp>
 
 namespace Nilos {
@@ -179,5 +180,20 @@ public:
     float Distance;
 };
 
+/**
+ * @brief Path request finished (see PathRequestQueue)
+ */
+class PathResultEvent : public Event {
+public:
+    PathResultEvent(uint32_t ticket, bool found, const std::vector<glm::vec3>& path)
+        : Ticket(ticket), Found(found), Path(path) {}
+
+    const char* GetName() const override { return "PathResultEvent"; }
+
+    uint32_t Ticket;
+    bool Found;                   // False if unreachable or an end was outside the grid
+    std::vector<glm::vec3> Path;  // Cell centers from start to goal, empty if not found
+};
+
 } // namespace Nilos
 
@@ -1,13 +1,18 @@
 #pragma once
 
 #include "Event.h"
+#include "../Core/JobSystem.h"
 #include "../Core/Logger.h"
 
+#include <algorithm>
+#include <atomic>
 #include <functional>
-#include <unordered_map>
-#include <vector>
-#include <typeindex>
 #include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
 
 namespace Nilos {
 
@@ -16,6 +21,27 @@ namespace Nilos {
  * 
  * Systems can subscribe to events they care about and dispatch events
  * when something interesting happens. This maintains loose coupling.
+ *
+ * Each event type has its own channel, found by a small per-type index
+ * rather than a hash lookup, holding typed subscribers and a queue of
+ * deferred events stored by value. QueueEvent appends to that contiguous
+ * queue (no allocation once it has grown); ProcessQueue then delivers
+ * each type's events as one batch, types in the order they were first
+ * queued, events of a type in queue order. Events queued while the queue
+ * is processed wait for the next ProcessQueue.
+ *
+ * QueueEvent may be called from any thread. The main thread (the one
+ * that called Initialize) appends straight to the channel; every other
+ * thread appends to a buffer of its own, so producers never contend with
+ * each other. ProcessQueue merges those buffers after the main thread's
+ * events, ordered by the order key passed to QueueEvent; give worker
+ * events a key (entity, job index, ...) and their order no longer
+ * depends on which thread ran what (the main thread runs jobs too, so
+ * its keyed events are sorted in with them). Everything else
+ * (Subscribe, Dispatch, ProcessQueue) is main-thread only.
+ *
+ * Subscribers registered with SubscribeParallel are invoked for queued
+ * events on the job system, so they must be safe to run concurrently.
  * 
  * Usage:
  *   // Subscribe to an event
@@ -25,11 +51,15 @@ namespace Nilos {
  * 
  *   // Dispatch an event
  *   EventManager::Get().Dispatch(CollisionEvent(entityA, entityB));
+ *
+ *   // Or defer it to the start of the next frame, and take many at once
+ *   EventManager::Get().QueueEvent(CollisionEvent(entityA, entityB, point));
+ *   EventManager::Get().SubscribeBatch<CollisionEvent>([](const CollisionEvent* events, size_t count) {
+ *       // Handle a frame's collisions
+ *   });
  */
 class EventManager {
 public:
-    using EventCallback = std::function<void(const Event&)>;
-
     /**
      * @brief Get the singleton instance
      */
@@ -42,14 +72,22 @@ public:
      * @brief Initialize the event system
      */
     void Initialize() {
+        m_MainThread = std::this_thread::get_id();
         NILOS_DEBUG("EventManager initialized");
     }
 
     /**
-     * @brief Shutdown the event system
+     * @brief Shutdown the event system (drops subscribers and queued events)
      */
     void Shutdown() {
-        m_Subscribers.clear();
+        {
+            // Thread buffers go too; threads still holding one notice the new generation
+            std::lock_guard<std::mutex> lock(m_ProducersMutex);
+            m_Producers.clear();
+            m_ProducerGeneration.fetch_add(1, std::memory_order_relaxed);
+        }
+        m_Channels.clear();
+        m_PendingChannels.clear();
         NILOS_DEBUG("EventManager shutdown");
     }
 
@@ -59,31 +97,47 @@ public:
      */
     template<typename T>
     uint32_t Subscribe(std::function<void(const T&)> callback) {
-        std::type_index typeIndex = typeid(T);
-        
-        // Wrap the typed callback in a generic one
-        EventCallback genericCallback = [callback](const Event& event) {
-            callback(static_cast<const T&>(event));
-        };
-        
         uint32_t subscriptionId = m_NextSubscriptionId++;
-        m_Subscribers[typeIndex].push_back({subscriptionId, genericCallback});
-        
+        GetChannel<T>().Subscribers.push_back({subscriptionId, std::move(callback)});
         return subscriptionId;
     }
 
     /**
-     * @brief Unsubscribe from an event
+     * @brief Subscribe to whole batches of an event type
+     *
+     * Gets all of a frame's queued events of the type in one call, before
+     * the per-event subscribers; an immediate Dispatch arrives as a batch
+     * of one.
+     */
+    template<typename T>
+    uint32_t SubscribeBatch(std::function<void(const T* events, size_t count)> callback) {
+        uint32_t subscriptionId = m_NextSubscriptionId++;
+        GetChannel<T>().BatchSubscribers.push_back({subscriptionId, std::move(callback)});
+        return subscriptionId;
+    }
+
+    /**
+     * @brief Subscribe with a callback that may run on worker threads
+     *
+     * Queued events of the type are split over the job system; the call
+     * returns before the per-event subscribers run. The callback must be
+     * safe to run concurrently with itself, and Handled is not honored.
+     */
+    template<typename T>
+    uint32_t SubscribeParallel(std::function<void(const T&)> callback) {
+        uint32_t subscriptionId = m_NextSubscriptionId++;
+        GetChannel<T>().ParallelSubscribers.push_back({subscriptionId, std::move(callback)});
+        return subscriptionId;
+    }
+
+    /**
+     * @brief Unsubscribe from an event (not from inside a callback of the same type)
      */
     void Unsubscribe(uint32_t subscriptionId) {
-        for (auto& [type, callbacks] : m_Subscribers) {
-            callbacks.erase(
-                std::remove_if(callbacks.begin(), callbacks.end(),
-                    [subscriptionId](const Subscription& sub) {
-                        return sub.Id == subscriptionId;
-                    }),
-                callbacks.end()
-            );
+        for (const std::unique_ptr<ChannelBase>& channel : m_Channels) {
+            if (channel) {
+                channel->Unsubscribe(subscriptionId);
+            }
         }
     }
 
@@ -94,18 +148,10 @@ public:
      */
     template<typename T>
     void Dispatch(const T& event) {
-        std::type_index typeIndex = typeid(T);
-        
-        auto it = m_Subscribers.find(typeIndex);
-        if (it != m_Subscribers.end()) {
-            for (auto& subscription : it->second) {
-                subscription.Callback(event);
-                
-                // Stop propagation if event is marked as handled
-                if (event.Handled) {
-                    break;
-                }
-            }
+        static_assert(std::is_base_of<Event, T>::value, "Events must derive from Event");
+        uint32_t typeId = GetTypeId<T>();
+        if (typeId < m_Channels.size() && m_Channels[typeId]) {
+            static_cast<Channel<T>&>(*m_Channels[typeId]).Deliver(&event, 1);
         }
     }
 
@@ -113,10 +159,32 @@ public:
      * @brief Queue an event for processing later
      * 
      * Events will be dispatched at the beginning of the next frame.
+     * Safe from any thread.
+     *
+     * @param orderKey Events with a key, or from other threads than the
+     *        main one, follow the main thread's unkeyed events sorted by
+     *        key (ties keep per-thread order)
      */
     template<typename T>
-    void QueueEvent(const T& event) {
-        m_EventQueue.push_back(std::make_unique<T>(event));
+    void QueueEvent(T event, uint64_t orderKey = 0) {
+        static_assert(std::is_base_of<Event, T>::value, "Events must derive from Event");
+        if (std::this_thread::get_id() != m_MainThread) {
+            QueueFromWorker(std::move(event), orderKey);
+            return;
+        }
+
+        Channel<T>& channel = GetChannel<T>();
+        if (orderKey != 0) {
+            if (channel.Incoming.empty()) {
+                m_MergedChannels.push_back(GetTypeId<T>());
+            }
+            channel.Incoming.push_back({orderKey, std::move(event)});
+            return;
+        }
+        if (channel.Queue.empty()) {
+            m_PendingChannels.push_back(GetTypeId<T>());
+        }
+        channel.Queue.push_back(std::move(event));
     }
 
     /**
@@ -125,27 +193,288 @@ public:
      * Should be called once per frame, usually at the beginning.
      */
     void ProcessQueue() {
-        for (auto& event : m_EventQueue) {
-            // Find the event type and dispatch
-            // Note: This is a simplified version. Production code would need
-            // a more sophisticated type-erased dispatch mechanism.
-            // For now, we'll skip this in the demo.
+        MergeProducers();
+
+        // Swapped out, so channels queued from inside the callbacks go to the next call
+        m_ProcessingChannels.swap(m_PendingChannels);
+        for (uint32_t typeId : m_ProcessingChannels) {
+            if (typeId < m_Channels.size() && m_Channels[typeId]) {
+                m_Channels[typeId]->DeliverQueue();
+            }
+        }
+        m_ProcessingChannels.clear();
+    }
+
+    /**
+     * @brief Events waiting for the next ProcessQueue (not counting other threads' buffers)
+     */
+    size_t GetQueuedCount() const {
+        size_t count = 0;
+        for (uint32_t typeId : m_PendingChannels) {
+            count += m_Channels[typeId]->GetQueuedCount();
         }
-        m_EventQueue.clear();
+        for (uint32_t typeId : m_MergedChannels) {
+            count += m_Channels[typeId]->GetIncomingCount();
+        }
+        return count;
     }
 
 private:
-    EventManager() : m_NextSubscriptionId(1) {}
+    EventManager() : m_NextSubscriptionId(1), m_MainThread(std::this_thread::get_id()) {}
+
+    // Queued events per job for parallel subscribers
+    static constexpr size_t PARALLEL_GRAIN = 256;
+
+    /**
+     * @brief Dense index of an event type, assigned on first use
+     */
+    template<typename T>
+    static uint32_t GetTypeId() {
+        static const uint32_t id = s_NextTypeId.fetch_add(1, std::memory_order_relaxed);
+        return id;
+    }
+
+    template<typename T>
+    struct KeyedEvent {
+        uint64_t Key;
+        T Value;
+    };
+
+    struct ChannelBase {
+        virtual ~ChannelBase() = default;
+        virtual void DeliverQueue() = 0;
+        virtual void Unsubscribe(uint32_t subscriptionId) = 0;
+        virtual size_t GetQueuedCount() const = 0;
+
+        /**
+         * @brief Append the events merged from thread buffers to the queue, sorted by key
+         */
+        virtual void QueueIncoming() = 0;
+        virtual size_t GetIncomingCount() const = 0;
+    };
+
+    template<typename T>
+    struct Channel : ChannelBase {
+        struct Subscription {
+            uint32_t Id;
+            std::function<void(const T&)> Callback;
+        };
+        struct BatchSubscription {
+            uint32_t Id;
+            std::function<void(const T*, size_t)> Callback;
+        };
+
+        void Deliver(const T* events, size_t count) {
+            for (BatchSubscription& subscription : BatchSubscribers) {
+                subscription.Callback(events, count);
+            }
+            if (!ParallelSubscribers.empty()) {
+                JobSystem::Get().ParallelFor(count, PARALLEL_GRAIN, [this, events](size_t begin, size_t end) {
+                    for (size_t i = begin; i < end; ++i) {
+                        for (const Subscription& subscription : ParallelSubscribers) {
+                            subscription.Callback(events[i]);
+                        }
+                    }
+                });
+            }
+            if (Subscribers.empty()) {
+                return;
+            }
+            for (size_t i = 0; i < count; ++i) {
+                for (Subscription& subscription : Subscribers) {
+                    subscription.Callback(events[i]);
+
+                    // Stop propagation if event is marked as handled
+                    if (events[i].Handled) {
+                        break;
+                    }
+                }
+            }
+        }
+
+        void DeliverQueue() override {
+            // Delivered from a second buffer: callbacks may queue more of this type
+            Processing.swap(Queue);
+            Deliver(Processing.data(), Processing.size());
+            Processing.clear();
+        }
 
-    struct Subscription {
-        uint32_t Id;
-        EventCallback Callback;
+        void QueueIncoming() override {
+            Queue.reserve(Queue.size() + Incoming.size());
+            bool sorted = std::is_sorted(Incoming.begin(), Incoming.end(),
+                [](const KeyedEvent<T>& a, const KeyedEvent<T>& b) { return a.Key < b.Key; });
+            if (sorted) {
+                for (KeyedEvent<T>& event : Incoming) {
+                    Queue.push_back(std::move(event.Value));
+                }
+            } else {
+                // Sort small (key, index) pairs rather than the events; the index keeps ties stable
+                Order.clear();
+                for (size_t i = 0; i < Incoming.size(); ++i) {
+                    Order.push_back({Incoming[i].Key, i});
+                }
+                std::sort(Order.begin(), Order.end());
+                for (const std::pair<uint64_t, size_t>& entry : Order) {
+                    Queue.push_back(std::move(Incoming[entry.second].Value));
+                }
+            }
+            Incoming.clear();
+        }
+
+        void Unsubscribe(uint32_t subscriptionId) override {
+            auto matches = [subscriptionId](const Subscription& sub) { return sub.Id == subscriptionId; };
+            Subscribers.erase(std::remove_if(Subscribers.begin(), Subscribers.end(), matches), Subscribers.end());
+            ParallelSubscribers.erase(std::remove_if(ParallelSubscribers.begin(), ParallelSubscribers.end(), matches),
+                                      ParallelSubscribers.end());
+            BatchSubscribers.erase(std::remove_if(BatchSubscribers.begin(), BatchSubscribers.end(),
+                [subscriptionId](const BatchSubscription& sub) { return sub.Id == subscriptionId; }),
+                BatchSubscribers.end());
+        }
+
+        size_t GetQueuedCount() const override { return Queue.size(); }
+        size_t GetIncomingCount() const override { return Incoming.size(); }
+
+        std::vector<Subscription> Subscribers;
+        std::vector<Subscription> ParallelSubscribers;
+        std::vector<BatchSubscription> BatchSubscribers;
+        std::vector<T> Queue;       // Keeps its capacity, so steady-state queuing does not allocate
+        std::vector<T> Processing;
+        std::vector<KeyedEvent<T>> Incoming;  // Merged from thread buffers, before sorting
+        std::vector<std::pair<uint64_t, size_t>> Order;
     };
 
+    struct ThreadQueueBase {
+        virtual ~ThreadQueueBase() = default;
+        virtual std::unique_ptr<ChannelBase> CreateChannel() const = 0;
+
+        /**
+         * @brief Move the buffered events to the channel's incoming list
+         */
+        virtual void MoveTo(ChannelBase& channel) = 0;
+    };
+
+    template<typename T>
+    struct ThreadQueue : ThreadQueueBase {
+        std::unique_ptr<ChannelBase> CreateChannel() const override { return std::make_unique<Channel<T>>(); }
+
+        void MoveTo(ChannelBase& channel) override {
+            std::vector<KeyedEvent<T>>& incoming = static_cast<Channel<T>&>(channel).Incoming;
+            incoming.insert(incoming.end(), std::make_move_iterator(Events.begin()),
+                            std::make_move_iterator(Events.end()));
+            Events.clear();
+        }
+
+        std::vector<KeyedEvent<T>> Events;
+    };
+
+    /**
+     * @brief Events queued by one non-main thread since the last merge
+     *
+     * Only its thread and the merge touch it, so the lock is practically
+     * never contended.
+     */
+    struct Producer {
+        std::mutex Mutex;
+        std::vector<std::unique_ptr<ThreadQueueBase>> Queues;  // By type ID
+        std::vector<uint32_t> UsedTypes;                       // Types with events, first queued first
+    };
+
+    struct ThreadState {
+        Producer* Buffer = nullptr;
+        uint32_t Generation = 0;
+    };
+
+    static ThreadState& GetThreadState() {
+        thread_local ThreadState state;
+        return state;
+    }
+
+    template<typename T>
+    void QueueFromWorker(T event, uint64_t orderKey) {
+        ThreadState& thread = GetThreadState();
+        uint32_t generation = m_ProducerGeneration.load(std::memory_order_relaxed);
+        if (!thread.Buffer || thread.Generation != generation) {
+            std::lock_guard<std::mutex> lock(m_ProducersMutex);
+            m_Producers.push_back(std::make_unique<Producer>());
+            thread.Buffer = m_Producers.back().get();
+            thread.Generation = m_ProducerGeneration.load(std::memory_order_relaxed);
+        }
+
+        Producer& producer = *thread.Buffer;
+        uint32_t typeId = GetTypeId<T>();
+        std::lock_guard<std::mutex> lock(producer.Mutex);
+        if (typeId >= producer.Queues.size()) {
+            producer.Queues.resize(typeId + 1);
+        }
+        if (!producer.Queues[typeId]) {
+            producer.Queues[typeId] = std::make_unique<ThreadQueue<T>>();
+        }
+        ThreadQueue<T>& queue = static_cast<ThreadQueue<T>&>(*producer.Queues[typeId]);
+        if (queue.Events.empty()) {
+            producer.UsedTypes.push_back(typeId);
+        }
+        queue.Events.push_back({orderKey, std::move(event)});
+    }
+
+    /**
+     * @brief Move every thread's buffered events into their channels' queues
+     */
+    void MergeProducers() {
+        std::lock_guard<std::mutex> lock(m_ProducersMutex);
+        for (const std::unique_ptr<Producer>& producer : m_Producers) {
+            std::lock_guard<std::mutex> bufferLock(producer->Mutex);
+            for (uint32_t typeId : producer->UsedTypes) {
+                ThreadQueueBase& queue = *producer->Queues[typeId];
+                if (typeId >= m_Channels.size()) {
+                    m_Channels.resize(typeId + 1);
+                }
+                if (!m_Channels[typeId]) {
+                    m_Channels[typeId] = queue.CreateChannel();
+                }
+                if (m_Channels[typeId]->GetIncomingCount() == 0) {
+                    m_MergedChannels.push_back(typeId);
+                }
+                queue.MoveTo(*m_Channels[typeId]);
+            }
+            producer->UsedTypes.clear();
+        }
+
+        // By type rather than by which thread happened to register first
+        std::sort(m_MergedChannels.begin(), m_MergedChannels.end());
+        for (uint32_t typeId : m_MergedChannels) {
+            ChannelBase& channel = *m_Channels[typeId];
+            if (channel.GetQueuedCount() == 0) {
+                m_PendingChannels.push_back(typeId);
+            }
+            channel.QueueIncoming();
+        }
+        m_MergedChannels.clear();
+    }
+
+    template<typename T>
+    Channel<T>& GetChannel() {
+        uint32_t typeId = GetTypeId<T>();
+        if (typeId >= m_Channels.size()) {
+            m_Channels.resize(typeId + 1);
+        }
+        if (!m_Channels[typeId]) {
+            m_Channels[typeId] = std::make_unique<Channel<T>>();
+        }
+        return static_cast<Channel<T>&>(*m_Channels[typeId]);
+    }
+
+    static inline std::atomic<uint32_t> s_NextTypeId{0};
+
     uint32_t m_NextSubscriptionId;
-    std::unordered_map<std::type_index, std::vector<Subscription>> m_Subscribers;
-    std::vector<std::unique_ptr<Event>> m_EventQueue;
+    std::vector<std::unique_ptr<ChannelBase>> m_Channels;  // By type ID, null if never used
+    std::vector<uint32_t> m_PendingChannels;               // Types with queued events, first queued first
+    std::vector<uint32_t> m_ProcessingChannels;
+    std::vector<uint32_t> m_MergedChannels;
+
+    std::thread::id m_MainThread;
+    std::mutex m_ProducersMutex;
+    std::vector<std::unique_ptr<Producer>> m_Producers;  // One per thread that queued events
+    std::atomic<uint32_t> m_ProducerGeneration{0};
 };
 
 } // namespace Nilos
-
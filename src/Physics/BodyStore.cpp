@@ -0,0 +1,59 @@
+#include "BodyStore.h"
+
+#include <algorithm>
+
+namespace Nilos {
+
+void BodyStore::Resize(size_t count) {
+    Count = count;
+    size_t padded = SIMD::PadToWidth(count);
+
+    for (FloatArray* array : { &PositionX, &PositionY, &PositionZ,
+                               &VelocityX, &VelocityY, &VelocityZ,
+                               &ForceX, &ForceY, &ForceZ,
+                               &InverseMass, &GravityScale, &Damping, &MoveScale }) {
+        array->resize(padded);
+        std::fill(array->begin() + count, array->end(), 0.0f);
+    }
+}
+
+void BodyStore::IntegrateVelocities(const glm::vec3& gravity, float deltaTime, size_t begin, size_t end) {
+    end = std::min(end, SIMD::PadToWidth(Count));
+
+    const SIMD::Float4 dt = SIMD::Set1(deltaTime);
+    const SIMD::Float4 gx = SIMD::Set1(gravity.x);
+    const SIMD::Float4 gy = SIMD::Set1(gravity.y);
+    const SIMD::Float4 gz = SIMD::Set1(gravity.z);
+
+    for (size_t i = begin; i < end; i += SIMD::WIDTH) {
+        SIMD::Float4 inverseMass = SIMD::Load(&InverseMass[i]);
+        SIMD::Float4 gravityScale = SIMD::Load(&GravityScale[i]);
+        SIMD::Float4 damping = SIMD::Load(&Damping[i]);
+
+        // a = F/m + g, v = (v + a*dt) * damping
+        SIMD::Float4 ax = SIMD::MulAdd(SIMD::Load(&ForceX[i]), inverseMass, SIMD::Mul(gx, gravityScale));
+        SIMD::Float4 ay = SIMD::MulAdd(SIMD::Load(&ForceY[i]), inverseMass, SIMD::Mul(gy, gravityScale));
+        SIMD::Float4 az = SIMD::MulAdd(SIMD::Load(&ForceZ[i]), inverseMass, SIMD::Mul(gz, gravityScale));
+
+        SIMD::Store(&VelocityX[i], SIMD::Mul(SIMD::MulAdd(ax, dt, SIMD::Load(&VelocityX[i])), damping));
+        SIMD::Store(&VelocityY[i], SIMD::Mul(SIMD::MulAdd(ay, dt, SIMD::Load(&VelocityY[i])), damping));
+        SIMD::Store(&VelocityZ[i], SIMD::Mul(SIMD::MulAdd(az, dt, SIMD::Load(&VelocityZ[i])), damping));
+    }
+}
+
+void BodyStore::IntegratePositions(float deltaTime, size_t begin, size_t end) {
+    end = std::min(end, SIMD::PadToWidth(Count));
+
+    const SIMD::Float4 dt = SIMD::Set1(deltaTime);
+
+    for (size_t i = begin; i < end; i += SIMD::WIDTH) {
+        SIMD::Float4 step = SIMD::Mul(dt, SIMD::Load(&MoveScale[i]));
+
+        // p += v * dt
+        SIMD::Store(&PositionX[i], SIMD::MulAdd(SIMD::Load(&VelocityX[i]), step, SIMD::Load(&PositionX[i])));
+        SIMD::Store(&PositionY[i], SIMD::MulAdd(SIMD::Load(&VelocityY[i]), step, SIMD::Load(&PositionY[i])));
+        SIMD::Store(&PositionZ[i], SIMD::MulAdd(SIMD::Load(&VelocityZ[i]), step, SIMD::Load(&PositionZ[i])));
+    }
+}
+
+} // namespace Nilos
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "../Core/SIMD.h"
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Structure-of-arrays copy of the rigidbody state used by the integrator
+ *
+ * PhysicsWorld gathers positions, velocities, forces and per-body constants
+ * from the ECS components into these arrays once per step, integrates them
+ * with SIMD kernels (velocities, then the contact solver, then positions)
+ * and scatters the results back. Every array is
+ * SIMD::ALIGNMENT aligned and padded to a multiple of SIMD::WIDTH; padding
+ * lanes hold zeros and are never written back.
+ *
+ * Per-body constants encode the body type so the kernel has no branches:
+ * - dynamic:   InverseMass = 1/m, GravityScale = UseGravity, Damping = 1 / (1 + dt * LinearDamping), MoveScale = 1
+ * - kinematic: InverseMass = 0,   GravityScale = 0,          Damping = 1,                             MoveScale = 1
+ * - static:    all zero except Damping = 1 (position and velocity never change)
+ */
+struct BodyStore {
+    using FloatArray = std::vector<float, AlignedAllocator<float>>;
+
+    FloatArray PositionX, PositionY, PositionZ;
+    FloatArray VelocityX, VelocityY, VelocityZ;
+    FloatArray ForceX, ForceY, ForceZ;
+    FloatArray InverseMass;
+    FloatArray GravityScale;
+    FloatArray Damping;
+    FloatArray MoveScale;
+
+    size_t Count = 0;
+
+    /**
+     * @brief Resize every array for count bodies (zeroing the padding)
+     */
+    void Resize(size_t count);
+
+    /**
+     * @brief Apply forces and gravity to the velocities
+     *
+     * v = (v + (F * invMass + g * gravityScale) * dt) * damping
+     *
+     * @param begin First body (multiple of SIMD::WIDTH)
+     * @param end One past the last body (clamped to the padded size)
+     */
+    void IntegrateVelocities(const glm::vec3& gravity, float deltaTime, size_t begin, size_t end);
+
+    /**
+     * @brief Integrate velocity into position (after the contact solver ran)
+     *
+     * p = p + v * dt * moveScale
+     */
+    void IntegratePositions(float deltaTime, size_t begin, size_t end);
+
+    // Scalar access for the contact solver
+    glm::vec3 GetPosition(size_t i) const { return glm::vec3(PositionX[i], PositionY[i], PositionZ[i]); }
+    glm::vec3 GetVelocity(size_t i) const { return glm::vec3(VelocityX[i], VelocityY[i], VelocityZ[i]); }
+
+    void AddPosition(size_t i, const glm::vec3& delta) {
+        PositionX[i] += delta.x;
+        PositionY[i] += delta.y;
+        PositionZ[i] += delta.z;
+    }
+    void AddVelocity(size_t i, const glm::vec3& delta) {
+        VelocityX[i] += delta.x;
+        VelocityY[i] += delta.y;
+        VelocityZ[i] += delta.z;
+    }
+};
+
+} // namespace Nilos
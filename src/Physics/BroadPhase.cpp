@@ -0,0 +1,275 @@
+#include "BroadPhase.h"
+
+#include <algorithm>
+#include <cassert>
+
+namespace Nilos {
+
+int32_t DynamicAABBTree::CreateProxy(const AABB& aabb, uint32_t userData) {
+    int32_t proxyId = AllocateNode();
+
+    Node& node = m_Nodes[proxyId];
+    node.Box = AABB(aabb.Min - glm::vec3(AABB_MARGIN), aabb.Max + glm::vec3(AABB_MARGIN));
+    node.UserData = userData;
+    node.Height = 0;
+
+    InsertLeaf(proxyId);
+    ++m_ProxyCount;
+    return proxyId;
+}
+
+void DynamicAABBTree::DestroyProxy(int32_t proxyId) {
+    assert(proxyId >= 0 && proxyId < static_cast<int32_t>(m_Nodes.size()));
+    assert(m_Nodes[proxyId].IsLeaf());
+
+    RemoveLeaf(proxyId);
+    FreeNode(proxyId);
+    --m_ProxyCount;
+}
+
+bool DynamicAABBTree::MoveProxy(int32_t proxyId, const AABB& aabb, const glm::vec3& displacement) {
+    assert(m_Nodes[proxyId].IsLeaf());
+
+    if (ContainsBox(m_Nodes[proxyId].Box, aabb)) {
+        return false;
+    }
+
+    RemoveLeaf(proxyId);
+
+    // Grow by the margin, then stretch ahead in the direction of motion
+    AABB fat(aabb.Min - glm::vec3(AABB_MARGIN), aabb.Max + glm::vec3(AABB_MARGIN));
+    glm::vec3 predicted = displacement * DISPLACEMENT_MULTIPLIER;
+    fat.Min += glm::min(predicted, glm::vec3(0.0f));
+    fat.Max += glm::max(predicted, glm::vec3(0.0f));
+    m_Nodes[proxyId].Box = fat;
+
+    InsertLeaf(proxyId);
+    return true;
+}
+
+void DynamicAABBTree::Clear() {
+    m_Nodes.clear();
+    m_Root = NULL_NODE;
+    m_FreeList = NULL_NODE;
+    m_ProxyCount = 0;
+}
+
+int32_t DynamicAABBTree::AllocateNode() {
+    if (m_FreeList == NULL_NODE) {
+        m_Nodes.emplace_back();
+        return static_cast<int32_t>(m_Nodes.size() - 1);
+    }
+
+    int32_t nodeId = m_FreeList;
+    m_FreeList = m_Nodes[nodeId].Parent;
+    m_Nodes[nodeId] = Node();
+    return nodeId;
+}
+
+void DynamicAABBTree::FreeNode(int32_t nodeId) {
+    m_Nodes[nodeId].Parent = m_FreeList;
+    m_Nodes[nodeId].Height = -1;
+    m_FreeList = nodeId;
+}
+
+void DynamicAABBTree::InsertLeaf(int32_t leaf) {
+    if (m_Root == NULL_NODE) {
+        m_Root = leaf;
+        m_Nodes[leaf].Parent = NULL_NODE;
+        return;
+    }
+
+    // Descend towards the sibling that minimizes the added surface area
+    AABB leafBox = m_Nodes[leaf].Box;
+    int32_t index = m_Root;
+    while (!m_Nodes[index].IsLeaf()) {
+        const Node& node = m_Nodes[index];
+        float area = SurfaceArea(node.Box);
+        float combinedArea = SurfaceArea(Union(node.Box, leafBox));
+
+        // Cost of making a new parent for this node and the leaf
+        float cost = 2.0f * combinedArea;
+        // Minimum cost of pushing the leaf further down
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        auto descendCost = [&](int32_t childId) {
+            const Node& child = m_Nodes[childId];
+            float unionArea = SurfaceArea(Union(leafBox, child.Box));
+            return child.IsLeaf() ? unionArea + inheritanceCost
+                                  : (unionArea - SurfaceArea(child.Box)) + inheritanceCost;
+        };
+        float cost1 = descendCost(node.Child1);
+        float cost2 = descendCost(node.Child2);
+
+        if (cost < cost1 && cost < cost2) break;
+        index = (cost1 < cost2) ? node.Child1 : node.Child2;
+    }
+
+    int32_t sibling = index;
+    int32_t oldParent = m_Nodes[sibling].Parent;
+    int32_t newParent = AllocateNode();
+
+    Node& parent = m_Nodes[newParent];
+    parent.Parent = oldParent;
+    parent.Box = Union(leafBox, m_Nodes[sibling].Box);
+    parent.Height = m_Nodes[sibling].Height + 1;
+    parent.Child1 = sibling;
+    parent.Child2 = leaf;
+
+    if (oldParent != NULL_NODE) {
+        if (m_Nodes[oldParent].Child1 == sibling) {
+            m_Nodes[oldParent].Child1 = newParent;
+        } else {
+            m_Nodes[oldParent].Child2 = newParent;
+        }
+    } else {
+        m_Root = newParent;
+    }
+    m_Nodes[sibling].Parent = newParent;
+    m_Nodes[leaf].Parent = newParent;
+
+    Refit(newParent);
+}
+
+void DynamicAABBTree::RemoveLeaf(int32_t leaf) {
+    if (leaf == m_Root) {
+        m_Root = NULL_NODE;
+        return;
+    }
+
+    int32_t parent = m_Nodes[leaf].Parent;
+    int32_t grandParent = m_Nodes[parent].Parent;
+    int32_t sibling = (m_Nodes[parent].Child1 == leaf) ? m_Nodes[parent].Child2 : m_Nodes[parent].Child1;
+
+    if (grandParent != NULL_NODE) {
+        // Splice the sibling into the parent's place
+        if (m_Nodes[grandParent].Child1 == parent) {
+            m_Nodes[grandParent].Child1 = sibling;
+        } else {
+            m_Nodes[grandParent].Child2 = sibling;
+        }
+        m_Nodes[sibling].Parent = grandParent;
+        FreeNode(parent);
+
+        Refit(grandParent);
+    } else {
+        m_Root = sibling;
+        m_Nodes[sibling].Parent = NULL_NODE;
+        FreeNode(parent);
+    }
+}
+
+void DynamicAABBTree::Refit(int32_t nodeId) {
+    int32_t index = nodeId;
+    while (index != NULL_NODE) {
+        index = Balance(index);
+
+        Node& node = m_Nodes[index];
+        const Node& child1 = m_Nodes[node.Child1];
+        const Node& child2 = m_Nodes[node.Child2];
+        node.Height = 1 + std::max(child1.Height, child2.Height);
+        node.Box = Union(child1.Box, child2.Box);
+
+        index = node.Parent;
+    }
+}
+
+int32_t DynamicAABBTree::Balance(int32_t iA) {
+    Node& A = m_Nodes[iA];
+    if (A.IsLeaf() || A.Height < 2) {
+        return iA;
+    }
+
+    int32_t iB = A.Child1;
+    int32_t iC = A.Child2;
+    Node& B = m_Nodes[iB];
+    Node& C = m_Nodes[iC];
+
+    int32_t balance = C.Height - B.Height;
+
+    // Rotate C up
+    if (balance > 1) {
+        int32_t iF = C.Child1;
+        int32_t iG = C.Child2;
+        Node& F = m_Nodes[iF];
+        Node& G = m_Nodes[iG];
+
+        C.Child1 = iA;
+        C.Parent = A.Parent;
+        A.Parent = iC;
+
+        if (C.Parent != NULL_NODE) {
+            if (m_Nodes[C.Parent].Child1 == iA) {
+                m_Nodes[C.Parent].Child1 = iC;
+            } else {
+                m_Nodes[C.Parent].Child2 = iC;
+            }
+        } else {
+            m_Root = iC;
+        }
+
+        if (F.Height > G.Height) {
+            C.Child2 = iF;
+            A.Child2 = iG;
+            G.Parent = iA;
+            A.Box = Union(B.Box, G.Box);
+            C.Box = Union(A.Box, F.Box);
+            A.Height = 1 + std::max(B.Height, G.Height);
+            C.Height = 1 + std::max(A.Height, F.Height);
+        } else {
+            C.Child2 = iG;
+            A.Child2 = iF;
+            F.Parent = iA;
+            A.Box = Union(B.Box, F.Box);
+            C.Box = Union(A.Box, G.Box);
+            A.Height = 1 + std::max(B.Height, F.Height);
+            C.Height = 1 + std::max(A.Height, G.Height);
+        }
+        return iC;
+    }
+
+    // Rotate B up
+    if (balance < -1) {
+        int32_t iD = B.Child1;
+        int32_t iE = B.Child2;
+        Node& D = m_Nodes[iD];
+        Node& E = m_Nodes[iE];
+
+        B.Child1 = iA;
+        B.Parent = A.Parent;
+        A.Parent = iB;
+
+        if (B.Parent != NULL_NODE) {
+            if (m_Nodes[B.Parent].Child1 == iA) {
+                m_Nodes[B.Parent].Child1 = iB;
+            } else {
+                m_Nodes[B.Parent].Child2 = iB;
+            }
+        } else {
+            m_Root = iB;
+        }
+
+        if (D.Height > E.Height) {
+            B.Child2 = iD;
+            A.Child1 = iE;
+            E.Parent = iA;
+            A.Box = Union(C.Box, E.Box);
+            B.Box = Union(A.Box, D.Box);
+            A.Height = 1 + std::max(C.Height, E.Height);
+            B.Height = 1 + std::max(A.Height, D.Height);
+        } else {
+            B.Child2 = iE;
+            A.Child1 = iD;
+            D.Parent = iA;
+            A.Box = Union(C.Box, D.Box);
+            B.Box = Union(A.Box, E.Box);
+            A.Height = 1 + std::max(C.Height, D.Height);
+            B.Height = 1 + std::max(A.Height, E.Height);
+        }
+        return iB;
+    }
+
+    return iA;
+}
+
+} // namespace Nilos
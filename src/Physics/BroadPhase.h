@@ -0,0 +1,334 @@
+#pragma once
+
+#include "Collision.h"
+#include "../Core/SIMD.h"
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Four rays in SoA layout, traversed through a tree together
+ *
+ * Lanes whose bit is clear in ActiveMask are ignored. Leaf callbacks clip a
+ * lane by lowering its MaxDistance.
+ */
+struct RayPacket {
+    alignas(SIMD::ALIGNMENT) float OriginX[SIMD::WIDTH];
+    alignas(SIMD::ALIGNMENT) float OriginY[SIMD::WIDTH];
+    alignas(SIMD::ALIGNMENT) float OriginZ[SIMD::WIDTH];
+    alignas(SIMD::ALIGNMENT) float InvDirectionX[SIMD::WIDTH];
+    alignas(SIMD::ALIGNMENT) float InvDirectionY[SIMD::WIDTH];
+    alignas(SIMD::ALIGNMENT) float InvDirectionZ[SIMD::WIDTH];
+    alignas(SIMD::ALIGNMENT) float MaxDistance[SIMD::WIDTH];
+    int ActiveMask = 0;
+
+    /**
+     * @brief Store a ray in a lane and mark the lane active
+     */
+    void SetLane(int lane, const Ray& ray, float maxDistance) {
+        OriginX[lane] = ray.Origin.x;
+        OriginY[lane] = ray.Origin.y;
+        OriginZ[lane] = ray.Origin.z;
+        InvDirectionX[lane] = 1.0f / ray.Direction.x;
+        InvDirectionY[lane] = 1.0f / ray.Direction.y;
+        InvDirectionZ[lane] = 1.0f / ray.Direction.z;
+        MaxDistance[lane] = maxDistance;
+        ActiveMask |= 1 << lane;
+    }
+
+    /**
+     * @brief Fill an unused lane with harmless values
+     */
+    void ClearLane(int lane) {
+        OriginX[lane] = OriginY[lane] = OriginZ[lane] = 0.0f;
+        InvDirectionX[lane] = InvDirectionY[lane] = InvDirectionZ[lane] = 1.0f;
+        MaxDistance[lane] = 0.0f;
+        ActiveMask &= ~(1 << lane);
+    }
+};
+
+/**
+ * @brief Dynamic AABB tree used as the physics broad phase
+ *
+ * A bounding volume hierarchy whose leaves (proxies) store "fat" AABBs:
+ * the collider bounds grown by a margin and extended along the body's
+ * displacement. While a body stays inside its fat AABB the tree is not
+ * touched at all, so a frame where most bodies move a little only costs a
+ * containment test per body. Leaves that escape are removed and reinserted.
+ *
+ * Insertion picks the sibling with the smallest surface area increase and
+ * the tree is kept height-balanced with AVL rotations, so queries stay
+ * O(log n) no matter the insertion order.
+ *
+ * Nodes live in one vector with an intrusive free list; proxy IDs are node
+ * indices and stay valid until DestroyProxy. Queries use a fixed-size stack
+ * and never allocate, so several threads may query the same tree at once
+ * (but not while it is being modified).
+ *
+ * Usage:
+ *   int32_t proxy = tree.CreateProxy(aabb, bodyIndex);
+ *   tree.MoveProxy(proxy, newAABB, velocity * dt);
+ *   tree.Query(box, [&](int32_t other) { ...; return true; });
+ */
+class DynamicAABBTree {
+public:
+    static constexpr int32_t NULL_NODE = -1;
+
+    /**
+     * @brief Extra space added around every leaf AABB (meters)
+     */
+    static constexpr float AABB_MARGIN = 0.1f;
+
+    /**
+     * @brief How far ahead (in displacements) a moved leaf is extended
+     */
+    static constexpr float DISPLACEMENT_MULTIPLIER = 2.0f;
+
+    DynamicAABBTree() = default;
+
+    /**
+     * @brief Insert a leaf
+     * @param aabb Tight bounds of the object (the margin is added here)
+     * @param userData Value handed back by GetUserData (e.g. a body index)
+     * @return Proxy ID
+     */
+    int32_t CreateProxy(const AABB& aabb, uint32_t userData);
+
+    /**
+     * @brief Remove a leaf
+     */
+    void DestroyProxy(int32_t proxyId);
+
+    /**
+     * @brief Update the bounds of a leaf
+     * @param aabb New tight bounds
+     * @param displacement Expected movement until the next update (extends the fat AABB)
+     * @return True if the leaf had to be reinserted
+     */
+    bool MoveProxy(int32_t proxyId, const AABB& aabb, const glm::vec3& displacement);
+
+    uint32_t GetUserData(int32_t proxyId) const { return m_Nodes[proxyId].UserData; }
+    void SetUserData(int32_t proxyId, uint32_t userData) { m_Nodes[proxyId].UserData = userData; }
+
+    /**
+     * @brief Fat AABB stored for a leaf
+     */
+    const AABB& GetFatAABB(int32_t proxyId) const { return m_Nodes[proxyId].Box; }
+
+    /**
+     * @brief Call callback(proxyId) for every leaf whose fat AABB overlaps aabb
+     *
+     * The callback returns false to stop the query early.
+     */
+    template<typename Callback>
+    void Query(const AABB& aabb, Callback&& callback) const;
+
+    /**
+     * @brief Walk every leaf whose fat AABB a ray segment crosses
+     * @param ray Ray (normalized direction)
+     * @param maxDistance Length of the segment
+     * @param callback callback(proxyId, currentMax) returning the new max distance
+     *
+     * Callbacks clip the segment by returning the distance of a confirmed hit
+     * (or currentMax to keep going unchanged, 0 to stop), so later subtrees
+     * behind the closest hit are skipped.
+     */
+    template<typename Callback>
+    void RayCast(const Ray& ray, float maxDistance, Callback&& callback) const {
+        BoxCast(ray, glm::vec3(0.0f), maxDistance, std::forward<Callback>(callback));
+    }
+
+    /**
+     * @brief Like RayCast, but for a box of halfExtent swept along the ray
+     *
+     * Node bounds are grown by halfExtent (Minkowski sum), so the ray stands
+     * in for the box center.
+     */
+    template<typename Callback>
+    void BoxCast(const Ray& ray, const glm::vec3& halfExtent, float maxDistance, Callback&& callback) const;
+
+    /**
+     * @brief Traverse four rays at once (SIMD slab tests against every visited node)
+     * @param callback callback(proxyId, laneMask) for leaves hit by the lanes in laneMask;
+     *                 may lower packet.MaxDistance of those lanes
+     *
+     * A subtree is entered when any active lane hits it, which keeps nearby
+     * rays (line-of-sight fans, shotgun traces) on mostly shared paths.
+     */
+    template<typename Callback>
+    void RayCastPacket(RayPacket& packet, Callback&& callback) const;
+
+    /**
+     * @brief Remove every proxy
+     */
+    void Clear();
+
+    /**
+     * @brief Number of live proxies
+     */
+    uint32_t GetProxyCount() const { return m_ProxyCount; }
+
+    /**
+     * @brief Height of the tree (0 for a single leaf, -1 when empty)
+     */
+    int32_t GetHeight() const { return m_Root == NULL_NODE ? -1 : m_Nodes[m_Root].Height; }
+
+private:
+    struct Node {
+        AABB Box;
+        int32_t Parent = NULL_NODE;  // Next free node while on the free list
+        int32_t Child1 = NULL_NODE;
+        int32_t Child2 = NULL_NODE;
+        int32_t Height = 0;          // Leaf = 0, free = -1
+        uint32_t UserData = 0;
+
+        bool IsLeaf() const { return Child1 == NULL_NODE; }
+    };
+
+    // Deep enough for any balanced tree that fits in memory
+    static constexpr int32_t QUERY_STACK_SIZE = 256;
+
+    int32_t AllocateNode();
+    void FreeNode(int32_t nodeId);
+
+    void InsertLeaf(int32_t leaf);
+    void RemoveLeaf(int32_t leaf);
+
+    /**
+     * @brief Rotate the subtree at nodeId if it is imbalanced
+     * @return New root of the subtree
+     */
+    int32_t Balance(int32_t nodeId);
+
+    /**
+     * @brief Recompute heights and bounds from nodeId up to the root
+     */
+    void Refit(int32_t nodeId);
+
+    static AABB Union(const AABB& a, const AABB& b) {
+        return AABB(glm::min(a.Min, b.Min), glm::max(a.Max, b.Max));
+    }
+
+    static float SurfaceArea(const AABB& box) {
+        glm::vec3 d = box.Max - box.Min;
+        return 2.0f * (d.x * d.y + d.y * d.z + d.z * d.x);
+    }
+
+    static bool ContainsBox(const AABB& outer, const AABB& inner) {
+        return outer.Min.x <= inner.Min.x && outer.Min.y <= inner.Min.y && outer.Min.z <= inner.Min.z &&
+               inner.Max.x <= outer.Max.x && inner.Max.y <= outer.Max.y && inner.Max.z <= outer.Max.z;
+    }
+
+    std::vector<Node> m_Nodes;
+    int32_t m_Root = NULL_NODE;
+    int32_t m_FreeList = NULL_NODE;
+    uint32_t m_ProxyCount = 0;
+};
+
+// ============================================================================
+// Template queries
+// ============================================================================
+
+template<typename Callback>
+void DynamicAABBTree::Query(const AABB& aabb, Callback&& callback) const {
+    if (m_Root == NULL_NODE) return;
+
+    int32_t stack[QUERY_STACK_SIZE];
+    int32_t count = 0;
+    stack[count++] = m_Root;
+
+    while (count > 0) {
+        int32_t nodeId = stack[--count];
+        const Node& node = m_Nodes[nodeId];
+        if (!node.Box.Intersects(aabb)) continue;
+
+        if (node.IsLeaf()) {
+            if (!callback(nodeId)) return;
+        } else if (count + 2 <= QUERY_STACK_SIZE) {
+            stack[count++] = node.Child1;
+            stack[count++] = node.Child2;
+        }
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::BoxCast(const Ray& ray, const glm::vec3& halfExtent, float maxDistance, Callback&& callback) const {
+    if (m_Root == NULL_NODE) return;
+
+    glm::vec3 invDirection = 1.0f / ray.Direction;
+
+    int32_t stack[QUERY_STACK_SIZE];
+    int32_t count = 0;
+    stack[count++] = m_Root;
+
+    while (count > 0) {
+        int32_t nodeId = stack[--count];
+        const Node& node = m_Nodes[nodeId];
+
+        // Slab test clipped to the current segment length
+        glm::vec3 t0 = (node.Box.Min - halfExtent - ray.Origin) * invDirection;
+        glm::vec3 t1 = (node.Box.Max + halfExtent - ray.Origin) * invDirection;
+        glm::vec3 tNear = glm::min(t0, t1);
+        glm::vec3 tFar = glm::max(t0, t1);
+        float enter = glm::max(glm::max(tNear.x, tNear.y), glm::max(tNear.z, 0.0f));
+        float exit = glm::min(glm::min(tFar.x, tFar.y), glm::min(tFar.z, maxDistance));
+        if (enter > exit) continue;
+
+        if (node.IsLeaf()) {
+            maxDistance = callback(nodeId, maxDistance);
+            if (maxDistance <= 0.0f) return;
+        } else if (count + 2 <= QUERY_STACK_SIZE) {
+            stack[count++] = node.Child1;
+            stack[count++] = node.Child2;
+        }
+    }
+}
+
+template<typename Callback>
+void DynamicAABBTree::RayCastPacket(RayPacket& packet, Callback&& callback) const {
+    if (m_Root == NULL_NODE || packet.ActiveMask == 0) return;
+
+    const SIMD::Float4 originX = SIMD::Load(packet.OriginX);
+    const SIMD::Float4 originY = SIMD::Load(packet.OriginY);
+    const SIMD::Float4 originZ = SIMD::Load(packet.OriginZ);
+    const SIMD::Float4 invX = SIMD::Load(packet.InvDirectionX);
+    const SIMD::Float4 invY = SIMD::Load(packet.InvDirectionY);
+    const SIMD::Float4 invZ = SIMD::Load(packet.InvDirectionZ);
+    const SIMD::Float4 zero = SIMD::Set1(0.0f);
+
+    int32_t stack[QUERY_STACK_SIZE];
+    int32_t count = 0;
+    stack[count++] = m_Root;
+
+    while (count > 0) {
+        int32_t nodeId = stack[--count];
+        const Node& node = m_Nodes[nodeId];
+
+        SIMD::Float4 x0 = SIMD::Mul(SIMD::Sub(SIMD::Set1(node.Box.Min.x), originX), invX);
+        SIMD::Float4 x1 = SIMD::Mul(SIMD::Sub(SIMD::Set1(node.Box.Max.x), originX), invX);
+        SIMD::Float4 y0 = SIMD::Mul(SIMD::Sub(SIMD::Set1(node.Box.Min.y), originY), invY);
+        SIMD::Float4 y1 = SIMD::Mul(SIMD::Sub(SIMD::Set1(node.Box.Max.y), originY), invY);
+        SIMD::Float4 z0 = SIMD::Mul(SIMD::Sub(SIMD::Set1(node.Box.Min.z), originZ), invZ);
+        SIMD::Float4 z1 = SIMD::Mul(SIMD::Sub(SIMD::Set1(node.Box.Max.z), originZ), invZ);
+
+        SIMD::Float4 enter = SIMD::Max(SIMD::Max(SIMD::Min(x0, x1), SIMD::Min(y0, y1)),
+                                       SIMD::Max(SIMD::Min(z0, z1), zero));
+        SIMD::Float4 exit = SIMD::Min(SIMD::Min(SIMD::Max(x0, x1), SIMD::Max(y0, y1)),
+                                      SIMD::Min(SIMD::Max(z0, z1), SIMD::Load(packet.MaxDistance)));
+
+        int mask = SIMD::LessEqualMask(enter, exit) & packet.ActiveMask;
+        if (mask == 0) continue;
+
+        if (node.IsLeaf()) {
+            callback(nodeId, mask);
+        } else if (count + 2 <= QUERY_STACK_SIZE) {
+            stack[count++] = node.Child1;
+            stack[count++] = node.Child2;
+        }
+    }
+}
+
+} // namespace Nilos
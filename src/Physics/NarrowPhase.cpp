@@ -0,0 +1,389 @@
+#include "NarrowPhase.h"
+
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+
+namespace Nilos {
+
+namespace {
+
+constexpr float EPSILON = 1e-6f;
+
+// Cross products of nearly parallel edges are too short to be a reliable axis
+constexpr float MIN_EDGE_AXIS_LENGTH = 1e-4f;
+
+// An axis must be this much shallower to win over a face of A (then a face
+// of B): keeps the manifold from flipping between features from step to step
+constexpr float AXIS_TOLERANCE = 0.005f;
+
+// Largest polygon clipping a quad against four planes can produce
+constexpr int MAX_CLIP_POINTS = 8;
+
+void AddPoint(ContactManifold& manifold, const glm::vec3& position, float separation) {
+    if (manifold.PointCount >= ContactManifold::MAX_POINTS) return;
+
+    ContactPoint& point = manifold.Points[manifold.PointCount++];
+    point.Position = position;
+    point.Separation = separation;
+}
+
+bool CollideSpheres(const CollisionShape& a, const CollisionShape& b, float margin, ContactManifold& manifold) {
+    glm::vec3 offset = b.Center - a.Center;
+    float distanceSq = glm::dot(offset, offset);
+    float limit = a.Radius + b.Radius + margin;
+    if (distanceSq > limit * limit) return false;
+
+    float distance = std::sqrt(distanceSq);
+    manifold.Normal = distance > EPSILON ? offset / distance : glm::vec3(0.0f, 1.0f, 0.0f);
+
+    float separation = distance - a.Radius - b.Radius;
+    AddPoint(manifold, a.Center + manifold.Normal * (a.Radius + separation * 0.5f), separation);
+    return true;
+}
+
+// Manifold normal points from the sphere to the box
+bool CollideSphereBox(const CollisionShape& sphere, const CollisionShape& box, float margin,
+                      ContactManifold& manifold) {
+    glm::vec3 offset = sphere.Center - box.Center;
+    glm::vec3 local(glm::dot(offset, box.Axes[0]), glm::dot(offset, box.Axes[1]), glm::dot(offset, box.Axes[2]));
+    glm::vec3 closest = glm::clamp(local, -box.HalfExtents, box.HalfExtents);
+    glm::vec3 delta = local - closest;
+    float distanceSq = glm::dot(delta, delta);
+
+    glm::vec3 normal;   // Box to sphere
+    glm::vec3 surface;  // On the box
+    float separation;
+    if (distanceSq > EPSILON * EPSILON) {
+        float limit = sphere.Radius + margin;
+        if (distanceSq > limit * limit) return false;
+
+        float distance = std::sqrt(distanceSq);
+        normal = box.Axes * (delta / distance);
+        surface = box.Center + box.Axes * closest;
+        separation = distance - sphere.Radius;
+    } else {
+        // Center inside the box: push out through the nearest face
+        glm::vec3 depth = box.HalfExtents - glm::abs(local);
+        int axis = 0;
+        if (depth.y < depth[axis]) axis = 1;
+        if (depth.z < depth[axis]) axis = 2;
+
+        float sign = local[axis] >= 0.0f ? 1.0f : -1.0f;
+        glm::vec3 onFace = local;
+        onFace[axis] = box.HalfExtents[axis] * sign;
+
+        normal = box.Axes[axis] * sign;
+        surface = box.Center + box.Axes * onFace;
+        separation = -depth[axis] - sphere.Radius;
+    }
+
+    manifold.Normal = -normal;
+    AddPoint(manifold, surface + normal * (separation * 0.5f), separation);
+    return true;
+}
+
+/**
+ * @brief Sutherland-Hodgman: keep the part of a convex polygon with dot(normal, p) <= offset
+ * @return Number of points written to output
+ */
+int ClipPolygon(const glm::vec3* input, int count, const glm::vec3& normal, float offset, glm::vec3* output) {
+    int outputCount = 0;
+    for (int i = 0; i < count; ++i) {
+        const glm::vec3& a = input[i];
+        const glm::vec3& b = input[(i + 1) % count];
+        float distanceA = glm::dot(normal, a) - offset;
+        float distanceB = glm::dot(normal, b) - offset;
+
+        if (distanceA <= 0.0f) {
+            output[outputCount++] = a;
+        }
+        if ((distanceA < 0.0f && distanceB > 0.0f) || (distanceA > 0.0f && distanceB < 0.0f)) {
+            output[outputCount++] = a + (b - a) * (distanceA / (distanceA - distanceB));
+        }
+    }
+    return outputCount;
+}
+
+/**
+ * @brief Add the clipped points, keeping the four that cover the largest area
+ *
+ * The deepest point, the point farthest from it, the point forming the
+ * largest triangle with those two, then the point adding the most area.
+ */
+void AddReducedPoints(ContactManifold& manifold, const glm::vec3* positions, const float* separations, int count,
+                      const glm::vec3& normal) {
+    if (count <= static_cast<int>(ContactManifold::MAX_POINTS)) {
+        for (int i = 0; i < count; ++i) {
+            AddPoint(manifold, positions[i], separations[i]);
+        }
+        return;
+    }
+
+    auto argMax = [&](auto score) {
+        int best = 0;
+        float bestScore = -FLT_MAX;
+        for (int i = 0; i < count; ++i) {
+            float value = score(i);
+            if (value > bestScore) {
+                bestScore = value;
+                best = i;
+            }
+        }
+        return best;
+    };
+
+    int first = argMax([&](int i) { return -separations[i]; });
+    const glm::vec3& p0 = positions[first];
+
+    int second = argMax([&](int i) {
+        glm::vec3 offset = positions[i] - p0;
+        return glm::dot(offset, offset);
+    });
+    const glm::vec3& p1 = positions[second];
+
+    auto signedArea = [&](const glm::vec3& a, const glm::vec3& b, const glm::vec3& p) {
+        return glm::dot(glm::cross(b - a, p - a), normal);
+    };
+
+    int third = argMax([&](int i) { return std::fabs(signedArea(p0, p1, positions[i])); });
+    const glm::vec3& p2 = positions[third];
+
+    // Area outside the triangle's edges (the triangle's winding decides which side is outside)
+    float winding = signedArea(p0, p1, p2) >= 0.0f ? 1.0f : -1.0f;
+    int fourth = argMax([&](int i) {
+        const glm::vec3& p = positions[i];
+        float outside = std::max(-winding * signedArea(p0, p1, p), -winding * signedArea(p1, p2, p));
+        return std::max(outside, -winding * signedArea(p2, p0, p));
+    });
+
+    for (int i : { first, second, third, fourth }) {
+        AddPoint(manifold, positions[i], separations[i]);
+    }
+}
+
+/**
+ * @brief Clip the incident box's face against a face of the reference box
+ * @param flip The reference box is B: the manifold normal is reversed
+ */
+void FaceContact(const CollisionShape& reference, const CollisionShape& incident, int axis, float margin, bool flip,
+                 ContactManifold& manifold) {
+    glm::vec3 normal = reference.Axes[axis];
+    if (glm::dot(incident.Center - reference.Center, normal) < 0.0f) {
+        normal = -normal;
+    }
+
+    // Incident face: the face most anti-parallel to the reference normal
+    int incidentAxis = 0;
+    float bestAlignment = -1.0f;
+    for (int j = 0; j < 3; ++j) {
+        float alignment = std::fabs(glm::dot(incident.Axes[j], normal));
+        if (alignment > bestAlignment) {
+            bestAlignment = alignment;
+            incidentAxis = j;
+        }
+    }
+    float incidentSign = glm::dot(incident.Axes[incidentAxis], normal) > 0.0f ? -1.0f : 1.0f;
+    glm::vec3 faceCenter = incident.Center + incident.Axes[incidentAxis] * (incident.HalfExtents[incidentAxis] * incidentSign);
+
+    int u = (incidentAxis + 1) % 3;
+    int v = (incidentAxis + 2) % 3;
+    glm::vec3 edgeU = incident.Axes[u] * incident.HalfExtents[u];
+    glm::vec3 edgeV = incident.Axes[v] * incident.HalfExtents[v];
+
+    glm::vec3 polygon[MAX_CLIP_POINTS] = {
+        faceCenter + edgeU + edgeV, faceCenter - edgeU + edgeV,
+        faceCenter - edgeU - edgeV, faceCenter + edgeU - edgeV
+    };
+    glm::vec3 clipped[MAX_CLIP_POINTS];
+    int count = 4;
+
+    // Side planes of the reference face
+    for (int side : { (axis + 1) % 3, (axis + 2) % 3 }) {
+        for (float sign : { 1.0f, -1.0f }) {
+            glm::vec3 planeNormal = reference.Axes[side] * sign;
+            float planeOffset = glm::dot(reference.Center, planeNormal) + reference.HalfExtents[side];
+            count = ClipPolygon(polygon, count, planeNormal, planeOffset, clipped);
+            if (count == 0) return;
+            std::copy(clipped, clipped + count, polygon);
+        }
+    }
+
+    // Keep what lies below the reference face (or within the margin above it)
+    float faceOffset = glm::dot(reference.Center, normal) + reference.HalfExtents[axis];
+    glm::vec3 positions[MAX_CLIP_POINTS];
+    float separations[MAX_CLIP_POINTS];
+    int kept = 0;
+    for (int i = 0; i < count; ++i) {
+        float separation = glm::dot(normal, polygon[i]) - faceOffset;
+        if (separation <= margin) {
+            positions[kept] = polygon[i] - normal * (separation * 0.5f);
+            separations[kept++] = separation;
+        }
+    }
+
+    manifold.Normal = flip ? -normal : normal;
+    AddReducedPoints(manifold, positions, separations, kept, normal);
+}
+
+/**
+ * @brief Single point between the closest points of an edge of A and an edge of B
+ */
+void EdgeContact(const CollisionShape& a, int edgeA, const CollisionShape& b, int edgeB, glm::vec3 axis,
+                 float separation, ContactManifold& manifold) {
+    if (glm::dot(axis, b.Center - a.Center) < 0.0f) {
+        axis = -axis;
+    }
+
+    // A's edge farthest along the axis, B's edge farthest against it
+    glm::vec3 centerA = a.Center;
+    glm::vec3 centerB = b.Center;
+    for (int k = 0; k < 3; ++k) {
+        if (k != edgeA) {
+            centerA += a.Axes[k] * (glm::dot(a.Axes[k], axis) > 0.0f ? a.HalfExtents[k] : -a.HalfExtents[k]);
+        }
+        if (k != edgeB) {
+            centerB += b.Axes[k] * (glm::dot(b.Axes[k], axis) > 0.0f ? -b.HalfExtents[k] : b.HalfExtents[k]);
+        }
+    }
+
+    // Closest points of the two lines, clamped to the edges
+    const glm::vec3& directionA = a.Axes[edgeA];
+    const glm::vec3& directionB = b.Axes[edgeB];
+    glm::vec3 offset = centerA - centerB;
+    float alignment = glm::dot(directionA, directionB);
+    float projectionA = glm::dot(directionA, offset);
+    float projectionB = glm::dot(directionB, offset);
+    float denominator = 1.0f - alignment * alignment;
+
+    float s = denominator > EPSILON ? (alignment * projectionB - projectionA) / denominator : 0.0f;
+    s = std::clamp(s, -a.HalfExtents[edgeA], a.HalfExtents[edgeA]);
+    float t = std::clamp(projectionB + s * alignment, -b.HalfExtents[edgeB], b.HalfExtents[edgeB]);
+    s = std::clamp(t * alignment - projectionA, -a.HalfExtents[edgeA], a.HalfExtents[edgeA]);
+
+    glm::vec3 closestA = centerA + directionA * s;
+    glm::vec3 closestB = centerB + directionB * t;
+
+    manifold.Normal = axis;
+    AddPoint(manifold, (closestA + closestB) * 0.5f, separation);
+}
+
+bool CollideBoxes(const CollisionShape& a, const CollisionShape& b, float margin, ContactManifold& manifold) {
+    const glm::vec3 offset = b.Center - a.Center;
+    const glm::vec3& extentA = a.HalfExtents;
+    const glm::vec3& extentB = b.HalfExtents;
+
+    // B's axes in A's frame; the epsilon keeps parallel edges from reporting a false separation
+    float absR[3][3];
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            absR[i][j] = std::fabs(glm::dot(a.Axes[i], b.Axes[j])) + EPSILON;
+        }
+    }
+
+    // Face normals of A
+    float faceASeparation = -FLT_MAX;
+    int faceA = 0;
+    for (int i = 0; i < 3; ++i) {
+        float radiusB = extentB.x * absR[i][0] + extentB.y * absR[i][1] + extentB.z * absR[i][2];
+        float separation = std::fabs(glm::dot(offset, a.Axes[i])) - extentA[i] - radiusB;
+        if (separation > margin) return false;
+        if (separation > faceASeparation) {
+            faceASeparation = separation;
+            faceA = i;
+        }
+    }
+
+    // Face normals of B
+    float faceBSeparation = -FLT_MAX;
+    int faceB = 0;
+    for (int j = 0; j < 3; ++j) {
+        float radiusA = extentA.x * absR[0][j] + extentA.y * absR[1][j] + extentA.z * absR[2][j];
+        float separation = std::fabs(glm::dot(offset, b.Axes[j])) - radiusA - extentB[j];
+        if (separation > margin) return false;
+        if (separation > faceBSeparation) {
+            faceBSeparation = separation;
+            faceB = j;
+        }
+    }
+
+    // Edge pairs
+    float edgeSeparation = -FLT_MAX;
+    int edgeA = -1;
+    int edgeB = -1;
+    glm::vec3 edgeAxis(0.0f);
+    for (int i = 0; i < 3; ++i) {
+        for (int j = 0; j < 3; ++j) {
+            glm::vec3 axis = glm::cross(a.Axes[i], b.Axes[j]);
+            float length = glm::length(axis);
+            if (length < MIN_EDGE_AXIS_LENGTH) continue;
+            axis /= length;
+
+            float radiusA = 0.0f;
+            float radiusB = 0.0f;
+            for (int k = 0; k < 3; ++k) {
+                radiusA += extentA[k] * std::fabs(glm::dot(a.Axes[k], axis));
+                radiusB += extentB[k] * std::fabs(glm::dot(b.Axes[k], axis));
+            }
+            float separation = std::fabs(glm::dot(offset, axis)) - radiusA - radiusB;
+            if (separation > margin) return false;
+            if (separation > edgeSeparation) {
+                edgeSeparation = separation;
+                edgeA = i;
+                edgeB = j;
+                edgeAxis = axis;
+            }
+        }
+    }
+
+    float faceSeparation = std::max(faceASeparation, faceBSeparation);
+    if (edgeA >= 0 && edgeSeparation > faceSeparation + AXIS_TOLERANCE) {
+        EdgeContact(a, edgeA, b, edgeB, edgeAxis, edgeSeparation, manifold);
+    } else if (faceBSeparation > faceASeparation + AXIS_TOLERANCE) {
+        FaceContact(b, a, faceB, margin, true, manifold);
+    } else {
+        FaceContact(a, b, faceA, margin, false, manifold);
+    }
+    return manifold.PointCount > 0;
+}
+
+} // namespace
+
+float ContactManifold::GetSeparation() const {
+    float separation = FLT_MAX;
+    for (uint32_t i = 0; i < PointCount; ++i) {
+        separation = std::min(separation, Points[i].Separation);
+    }
+    return separation;
+}
+
+AABB CollisionShape::GetBounds() const {
+    if (ShapeType == Type::Sphere) {
+        return AABB(Center - glm::vec3(Radius), Center + glm::vec3(Radius));
+    }
+
+    glm::vec3 extent = glm::abs(Axes[0]) * HalfExtents.x + glm::abs(Axes[1]) * HalfExtents.y +
+                       glm::abs(Axes[2]) * HalfExtents.z;
+    return AABB(Center - extent, Center + extent);
+}
+
+bool Collide(const CollisionShape& a, const CollisionShape& b, float margin, ContactManifold& manifold) {
+    manifold.PointCount = 0;
+
+    bool sphereA = a.ShapeType == CollisionShape::Type::Sphere;
+    bool sphereB = b.ShapeType == CollisionShape::Type::Sphere;
+    if (sphereA && sphereB) {
+        CollideSpheres(a, b, margin, manifold);
+    } else if (sphereA) {
+        CollideSphereBox(a, b, margin, manifold);
+    } else if (sphereB) {
+        if (CollideSphereBox(b, a, margin, manifold)) {
+            manifold.Normal = -manifold.Normal;
+        }
+    } else {
+        CollideBoxes(a, b, margin, manifold);
+    }
+    return manifold.PointCount > 0;
+}
+
+} // namespace Nilos
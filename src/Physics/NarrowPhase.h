@@ -0,0 +1,71 @@
+#pragma once
+
+#include "Collision.h"
+
+#include <cstdint>
+
+namespace Nilos {
+
+/**
+ * @brief World-space collision shape of a collider for the narrow phase
+ *
+ * Boxes are oriented (Axes holds the box's unit axes as columns). Capsule
+ * and Mesh colliders collide as their bounding boxes.
+ */
+struct CollisionShape {
+    enum class Type {
+        Sphere,
+        Box
+    };
+
+    Type ShapeType = Type::Box;
+    glm::vec3 Center = glm::vec3(0.0f);
+    glm::mat3 Axes = glm::mat3(1.0f);         // Box: local X/Y/Z axes in world space
+    glm::vec3 HalfExtents = glm::vec3(0.5f);  // Box: half size along each axis
+    float Radius = 0.5f;                      // Sphere
+
+    /**
+     * @brief Tight world-space bounds
+     */
+    AABB GetBounds() const;
+};
+
+/**
+ * @brief One point of a contact manifold
+ */
+struct ContactPoint {
+    glm::vec3 Position = glm::vec3(0.0f);  // World space, midway between the surfaces
+    float Separation = 0.0f;               // Distance along the normal, negative = penetration
+};
+
+/**
+ * @brief Up to four contact points sharing one normal
+ */
+struct ContactManifold {
+    static constexpr uint32_t MAX_POINTS = 4;
+
+    glm::vec3 Normal = glm::vec3(0.0f, 1.0f, 0.0f);  // From A to B
+    ContactPoint Points[MAX_POINTS];
+    uint32_t PointCount = 0;
+
+    /**
+     * @brief Separation of the closest (deepest) point
+     */
+    float GetSeparation() const;
+};
+
+/**
+ * @brief Generate the contact manifold between two shapes
+ *
+ * Sphere/sphere and sphere/box are solved exactly; box/box uses the
+ * separating axis test over the 15 candidate axes, then clips the incident
+ * face against the reference face (face contacts, up to four points) or
+ * finds the closest points of the two edges (edge contacts, one point).
+ *
+ * @param margin Points up to this far apart are reported too (speculative
+ *               contacts, so the solver can stop bodies before they touch)
+ * @return True if the manifold has at least one point
+ */
+bool Collide(const CollisionShape& a, const CollisionShape& b, float margin, ContactManifold& manifold);
+
+} // namespace Nilos
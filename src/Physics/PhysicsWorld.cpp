@@ -1,165 +1,711 @@
 #include "PhysicsWorld.h"
+#include "../ECS/World.h"
 #include "../Core/Logger.h"
+#include "../Core/JobSystem.h"
+#include "../Core/Profiler.h"
 #include <algorithm>
+#include <cmath>
 
 namespace Nilos {
 
+namespace {
+
+// Bodies that take part in the step (static and sleeping bodies do not)
+bool IsActive(const RigidbodyComponent* rb) {
+    return !rb->IsStatic && !rb->IsSleeping;
+}
+
+// Bodies that link contacts into islands (static and kinematic bodies split islands)
+bool JoinsIslands(const RigidbodyComponent* rb) {
+    return !rb->IsStatic && !rb->IsKinematic;
+}
+
+// Bodies contacts can push
+bool IsMovable(const RigidbodyComponent* rb) {
+    return !rb->IsStatic && !rb->IsKinematic && rb->InverseMass > 0.0f;
+}
+
+uint64_t PairKey(Entity a, Entity b) {
+    return (static_cast<uint64_t>(a) << 32) | b;
+}
+
+// Same rotation as TransformComponent::GetModelMatrix, without the scale
+glm::mat3 RotationMatrix(const glm::vec3& degrees) {
+    float sx = std::sin(glm::radians(degrees.x)), cx = std::cos(glm::radians(degrees.x));
+    float sy = std::sin(glm::radians(degrees.y)), cy = std::cos(glm::radians(degrees.y));
+    float sz = std::sin(glm::radians(degrees.z)), cz = std::cos(glm::radians(degrees.z));
+
+    return glm::mat3(glm::vec3(cy * cz + sy * sx * sz, cx * sz, cy * sx * sz - sy * cz),
+                     glm::vec3(sy * sx * cz - cy * sz, cx * cz, sy * sz + cy * sx * cz),
+                     glm::vec3(sy * cx, -sx, cy * cx));
+}
+
+// Orthonormal tangents that only depend on the normal (Duff et al. 2017), so
+// warm-started friction impulses keep their meaning from step to step
+void ComputeTangents(const glm::vec3& normal, glm::vec3& tangent1, glm::vec3& tangent2) {
+    float sign = std::copysign(1.0f, normal.z);
+    float a = -1.0f / (sign + normal.z);
+    float b = normal.x * normal.y * a;
+    tangent1 = glm::vec3(1.0f + sign * normal.x * normal.x * a, sign * b, -sign * normal.x);
+    tangent2 = glm::vec3(b, sign + normal.y * normal.y * a, -normal.y);
+}
+
+// Exact ray vs AABB with the entry normal; rays starting inside report distance 0
+bool RayVsBox(const Ray& ray, const AABB& box, float maxDistance, float& distance, glm::vec3& normal) {
+    float enter = 0.0f;
+    float exit = maxDistance;
+    int enterAxis = -1;
+    float enterSign = 0.0f;
+
+    for (int axis = 0; axis < 3; ++axis) {
+        float invD = 1.0f / ray.Direction[axis];
+        float t0 = (box.Min[axis] - ray.Origin[axis]) * invD;
+        float t1 = (box.Max[axis] - ray.Origin[axis]) * invD;
+        float sign = -1.0f;  // Entering through the Min face
+        if (invD < 0.0f) {
+            std::swap(t0, t1);
+            sign = 1.0f;
+        }
+
+        if (t0 > enter) {
+            enter = t0;
+            enterAxis = axis;
+            enterSign = sign;
+        }
+        exit = std::min(exit, t1);
+        if (exit < enter) return false;
+    }
+
+    distance = enter;
+    normal = glm::vec3(0.0f);
+    if (enterAxis >= 0) {
+        normal[enterAxis] = enterSign;
+    } else {
+        normal = -ray.Direction;
+    }
+    return true;
+}
+
+
+} // namespace
+
 void PhysicsWorld::Update(float deltaTime) {
-    // Step 1: Apply forces (gravity, etc.)
-    for (auto& entry : m_Rigidbodies) {
-        RigidbodyComponent* rb = entry.Rigidbody;
-        
-        if (!rb || rb->IsStatic || rb->IsKinematic) continue;
-        
-        // Apply gravity
-        if (rb->UseGravity) {
-            rb->AddForce(m_Gravity * rb->Mass);
-        }
-        
-        // Apply accumulated forces: F = ma -> a = F/m
-        glm::vec3 acceleration = rb->Force * rb->InverseMass;
-        rb->Velocity += acceleration * deltaTime;
-        
-        // Apply linear damping (air resistance)
-        rb->Velocity *= (1.0f - rb->LinearDamping);
-        
-        // Clear forces for next frame
-        rb->ClearForces();
+    NILOS_PROFILE_SCOPE("PhysicsWorld::Update");
+    ResolveEntries();
+    BeginStepPoses();
+    ++m_StepCount;
+
+    // Step 1: Apply forces and gravity to the velocities (SoA, SIMD)
+    {
+        NILOS_PROFILE_SCOPE("Physics: Integrate Velocities");
+        GatherBodies(deltaTime);
+        JobSystem::Get().ParallelFor(m_Bodies.Count, INTEGRATION_GRAIN, [&](size_t begin, size_t end) {
+            m_Bodies.IntegrateVelocities(m_Gravity, deltaTime, begin, end);
+        });
     }
-    
-    // Step 2: Integrate velocity -> position
-    for (auto& entry : m_Rigidbodies) {
-        RigidbodyComponent* rb = entry.Rigidbody;
-        TransformComponent* transform = entry.Transform;
-        ColliderComponent* collider = entry.Collider;
-        
-        if (!rb || !transform || rb->IsStatic) continue;
-        
-        // Update position
-        transform->Position += rb->Velocity * deltaTime;
-        
-        // Update rotation (angular velocity)
-        if (glm::length(rb->AngularVelocity) > 0.0f) {
-            glm::vec3 axis = glm::normalize(rb->AngularVelocity);
-            float angle = glm::length(rb->AngularVelocity) * deltaTime;
-            // Simple angular integration (Euler)
-            transform->Rotation += rb->AngularVelocity * deltaTime;
-            rb->AngularVelocity *= (1.0f - rb->AngularDamping);
+
+    // Step 2: Refresh broad-phase bounds (most bodies stay inside their fat AABB)
+    // and collect candidates within reach of this step's motion
+    {
+        NILOS_PROFILE_SCOPE("Physics: Broad Phase");
+        for (size_t slot = 0; slot < m_ActiveBodies.size(); ++slot) {
+            uint32_t i = m_ActiveBodies[slot];
+            const RigidbodyEntry& entry = m_Rigidbodies[i];
+            m_DynamicTree.MoveProxy(m_RigidbodyProxies[i], GetWorldAABB(entry.Collider, entry.Transform),
+                                    m_Bodies.GetVelocity(slot) * deltaTime);
         }
+        FindBodyPairs();
+        FindStaticPairs(deltaTime);
+    }
+
+    // Step 3: Shape vs shape contacts into the persistent manifolds
+    {
+        NILOS_PROFILE_SCOPE("Physics: Narrow Phase");
+        UpdateContacts(deltaTime);
     }
-    
-    // Step 3: Ground collision (simple for now)
+
+    // Step 4: Sequential impulses, warm started from the last step
+    {
+        NILOS_PROFILE_SCOPE("Physics: Solve Velocities");
+        PrepareContacts(deltaTime);
+        for (uint32_t iteration = 0; iteration < VELOCITY_ITERATIONS; ++iteration) {
+            SolveVelocities();
+        }
+        ApplyRestitution();
+    }
+
+    // Step 5: Integrate the solved velocities, then remove leftover penetration
+    {
+        NILOS_PROFILE_SCOPE("Physics: Integrate Positions");
+        JobSystem::Get().ParallelFor(m_Bodies.Count, INTEGRATION_GRAIN, [&](size_t begin, size_t end) {
+            m_Bodies.IntegratePositions(deltaTime, begin, end);
+        });
+        for (uint32_t iteration = 0; iteration < POSITION_ITERATIONS; ++iteration) {
+            SolvePositions();
+        }
+        ScatterBodies(deltaTime);
+    }
+
+    // Step 6: Put islands to sleep that have been at rest long enough
+    {
+        NILOS_PROFILE_SCOPE("Physics: Sleep");
+        UpdateSleep(deltaTime);
+    }
+
+    EndStepPoses();
+}
+
+void PhysicsWorld::WakeAllBodies() {
+    ResolveEntries();
     for (auto& entry : m_Rigidbodies) {
-        RigidbodyComponent* rb = entry.Rigidbody;
-        TransformComponent* transform = entry.Transform;
-        ColliderComponent* collider = entry.Collider;
-        
-        if (!rb || !transform || !collider || rb->IsStatic) continue;
-        
-        // Calculate bottom of object
-        float objectBottom = transform->Position.y - (collider->Size.y * transform->Scale.y * 0.5f);
-        
-        // Ground is at Y = 0
-        if (objectBottom <= 0.0f) {
-            // Place on ground
-            transform->Position.y = (collider->Size.y * transform->Scale.y * 0.5f);
-            
-            // Bounce
-            if (rb->Velocity.y < 0.0f) {
-                rb->Velocity.y = -rb->Velocity.y * rb->Restitution;
-                
-                // Apply friction to horizontal velocity
-                rb->Velocity.x *= (1.0f - rb->DynamicFriction);
-                rb->Velocity.z *= (1.0f - rb->DynamicFriction);
-                
-                // Stop bouncing if too slow
-                if (glm::abs(rb->Velocity.y) < 0.05f) {
-                    rb->Velocity.y = 0.0f;
-                    
-                    // Apply static friction
-                    if (glm::length(glm::vec2(rb->Velocity.x, rb->Velocity.z)) < 0.1f) {
-                        rb->Velocity = glm::vec3(0.0f);
-                    }
-                }
-            }
+        entry.Rigidbody->WakeUp();
+    }
+}
+
+uint32_t PhysicsWorld::FindIsland(uint32_t body) {
+    // Path halving
+    while (m_IslandParent[body] != body) {
+        m_IslandParent[body] = m_IslandParent[m_IslandParent[body]];
+        body = m_IslandParent[body];
+    }
+    return body;
+}
+
+void PhysicsWorld::UnionIslands(uint32_t a, uint32_t b) {
+    uint32_t rootA = FindIsland(a);
+    uint32_t rootB = FindIsland(b);
+    if (rootA != rootB) {
+        m_IslandParent[std::max(rootA, rootB)] = std::min(rootA, rootB);
+    }
+}
+
+void PhysicsWorld::UpdateSleep(float deltaTime) {
+    const float linearThresholdSq = SLEEP_LINEAR_VELOCITY * SLEEP_LINEAR_VELOCITY;
+    const float angularThresholdSq = SLEEP_ANGULAR_VELOCITY * SLEEP_ANGULAR_VELOCITY;
+
+    // Per-body rest timers, then the island's time is the minimum over its members
+    m_IslandSleepTime.assign(m_Rigidbodies.size(), TIME_TO_SLEEP);
+    for (uint32_t i : m_ActiveBodies) {
+        RigidbodyComponent* rb = m_Rigidbodies[i].Rigidbody;
+
+        bool resting = rb->AllowSleep && !rb->IsKinematic &&
+                       glm::dot(rb->Velocity, rb->Velocity) <= linearThresholdSq &&
+                       glm::dot(rb->AngularVelocity, rb->AngularVelocity) <= angularThresholdSq;
+        rb->SleepTimer = resting ? rb->SleepTimer + deltaTime : 0.0f;
+
+        uint32_t island = FindIsland(i);
+        m_IslandSleepTime[island] = std::min(m_IslandSleepTime[island], rb->SleepTimer);
+    }
+
+    for (uint32_t i : m_ActiveBodies) {
+        RigidbodyComponent* rb = m_Rigidbodies[i].Rigidbody;
+        if (m_IslandSleepTime[FindIsland(i)] < TIME_TO_SLEEP) continue;
+
+        rb->IsSleeping = true;
+        rb->Velocity = glm::vec3(0.0f);
+        rb->AngularVelocity = glm::vec3(0.0f);
+    }
+}
+
+void PhysicsWorld::InterpolateTransforms(float alpha) {
+    ResolveEntries();
+
+    for (size_t i = 0; i < m_Rigidbodies.size(); ++i) {
+        TransformComponent* transform = m_Rigidbodies[i].Transform;
+        BodyPoses& poses = m_Poses[i];
+
+        // Moved by gameplay code since we last wrote it: teleport, no blending
+        if (!poses.Rendered.Matches(*transform)) {
+            poses.Previous = poses.Current = BodyPose::From(*transform);
         }
+
+        poses.Rendered.Position = glm::mix(poses.Previous.Position, poses.Current.Position, alpha);
+        poses.Rendered.Rotation = glm::mix(poses.Previous.Rotation, poses.Current.Rotation, alpha);
+        poses.Rendered.ApplyTo(*transform);
     }
-    
-    // Step 4: Object-object collisions (AABB)
+    m_TransformsInterpolated = true;
+}
+
+void PhysicsWorld::BeginStepPoses() {
     for (size_t i = 0; i < m_Rigidbodies.size(); ++i) {
-        RigidbodyComponent* rbA = m_Rigidbodies[i].Rigidbody;
-        ColliderComponent* colA = m_Rigidbodies[i].Collider;
-        TransformComponent* transA = m_Rigidbodies[i].Transform;
-        
-        if (!rbA || !colA || !transA || rbA->IsStatic) continue;
-        
-        AABB aabbA = GetWorldAABB(colA, transA);
-        
-        for (size_t j = i + 1; j < m_Rigidbodies.size(); ++j) {
-            RigidbodyComponent* rbB = m_Rigidbodies[j].Rigidbody;
-            ColliderComponent* colB = m_Rigidbodies[j].Collider;
-            TransformComponent* transB = m_Rigidbodies[j].Transform;
-            
-            if (!rbB || !colB || !transB) continue;
-            
-            AABB aabbB = GetWorldAABB(colB, transB);
-            
-            if (aabbA.Intersects(aabbB)) {
-                // Simple collision response: push apart
-                glm::vec3 centerA = aabbA.GetCenter();
-                glm::vec3 centerB = aabbB.GetCenter();
-                glm::vec3 normal = glm::normalize(centerA - centerB);
-                
-                if (glm::length(normal) < 0.001f) {
-                    normal = glm::vec3(0.0f, 1.0f, 0.0f);
-                }
-                
-                // Push objects apart
-                if (!rbA->IsStatic) {
-                    transA->Position += normal * 0.01f;
-                }
-                if (!rbB->IsStatic) {
-                    transB->Position -= normal * 0.01f;
-                }
-                
-                // Simple impulse (bounce)
-                float restitution = (rbA->Restitution + rbB->Restitution) * 0.5f;
-                glm::vec3 relativeVelocity = rbA->Velocity - rbB->Velocity;
-                float velocityAlongNormal = glm::dot(relativeVelocity, normal);
-                
-                if (velocityAlongNormal > 0) continue; // Moving apart
-                
-                float impulseScalar = -(1.0f + restitution) * velocityAlongNormal;
-                impulseScalar /= (rbA->InverseMass + rbB->InverseMass);
-                
-                glm::vec3 impulse = impulseScalar * normal;
-                
-                if (!rbA->IsStatic) {
-                    rbA->Velocity += impulse * rbA->InverseMass;
-                }
-                if (!rbB->IsStatic) {
-                    rbB->Velocity -= impulse * rbB->InverseMass;
-                }
+        TransformComponent* transform = m_Rigidbodies[i].Transform;
+        BodyPoses& poses = m_Poses[i];
+
+        // Swap the interpolated pose for the simulated one, unless gameplay
+        // code moved the body since (then its new pose is authoritative)
+        if (m_TransformsInterpolated && poses.Rendered.Matches(*transform)) {
+            poses.Current.ApplyTo(*transform);
+        }
+
+        // Woken by the game moving it, setting a velocity or applying a force
+        RigidbodyComponent* rb = m_Rigidbodies[i].Rigidbody;
+        if (rb->IsSleeping &&
+            (!poses.Current.Matches(*transform) || rb->Velocity != glm::vec3(0.0f) || rb->Force != glm::vec3(0.0f))) {
+            rb->WakeUp();
+        }
+
+        poses.Previous = BodyPose::From(*transform);
+    }
+    m_TransformsInterpolated = false;
+}
+
+void PhysicsWorld::EndStepPoses() {
+    for (size_t i = 0; i < m_Rigidbodies.size(); ++i) {
+        BodyPoses& poses = m_Poses[i];
+        poses.Current = BodyPose::From(*m_Rigidbodies[i].Transform);
+        poses.Rendered = poses.Current;
+    }
+}
+
+void PhysicsWorld::GatherBodies(float deltaTime) {
+    // Only active bodies are copied, so sleeping debris costs nothing past this scan
+    m_ActiveBodies.clear();
+    for (uint32_t i = 0; i < m_Rigidbodies.size(); ++i) {
+        if (IsActive(m_Rigidbodies[i].Rigidbody)) {
+            m_ActiveBodies.push_back(i);
+        }
+    }
+    m_Bodies.Resize(m_ActiveBodies.size());
+    m_BodySlots.assign(m_Rigidbodies.size(), NO_SLOT);
+
+    for (size_t i = 0; i < m_ActiveBodies.size(); ++i) {
+        m_BodySlots[m_ActiveBodies[i]] = static_cast<uint32_t>(i);
+        const RigidbodyComponent* rb = m_Rigidbodies[m_ActiveBodies[i]].Rigidbody;
+        const glm::vec3& position = m_Rigidbodies[m_ActiveBodies[i]].Transform->Position;
+
+        m_Bodies.PositionX[i] = position.x;
+        m_Bodies.PositionY[i] = position.y;
+        m_Bodies.PositionZ[i] = position.z;
+        m_Bodies.VelocityX[i] = rb->Velocity.x;
+        m_Bodies.VelocityY[i] = rb->Velocity.y;
+        m_Bodies.VelocityZ[i] = rb->Velocity.z;
+        m_Bodies.ForceX[i] = rb->Force.x;
+        m_Bodies.ForceY[i] = rb->Force.y;
+        m_Bodies.ForceZ[i] = rb->Force.z;
+
+        // Encode the body type in the constants (see BodyStore)
+        bool dynamic = !rb->IsStatic && !rb->IsKinematic;
+        m_Bodies.InverseMass[i] = dynamic ? rb->InverseMass : 0.0f;
+        m_Bodies.GravityScale[i] = (dynamic && rb->UseGravity && rb->InverseMass > 0.0f) ? 1.0f : 0.0f;
+        m_Bodies.Damping[i] = dynamic ? 1.0f / (1.0f + deltaTime * rb->LinearDamping) : 1.0f;
+        m_Bodies.MoveScale[i] = 1.0f;
+    }
+}
+
+void PhysicsWorld::ScatterBodies(float deltaTime) {
+    for (size_t i = 0; i < m_ActiveBodies.size(); ++i) {
+        RigidbodyComponent* rb = m_Rigidbodies[m_ActiveBodies[i]].Rigidbody;
+        TransformComponent* transform = m_Rigidbodies[m_ActiveBodies[i]].Transform;
+
+        rb->Velocity = glm::vec3(m_Bodies.VelocityX[i], m_Bodies.VelocityY[i], m_Bodies.VelocityZ[i]);
+        transform->Position = glm::vec3(m_Bodies.PositionX[i], m_Bodies.PositionY[i], m_Bodies.PositionZ[i]);
+
+        // Clear forces for next frame
+        if (!rb->IsKinematic) {
+            rb->ClearForces();
+        }
+
+        // Update rotation (angular velocity, simple Euler); rare enough to stay scalar
+        if (rb->AngularVelocity != glm::vec3(0.0f)) {
+            transform->Rotation += rb->AngularVelocity * deltaTime;
+            rb->AngularVelocity *= 1.0f / (1.0f + deltaTime * rb->AngularDamping);
+        }
+    }
+}
+
+void PhysicsWorld::FindBodyPairs() {
+    m_Pairs.clear();
+
+    for (uint32_t i : m_ActiveBodies) {
+        const AABB& fatBox = m_DynamicTree.GetFatAABB(m_RigidbodyProxies[i]);
+        m_DynamicTree.Query(fatBox, [&](int32_t proxyId) {
+            uint32_t j = m_DynamicTree.GetUserData(proxyId);
+
+            // Each pair once: the lower index reports it, unless the other body
+            // is inactive (static and sleeping bodies never query themselves)
+            if (j == i || (j < i && IsActive(m_Rigidbodies[j].Rigidbody))) return true;
+
+            m_Pairs.emplace_back(i, j);
+            return true;
+        });
+    }
+}
+
+void PhysicsWorld::FindStaticPairs(float deltaTime) {
+    m_StaticPairs.clear();
+
+    for (size_t slot = 0; slot < m_ActiveBodies.size(); ++slot) {
+        uint32_t i = m_ActiveBodies[slot];
+        const RigidbodyEntry& entry = m_Rigidbodies[i];
+        if (entry.Collider->IsTrigger) continue;
+
+        // Bounds swept along this step's motion, plus the speculative margin
+        AABB box = GetWorldAABB(entry.Collider, entry.Transform);
+        glm::vec3 displacement = m_Bodies.GetVelocity(slot) * deltaTime;
+        AABB swept(glm::min(box.Min, box.Min + displacement) - glm::vec3(CONTACT_MARGIN),
+                   glm::max(box.Max, box.Max + displacement) + glm::vec3(CONTACT_MARGIN));
+
+        m_StaticTree.Query(swept, [&](int32_t proxyId) {
+            uint32_t other = m_StaticTree.GetUserData(proxyId);
+            if (!m_StaticColliders[other].Collider->IsTrigger) {
+                m_StaticPairs.emplace_back(i, other);
             }
+            return true;
+        });
+    }
+}
+
+void PhysicsWorld::UpdateContacts(float deltaTime) {
+    m_Contacts.clear();
+    m_IslandParent.resize(m_Rigidbodies.size());
+    for (uint32_t i = 0; i < m_IslandParent.size(); ++i) {
+        m_IslandParent[i] = i;
+    }
+
+    // Static, sleeping and kinematic (unless active) bodies have no velocity here
+    auto velocityOf = [&](uint32_t body) {
+        uint32_t slot = m_BodySlots[body];
+        return slot != NO_SLOT ? m_Bodies.GetVelocity(slot) : glm::vec3(0.0f);
+    };
+
+    for (const auto& pair : m_Pairs) {
+        uint32_t indexA = pair.first;
+        uint32_t indexB = pair.second;
+
+        // Same key and normal direction whichever body found the pair
+        if (m_Rigidbodies[indexA].EntityID > m_Rigidbodies[indexB].EntityID) {
+            std::swap(indexA, indexB);
         }
+        const RigidbodyEntry& a = m_Rigidbodies[indexA];
+        const RigidbodyEntry& b = m_Rigidbodies[indexB];
+        if (a.Collider->IsTrigger || b.Collider->IsTrigger) continue;
+        if (!IsMovable(a.Rigidbody) && !IsMovable(b.Rigidbody)) continue;
+
+        float margin = CONTACT_MARGIN + glm::length(velocityOf(indexB) - velocityOf(indexA)) * deltaTime;
+        ContactConstraint* contact = UpdateManifold(PairKey(a.EntityID, b.EntityID),
+                                                    GetWorldShape(a.Collider, a.Transform),
+                                                    GetWorldShape(b.Collider, b.Transform), margin);
+        if (!contact) continue;
+
+        contact->BodyA = a.EntityID;
+        contact->BodyB = b.EntityID;
+        contact->StaticB = false;
+        contact->SlotA = m_BodySlots[indexA];
+        contact->SlotB = m_BodySlots[indexB];
+        contact->Friction = (a.Rigidbody->DynamicFriction + b.Rigidbody->DynamicFriction) * 0.5f;
+        contact->Restitution = (a.Rigidbody->Restitution + b.Rigidbody->Restitution) * 0.5f;
+        m_Contacts.push_back(contact);
+
+        // Touched by an active body: wake up and join its island
+        if (a.Rigidbody->IsSleeping) a.Rigidbody->WakeUp();
+        if (b.Rigidbody->IsSleeping) b.Rigidbody->WakeUp();
+        if (JoinsIslands(a.Rigidbody) && JoinsIslands(b.Rigidbody)) {
+            UnionIslands(indexA, indexB);
+        }
+    }
+
+    for (const auto& pair : m_StaticPairs) {
+        const RigidbodyEntry& body = m_Rigidbodies[pair.first];
+        const StaticColliderEntry& other = m_StaticColliders[pair.second];
+        if (!IsMovable(body.Rigidbody)) continue;
+
+        float margin = CONTACT_MARGIN + glm::length(velocityOf(pair.first)) * deltaTime;
+        ContactConstraint* contact = UpdateManifold(PairKey(body.EntityID, other.EntityID),
+                                                    GetWorldShape(body.Collider, body.Transform),
+                                                    GetWorldShape(other.Collider, other.Transform), margin);
+        if (!contact) continue;
+
+        contact->BodyA = body.EntityID;
+        contact->BodyB = other.EntityID;
+        contact->StaticB = true;
+        contact->SlotA = m_BodySlots[pair.first];
+        contact->SlotB = NO_SLOT;
+        contact->Friction = body.Rigidbody->DynamicFriction;
+        contact->Restitution = body.Rigidbody->Restitution;
+        m_Contacts.push_back(contact);
     }
+
+    PruneContacts();
+}
+
+PhysicsWorld::ContactConstraint* PhysicsWorld::UpdateManifold(uint64_t key, const CollisionShape& shapeA,
+                                                              const CollisionShape& shapeB, float margin) {
+    ContactManifold manifold;
+    if (!Collide(shapeA, shapeB, margin, manifold)) {
+        m_Manifolds.erase(key);
+        return nullptr;
+    }
+
+    // Still the same contact if the surface faces the same way: start from its impulses
+    ContactConstraint& contact = m_Manifolds[key];
+    if (glm::dot(contact.Manifold.Normal, manifold.Normal) < CONTACT_MATCH_COSINE) {
+        contact.NormalImpulse = 0.0f;
+        contact.TangentImpulse[0] = 0.0f;
+        contact.TangentImpulse[1] = 0.0f;
+    }
+
+    contact.Manifold = manifold;
+    contact.Separation = manifold.GetSeparation();
+    contact.LastStep = m_StepCount;
+    return &contact;
+}
+
+void PhysicsWorld::PruneContacts() {
+    // Sleeping bodies skip the narrow phase; their manifolds are kept so
+    // they wake up warm started. Everything else not collided is gone.
+    auto sleeps = [&](Entity entity) {
+        const RigidbodyComponent* rb = m_World->GetComponent<RigidbodyComponent>(entity);
+        return rb && rb->IsSleeping;
+    };
+
+    for (auto it = m_Manifolds.begin(); it != m_Manifolds.end();) {
+        const ContactConstraint& contact = it->second;
+        bool keep = contact.LastStep == m_StepCount ||
+                    (sleeps(contact.BodyA) &&
+                     (contact.StaticB ? m_World->HasComponent<ColliderComponent>(contact.BodyB) : sleeps(contact.BodyB)));
+        it = keep ? std::next(it) : m_Manifolds.erase(it);
+    }
+}
+
+void PhysicsWorld::PrepareContacts(float deltaTime) {
+    // Bounces slower than what gravity adds in a couple of steps are resting
+    // contact; treating them as bounces would make bodies jitter forever
+    const float restingSpeed = std::max(RESTING_CONTACT_SPEED, glm::length(m_Gravity) * deltaTime * 2.0f);
+
+    for (ContactConstraint* contact : m_Contacts) {
+        const glm::vec3& normal = contact->Manifold.Normal;
+        bool movableA = contact->SlotA != NO_SLOT;
+        bool movableB = contact->SlotB != NO_SLOT;
+        contact->InverseMassA = movableA ? m_Bodies.InverseMass[contact->SlotA] : 0.0f;
+        contact->InverseMassB = movableB ? m_Bodies.InverseMass[contact->SlotB] : 0.0f;
+        contact->StartA = movableA ? m_Bodies.GetPosition(contact->SlotA) : glm::vec3(0.0f);
+        contact->StartB = movableB ? m_Bodies.GetPosition(contact->SlotB) : glm::vec3(0.0f);
+
+        // E.g. a kinematic body against one that only just woke up
+        float inverseMassSum = contact->InverseMassA + contact->InverseMassB;
+        contact->NormalMass = inverseMassSum > 0.0f ? 1.0f / inverseMassSum : 0.0f;
+        if (contact->NormalMass == 0.0f) continue;
+
+        ComputeTangents(normal, contact->Tangents[0], contact->Tangents[1]);
+
+        // Speculative contacts may close the gap, no more; touching ones must not approach
+        contact->VelocityBias = contact->Separation > 0.0f ? -contact->Separation / deltaTime : 0.0f;
+
+        // Bounce off the approach speed from before this step's forces (the
+        // components are only updated in ScatterBodies): with the gravity of
+        // the step included every bounce would gain energy and never settle
+        glm::vec3 velocityA = movableA ? m_Rigidbodies[m_ActiveBodies[contact->SlotA]].Rigidbody->Velocity : glm::vec3(0.0f);
+        glm::vec3 velocityB = movableB ? m_Rigidbodies[m_ActiveBodies[contact->SlotB]].Rigidbody->Velocity : glm::vec3(0.0f);
+        float normalSpeed = glm::dot(velocityB - velocityA, normal);
+        contact->NormalVelocity = normalSpeed < -restingSpeed ? normalSpeed : 0.0f;
+
+        // Warm start
+        glm::vec3 impulse = normal * contact->NormalImpulse + contact->Tangents[0] * contact->TangentImpulse[0] +
+                            contact->Tangents[1] * contact->TangentImpulse[1];
+        if (movableA) m_Bodies.AddVelocity(contact->SlotA, -impulse * contact->InverseMassA);
+        if (movableB) m_Bodies.AddVelocity(contact->SlotB, impulse * contact->InverseMassB);
+    }
+}
+
+void PhysicsWorld::SolveVelocities() {
+    for (ContactConstraint* contact : m_Contacts) {
+        if (contact->NormalMass == 0.0f) continue;
+
+        const glm::vec3& normal = contact->Manifold.Normal;
+        bool movableA = contact->SlotA != NO_SLOT;
+        bool movableB = contact->SlotB != NO_SLOT;
+        glm::vec3 velocityA = movableA ? m_Bodies.GetVelocity(contact->SlotA) : glm::vec3(0.0f);
+        glm::vec3 velocityB = movableB ? m_Bodies.GetVelocity(contact->SlotB) : glm::vec3(0.0f);
+        glm::vec3 impulse(0.0f);
+
+        // Friction first, bounded by the normal impulse (Coulomb, per tangent)
+        float limit = contact->Friction * contact->NormalImpulse;
+        for (int k = 0; k < 2; ++k) {
+            const glm::vec3& tangent = contact->Tangents[k];
+            float speed = glm::dot(velocityB - velocityA, tangent);
+            float previous = contact->TangentImpulse[k];
+            contact->TangentImpulse[k] = std::clamp(previous - speed * contact->NormalMass, -limit, limit);
+
+            glm::vec3 delta = tangent * (contact->TangentImpulse[k] - previous);
+            velocityA -= delta * contact->InverseMassA;
+            velocityB += delta * contact->InverseMassB;
+            impulse += delta;
+        }
+
+        // Non-penetration: the accumulated impulse may only push
+        float speed = glm::dot(velocityB - velocityA, normal);
+        float previous = contact->NormalImpulse;
+        contact->NormalImpulse = std::max(previous - (speed - contact->VelocityBias) * contact->NormalMass, 0.0f);
+        impulse += normal * (contact->NormalImpulse - previous);
+
+        if (movableA) m_Bodies.AddVelocity(contact->SlotA, -impulse * contact->InverseMassA);
+        if (movableB) m_Bodies.AddVelocity(contact->SlotB, impulse * contact->InverseMassB);
+    }
+}
+
+void PhysicsWorld::ApplyRestitution() {
+    // After the solver, so speculative contacts bounce too once they pushed
+    for (ContactConstraint* contact : m_Contacts) {
+        if (contact->NormalMass == 0.0f || contact->NormalVelocity >= 0.0f || contact->NormalImpulse <= 0.0f) continue;
+
+        const glm::vec3& normal = contact->Manifold.Normal;
+        bool movableA = contact->SlotA != NO_SLOT;
+        bool movableB = contact->SlotB != NO_SLOT;
+        glm::vec3 velocityA = movableA ? m_Bodies.GetVelocity(contact->SlotA) : glm::vec3(0.0f);
+        glm::vec3 velocityB = movableB ? m_Bodies.GetVelocity(contact->SlotB) : glm::vec3(0.0f);
+
+        float speed = glm::dot(velocityB - velocityA, normal);
+        float previous = contact->NormalImpulse;
+        contact->NormalImpulse = std::max(previous - (speed + contact->Restitution * contact->NormalVelocity) *
+                                                         contact->NormalMass, 0.0f);
+
+        glm::vec3 impulse = normal * (contact->NormalImpulse - previous);
+        if (movableA) m_Bodies.AddVelocity(contact->SlotA, -impulse * contact->InverseMassA);
+        if (movableB) m_Bodies.AddVelocity(contact->SlotB, impulse * contact->InverseMassB);
+    }
+}
+
+void PhysicsWorld::SolvePositions() {
+    for (ContactConstraint* contact : m_Contacts) {
+        if (contact->NormalMass == 0.0f) continue;
+
+        // Contacts don't rotate bodies, so the separation follows from the displacement alone
+        const glm::vec3& normal = contact->Manifold.Normal;
+        bool movableA = contact->SlotA != NO_SLOT;
+        bool movableB = contact->SlotB != NO_SLOT;
+        glm::vec3 movedA = movableA ? m_Bodies.GetPosition(contact->SlotA) - contact->StartA : glm::vec3(0.0f);
+        glm::vec3 movedB = movableB ? m_Bodies.GetPosition(contact->SlotB) - contact->StartB : glm::vec3(0.0f);
+        float separation = contact->Separation + glm::dot(normal, movedB - movedA);
+
+        // Leave LINEAR_SLOP of overlap so resting contacts stay touching
+        float correction = std::clamp(POSITION_CORRECTION * (separation + LINEAR_SLOP), -MAX_POSITION_CORRECTION, 0.0f);
+        if (correction >= 0.0f) continue;
+
+        glm::vec3 push = normal * (-correction * contact->NormalMass);
+        if (movableA) m_Bodies.AddPosition(contact->SlotA, -push * contact->InverseMassA);
+        if (movableB) m_Bodies.AddPosition(contact->SlotB, push * contact->InverseMassB);
+    }
+}
+
+void PhysicsWorld::RegisterRigidbody(Entity entity) {
+    if (!m_World->HasComponent<RigidbodyComponent>(entity) ||
+        !m_World->HasComponent<ColliderComponent>(entity) ||
+        !m_World->HasComponent<TransformComponent>(entity)) {
+        NILOS_WARNING("RegisterRigidbody: ", m_World->GetEntityName(entity),
+                      " needs Rigidbody, Collider and Transform components");
+        return;
+    }
+
+    AABB aabb = GetWorldAABB(m_World->GetComponent<ColliderComponent>(entity),
+                             m_World->GetComponent<TransformComponent>(entity));
+    m_RigidbodyProxies.push_back(m_DynamicTree.CreateProxy(aabb, static_cast<uint32_t>(m_RigidbodyEntities.size())));
+    m_RigidbodyEntities.push_back(entity);
+
+    BodyPose pose = BodyPose::From(*m_World->GetComponent<TransformComponent>(entity));
+    m_Poses.push_back({ pose, pose, pose });
+}
+
+void PhysicsWorld::RegisterStaticCollider(Entity entity) {
+    if (!m_World->HasComponent<ColliderComponent>(entity) ||
+        !m_World->HasComponent<TransformComponent>(entity)) {
+        NILOS_WARNING("RegisterStaticCollider: ", m_World->GetEntityName(entity),
+                      " needs Collider and Transform components");
+        return;
+    }
+
+    AABB aabb = GetWorldAABB(m_World->GetComponent<ColliderComponent>(entity),
+                             m_World->GetComponent<TransformComponent>(entity));
+    m_StaticProxies.push_back(m_StaticTree.CreateProxy(aabb, static_cast<uint32_t>(m_StaticEntities.size())));
+    m_StaticEntities.push_back(entity);
+}
+
+size_t PhysicsWorld::RegisterEntities(const Entity* entities, size_t count) {
+    size_t registered = 0;
+    for (size_t i = 0; i < count; ++i) {
+        Entity entity = entities[i];
+        if (!m_World->HasComponent<ColliderComponent>(entity) || !m_World->HasComponent<TransformComponent>(entity)) {
+            continue;
+        }
+        if (m_World->HasComponent<RigidbodyComponent>(entity)) {
+            RegisterRigidbody(entity);
+        } else {
+            RegisterStaticCollider(entity);
+        }
+        ++registered;
+    }
+    return registered;
 }
 
-void PhysicsWorld::RegisterRigidbody(RigidbodyComponent* rb, ColliderComponent* collider, TransformComponent* transform) {
-    RigidbodyEntry entry;
-    entry.Rigidbody = rb;
-    entry.Collider = collider;
-    entry.Transform = transform;
-    entry.EntityID = 0;
-    m_Rigidbodies.push_back(entry);
+void PhysicsWorld::RefreshStaticColliders() {
+    ResolveEntries();
+
+    m_StaticTree.Clear();
+    for (size_t i = 0; i < m_StaticColliders.size(); ++i) {
+        const StaticColliderEntry& entry = m_StaticColliders[i];
+        m_StaticProxies[i] = m_StaticTree.CreateProxy(GetWorldAABB(entry.Collider, entry.Transform),
+                                                      static_cast<uint32_t>(i));
+    }
+
+    // Statics moved: bodies resting on them must re-evaluate their contacts
+    for (auto& entry : m_Rigidbodies) {
+        entry.Rigidbody->WakeUp();
+    }
 }
 
-void PhysicsWorld::RegisterStaticCollider(ColliderComponent* collider, TransformComponent* transform) {
-    StaticColliderEntry entry;
-    entry.Collider = collider;
-    entry.Transform = transform;
-    entry.EntityID = 0;
-    m_StaticColliders.push_back(entry);
+void PhysicsWorld::ResolveEntries() {
+    m_Rigidbodies.clear();
+    m_StaticColliders.clear();
+
+    // Compact in place, dropping entities that were destroyed or lost a required component
+    size_t alive = 0;
+    for (size_t i = 0; i < m_RigidbodyEntities.size(); ++i) {
+        Entity entity = m_RigidbodyEntities[i];
+        RigidbodyEntry entry;
+        entry.Rigidbody = m_World->GetComponent<RigidbodyComponent>(entity);
+        entry.Collider = m_World->GetComponent<ColliderComponent>(entity);
+        entry.Transform = m_World->GetComponent<TransformComponent>(entity);
+        entry.EntityID = entity;
+        if (entry.Rigidbody && entry.Collider && entry.Transform) {
+            m_DynamicTree.SetUserData(m_RigidbodyProxies[i], static_cast<uint32_t>(alive));
+            m_RigidbodyProxies[alive] = m_RigidbodyProxies[i];
+            m_Poses[alive] = m_Poses[i];
+            m_RigidbodyEntities[alive++] = entity;
+            m_Rigidbodies.push_back(entry);
+        } else {
+            m_DynamicTree.DestroyProxy(m_RigidbodyProxies[i]);
+        }
+    }
+    m_RigidbodyEntities.resize(alive);
+    m_RigidbodyProxies.resize(alive);
+    m_Poses.resize(alive);
+
+    alive = 0;
+    bool staticsRemoved = false;
+    for (size_t i = 0; i < m_StaticEntities.size(); ++i) {
+        Entity entity = m_StaticEntities[i];
+        StaticColliderEntry entry;
+        entry.Collider = m_World->GetComponent<ColliderComponent>(entity);
+        entry.Transform = m_World->GetComponent<TransformComponent>(entity);
+        entry.EntityID = entity;
+        if (entry.Collider && entry.Transform) {
+            m_StaticTree.SetUserData(m_StaticProxies[i], static_cast<uint32_t>(alive));
+            m_StaticProxies[alive] = m_StaticProxies[i];
+            m_StaticEntities[alive++] = entity;
+            m_StaticColliders.push_back(entry);
+        } else {
+            m_StaticTree.DestroyProxy(m_StaticProxies[i]);
+            staticsRemoved = true;
+        }
+    }
+    m_StaticEntities.resize(alive);
+    m_StaticProxies.resize(alive);
+
+    // Sleeping bodies may have been resting on a collider that is gone
+    if (staticsRemoved) {
+        for (auto& entry : m_Rigidbodies) {
+            entry.Rigidbody->WakeUp();
+        }
+    }
 }
 
 bool PhysicsWorld::CheckCollision(const AABB& a, const AABB& b) const {
@@ -167,52 +713,237 @@ bool PhysicsWorld::CheckCollision(const AABB& a, const AABB& b) const {
 }
 
 bool PhysicsWorld::Raycast(const Ray& ray, float maxDistance, glm::vec3& hitPoint, Entity& hitEntity) {
+    ResolveEntries();
+
     float closestT = maxDistance;
     bool hit = false;
-    
-    // Check rigidbodies
-    for (const auto& entry : m_Rigidbodies) {
-        AABB aabb = GetWorldAABB(entry.Collider, entry.Transform);
-        
+
+    // Both trees share the clipped distance, so the second one skips anything behind the first hit
+    auto testEntry = [&](const ColliderComponent* collider, const TransformComponent* transform, Entity entity) {
+        AABB aabb = GetWorldAABB(collider, transform);
+
         float tMin, tMax;
         if (ray.Intersects(aabb, tMin, tMax)) {
             if (tMin < closestT && tMin >= 0.0f) {
                 closestT = tMin;
                 hitPoint = ray.GetPoint(tMin);
-                hitEntity = entry.EntityID;
+                hitEntity = entity;
                 hit = true;
             }
         }
-    }
-    
+        return closestT;
+    };
+
+    // Check rigidbodies
+    m_DynamicTree.RayCast(ray, closestT, [&](int32_t proxyId, float) {
+        const RigidbodyEntry& entry = m_Rigidbodies[m_DynamicTree.GetUserData(proxyId)];
+        return testEntry(entry.Collider, entry.Transform, entry.EntityID);
+    });
+
     // Check static colliders
-    for (const auto& entry : m_StaticColliders) {
-        AABB aabb = GetWorldAABB(entry.Collider, entry.Transform);
-        
-        float tMin, tMax;
-        if (ray.Intersects(aabb, tMin, tMax)) {
-            if (tMin < closestT && tMin >= 0.0f) {
-                closestT = tMin;
-                hitPoint = ray.GetPoint(tMin);
-                hitEntity = entry.EntityID;
-                hit = true;
+    m_StaticTree.RayCast(ray, closestT, [&](int32_t proxyId, float) {
+        const StaticColliderEntry& entry = m_StaticColliders[m_StaticTree.GetUserData(proxyId)];
+        return testEntry(entry.Collider, entry.Transform, entry.EntityID);
+    });
+
+    return hit;
+}
+
+void PhysicsWorld::RaycastBatch(const Ray* rays, size_t count, float maxDistance, RaycastHit* hits) {
+    ResolveEntries();
+
+    size_t packetCount = (count + SIMD::WIDTH - 1) / SIMD::WIDTH;
+    JobSystem::Get().ParallelFor(packetCount, RAYCAST_PACKET_GRAIN, [&](size_t begin, size_t end) {
+        for (size_t packetIndex = begin; packetIndex < end; ++packetIndex) {
+            size_t first = packetIndex * SIMD::WIDTH;
+
+            RayPacket packet;
+            for (int lane = 0; lane < static_cast<int>(SIMD::WIDTH); ++lane) {
+                if (first + lane < count) {
+                    packet.SetLane(lane, rays[first + lane], maxDistance);
+                    hits[first + lane] = RaycastHit();
+                } else {
+                    packet.ClearLane(lane);
+                }
             }
+
+            RaycastPacket(packet, rays + first, hits + first);
         }
-    }
-    
-    return hit;
+    });
+}
+
+void PhysicsWorld::RaycastPacket(RayPacket& packet, const Ray* rays, RaycastHit* hits) const {
+    // Exact test for every lane that reached a leaf; clipping MaxDistance
+    // lets the traversal skip subtrees behind each lane's closest hit
+    auto testLanes = [&](int laneMask, const ColliderComponent* collider,
+                         const TransformComponent* transform, Entity entity) {
+        AABB box = GetWorldAABB(collider, transform);
+        for (int lane = 0; lane < static_cast<int>(SIMD::WIDTH); ++lane) {
+            if (!(laneMask & (1 << lane))) continue;
+
+            float distance;
+            glm::vec3 normal;
+            if (RayVsBox(rays[lane], box, packet.MaxDistance[lane], distance, normal)) {
+                RaycastHit& hit = hits[lane];
+                hit.HitEntity = entity;
+                hit.Point = rays[lane].GetPoint(distance);
+                hit.Normal = normal;
+                hit.Distance = distance;
+                hit.Hit = true;
+                packet.MaxDistance[lane] = distance;
+            }
+        }
+    };
+
+    m_DynamicTree.RayCastPacket(packet, [&](int32_t proxyId, int laneMask) {
+        const RigidbodyEntry& entry = m_Rigidbodies[m_DynamicTree.GetUserData(proxyId)];
+        testLanes(laneMask, entry.Collider, entry.Transform, entry.EntityID);
+    });
+
+    m_StaticTree.RayCastPacket(packet, [&](int32_t proxyId, int laneMask) {
+        const StaticColliderEntry& entry = m_StaticColliders[m_StaticTree.GetUserData(proxyId)];
+        testLanes(laneMask, entry.Collider, entry.Transform, entry.EntityID);
+    });
+}
+
+size_t PhysicsWorld::OverlapBox(const AABB& box, std::vector<Entity>& results) {
+    ResolveEntries();
+
+    size_t before = results.size();
+    m_DynamicTree.Query(box, [&](int32_t proxyId) {
+        const RigidbodyEntry& entry = m_Rigidbodies[m_DynamicTree.GetUserData(proxyId)];
+        if (GetWorldAABB(entry.Collider, entry.Transform).Intersects(box)) {
+            results.push_back(entry.EntityID);
+        }
+        return true;
+    });
+    m_StaticTree.Query(box, [&](int32_t proxyId) {
+        const StaticColliderEntry& entry = m_StaticColliders[m_StaticTree.GetUserData(proxyId)];
+        if (GetWorldAABB(entry.Collider, entry.Transform).Intersects(box)) {
+            results.push_back(entry.EntityID);
+        }
+        return true;
+    });
+    return results.size() - before;
+}
+
+size_t PhysicsWorld::OverlapSphere(const glm::vec3& center, float radius, std::vector<Entity>& results) {
+    ResolveEntries();
+
+    AABB bounds = AABB::FromCenterSize(center, glm::vec3(radius * 2.0f));
+    float radiusSq = radius * radius;
+    auto overlaps = [&](const AABB& box) {
+        glm::vec3 closest = glm::clamp(center, box.Min, box.Max);
+        glm::vec3 offset = closest - center;
+        return glm::dot(offset, offset) <= radiusSq;
+    };
+
+    size_t before = results.size();
+    m_DynamicTree.Query(bounds, [&](int32_t proxyId) {
+        const RigidbodyEntry& entry = m_Rigidbodies[m_DynamicTree.GetUserData(proxyId)];
+        if (overlaps(GetWorldAABB(entry.Collider, entry.Transform))) {
+            results.push_back(entry.EntityID);
+        }
+        return true;
+    });
+    m_StaticTree.Query(bounds, [&](int32_t proxyId) {
+        const StaticColliderEntry& entry = m_StaticColliders[m_StaticTree.GetUserData(proxyId)];
+        if (overlaps(GetWorldAABB(entry.Collider, entry.Transform))) {
+            results.push_back(entry.EntityID);
+        }
+        return true;
+    });
+    return results.size() - before;
+}
+
+bool PhysicsWorld::SweepBox(const AABB& box, const glm::vec3& direction, float maxDistance, RaycastHit& hit,
+                            Entity ignore) {
+    ResolveEntries();
+
+    hit = RaycastHit();
+    if (glm::dot(direction, direction) <= 0.0f) return false;
+
+    // Sweeping a box is a ray from its center against colliders grown by its half size
+    Ray ray(box.GetCenter(), direction);
+    glm::vec3 halfExtent = box.GetSize() * 0.5f;
+    float closest = maxDistance;
+
+    auto testCollider = [&](const ColliderComponent* collider, const TransformComponent* transform, Entity entity) {
+        if (entity == ignore) return closest;
+
+        AABB target = GetWorldAABB(collider, transform);
+        AABB expanded(target.Min - halfExtent, target.Max + halfExtent);
+
+        float distance;
+        glm::vec3 normal;
+        if (RayVsBox(ray, expanded, closest, distance, normal)) {
+            closest = distance;
+            hit.HitEntity = entity;
+            hit.Point = ray.GetPoint(distance);
+            hit.Normal = normal;
+            hit.Distance = distance;
+            hit.Hit = true;
+        }
+        return closest;
+    };
+
+    m_DynamicTree.BoxCast(ray, halfExtent, closest, [&](int32_t proxyId, float) {
+        const RigidbodyEntry& entry = m_Rigidbodies[m_DynamicTree.GetUserData(proxyId)];
+        return testCollider(entry.Collider, entry.Transform, entry.EntityID);
+    });
+    m_StaticTree.BoxCast(ray, halfExtent, closest, [&](int32_t proxyId, float) {
+        const StaticColliderEntry& entry = m_StaticColliders[m_StaticTree.GetUserData(proxyId)];
+        return testCollider(entry.Collider, entry.Transform, entry.EntityID);
+    });
+
+    return hit.Hit;
 }
 
 void PhysicsWorld::Clear() {
+    m_RigidbodyEntities.clear();
+    m_RigidbodyProxies.clear();
+    m_Poses.clear();
+    m_TransformsInterpolated = false;
+    m_StaticEntities.clear();
+    m_StaticProxies.clear();
+    m_DynamicTree.Clear();
+    m_StaticTree.Clear();
+    m_Pairs.clear();
+    m_StaticPairs.clear();
+    m_Manifolds.clear();
+    m_Contacts.clear();
+    m_BodySlots.clear();
+    m_ActiveBodies.clear();
     m_Rigidbodies.clear();
     m_StaticColliders.clear();
 }
 
 AABB PhysicsWorld::GetWorldAABB(const ColliderComponent* collider, const TransformComponent* transform) const {
-    // Transform local AABB to world space
-    glm::vec3 worldCenter = transform->Position + collider->Center * transform->Scale;
-    glm::vec3 worldSize = collider->Size * transform->Scale;
-    return AABB::FromCenterSize(worldCenter, worldSize);
+    return GetWorldShape(collider, transform).GetBounds();
+}
+
+CollisionShape PhysicsWorld::GetWorldShape(const ColliderComponent* collider, const TransformComponent* transform) const {
+    CollisionShape shape;
+    if (transform->Rotation != glm::vec3(0.0f)) {
+        shape.Axes = RotationMatrix(transform->Rotation);
+    }
+    shape.Center = transform->Position + shape.Axes * (collider->Center * transform->Scale);
+
+    glm::vec3 scale = glm::abs(transform->Scale);
+    switch (collider->ColliderType) {
+        case ColliderComponent::Type::Sphere:
+            shape.ShapeType = CollisionShape::Type::Sphere;
+            shape.Radius = collider->Radius * std::max({ scale.x, scale.y, scale.z });
+            break;
+        case ColliderComponent::Type::Capsule:
+            // Collides as its bounding box
+            shape.HalfExtents = glm::vec3(collider->Radius, collider->Height * 0.5f, collider->Radius) * scale;
+            break;
+        default:  // Box, Mesh (bounding box)
+            shape.HalfExtents = collider->Size * scale * 0.5f;
+            break;
+    }
+    return shape;
 }
 
 } // namespace Nilos
@@ -1,39 +1,153 @@
 #pragma once
 
 #include "Collision.h"
+#include "BroadPhase.h"
+#include "NarrowPhase.h"
+#include "BodyStore.h"
 #include "../ECS/Component.h"
 #include "../ECS/Entity.h"
 #include <vector>
 #include <cstdint>
+#include <unordered_map>
+#include <utility>
 
 namespace Nilos {
 
+class World;
 
 /**
- * @brief Simple physics world - AABB collisions and gravity
+ * @brief Result of a raycast or sweep query
+ */
+struct RaycastHit {
+    Entity HitEntity = NULL_ENTITY;
+    glm::vec3 Point = glm::vec3(0.0f);   // Hit point (sweeps: box center at impact)
+    glm::vec3 Normal = glm::vec3(0.0f);  // Surface normal at the hit
+    float Distance = 0.0f;               // Distance along the ray
+    bool Hit = false;
+};
+
+/**
+ * @brief Physics world - rigidbodies, contacts and gravity
  * 
- * Lightweight physics for NPCs and basic gameplay.
- * No rigid body dynamics - just collisions and movement.
+ * Lightweight physics for NPCs and basic gameplay. Contacts push bodies
+ * linearly; colliders never induce spin (rotation stays gameplay state).
+ * 
+ * Bodies are registered by Entity, not by component pointer: component
+ * storage is dense and may relocate components when the ECS adds or removes
+ * components of the same type. Components are looked up once per Update.
+ *
+ * BROAD PHASE:
+ * Rigidbodies and static colliders live in two separate DynamicAABBTrees.
+ * The dynamic tree is updated incrementally every step (only bodies that
+ * leave their fat AABB are reinserted); the static tree is only modified
+ * when static colliders are registered or removed. Each body queries both
+ * trees, so the narrow phase only sees overlapping candidates instead of
+ * every pair.
+ *
+ * NARROW PHASE:
+ * Candidates are collided as their real shapes (spheres and oriented boxes,
+ * see Collide) into contact manifolds of up to four points. Manifolds are
+ * kept from step to step by pair key together with their accumulated
+ * impulses, until the shapes separate or the normal turns. Shapes slightly
+ * apart are kept as speculative contacts, so fast bodies are stopped at the
+ * surface instead of sinking in.
+ *
+ * SOLVER:
+ * Velocities are integrated first, then a sequential-impulse solver runs
+ * VELOCITY_ITERATIONS passes over all contacts (non-penetration, Coulomb
+ * friction, then restitution), starting from the impulses of the last step
+ * (warm starting). Resting stacks converge in a few iterations and come to
+ * rest, which is what lets them fall asleep. Positions are integrated with
+ * the solved velocities and the remaining penetration is removed by a few
+ * position passes that do not add velocity. Contacts only push linearly, so
+ * all points of a manifold share one constraint, set by the closest point.
+ *
+ * INTEGRATION:
+ * Forces, gravity, damping and velocity/position integration run on a
+ * structure-of-arrays copy of the bodies (BodyStore) with SIMD kernels,
+ * split across the JobSystem for large scenes. Component data is gathered
+ * once before and written back once after integration.
+ *
+ * SLEEPING:
+ * Bodies touching each other form islands (static and kinematic bodies do
+ * not connect islands). When every body of an island stayed below the sleep
+ * velocities for TIME_TO_SLEEP seconds, the whole island falls asleep and
+ * is skipped by integration, contacts and the broad phase. A sleeping body
+ * wakes when an active body touches it, on AddForce, or when gameplay code
+ * moves it or sets its velocity.
  */
 class PhysicsWorld {
 public:
-    PhysicsWorld() = default;
+    explicit PhysicsWorld(World* world) : m_World(world) {}
     ~PhysicsWorld() = default;
 
     /**
-     * @brief Update physics (apply gravity, detect collisions)
+     * @brief Advance the simulation by one step (apply gravity, detect collisions)
+     * 
+     * Meant to be called with a fixed deltaTime (see Engine::UpdatePhysics).
+     * If InterpolateTransforms ran since the last step, transforms are first
+     * restored to the simulated pose.
      */
     void Update(float deltaTime);
 
+    /**
+     * @brief Write poses blended between the last two steps into the transforms
+     * @param alpha 0 = previous step, 1 = latest step (leftover time / step size)
+     * 
+     * Transforms that gameplay code changed since they were last written are
+     * treated as teleports: they are kept as-is and not blended.
+     */
+    void InterpolateTransforms(float alpha);
+
     /**
      * @brief Register a rigidbody for physics simulation
+     * 
+     * The entity must have Rigidbody, Collider and Transform components.
+     * Entities that lose any of them are dropped on the next Update.
      */
-    void RegisterRigidbody(RigidbodyComponent* rb, ColliderComponent* collider, TransformComponent* transform);
+    void RegisterRigidbody(Entity entity);
     
     /**
      * @brief Register a static collider (no rigidbody, never moves)
+     * 
+     * The entity must have Collider and Transform components.
      */
-    void RegisterStaticCollider(ColliderComponent* collider, TransformComponent* transform);
+    void RegisterStaticCollider(Entity entity);
+
+    /**
+     * @brief Register every entity that has the components for it (e.g. after a scene load)
+     *
+     * Entities with Rigidbody, Collider and Transform become rigidbodies,
+     * those with only Collider and Transform static colliders; others are
+     * skipped. The entities must not be registered already.
+     * @return Number of entities registered
+     */
+    size_t RegisterEntities(const Entity* entities, size_t count);
+    size_t RegisterEntities(const std::vector<Entity>& entities) {
+        return RegisterEntities(entities.data(), entities.size());
+    }
+
+    /**
+     * @brief Rebuild the static tree after static colliders were moved or resized
+     * 
+     * Also wakes all bodies, since their supports may have moved.
+     */
+    void RefreshStaticColliders();
+
+    /**
+     * @brief Wake every sleeping body
+     */
+    void WakeAllBodies();
+
+    /**
+     * @brief Number of bodies simulated in the last step (excludes sleeping/static bodies)
+     */
+    uint32_t GetActiveBodyCount() const { return static_cast<uint32_t>(m_ActiveBodies.size()); }
+
+    /**
+     * @brief Number of touching manifolds solved in the last step
+     */
+    uint32_t GetContactCount() const { return static_cast<uint32_t>(m_Contacts.size()); }
 
     /**
      * @brief Check collision between two AABBs
@@ -46,6 +160,52 @@ public:
      */
     bool Raycast(const Ray& ray, float maxDistance, glm::vec3& hitPoint, Entity& hitEntity);
 
+    // ========================================================================
+    // Batched / shape queries
+    // Call from one thread at a time (like Update): each query first
+    // refreshes the component lookups. RaycastBatch parallelizes internally.
+    // ========================================================================
+
+    /**
+     * @brief Cast many rays at once; hits[i] receives the closest hit of rays[i]
+     * @param rays Array of count rays
+     * @param count Number of rays
+     * @param maxDistance Segment length for every ray
+     * @param hits Array of count results (written for every ray)
+     * 
+     * Rays are traversed through the broad-phase trees in packets of four
+     * with SIMD slab tests, and packets are spread across the JobSystem.
+     * Rays sharing an origin and roughly a direction (line-of-sight fans,
+     * spread shots) benefit most.
+     */
+    void RaycastBatch(const Ray* rays, size_t count, float maxDistance, RaycastHit* hits);
+
+    /**
+     * @brief Collect entities whose collider AABB overlaps a box
+     * @param results Appended to (not cleared), reuse it across calls to avoid allocations
+     * @return Number of entities appended
+     */
+    size_t OverlapBox(const AABB& box, std::vector<Entity>& results);
+
+    /**
+     * @brief Collect entities whose collider AABB overlaps a sphere
+     * @param results Appended to (not cleared)
+     * @return Number of entities appended
+     */
+    size_t OverlapSphere(const glm::vec3& center, float radius, std::vector<Entity>& results);
+
+    /**
+     * @brief Sweep a box along a direction and report the first collider it touches
+     * @param box Box at the start of the sweep
+     * @param direction Sweep direction (normalized internally)
+     * @param maxDistance Sweep length
+     * @param hit Closest hit (Point is the box center at impact)
+     * @param ignore Entity to skip, e.g. the body that is being moved
+     * @return True if the box hits something
+     */
+    bool SweepBox(const AABB& box, const glm::vec3& direction, float maxDistance, RaycastHit& hit,
+                  Entity ignore = NULL_ENTITY);
+
     /**
      * @brief Set global gravity
      */
@@ -58,6 +218,9 @@ public:
     void Clear();
 
 private:
+    /**
+     * @brief Component pointers resolved for the duration of one Update/query
+     */
     struct RigidbodyEntry {
         RigidbodyComponent* Rigidbody;
         ColliderComponent* Collider;
@@ -71,14 +234,212 @@ private:
         uint32_t EntityID;
     };
 
+    /**
+     * @brief Look up components for all registered entities
+     * 
+     * Fills m_Rigidbodies/m_StaticColliders and unregisters entities whose
+     * components are gone. Pointers stay valid until the ECS adds or removes
+     * components, so they must not outlive the current call.
+     */
+    void ResolveEntries();
+
+    /**
+     * @brief Pose of a body as stored in its TransformComponent
+     */
+    struct BodyPose {
+        glm::vec3 Position;
+        glm::vec3 Rotation;
+
+        static BodyPose From(const TransformComponent& transform) {
+            return { transform.Position, transform.Rotation };
+        }
+        void ApplyTo(TransformComponent& transform) const {
+            transform.Position = Position;
+            transform.Rotation = Rotation;
+        }
+        bool Matches(const TransformComponent& transform) const {
+            return transform.Position == Position && transform.Rotation == Rotation;
+        }
+    };
+
+    /**
+     * @brief Poses needed for render interpolation
+     */
+    struct BodyPoses {
+        BodyPose Previous;  // Before the latest step
+        BodyPose Current;   // After the latest step (simulation state)
+        BodyPose Rendered;  // Last pose written into the transform
+    };
+
+    /**
+     * @brief Restore simulated poses (or accept teleports) and remember them as Previous
+     */
+    void BeginStepPoses();
+
+    /**
+     * @brief Record the result of the step as Current
+     */
+    void EndStepPoses();
+
+    /**
+     * @brief Copy rigidbody state from the components into m_Bodies
+     */
+    void GatherBodies(float deltaTime);
+
+    /**
+     * @brief Write integrated state back to the components, clear forces, integrate rotation
+     */
+    void ScatterBodies(float deltaTime);
+
+    /**
+     * @brief Collect overlapping rigidbody pairs from the dynamic tree into m_Pairs
+     */
+    void FindBodyPairs();
+
+    /**
+     * @brief Collect rigidbodies near static colliders into m_StaticPairs
+     */
+    void FindStaticPairs(float deltaTime);
+
+    /**
+     * @brief Persistent contact between a rigidbody and another body or a static collider
+     */
+    struct ContactConstraint {
+        Entity BodyA = NULL_ENTITY;  // Always a rigidbody
+        Entity BodyB = NULL_ENTITY;
+        bool StaticB = false;        // B is a static collider
+        uint64_t LastStep = 0;       // Step the manifold was last collided in
+        ContactManifold Manifold;
+        float Separation = 0.0f;     // Of the closest point, negative = penetration
+
+        // Accumulated impulses, carried over for warm starting
+        float NormalImpulse = 0.0f;
+        float TangentImpulse[2] = { 0.0f, 0.0f };
+
+        // Solver state for the current step
+        uint32_t SlotA = 0;          // Index into m_Bodies, NO_SLOT = immovable
+        uint32_t SlotB = 0;
+        float InverseMassA = 0.0f;
+        float InverseMassB = 0.0f;
+        float NormalMass = 0.0f;     // 1 / (InverseMassA + InverseMassB), 0 = nothing to solve
+        float Friction = 0.0f;
+        float Restitution = 0.0f;
+        glm::vec3 Tangents[2];
+        float VelocityBias = 0.0f;   // Target normal velocity
+        float NormalVelocity = 0.0f; // Approach speed to bounce from, 0 = none
+        glm::vec3 StartA;            // Positions the manifold was built at (position passes)
+        glm::vec3 StartB;
+    };
+
+    /**
+     * @brief Narrow phase for the candidate pairs: update manifolds, wake bodies, join islands
+     */
+    void UpdateContacts(float deltaTime);
+
+    /**
+     * @brief Collide a pair into its persistent manifold, keeping its impulses if the normal held
+     * @return The constraint if the shapes touch, nullptr (and the manifold is dropped) if not
+     */
+    ContactConstraint* UpdateManifold(uint64_t key, const CollisionShape& shapeA, const CollisionShape& shapeB,
+                                      float margin);
+
+    /**
+     * @brief Drop manifolds that were not collided this step, unless their bodies sleep
+     */
+    void PruneContacts();
+
+    /**
+     * @brief Compute masses and velocity targets, then apply last step's impulses
+     */
+    void PrepareContacts(float deltaTime);
+
+    /**
+     * @brief One sequential-impulse pass over all contacts
+     */
+    void SolveVelocities();
+
+    /**
+     * @brief Make bouncing contacts leave at Restitution times their approach speed
+     */
+    void ApplyRestitution();
+
+    /**
+     * @brief One pass removing penetration from the integrated positions
+     */
+    void SolvePositions();
+
+    /**
+     * @brief Advance sleep timers and put resting islands to sleep
+     */
+    void UpdateSleep(float deltaTime);
+
+    // Union-find over body indices (islands)
+    uint32_t FindIsland(uint32_t body);
+    void UnionIslands(uint32_t a, uint32_t b);
+
+    /**
+     * @brief Closest hit of one packet of up to four rays (hits[lane] for every active lane)
+     */
+    void RaycastPacket(RayPacket& packet, const Ray* rays, RaycastHit* hits) const;
+
+    static constexpr float SLEEP_LINEAR_VELOCITY = 0.05f;   // m/s
+    static constexpr float SLEEP_ANGULAR_VELOCITY = 0.05f;  // Rotation units/s
+    static constexpr float TIME_TO_SLEEP = 0.5f;            // Seconds at rest
+    static constexpr float RESTING_CONTACT_SPEED = 0.05f;   // Slower bounces are dropped
+
+    static constexpr uint32_t VELOCITY_ITERATIONS = 8;
+    static constexpr uint32_t POSITION_ITERATIONS = 3;
+    static constexpr float CONTACT_MARGIN = 0.02f;          // Speculative distance on top of the step's motion (m)
+    static constexpr float LINEAR_SLOP = 0.005f;            // Penetration left alone, keeps contacts alive (m)
+    static constexpr float POSITION_CORRECTION = 0.2f;      // Fraction of the penetration removed per pass
+    static constexpr float MAX_POSITION_CORRECTION = 0.2f;  // Per pass (m)
+    static constexpr float CONTACT_MATCH_COSINE = 0.95f;    // Impulses are kept while the normal turns less than this
+    static constexpr uint32_t NO_SLOT = ~0u;
+
+    static constexpr size_t INTEGRATION_GRAIN = 4096;       // Bodies per integration job (multiple of SIMD::WIDTH)
+    static constexpr size_t RAYCAST_PACKET_GRAIN = 16;      // Ray packets per raycast job
+
+    World* m_World;
+
+    // Registered entities and their broad-phase proxies (parallel arrays).
+    // Proxy user data is the index into these arrays.
+    std::vector<Entity> m_RigidbodyEntities;
+    std::vector<int32_t> m_RigidbodyProxies;
+    std::vector<BodyPoses> m_Poses;
+    bool m_TransformsInterpolated = false;
+    std::vector<Entity> m_StaticEntities;
+    std::vector<int32_t> m_StaticProxies;
+
     std::vector<RigidbodyEntry> m_Rigidbodies;
     std::vector<StaticColliderEntry> m_StaticColliders;
+
+    BodyStore m_Bodies;
+    std::vector<uint32_t> m_ActiveBodies;    // Indices into m_Rigidbodies, one per m_Bodies slot
+
+    std::vector<uint32_t> m_IslandParent;
+    std::vector<float> m_IslandSleepTime;
+
+    DynamicAABBTree m_DynamicTree;
+    DynamicAABBTree m_StaticTree;
+    std::vector<std::pair<uint32_t, uint32_t>> m_Pairs;        // Rigidbody indices
+    std::vector<std::pair<uint32_t, uint32_t>> m_StaticPairs;  // Rigidbody index, static collider index
+
+    std::unordered_map<uint64_t, ContactConstraint> m_Manifolds;  // By pair key (entities of A and B)
+    std::vector<ContactConstraint*> m_Contacts;                  // Touching this step, in pair order
+    std::vector<uint32_t> m_BodySlots;                           // Rigidbody index -> m_Bodies slot or NO_SLOT
+    uint64_t m_StepCount = 0;
+
     glm::vec3 m_Gravity = glm::vec3(0.0f, -9.81f, 0.0f);
 
     /**
      * @brief Get world-space AABB for a collider
      */
     AABB GetWorldAABB(const ColliderComponent* collider, const TransformComponent* transform) const;
+
+    /**
+     * @brief Get the world-space narrow-phase shape of a collider
+     */
+    CollisionShape GetWorldShape(const ColliderComponent* collider, const TransformComponent* transform) const;
 };
 
 } // namespace Nilos
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Nilos {
+
+/**
+ * @brief On-disk layout of cooked meshes (.nmesh)
+ *
+ * Written offline by ModelLoader::Cook (see tools/MeshCooker) and read by
+ * MeshManager::LoadCooked, which memory-maps the file and stages the
+ * sections unchanged for the GPU buffers. Everything is little-endian and
+ * already in GPU format, so loading does no parsing or conversion:
+ *
+ *   CookedMesh::Header
+ *   CookedMesh::SubMesh[SubMeshCount]  at SubMeshOffset
+ *   packed vertices                    at VertexDataOffset (see PackedVertexFormat)
+ *   16- or 32-bit indices              at IndexDataOffset
+ *
+ * Section offsets are multiples of CookedMesh::ALIGNMENT. Bump
+ * CookedMesh::VERSION whenever the layout changes; older files are rejected
+ * and must be re-cooked.
+ */
+namespace CookedMesh {
+
+constexpr uint32_t MAGIC = 0x48534D4E; // "NMSH"
+constexpr uint32_t VERSION = 1;
+constexpr uint32_t ALIGNMENT = 16;
+
+/**
+ * @brief Header flags
+ */
+enum Flags : uint32_t {
+    HalfPositions = 1u << 0,  // PackedVertexFormat::HalfPositions
+    UNormTexCoords = 1u << 1  // PackedVertexFormat::UNormTexCoords
+};
+
+struct Header {
+    uint32_t Magic;
+    uint32_t Version;
+    uint32_t LayoutMask;     // VertexLayout::Mask
+    uint32_t Flags;
+    uint32_t VertexStride;   // Bytes, must match VertexPacking::MakeFormat
+    uint32_t IndexSize;      // 2 or 4
+    uint32_t VertexCount;
+    uint32_t IndexCount;
+    uint32_t SubMeshCount;
+    float BoundsCenter[3];
+    float BoundsExtents[3];
+    uint32_t Reserved;
+    uint64_t SubMeshOffset;
+    uint64_t VertexDataOffset;
+    uint64_t IndexDataOffset;
+};
+static_assert(sizeof(Header) == 88, "CookedMesh::Header layout changed; bump VERSION");
+
+/**
+ * @brief Range of the index buffer drawn with one material
+ */
+struct SubMesh {
+    uint32_t FirstIndex;
+    uint32_t IndexCount;
+    uint32_t MaterialIndex;  // Index into the source file's materials
+    float BoundsCenter[3];
+    float BoundsExtents[3];
+    uint32_t Reserved;
+};
+static_assert(sizeof(SubMesh) == 40, "CookedMesh::SubMesh layout changed; bump VERSION");
+
+} // namespace CookedMesh
+
+} // namespace Nilos
@@ -1,9 +1,33 @@
 #include "DebugRenderer.h"
 #include "../Core/Logger.h"
 #include <glad/glad.h>
+#include <algorithm>
+#include <cstddef>
 
 namespace Nilos {
 
+namespace {
+
+constexpr UniformName U_VIEW("uView");
+constexpr UniformName U_PROJECTION("uProjection");
+
+/**
+ * @brief Block until the GPU has passed fence, then delete it
+ */
+void WaitAndDeleteFence(void*& fence) {
+    if (!fence) return;
+
+    GLsync sync = static_cast<GLsync>(fence);
+    GLenum result = glClientWaitSync(sync, 0, 0);
+    while (result == GL_TIMEOUT_EXPIRED) {
+        result = glClientWaitSync(sync, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000); // 1 ms
+    }
+    glDeleteSync(sync);
+    fence = nullptr;
+}
+
+} // namespace
+
 bool DebugRenderer::Initialize() {
     // Create simple line shader
     m_Shader = std::make_unique<Shader>();
@@ -39,14 +63,121 @@ bool DebugRenderer::Initialize() {
         return false;
     }
     
-    // Create VAO/VBO for lines
+    // Fallback/overflow VAO/VBO for lines
     glGenVertexArrays(1, &m_VAO);
     glGenBuffers(1, &m_VBO);
-    
-    NILOS_INFO("Debug renderer initialized");
+    glBindVertexArray(m_VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+    SetupVertexAttributes();
+    glBindVertexArray(0);
+
+    if (CreateRing(INITIAL_SEGMENT_VERTICES)) {
+        NILOS_INFO("Debug renderer initialized (persistent mapped ring, ",
+                   RING_SEGMENTS, " x ", m_SegmentCapacity / 2, " lines)");
+    } else {
+        NILOS_INFO("Debug renderer initialized (ARB_buffer_storage unavailable, using buffer orphaning)");
+    }
+    return true;
+}
+
+bool DebugRenderer::CreateRing(size_t segmentVertices) {
+    if (!GLAD_GL_ARB_buffer_storage) {
+        return false;
+    }
+
+    GLsizeiptr size = static_cast<GLsizeiptr>(segmentVertices * RING_SEGMENTS * sizeof(DebugVertex));
+    GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+
+    glGenVertexArrays(1, &m_RingVAO);
+    glGenBuffers(1, &m_RingVBO);
+    glBindVertexArray(m_RingVAO);
+    glBindBuffer(GL_ARRAY_BUFFER, m_RingVBO);
+    glBufferStorage(GL_ARRAY_BUFFER, size, nullptr, flags);
+    m_RingMapped = static_cast<DebugVertex*>(glMapBufferRange(GL_ARRAY_BUFFER, 0, size, flags));
+    SetupVertexAttributes();
+    glBindVertexArray(0);
+
+    if (!m_RingMapped) {
+        NILOS_WARNING("Failed to map debug line ring buffer, using buffer orphaning");
+        DestroyRing();
+        return false;
+    }
+
+    m_SegmentCapacity = segmentVertices;
+    m_Segment = 0;
+    m_SegmentVertexCount = 0;
+    m_SegmentOpen = false;
+    m_SegmentDrawn = false;
     return true;
 }
 
+void DebugRenderer::DestroyRing() {
+    for (void*& fence : m_SegmentFences) {
+        WaitAndDeleteFence(fence);
+    }
+
+    if (m_RingMapped) {
+        glBindBuffer(GL_ARRAY_BUFFER, m_RingVBO);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        m_RingMapped = nullptr;
+    }
+    if (m_RingVAO) glDeleteVertexArrays(1, &m_RingVAO);
+    if (m_RingVBO) glDeleteBuffers(1, &m_RingVBO);
+    m_RingVAO = 0;
+    m_RingVBO = 0;
+    m_SegmentCapacity = 0;
+}
+
+void DebugRenderer::SetupVertexAttributes() {
+    // Position attribute
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, Position));
+    glEnableVertexAttribArray(0);
+
+    // Color attribute
+    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, sizeof(DebugVertex), (void*)offsetof(DebugVertex, Color));
+    glEnableVertexAttribArray(1);
+}
+
+void DebugRenderer::BeginSegment() {
+    // Last frame overflowed: grow the ring now that nothing is being written
+    if (m_RequiredCapacity > m_SegmentCapacity) {
+        size_t capacity = m_SegmentCapacity;
+        while (capacity < m_RequiredCapacity) capacity *= 2;
+        DestroyRing();
+        if (!CreateRing(capacity)) {
+            m_RequiredCapacity = 0;
+            return;
+        }
+        NILOS_DEBUG("Debug line ring grown to ", capacity / 2, " lines per segment");
+    }
+    m_RequiredCapacity = 0;
+
+    // Wait for the GPU to finish the draws that last read this segment
+    WaitAndDeleteFence(m_SegmentFences[m_Segment]);
+
+    m_SegmentVertexCount = 0;
+    m_SegmentOpen = true;
+}
+
+DebugRenderer::DebugVertex* DebugRenderer::AllocateVertices(size_t count) {
+    if (m_RingMapped) {
+        if (!m_SegmentOpen) {
+            BeginSegment();
+        }
+        if (m_RingMapped && m_SegmentVertexCount + count <= m_SegmentCapacity) {
+            DebugVertex* vertices = m_RingMapped + m_Segment * m_SegmentCapacity + m_SegmentVertexCount;
+            m_SegmentVertexCount += count;
+            return vertices;
+        }
+    }
+
+    // No ring, or this frame outgrew it
+    size_t first = m_Staging.size();
+    m_Staging.resize(first + count);
+    return &m_Staging[first];
+}
+
+
 void DebugRenderer::DrawAABB(const AABB& aabb, const glm::vec3& color) {
     // Draw 12 edges of the box
     glm::vec3 corners[8] = {
@@ -60,92 +191,93 @@ void DebugRenderer::DrawAABB(const AABB& aabb, const glm::vec3& color) {
         {aabb.Min.x, aabb.Max.y, aabb.Max.z}
     };
     
-    // Bottom face
-    DrawLine(corners[0], corners[1], color);
-    DrawLine(corners[1], corners[2], color);
-    DrawLine(corners[2], corners[3], color);
-    DrawLine(corners[3], corners[0], color);
-    
-    // Top face
-    DrawLine(corners[4], corners[5], color);
-    DrawLine(corners[5], corners[6], color);
-    DrawLine(corners[6], corners[7], color);
-    DrawLine(corners[7], corners[4], color);
-    
-    // Vertical edges
-    DrawLine(corners[0], corners[4], color);
-    DrawLine(corners[1], corners[5], color);
-    DrawLine(corners[2], corners[6], color);
-    DrawLine(corners[3], corners[7], color);
+    // Bottom face, top face, vertical edges
+    static const uint8_t edges[24] = {
+        0, 1,  1, 2,  2, 3,  3, 0,
+        4, 5,  5, 6,  6, 7,  7, 4,
+        0, 4,  1, 5,  2, 6,  3, 7
+    };
+
+    DebugVertex* vertices = AllocateVertices(24);
+    for (int i = 0; i < 24; ++i) {
+        vertices[i] = { corners[edges[i]], color };
+    }
 }
 
 void DebugRenderer::DrawLine(const glm::vec3& start, const glm::vec3& end, const glm::vec3& color) {
-    m_Lines.push_back({start, end, color});
+    DebugVertex* vertices = AllocateVertices(2);
+    vertices[0] = { start, color };
+    vertices[1] = { end, color };
 }
 
 void DebugRenderer::DrawPath(const std::vector<glm::vec3>& path, const glm::vec3& color) {
-    for (size_t i = 0; i < path.size() - 1; ++i) {
-        DrawLine(path[i], path[i + 1], color);
+    if (path.size() < 2) return;
+
+    DebugVertex* vertices = AllocateVertices((path.size() - 1) * 2);
+    for (size_t i = 0; i + 1 < path.size(); ++i) {
+        vertices[i * 2] = { path[i], color };
+        vertices[i * 2 + 1] = { path[i + 1], color };
     }
 }
 
 void DebugRenderer::Render(const glm::mat4& view, const glm::mat4& projection) {
-    if (m_Lines.empty()) return;
+    size_t ringVertices = m_SegmentOpen ? m_SegmentVertexCount : 0;
+    if (ringVertices == 0 && m_Staging.empty()) return;
     
     m_Shader->Use();
-    m_Shader->SetMat4("uView", view);
-    m_Shader->SetMat4("uProjection", projection);
-    
-    // Prepare vertex data (position + color interleaved)
-    std::vector<float> vertices;
-    vertices.reserve(m_Lines.size() * 12); // 2 vertices * 6 floats per line
-    
-    for (const auto& line : m_Lines) {
-        // Start vertex
-        vertices.push_back(line.Start.x);
-        vertices.push_back(line.Start.y);
-        vertices.push_back(line.Start.z);
-        vertices.push_back(line.Color.r);
-        vertices.push_back(line.Color.g);
-        vertices.push_back(line.Color.b);
-        
-        // End vertex
-        vertices.push_back(line.End.x);
-        vertices.push_back(line.End.y);
-        vertices.push_back(line.End.z);
-        vertices.push_back(line.Color.r);
-        vertices.push_back(line.Color.g);
-        vertices.push_back(line.Color.b);
+    m_Shader->SetMat4(U_VIEW, view);
+    m_Shader->SetMat4(U_PROJECTION, projection);
+
+    // Ring: the vertices are already in GPU memory (coherent mapping)
+    if (ringVertices > 0) {
+        glBindVertexArray(m_RingVAO);
+        glDrawArrays(GL_LINES, static_cast<GLint>(m_Segment * m_SegmentCapacity), static_cast<GLsizei>(ringVertices));
+        m_SegmentDrawn = true;
     }
-    
-    // Upload to GPU
-    glBindVertexArray(m_VAO);
-    glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), vertices.data(), GL_DYNAMIC_DRAW);
-    
-    // Position attribute
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)0);
-    glEnableVertexAttribArray(0);
-    
-    // Color attribute
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 6 * sizeof(float), (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
-    
-    // Draw lines
-    glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(m_Lines.size() * 2));
-    
+
+    // Staging: orphan (or grow) the buffer and upload in one call
+    if (!m_Staging.empty()) {
+        glBindVertexArray(m_VAO);
+        glBindBuffer(GL_ARRAY_BUFFER, m_VBO);
+        if (m_Staging.size() > m_VBOCapacity) {
+            m_VBOCapacity = std::max(m_Staging.size(), m_VBOCapacity * 2);
+        }
+        glBufferData(GL_ARRAY_BUFFER, m_VBOCapacity * sizeof(DebugVertex), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, m_Staging.size() * sizeof(DebugVertex), m_Staging.data());
+        glDrawArrays(GL_LINES, 0, static_cast<GLsizei>(m_Staging.size()));
+
+        // The ring overflowed this frame: make it big enough for next time
+        if (m_RingMapped) {
+            m_RequiredCapacity = std::max(m_RequiredCapacity, ringVertices + m_Staging.size());
+        }
+    }
+
     glBindVertexArray(0);
 }
 
 void DebugRenderer::Clear() {
-    m_Lines.clear();
+    // Fence the segment after its last draw and move on to the next one
+    if (m_SegmentOpen) {
+        if (m_SegmentDrawn) {
+            m_SegmentFences[m_Segment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        }
+        m_Segment = (m_Segment + 1) % RING_SEGMENTS;
+        m_SegmentVertexCount = 0;
+        m_SegmentOpen = false;
+        m_SegmentDrawn = false;
+    }
+    m_Staging.clear();
 }
 
 void DebugRenderer::Shutdown() {
+    DestroyRing();
     if (m_VAO) glDeleteVertexArrays(1, &m_VAO);
     if (m_VBO) glDeleteBuffers(1, &m_VBO);
+    m_VAO = 0;
+    m_VBO = 0;
+    m_VBOCapacity = 0;
+    m_Staging.clear();
     NILOS_INFO("Debug renderer shutdown");
 }
 
 } // namespace Nilos
-
@@ -4,6 +4,8 @@
 #include "../AI/Pathfinding.h"
 #include "Shader.h"
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 #include <memory>
 
@@ -14,6 +16,17 @@ namespace Nilos {
  * 
  * Visualize physics, pathfinding, and debug info.
  * Simple wireframe rendering.
+ *
+ * Line vertices are written straight into GPU memory: with
+ * ARB_buffer_storage the vertex buffer is persistently mapped and split into
+ * RING_SEGMENTS segments, one per frame in flight. The segment being filled
+ * is only reused once the fence issued after its last draw has signalled,
+ * so the CPU never waits on or reallocates GPU storage in steady state.
+ * Without the extension (or when a frame outgrows the ring, which then grows
+ * for the next frame) vertices go to a CPU staging array uploaded into an
+ * orphaned buffer in Render.
+ *
+ * Render draws everything queued since the last Clear; Clear ends the frame.
  */
 class DebugRenderer {
 public:
@@ -55,16 +68,59 @@ public:
      */
     void Shutdown();
 
+    /**
+     * @brief True when lines stream through the persistently mapped ring
+     */
+    bool IsPersistentMapped() const { return m_RingMapped != nullptr; }
+
 private:
-    struct DebugLine {
-        glm::vec3 Start;
-        glm::vec3 End;
+    struct DebugVertex {
+        glm::vec3 Position;
         glm::vec3 Color;
     };
 
-    std::vector<DebugLine> m_Lines;
+    /**
+     * @brief Reserve count vertices in the current segment (or the staging array)
+     */
+    DebugVertex* AllocateVertices(size_t count);
+
+    /**
+     * @brief Wait until the GPU is done with the current segment
+     */
+    void BeginSegment();
+
+    /**
+     * @brief Create the persistently mapped ring (false if unsupported)
+     */
+    bool CreateRing(size_t segmentVertices);
+    void DestroyRing();
+
+    /**
+     * @brief Point position/color attributes of the bound VAO at the bound buffer
+     */
+    static void SetupVertexAttributes();
+
+    static constexpr uint32_t RING_SEGMENTS = 3;                  // Frames in flight
+    static constexpr size_t INITIAL_SEGMENT_VERTICES = 128 * 1024; // 64k lines, 3 MB
+
+    // Persistently mapped ring
+    uint32_t m_RingVAO = 0;
+    uint32_t m_RingVBO = 0;
+    DebugVertex* m_RingMapped = nullptr;
+    size_t m_SegmentCapacity = 0;     // Vertices per segment
+    size_t m_RequiredCapacity = 0;    // Grow to this before the next segment
+    uint32_t m_Segment = 0;           // Segment being filled
+    size_t m_SegmentVertexCount = 0;  // Vertices written to it
+    bool m_SegmentOpen = false;
+    bool m_SegmentDrawn = false;      // Needs a fence on Clear
+    void* m_SegmentFences[RING_SEGMENTS] = {};  // GLsync
+
+    // Fallback / overflow path
     uint32_t m_VAO = 0;
     uint32_t m_VBO = 0;
+    size_t m_VBOCapacity = 0;         // In vertices
+    std::vector<DebugVertex> m_Staging;
+
     std::unique_ptr<Shader> m_Shader;
 };
 
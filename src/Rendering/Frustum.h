@@ -0,0 +1,61 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Nilos {
+
+/**
+ * @brief View frustum as six inward-facing planes
+ *
+ * Each plane is (normal.xyz, distance) with a unit normal, so
+ * dot(normal, p) + distance is the signed distance of p (positive inside).
+ */
+struct Frustum {
+    enum PlaneIndex { Left = 0, Right, Bottom, Top, Near, Far, PlaneCount };
+
+    glm::vec4 Planes[PlaneCount];
+
+    /**
+     * @brief Extract the planes from a view-projection matrix (OpenGL clip space)
+     */
+    static Frustum FromMatrix(const glm::mat4& viewProjection) {
+        // Rows of the (column-major) matrix
+        glm::vec4 row0(viewProjection[0][0], viewProjection[1][0], viewProjection[2][0], viewProjection[3][0]);
+        glm::vec4 row1(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1], viewProjection[3][1]);
+        glm::vec4 row2(viewProjection[0][2], viewProjection[1][2], viewProjection[2][2], viewProjection[3][2]);
+        glm::vec4 row3(viewProjection[0][3], viewProjection[1][3], viewProjection[2][3], viewProjection[3][3]);
+
+        Frustum frustum;
+        frustum.Planes[Left]   = row3 + row0;
+        frustum.Planes[Right]  = row3 - row0;
+        frustum.Planes[Bottom] = row3 + row1;
+        frustum.Planes[Top]    = row3 - row1;
+        frustum.Planes[Near]   = row3 + row2;
+        frustum.Planes[Far]    = row3 - row2;
+
+        for (glm::vec4& plane : frustum.Planes) {
+            float length = glm::length(glm::vec3(plane));
+            if (length > 0.0f) {
+                plane /= length;
+            }
+        }
+        return frustum;
+    }
+
+    /**
+     * @brief Conservative box test (false only if the box is fully outside one plane)
+     */
+    bool IntersectsBox(const glm::vec3& center, const glm::vec3& extents) const {
+        for (const glm::vec4& plane : Planes) {
+            glm::vec3 normal(plane);
+            float distance = glm::dot(normal, center) + plane.w;
+            float radius = glm::dot(glm::abs(normal), extents);
+            if (distance + radius < 0.0f) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} // namespace Nilos
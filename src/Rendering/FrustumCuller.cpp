@@ -0,0 +1,100 @@
+#include "FrustumCuller.h"
+#include "../Core/JobSystem.h"
+#include "../ECS/World.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace Nilos {
+
+const std::vector<FrustumCuller::VisibleMesh>& FrustumCuller::Cull(World& world, const Frustum& frustum) {
+    m_Candidates.clear();
+    m_Visible.clear();
+
+    world.Each<MeshComponent, TransformComponent>(
+        [this](Entity entity, MeshComponent& mesh, TransformComponent& transform) {
+            m_Candidates.push_back({ entity, &mesh, &transform });
+        });
+
+    size_t count = m_Candidates.size();
+    if (count == 0) {
+        return m_Visible;
+    }
+
+    // Padding lanes are tested too but their results are never read
+    size_t padded = SIMD::PadToWidth(count);
+    for (FloatArray* array : { &m_CenterX, &m_CenterY, &m_CenterZ, &m_ExtentX, &m_ExtentY, &m_ExtentZ }) {
+        array->resize(padded);
+        std::fill(array->begin() + count, array->end(), 0.0f);
+    }
+    m_Inside.resize(count);
+
+    JobSystem::Get().ParallelFor(count, CULL_GRAIN, [this, &frustum](size_t begin, size_t end) {
+        ComputeWorldBounds(begin, end);
+        TestBounds(frustum, begin, end);
+    });
+
+    for (size_t i = 0; i < count; ++i) {
+        if (m_Inside[i]) {
+            m_Visible.push_back(m_Candidates[i]);
+        }
+    }
+    return m_Visible;
+}
+
+void FrustumCuller::ComputeWorldBounds(size_t begin, size_t end) {
+    for (size_t i = begin; i < end; ++i) {
+        MeshComponent& mesh = *m_Candidates[i].Mesh;
+        if (!mesh.HasBounds) {
+            mesh.ComputeBounds();
+        }
+
+        // Transform the center; the world extents of a rotated/scaled box
+        // are the local extents projected through |M| (Arvo)
+        const glm::mat4& model = m_Candidates[i].Transform->WorldMatrix;
+        glm::vec3 center = glm::vec3(model * glm::vec4(mesh.BoundsCenter, 1.0f));
+        glm::vec3 extents = glm::abs(glm::vec3(model[0])) * mesh.BoundsExtents.x +
+                            glm::abs(glm::vec3(model[1])) * mesh.BoundsExtents.y +
+                            glm::abs(glm::vec3(model[2])) * mesh.BoundsExtents.z;
+
+        m_CenterX[i] = center.x;
+        m_CenterY[i] = center.y;
+        m_CenterZ[i] = center.z;
+        m_ExtentX[i] = extents.x;
+        m_ExtentY[i] = extents.y;
+        m_ExtentZ[i] = extents.z;
+    }
+}
+
+void FrustumCuller::TestBounds(const Frustum& frustum, size_t begin, size_t end) {
+    const SIMD::Float4 zero = SIMD::Set1(0.0f);
+
+    for (size_t i = begin; i < end; i += SIMD::WIDTH) {
+        SIMD::Float4 cx = SIMD::Load(&m_CenterX[i]);
+        SIMD::Float4 cy = SIMD::Load(&m_CenterY[i]);
+        SIMD::Float4 cz = SIMD::Load(&m_CenterZ[i]);
+        SIMD::Float4 ex = SIMD::Load(&m_ExtentX[i]);
+        SIMD::Float4 ey = SIMD::Load(&m_ExtentY[i]);
+        SIMD::Float4 ez = SIMD::Load(&m_ExtentZ[i]);
+
+        // A box is outside if it lies fully behind any plane:
+        // dot(n, c) + d + dot(|n|, e) < 0
+        int outside = 0;
+        for (const glm::vec4& plane : frustum.Planes) {
+            SIMD::Float4 distance = SIMD::MulAdd(cx, SIMD::Set1(plane.x),
+                                    SIMD::MulAdd(cy, SIMD::Set1(plane.y),
+                                    SIMD::MulAdd(cz, SIMD::Set1(plane.z), SIMD::Set1(plane.w))));
+            SIMD::Float4 radius = SIMD::MulAdd(ex, SIMD::Set1(std::abs(plane.x)),
+                                  SIMD::MulAdd(ey, SIMD::Set1(std::abs(plane.y)),
+                                  SIMD::Mul(ez, SIMD::Set1(std::abs(plane.z)))));
+            outside |= SIMD::LessMask(SIMD::Add(distance, radius), zero);
+        }
+
+        size_t lanes = std::min(SIMD::WIDTH, end - i);
+        for (size_t lane = 0; lane < lanes; ++lane) {
+            m_Inside[i + lane] = (outside & (1 << lane)) ? 0 : 1;
+        }
+    }
+}
+
+} // namespace Nilos
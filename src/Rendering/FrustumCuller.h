@@ -0,0 +1,81 @@
+#pragma once
+
+#include "Frustum.h"
+#include "../Core/SIMD.h"
+#include "../ECS/Component.h"
+#include "../ECS/Entity.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nilos {
+
+class World;
+
+/**
+ * @brief Finds the mesh entities inside the camera frustum
+ *
+ * Cull() collects every MeshComponent + TransformComponent entity, derives
+ * its world-space box from the mesh's local bounds (computed once from the
+ * vertices) and the cached WorldMatrix (see TransformHierarchy), and tests
+ * the boxes against the frustum planes four at a time. Boxes are kept in
+ * structure-of-arrays form (the same layout as the physics BodyStore) and
+ * large scenes are split across the JobSystem.
+ *
+ * Usage:
+ *   Frustum frustum = Frustum::FromMatrix(projection * view);
+ *   for (const auto& visible : culler.Cull(*world, frustum)) {
+ *       renderer->RenderMesh(*visible.Mesh, *visible.Transform);
+ *   }
+ */
+class FrustumCuller {
+public:
+    struct VisibleMesh {
+        Entity Owner;
+        MeshComponent* Mesh;
+        TransformComponent* Transform;
+    };
+
+    /**
+     * @brief Cull all mesh entities of world against frustum
+     * @return Visible meshes (valid until the next Cull or component add/remove)
+     */
+    const std::vector<VisibleMesh>& Cull(World& world, const Frustum& frustum);
+
+    /**
+     * @brief Result of the last Cull
+     */
+    const std::vector<VisibleMesh>& GetVisible() const { return m_Visible; }
+
+    /**
+     * @brief Number of meshes tested by the last Cull
+     */
+    size_t GetCandidateCount() const { return m_Candidates.size(); }
+
+private:
+    using FloatArray = std::vector<float, AlignedAllocator<float>>;
+
+    /**
+     * @brief Compute world-space boxes of candidates [begin, end)
+     */
+    void ComputeWorldBounds(size_t begin, size_t end);
+
+    /**
+     * @brief Test boxes [begin, end) against the frustum (begin multiple of SIMD::WIDTH)
+     */
+    void TestBounds(const Frustum& frustum, size_t begin, size_t end);
+
+    // Meshes per job; a multiple of SIMD::WIDTH so chunks start on a SIMD lane
+    static constexpr size_t CULL_GRAIN = 1024;
+
+    std::vector<VisibleMesh> m_Candidates;
+    std::vector<VisibleMesh> m_Visible;
+
+    // World-space boxes of the candidates (SoA, padded to SIMD::WIDTH)
+    FloatArray m_CenterX, m_CenterY, m_CenterZ;
+    FloatArray m_ExtentX, m_ExtentY, m_ExtentZ;
+    std::vector<uint8_t> m_Inside;
+};
+
+} // namespace Nilos
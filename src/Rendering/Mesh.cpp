@@ -20,7 +20,8 @@ MeshComponent CreatePlane(float width, float height) {
     float halfW = width * 0.5f;
     float halfH = height * 0.5f;
     
-    // Plane vertices (lying on XZ plane)
+    // Plane vertices (lying on XZ plane), normals default to +Y
+    mesh.Layout = VertexLayout::PositionColor();
     mesh.Vertices = {
         // Position              // Color
         -halfW, 0.0f, -halfH,    0.8f, 0.8f, 0.8f,
@@ -39,6 +40,7 @@ MeshComponent CreatePlane(float width, float height) {
 
 MeshComponent CreateSphere(float radius, int segments) {
     MeshComponent mesh;
+    mesh.Layout = VertexLayout::PositionNormalColor();
     
     // Generate sphere vertices
     for (int lat = 0; lat <= segments; ++lat) {
@@ -59,6 +61,11 @@ MeshComponent CreateSphere(float radius, int segments) {
             mesh.Vertices.push_back(x * radius);
             mesh.Vertices.push_back(y * radius);
             mesh.Vertices.push_back(z * radius);
+
+            // Normal (unit position on the sphere)
+            mesh.Vertices.push_back(x);
+            mesh.Vertices.push_back(y);
+            mesh.Vertices.push_back(z);
             
             // Color (based on position for variety)
             mesh.Vertices.push_back((x + 1.0f) * 0.5f);
@@ -8,7 +8,7 @@ namespace Nilos {
  * @brief Mesh utilities and factory functions
  * 
  * Helper functions to create common mesh shapes.
- * In the future, this will include model loading (GLTF, OBJ, etc.)
+ * Model files are loaded by ModelLoader.
  */
 namespace MeshFactory {
 
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <cstdint>
+
+namespace Nilos {
+
+/**
+ * @brief Handle to a mesh asset owned by the MeshManager
+ *
+ * Same packing as Entity: [ generation : 12 bits | index : 20 bits ].
+ * Unloading a mesh bumps its slot generation so stale handles are rejected.
+ */
+using MeshHandle = uint32_t;
+
+/**
+ * @brief The "no mesh" handle (slot 0 is never used)
+ */
+constexpr MeshHandle NULL_MESH = 0;
+
+} // namespace Nilos
@@ -0,0 +1,643 @@
+#include "MeshManager.h"
+#include "CookedMesh.h"
+#include "../ECS/Component.h"
+#include "../Core/Logger.h"
+#include "../Core/MappedFile.h"
+
+#include <glad/glad.h>
+#include <glm/gtc/constants.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Nilos {
+
+namespace {
+
+constexpr size_t INDEX_ALIGNMENT = 4;
+
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+size_t AlignUp(size_t value, size_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Arenas are shared by meshes with the same layout and packed format
+ */
+bool SameFormat(const MeshArena& arena, VertexLayout layout, const PackedVertexFormat& format) {
+    return arena.Layout == layout &&
+           arena.Format.HalfPositions == format.HalfPositions &&
+           arena.Format.UNormTexCoords == format.UNormTexCoords;
+}
+
+void BuildCube(std::vector<float>& vertices, std::vector<uint32_t>& indices) {
+    // Position(3) + Normal(3) + Color(3) + TexCoord(2) = 11 floats per vertex
+    vertices = {
+        // Front face (+Z) - RED
+        -0.5f, -0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  0.8f, 0.3f, 0.3f,  0.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  0.8f, 0.3f, 0.3f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  0.8f, 0.3f, 0.3f,  1.0f, 1.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 0.0f, 1.0f,  0.8f, 0.3f, 0.3f,  0.0f, 1.0f,
+
+        // Back face (-Z) - GREEN
+        -0.5f, -0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  0.3f, 0.8f, 0.3f,  0.0f, 0.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  0.3f, 0.8f, 0.3f,  1.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  0.3f, 0.8f, 0.3f,  1.0f, 1.0f,
+        -0.5f,  0.5f, -0.5f,  0.0f, 0.0f, -1.0f,  0.3f, 0.8f, 0.3f,  0.0f, 1.0f,
+
+        // Top face (+Y) - BLUE
+        -0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  0.3f, 0.3f, 0.8f,  0.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  0.0f, 1.0f, 0.0f,  0.3f, 0.3f, 0.8f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  0.0f, 1.0f, 0.0f,  0.3f, 0.3f, 0.8f,  1.0f, 1.0f,
+        -0.5f,  0.5f,  0.5f,  0.0f, 1.0f, 0.0f,  0.3f, 0.3f, 0.8f,  0.0f, 1.0f,
+
+        // Bottom face (-Y) - YELLOW
+        -0.5f, -0.5f, -0.5f,  0.0f, -1.0f, 0.0f,  0.8f, 0.8f, 0.3f,  0.0f, 0.0f,
+         0.5f, -0.5f, -0.5f,  0.0f, -1.0f, 0.0f,  0.8f, 0.8f, 0.3f,  1.0f, 0.0f,
+         0.5f, -0.5f,  0.5f,  0.0f, -1.0f, 0.0f,  0.8f, 0.8f, 0.3f,  1.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  0.0f, -1.0f, 0.0f,  0.8f, 0.8f, 0.3f,  0.0f, 1.0f,
+
+        // Right face (+X) - MAGENTA
+         0.5f, -0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.8f, 0.3f, 0.8f,  0.0f, 0.0f,
+         0.5f,  0.5f, -0.5f,  1.0f, 0.0f, 0.0f,  0.8f, 0.3f, 0.8f,  1.0f, 0.0f,
+         0.5f,  0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  0.8f, 0.3f, 0.8f,  1.0f, 1.0f,
+         0.5f, -0.5f,  0.5f,  1.0f, 0.0f, 0.0f,  0.8f, 0.3f, 0.8f,  0.0f, 1.0f,
+
+        // Left face (-X) - CYAN
+        -0.5f, -0.5f, -0.5f,  -1.0f, 0.0f, 0.0f,  0.3f, 0.8f, 0.8f,  0.0f, 0.0f,
+        -0.5f,  0.5f, -0.5f,  -1.0f, 0.0f, 0.0f,  0.3f, 0.8f, 0.8f,  1.0f, 0.0f,
+        -0.5f,  0.5f,  0.5f,  -1.0f, 0.0f, 0.0f,  0.3f, 0.8f, 0.8f,  1.0f, 1.0f,
+        -0.5f, -0.5f,  0.5f,  -1.0f, 0.0f, 0.0f,  0.3f, 0.8f, 0.8f,  0.0f, 1.0f,
+    };
+
+    indices = {
+        0,  1,  2,   2,  3,  0,   // Front (CCW from outside)
+        4,  5,  6,   6,  7,  4,   // Back
+        8,  9, 10,  10, 11,  8,   // Top
+        12, 13, 14,  14, 15, 12,  // Bottom
+        16, 17, 18,  18, 19, 16,  // Right
+        20, 21, 22,  22, 23, 20   // Left
+    };
+}
+
+void BuildSphere(float radius, int segments, int rings,
+                 std::vector<float>& vertices, std::vector<uint32_t>& indices) {
+    vertices.clear();
+    indices.clear();
+
+    for (int ring = 0; ring <= rings; ++ring) {
+        float v = (float)ring / (float)rings;
+        float phi = v * glm::pi<float>();
+
+        for (int seg = 0; seg <= segments; ++seg) {
+            float u = (float)seg / (float)segments;
+            float theta = u * 2.0f * glm::pi<float>();
+
+            // Normal (normalized position for sphere)
+            float nx = std::sin(phi) * std::cos(theta);
+            float ny = std::cos(phi);
+            float nz = std::sin(phi) * std::sin(theta);
+
+            // Position(3) + Normal(3) + Color(3, orange for basketball) + TexCoord(2)
+            vertices.insert(vertices.end(), {
+                radius * nx, radius * ny, radius * nz,
+                nx, ny, nz,
+                0.9f, 0.5f, 0.2f,
+                u, v
+            });
+        }
+    }
+
+    for (int ring = 0; ring < rings; ++ring) {
+        for (int seg = 0; seg < segments; ++seg) {
+            uint32_t current = ring * (segments + 1) + seg;
+            uint32_t next = current + segments + 1;
+
+            // Two triangles per quad
+            indices.insert(indices.end(), { current, next, current + 1, current + 1, next, next + 1 });
+        }
+    }
+}
+
+} // namespace
+
+MeshHandle MeshManager::Create(std::vector<float> vertices, std::vector<uint32_t> indices,
+                               VertexLayout layout, bool keepCPUData) {
+    // Identical contents (e.g. every cube) share one asset
+    uint64_t hash = HashMeshData(vertices, indices, layout);
+    auto existing = m_ByHash.find(hash);
+    if (existing != m_ByHash.end()) {
+        MeshAsset& asset = m_Meshes[existing->second & HANDLE_INDEX_MASK];
+        if (keepCPUData && !asset.KeepCPUData) {
+            asset.KeepCPUData = true;
+            // Already uploaded and freed: the incoming data is the same, keep that
+            if (asset.Vertices.empty()) {
+                asset.Vertices = std::move(vertices);
+                asset.Indices = std::move(indices);
+            }
+        }
+        return existing->second;
+    }
+
+    MeshHandle handle = AllocateHandle();
+    if (handle == NULL_MESH) {
+        return NULL_MESH;
+    }
+
+    MeshAsset& asset = m_Meshes[handle & HANDLE_INDEX_MASK];
+    asset.Layout = layout;
+    asset.Hash = hash;
+    asset.KeepCPUData = keepCPUData;
+
+    size_t stride = layout.GetStride();
+    asset.VertexCount = stride ? static_cast<uint32_t>(vertices.size() / stride) : 0;
+    asset.IndexCount = static_cast<uint32_t>(indices.size());
+
+    // Local bounds, kept after the CPU copy is freed
+    if (layout.Has(VertexAttribute::Position) && asset.VertexCount > 0) {
+        size_t offset = layout.GetOffset(VertexAttribute::Position);
+        glm::vec3 min(vertices[offset], vertices[offset + 1], vertices[offset + 2]);
+        glm::vec3 max = min;
+        for (size_t i = stride; i + stride <= vertices.size(); i += stride) {
+            glm::vec3 position(vertices[i + offset], vertices[i + offset + 1], vertices[i + offset + 2]);
+            min = glm::min(min, position);
+            max = glm::max(max, position);
+        }
+        asset.BoundsCenter = (min + max) * 0.5f;
+        asset.BoundsExtents = (max - min) * 0.5f;
+    }
+
+    asset.Vertices = std::move(vertices);
+    asset.Indices = std::move(indices);
+
+    m_ByHash[hash] = handle;
+    return handle;
+}
+
+std::vector<MeshHandle> MeshManager::LoadCooked(const std::string& filepath) {
+    // Check cache (any unloaded submesh means the whole file is reloaded)
+    auto cached = m_ByPath.find(filepath);
+    if (cached != m_ByPath.end()) {
+        bool valid = std::all_of(cached->second.begin(), cached->second.end(),
+                                 [this](MeshHandle handle) { return IsValid(handle); });
+        if (valid) {
+            return cached->second;
+        }
+        for (MeshHandle handle : cached->second) {
+            Unload(handle);
+        }
+        m_ByPath.erase(cached);
+    }
+
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        return {};
+    }
+
+    // Validate everything up front; the sections are then used as-is
+    const uint8_t* data = file.GetData();
+    uint64_t fileSize = file.GetSize();
+    if (fileSize < sizeof(CookedMesh::Header)) {
+        NILOS_ERROR("Cooked mesh too small: ", filepath);
+        return {};
+    }
+
+    CookedMesh::Header header;
+    std::memcpy(&header, data, sizeof(header));
+    if (header.Magic != CookedMesh::MAGIC) {
+        NILOS_ERROR("Not a cooked mesh: ", filepath);
+        return {};
+    }
+    if (header.Version != CookedMesh::VERSION) {
+        NILOS_ERROR("Cooked mesh version ", header.Version, " (expected ", CookedMesh::VERSION,
+                    "), re-cook: ", filepath);
+        return {};
+    }
+
+    VertexLayout layout{ static_cast<uint8_t>(header.LayoutMask) };
+    PackedVertexFormat format = VertexPacking::MakeFormat(layout,
+                                                          (header.Flags & CookedMesh::HalfPositions) != 0,
+                                                          (header.Flags & CookedMesh::UNormTexCoords) != 0);
+    uint64_t vertexBytes = uint64_t(header.VertexCount) * format.Stride;
+    uint64_t indexBytes = uint64_t(header.IndexCount) * header.IndexSize;
+    uint64_t subMeshBytes = uint64_t(header.SubMeshCount) * sizeof(CookedMesh::SubMesh);
+    auto fits = [fileSize](uint64_t offset, uint64_t size) {
+        return offset <= fileSize && size <= fileSize - offset;
+    };
+
+    if (header.LayoutMask >= (1u << static_cast<uint32_t>(VertexAttribute::Count)) ||
+        !layout.Has(VertexAttribute::Position) || header.VertexStride != format.Stride ||
+        (header.IndexSize != 2 && header.IndexSize != 4) ||
+        (header.IndexSize == 2 && header.VertexCount > 65536) ||
+        header.VertexCount == 0 || header.IndexCount == 0 || header.SubMeshCount == 0 ||
+        !fits(header.VertexDataOffset, vertexBytes) || !fits(header.IndexDataOffset, indexBytes) ||
+        !fits(header.SubMeshOffset, subMeshBytes)) {
+        NILOS_ERROR("Corrupt cooked mesh header: ", filepath);
+        return {};
+    }
+
+    std::vector<CookedMesh::SubMesh> subMeshes(header.SubMeshCount);
+    std::memcpy(subMeshes.data(), data + header.SubMeshOffset, subMeshBytes);
+    for (const CookedMesh::SubMesh& subMesh : subMeshes) {
+        if (subMesh.IndexCount == 0 || subMesh.FirstIndex > header.IndexCount ||
+            subMesh.IndexCount > header.IndexCount - subMesh.FirstIndex) {
+            NILOS_ERROR("Corrupt cooked mesh submesh table: ", filepath);
+            return {};
+        }
+    }
+
+    size_t unusedSlots = HANDLE_INDEX_MASK + 1 - std::max<size_t>(m_Meshes.size(), 1);
+    if (m_FreeSlots.size() + unusedSlots < subMeshes.size()) {
+        NILOS_ERROR("Mesh limit reached (", HANDLE_INDEX_MASK, "), cannot load ", filepath);
+        return {};
+    }
+
+    // No GL here (this may be the simulation thread): stage the sections
+    // for one upload each in UploadStaged; submeshes share the vertices
+    StagedCookedMesh staged;
+    staged.Layout = layout;
+    staged.Format = format;
+    staged.IndexSize = header.IndexSize;
+    staged.Vertices.assign(data + header.VertexDataOffset, data + header.VertexDataOffset + vertexBytes);
+    staged.Indices.assign(data + header.IndexDataOffset, data + header.IndexDataOffset + indexBytes);
+
+    std::vector<MeshHandle> handles;
+    handles.reserve(subMeshes.size());
+    for (size_t i = 0; i < subMeshes.size(); ++i) {
+        const CookedMesh::SubMesh& subMesh = subMeshes[i];
+        MeshHandle handle = AllocateHandle();
+
+        MeshAsset& asset = m_Meshes[handle & HANDLE_INDEX_MASK];
+        asset.Layout = layout;
+        asset.VertexCount = header.VertexCount;
+        asset.IndexCount = subMesh.IndexCount;
+        asset.BoundsCenter = glm::vec3(subMesh.BoundsCenter[0], subMesh.BoundsCenter[1], subMesh.BoundsCenter[2]);
+        asset.BoundsExtents = glm::vec3(subMesh.BoundsExtents[0], subMesh.BoundsExtents[1], subMesh.BoundsExtents[2]);
+        asset.Staged = true;
+
+        // File assets dedup by path, the hash only keys them in m_ByHash
+        asset.Hash = FNV_OFFSET_BASIS;
+        HashBytes(asset.Hash, filepath.data(), filepath.size());
+        HashBytes(asset.Hash, &i, sizeof(i));
+        m_ByHash[asset.Hash] = handle;
+
+        handles.push_back(handle);
+        staged.Handles.push_back(handle);
+        staged.IndexOffsets.push_back(size_t(subMesh.FirstIndex) * header.IndexSize);
+    }
+    m_Staged.push_back(std::move(staged));
+
+    NILOS_DEBUG("Cooked mesh loaded: ", filepath, " (", header.VertexCount, " vertices, ",
+                header.IndexCount, " indices, ", subMeshes.size(), " submeshes)");
+
+    m_ByPath[filepath] = handles;
+    return handles;
+}
+
+MeshHandle MeshManager::GetCube() {
+    if (!IsValid(m_Cube)) {
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+        BuildCube(vertices, indices);
+        m_Cube = Create(std::move(vertices), std::move(indices), VertexLayout::Standard());
+    }
+    return m_Cube;
+}
+
+MeshHandle MeshManager::GetSphere(float radius, int segments, int rings) {
+    // Creating the data again is cheap next to keeping a second cache;
+    // Create dedups it by hash
+    std::vector<float> vertices;
+    std::vector<uint32_t> indices;
+    BuildSphere(radius, segments, rings, vertices, indices);
+    return Create(std::move(vertices), std::move(indices), VertexLayout::Standard());
+}
+
+const MeshAsset* MeshManager::GetMesh(MeshHandle handle) const {
+    uint32_t slot = handle & HANDLE_INDEX_MASK;
+    if (slot == 0 || slot >= m_Meshes.size()) {
+        return nullptr;
+    }
+    if ((handle >> HANDLE_INDEX_BITS) != m_Generations[slot]) {
+        return nullptr;
+    }
+    return &m_Meshes[slot];
+}
+
+MeshHandle MeshManager::FindByHash(uint64_t hash) const {
+    auto it = m_ByHash.find(hash);
+    return (it != m_ByHash.end()) ? it->second : NULL_MESH;
+}
+
+MeshHandle MeshManager::AllocateHandle() {
+    uint32_t slot;
+    if (!m_FreeSlots.empty()) {
+        slot = m_FreeSlots.back();
+        m_FreeSlots.pop_back();
+    } else {
+        if (m_Meshes.empty()) {
+            // Slot 0 backs NULL_MESH
+            m_Meshes.emplace_back();
+            m_Generations.push_back(0);
+        }
+        if (m_Meshes.size() > HANDLE_INDEX_MASK) {
+            NILOS_ERROR("Mesh limit reached (", HANDLE_INDEX_MASK, ")");
+            return NULL_MESH;
+        }
+        slot = static_cast<uint32_t>(m_Meshes.size());
+        m_Meshes.emplace_back();
+        m_Generations.push_back(0);
+    }
+
+    m_Meshes[slot] = MeshAsset();
+    return (m_Generations[slot] << HANDLE_INDEX_BITS) | slot;
+}
+
+bool MeshManager::MakeResident(MeshHandle handle) {
+    if (!IsValid(handle)) {
+        return false;
+    }
+    MeshAsset& asset = m_Meshes[handle & HANDLE_INDEX_MASK];
+    if (asset.Resident) {
+        return true;
+    }
+    if (asset.Staged) {
+        UploadStaged();
+        return asset.Resident;
+    }
+    if (asset.VertexCount == 0 || asset.IndexCount == 0) {
+        return false;
+    }
+
+    // Pack the vertices into the compact format (see VertexPacking)
+    PackedVertexFormat format = VertexPacking::ChooseFormat(asset.Vertices.data(), asset.VertexCount, asset.Layout);
+    std::vector<uint8_t> packed;
+    VertexPacking::Encode(asset.Vertices.data(), asset.VertexCount, asset.Layout, format, packed);
+
+    // Indices are relative to BaseVertex, so 16-bit whenever the mesh itself allows it
+    bool shortIndices = asset.VertexCount <= 65536;
+    size_t indexBytes = asset.IndexCount * (shortIndices ? sizeof(uint16_t) : sizeof(uint32_t));
+
+    uint32_t arenaIndex = AcquireArena(asset.Layout, format, packed.size(), indexBytes);
+    MeshArena& arena = m_Arenas[arenaIndex];
+
+    size_t vertexOffset = arena.VertexUsed;
+    size_t indexOffset = AlignUp(arena.IndexUsed, INDEX_ALIGNMENT);
+
+    // Upload through the copy target so no VAO's index binding is disturbed
+    glBindBuffer(GL_COPY_WRITE_BUFFER, arena.VBO);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset, packed.size(), packed.data());
+    glBindBuffer(GL_COPY_WRITE_BUFFER, arena.EBO);
+    if (shortIndices) {
+        std::vector<uint16_t> indices(asset.Indices.begin(), asset.Indices.end());
+        glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset, indexBytes, indices.data());
+    } else {
+        glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset, indexBytes, asset.Indices.data());
+    }
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    arena.VertexUsed = vertexOffset + packed.size();
+    arena.IndexUsed = indexOffset + indexBytes;
+
+    asset.Resident = true;
+    asset.Arena = arenaIndex;
+    asset.BaseVertex = static_cast<int32_t>(vertexOffset / format.Stride);
+    asset.IndexOffset = indexOffset;
+    asset.IndexType = shortIndices ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+
+    if (!asset.KeepCPUData) {
+        std::vector<float>().swap(asset.Vertices);
+        std::vector<uint32_t>().swap(asset.Indices);
+    }
+
+    NILOS_DEBUG("Mesh uploaded (arena ", arenaIndex, ", ", asset.VertexCount, " vertices x ",
+                format.Stride, " bytes, ", shortIndices ? 16 : 32, "-bit indices)");
+    return true;
+}
+
+void MeshManager::UploadStaged() {
+    for (StagedCookedMesh& staged : m_Staged) {
+        // Meshes unloaded before their first upload are skipped
+        bool used = std::any_of(staged.Handles.begin(), staged.Handles.end(),
+                                [this](MeshHandle handle) { return IsValid(handle); });
+        if (!used) {
+            continue;
+        }
+
+        uint32_t arenaIndex = AcquireArena(staged.Layout, staged.Format, staged.Vertices.size(), staged.Indices.size());
+        MeshArena& arena = m_Arenas[arenaIndex];
+        size_t vertexOffset = arena.VertexUsed;
+        size_t indexOffset = AlignUp(arena.IndexUsed, INDEX_ALIGNMENT);
+
+        glBindBuffer(GL_COPY_WRITE_BUFFER, arena.VBO);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, vertexOffset, staged.Vertices.size(), staged.Vertices.data());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, arena.EBO);
+        glBufferSubData(GL_COPY_WRITE_BUFFER, indexOffset, staged.Indices.size(), staged.Indices.data());
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        arena.VertexUsed = vertexOffset + staged.Vertices.size();
+        arena.IndexUsed = indexOffset + staged.Indices.size();
+
+        for (size_t i = 0; i < staged.Handles.size(); ++i) {
+            if (!IsValid(staged.Handles[i])) {
+                continue;
+            }
+            MeshAsset& asset = m_Meshes[staged.Handles[i] & HANDLE_INDEX_MASK];
+            asset.Staged = false;
+            asset.Resident = true;
+            asset.Arena = arenaIndex;
+            asset.BaseVertex = static_cast<int32_t>(vertexOffset / staged.Format.Stride);
+            asset.IndexOffset = indexOffset + staged.IndexOffsets[i];
+            asset.IndexType = staged.IndexSize == 2 ? GL_UNSIGNED_SHORT : GL_UNSIGNED_INT;
+        }
+    }
+    m_Staged.clear();
+}
+
+uint32_t MeshManager::AcquireArena(VertexLayout layout, const PackedVertexFormat& format,
+                                   size_t vertexBytes, size_t indexBytes) {
+    for (size_t i = 0; i < m_Arenas.size(); ++i) {
+        const MeshArena& arena = m_Arenas[i];
+        if (!SameFormat(arena, layout, format)) {
+            continue;
+        }
+        // BaseVertex needs the vertex offset to be a whole number of vertices
+        size_t vertexOffset = arena.VertexUsed;
+        size_t indexOffset = AlignUp(arena.IndexUsed, INDEX_ALIGNMENT);
+        if (vertexOffset + vertexBytes <= arena.VertexCapacity &&
+            indexOffset + indexBytes <= arena.IndexCapacity) {
+            return static_cast<uint32_t>(i);
+        }
+    }
+
+    MeshArena arena;
+    arena.Layout = layout;
+    arena.Format = format;
+    // Round the vertex capacity down to whole vertices
+    arena.VertexCapacity = std::max(ARENA_VERTEX_BYTES, vertexBytes) / format.Stride * format.Stride;
+    arena.IndexCapacity = std::max(ARENA_INDEX_BYTES, AlignUp(indexBytes, INDEX_ALIGNMENT));
+
+    glGenVertexArrays(1, &arena.VAO);
+    glGenBuffers(1, &arena.VBO);
+    glGenBuffers(1, &arena.EBO);
+
+    glBindVertexArray(arena.VAO);
+    glBindBuffer(GL_ARRAY_BUFFER, arena.VBO);
+    glBufferData(GL_ARRAY_BUFFER, arena.VertexCapacity, nullptr, GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, arena.EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, arena.IndexCapacity, nullptr, GL_STATIC_DRAW);
+
+    GLsizei stride = static_cast<GLsizei>(format.Stride);
+    auto offset = [&format](VertexAttribute attribute) {
+        return (void*)(size_t)format.Offsets[static_cast<size_t>(attribute)];
+    };
+
+    // Missing attributes are left disabled and read the renderer's defaults
+    // Position (location = 0)
+    if (layout.Has(VertexAttribute::Position)) {
+        glVertexAttribPointer(0, 3, format.HalfPositions ? GL_HALF_FLOAT : GL_FLOAT, GL_FALSE, stride,
+                              offset(VertexAttribute::Position));
+        glEnableVertexAttribArray(0);
+    }
+
+    // Normal (location = 1), signed 10:10:10:2
+    if (layout.Has(VertexAttribute::Normal)) {
+        glVertexAttribPointer(1, 4, GL_INT_2_10_10_10_REV, GL_TRUE, stride, offset(VertexAttribute::Normal));
+        glEnableVertexAttribArray(1);
+    }
+
+    // Color (location = 2), RGBA8
+    if (layout.Has(VertexAttribute::Color)) {
+        glVertexAttribPointer(2, 4, GL_UNSIGNED_BYTE, GL_TRUE, stride, offset(VertexAttribute::Color));
+        glEnableVertexAttribArray(2);
+    }
+
+    // TexCoord (location = 3), unorm16 or half
+    if (layout.Has(VertexAttribute::TexCoord)) {
+        glVertexAttribPointer(3, 2, format.UNormTexCoords ? GL_UNSIGNED_SHORT : GL_HALF_FLOAT,
+                              format.UNormTexCoords ? GL_TRUE : GL_FALSE, stride, offset(VertexAttribute::TexCoord));
+        glEnableVertexAttribArray(3);
+    }
+
+    glBindVertexArray(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    NILOS_DEBUG("Mesh arena ", m_Arenas.size(), " created (", arena.VertexCapacity / 1024, " KB vertices, ",
+                arena.IndexCapacity / 1024, " KB indices, ", format.Stride, " bytes/vertex)");
+
+    m_Arenas.push_back(arena);
+    return static_cast<uint32_t>(m_Arenas.size() - 1);
+}
+
+void MeshManager::Unload(MeshHandle handle) {
+    if (!IsValid(handle)) {
+        return;
+    }
+    uint32_t slot = handle & HANDLE_INDEX_MASK;
+    m_ByHash.erase(m_Meshes[slot].Hash);
+    m_Meshes[slot] = MeshAsset();
+    m_Generations[slot] = (m_Generations[slot] + 1) & HANDLE_GENERATION_MASK;
+    m_FreeSlots.push_back(slot);
+}
+
+void MeshManager::Clear() {
+    for (MeshArena& arena : m_Arenas) {
+        glDeleteVertexArrays(1, &arena.VAO);
+        glDeleteBuffers(1, &arena.VBO);
+        glDeleteBuffers(1, &arena.EBO);
+    }
+    m_Arenas.clear();
+    m_Staged.clear();
+
+    // Bump every generation so outstanding handles go stale
+    m_FreeSlots.clear();
+    for (size_t slot = 1; slot < m_Meshes.size(); ++slot) {
+        m_Meshes[slot] = MeshAsset();
+        m_Generations[slot] = (m_Generations[slot] + 1) & HANDLE_GENERATION_MASK;
+        m_FreeSlots.push_back(static_cast<uint32_t>(slot));
+    }
+    m_ByHash.clear();
+    m_ByPath.clear();
+    m_Cube = NULL_MESH;
+}
+
+size_t MeshManager::GetGPUMemoryUsage() const {
+    size_t bytes = 0;
+    for (const MeshArena& arena : m_Arenas) {
+        bytes += arena.VertexCapacity + arena.IndexCapacity;
+    }
+    return bytes;
+}
+
+uint64_t MeshManager::HashMeshData(const std::vector<float>& vertices, const std::vector<uint32_t>& indices,
+                                   VertexLayout layout) {
+    // FNV-1a over the layout, sizes and raw bytes of both arrays
+    uint64_t hash = FNV_OFFSET_BASIS;
+    uint64_t vertexCount = vertices.size();
+    uint64_t indexCount = indices.size();
+    HashBytes(hash, &layout.Mask, sizeof(layout.Mask));
+    HashBytes(hash, &vertexCount, sizeof(vertexCount));
+    HashBytes(hash, &indexCount, sizeof(indexCount));
+    HashBytes(hash, vertices.data(), vertices.size() * sizeof(float));
+    HashBytes(hash, indices.data(), indices.size() * sizeof(uint32_t));
+    return hash;
+}
+
+// ============================================================================
+// MeshComponent helpers (declared in Component.h)
+// ============================================================================
+
+void MeshComponent::SetMesh(MeshHandle handle) {
+    Mesh = handle;
+    Vertices.clear();
+    Indices.clear();
+    HasBounds = false;
+    if (const MeshAsset* asset = MeshManager::Get().GetMesh(handle)) {
+        Layout = asset->Layout;
+        BoundsCenter = asset->BoundsCenter;
+        BoundsExtents = asset->BoundsExtents;
+        HasBounds = true;
+    }
+}
+
+void MeshComponent::CreateCube() {
+    SetMesh(MeshManager::Get().GetCube());
+}
+
+void MeshComponent::CreateSphere(float radius, int segments, int rings) {
+    SetMesh(MeshManager::Get().GetSphere(radius, segments, rings));
+}
+
+void MeshComponent::ComputeBounds() {
+    if (const MeshAsset* asset = MeshManager::Get().GetMesh(Mesh)) {
+        BoundsCenter = asset->BoundsCenter;
+        BoundsExtents = asset->BoundsExtents;
+        HasBounds = true;
+        return;
+    }
+
+    glm::vec3 min(0.0f), max(0.0f);
+    size_t stride = Layout.GetStride();
+    size_t offset = Layout.GetOffset(VertexAttribute::Position);
+    if (Layout.Has(VertexAttribute::Position)) {
+        for (size_t i = 0; i + stride <= Vertices.size(); i += stride) {
+            glm::vec3 position(Vertices[i + offset], Vertices[i + offset + 1], Vertices[i + offset + 2]);
+            min = (i == 0) ? position : glm::min(min, position);
+            max = (i == 0) ? position : glm::max(max, position);
+        }
+    }
+    BoundsCenter = (min + max) * 0.5f;
+    BoundsExtents = (max - min) * 0.5f;
+    HasBounds = true;
+}
+
+} // namespace Nilos
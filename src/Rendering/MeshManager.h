@@ -0,0 +1,212 @@
+#pragma once
+
+#include "MeshHandle.h"
+#include "VertexLayout.h"
+
+#include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief A deduplicated mesh: source data, bounds and GPU placement
+ */
+struct MeshAsset {
+    VertexLayout Layout;
+    std::vector<float> Vertices;   // CPU copy, empty once freed after upload
+    std::vector<uint32_t> Indices; // CPU copy, empty once freed after upload
+    uint32_t VertexCount = 0;
+    uint32_t IndexCount = 0;
+    glm::vec3 BoundsCenter = glm::vec3(0.0f);
+    glm::vec3 BoundsExtents = glm::vec3(0.0f);
+    uint64_t Hash = 0;
+    bool KeepCPUData = false;
+
+    // GPU placement inside a shared arena (valid once Resident)
+    bool Staged = false;       // Cooked data waiting for UploadStaged
+    bool Resident = false;
+    uint32_t Arena = 0;
+    int32_t BaseVertex = 0;    // First vertex in the arena's vertex buffer
+    size_t IndexOffset = 0;    // Byte offset into the arena's index buffer
+    uint32_t IndexType = 0;    // GL_UNSIGNED_SHORT or GL_UNSIGNED_INT
+};
+
+/**
+ * @brief Large shared vertex/index buffer pair holding many meshes
+ *
+ * Every mesh in an arena has the same packed vertex format, so the arena's
+ * VAO (vertex attributes 0-3 and the index buffer) draws all of them with a
+ * base vertex and an index offset.
+ */
+struct MeshArena {
+    uint32_t VAO = 0;
+    uint32_t VBO = 0;
+    uint32_t EBO = 0;
+    VertexLayout Layout;
+    PackedVertexFormat Format;
+    size_t VertexCapacity = 0;  // Bytes
+    size_t VertexUsed = 0;      // Bytes
+    size_t IndexCapacity = 0;   // Bytes
+    size_t IndexUsed = 0;       // Bytes
+};
+
+/**
+ * @brief Mesh manager for sharing geometry between entities
+ *
+ * Owns every mesh asset, deduplicated by content hash, so a thousand crates
+ * hold a thousand 4-byte handles instead of a thousand vertex arrays.
+ * Uploading packs a mesh (see VertexPacking) into a shared MeshArena and,
+ * unless the mesh asked to keep them, frees the CPU copies.
+ *
+ * Arena space of unloaded meshes is only reclaimed by Clear().
+ * Create and LoadCooked only stage data and may be called from the
+ * simulation thread; uploads (MakeResident, UploadStaged) and Clear need
+ * the OpenGL context and run on the render thread while the simulation
+ * waits (Renderer::PrepareFrame). The manager itself is not thread-safe.
+ *
+ * Usage:
+ *   MeshHandle cube = MeshManager::Get().GetCube();
+ *   mesh->SetMesh(cube);
+ */
+class MeshManager {
+public:
+    static MeshManager& Get() {
+        static MeshManager instance;
+        return instance;
+    }
+
+    /**
+     * @brief Register mesh data (returns the existing handle for identical data)
+     * @param keepCPUData Keep Vertices/Indices in the asset after upload; on a
+     *        dedupe hit whose CPU copy was already freed, it is refilled from
+     *        the (identical) incoming data
+     */
+    MeshHandle Create(std::vector<float> vertices, std::vector<uint32_t> indices,
+                      VertexLayout layout = VertexLayout::Standard(), bool keepCPUData = false);
+
+    /**
+     * @brief Load a cooked mesh (.nmesh, see CookedMesh.h), one handle per submesh
+     *
+     * The file is memory-mapped and its sections are staged as-is, to be
+     * copied into an arena by the next UploadStaged; nothing is decoded.
+     * Loading the same path again returns the cached handles.
+     * @return Empty if the file is missing, invalid or from another version
+     */
+    std::vector<MeshHandle> LoadCooked(const std::string& filepath);
+
+    /**
+     * @brief Shared unit cube (Position, Normal, Color, TexCoord)
+     */
+    MeshHandle GetCube();
+
+    /**
+     * @brief Shared UV sphere (deduplicated per parameter set)
+     */
+    MeshHandle GetSphere(float radius = 0.5f, int segments = 32, int rings = 16);
+
+    /**
+     * @brief Get a mesh asset (nullptr if the handle is stale or null)
+     */
+    const MeshAsset* GetMesh(MeshHandle handle) const;
+
+    /**
+     * @brief Find a loaded mesh by its content hash (MeshAsset::Hash)
+     * @return NULL_MESH if no mesh with that hash is loaded
+     */
+    MeshHandle FindByHash(uint64_t hash) const;
+
+    /**
+     * @brief Check if a handle refers to a loaded mesh
+     */
+    bool IsValid(MeshHandle handle) const { return GetMesh(handle) != nullptr; }
+
+    /**
+     * @brief Upload a mesh into an arena if it is not resident yet
+     * @return false if the handle is invalid or the mesh has no data to upload
+     */
+    bool MakeResident(MeshHandle handle);
+
+    /**
+     * @brief Upload every cooked mesh staged by LoadCooked (render thread)
+     */
+    void UploadStaged();
+
+    /**
+     * @brief Arenas (index = MeshAsset::Arena)
+     */
+    const MeshArena& GetArena(uint32_t index) const { return m_Arenas[index]; }
+    size_t GetArenaCount() const { return m_Arenas.size(); }
+
+    /**
+     * @brief Unload one mesh (its handle becomes invalid)
+     */
+    void Unload(MeshHandle handle);
+
+    /**
+     * @brief Unload all meshes and free all arenas
+     */
+    void Clear();
+
+    /**
+     * @brief Number of loaded meshes
+     */
+    size_t GetMeshCount() const { return m_ByHash.size(); }
+
+    /**
+     * @brief Bytes allocated in arena buffers
+     */
+    size_t GetGPUMemoryUsage() const;
+
+private:
+    MeshManager() = default;
+
+    static uint64_t HashMeshData(const std::vector<float>& vertices, const std::vector<uint32_t>& indices,
+                                 VertexLayout layout);
+
+    /**
+     * @brief Take a free slot and return its handle (NULL_MESH if full)
+     */
+    MeshHandle AllocateHandle();
+
+    /**
+     * @brief Find (or create) an arena with room for the given format and sizes
+     */
+    uint32_t AcquireArena(VertexLayout layout, const PackedVertexFormat& format,
+                          size_t vertexBytes, size_t indexBytes);
+
+    /**
+     * @brief Sections of a cooked file waiting for the GL context, shared by its submeshes
+     */
+    struct StagedCookedMesh {
+        VertexLayout Layout;
+        PackedVertexFormat Format;
+        uint32_t IndexSize = 0;
+        std::vector<uint8_t> Vertices;
+        std::vector<uint8_t> Indices;
+        std::vector<MeshHandle> Handles;
+        std::vector<size_t> IndexOffsets;  // Per handle, bytes into Indices
+    };
+
+    // Default arena size; larger meshes get an arena of their own size
+    static constexpr size_t ARENA_VERTEX_BYTES = 8 * 1024 * 1024;
+    static constexpr size_t ARENA_INDEX_BYTES = 4 * 1024 * 1024;
+
+    static constexpr uint32_t HANDLE_INDEX_BITS = 20;
+    static constexpr uint32_t HANDLE_INDEX_MASK = (1u << HANDLE_INDEX_BITS) - 1;
+    static constexpr uint32_t HANDLE_GENERATION_MASK = (1u << (32 - HANDLE_INDEX_BITS)) - 1;
+
+    std::vector<MeshAsset> m_Meshes;       // Slot 0 unused
+    std::vector<uint32_t> m_Generations;   // Per slot
+    std::vector<uint32_t> m_FreeSlots;
+    std::unordered_map<uint64_t, MeshHandle> m_ByHash;
+    std::unordered_map<std::string, std::vector<MeshHandle>> m_ByPath;
+    std::vector<MeshArena> m_Arenas;
+    std::vector<StagedCookedMesh> m_Staged;
+    MeshHandle m_Cube = NULL_MESH;
+};
+
+} // namespace Nilos
@@ -0,0 +1,1007 @@
+#include "ModelLoader.h"
+#include "../Core/Logger.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <unordered_map>
+
+// Source format importers behind ModelLoader::Import. These run in the
+// offline cook step, so they favour clear validation over raw speed.
+
+namespace Nilos {
+
+namespace {
+
+constexpr uint32_t INVALID_INDEX = UINT32_MAX;
+
+bool ReadFile(const std::string& filepath, std::vector<uint8_t>& bytes) {
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.is_open()) {
+        NILOS_ERROR("Failed to open model file: ", filepath);
+        return false;
+    }
+    bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+std::string GetDirectory(const std::string& filepath) {
+    size_t slash = filepath.find_last_of("/\\");
+    return slash == std::string::npos ? "" : filepath.substr(0, slash + 1);
+}
+
+/**
+ * @brief One vertex before it is interleaved into ModelData::Layout
+ */
+struct ImportVertex {
+    glm::vec3 Position = glm::vec3(0.0f);
+    glm::vec3 Normal = glm::vec3(0.0f, 1.0f, 0.0f);
+    glm::vec3 Color = glm::vec3(1.0f);
+    glm::vec2 TexCoord = glm::vec2(0.0f);
+};
+
+void AppendVertex(ModelData& model, const ImportVertex& vertex) {
+    const VertexLayout& layout = model.Layout;
+    if (layout.Has(VertexAttribute::Position)) {
+        model.Vertices.insert(model.Vertices.end(), { vertex.Position.x, vertex.Position.y, vertex.Position.z });
+    }
+    if (layout.Has(VertexAttribute::Normal)) {
+        model.Vertices.insert(model.Vertices.end(), { vertex.Normal.x, vertex.Normal.y, vertex.Normal.z });
+    }
+    if (layout.Has(VertexAttribute::Color)) {
+        model.Vertices.insert(model.Vertices.end(), { vertex.Color.r, vertex.Color.g, vertex.Color.b });
+    }
+    if (layout.Has(VertexAttribute::TexCoord)) {
+        model.Vertices.insert(model.Vertices.end(), { vertex.TexCoord.x, vertex.TexCoord.y });
+    }
+}
+
+/**
+ * @brief Area-weighted smooth normals for the vertices flagged in missing
+ */
+void GenerateMissingNormals(ModelData& model, const std::vector<uint8_t>& missing) {
+    if (std::find(missing.begin(), missing.end(), 1) == missing.end()) {
+        return;
+    }
+
+    size_t stride = model.Layout.GetStride();
+    size_t positionOffset = model.Layout.GetOffset(VertexAttribute::Position);
+    size_t normalOffset = model.Layout.GetOffset(VertexAttribute::Normal);
+    auto position = [&](uint32_t index) {
+        const float* p = &model.Vertices[index * stride + positionOffset];
+        return glm::vec3(p[0], p[1], p[2]);
+    };
+
+    std::vector<glm::vec3> sums(missing.size(), glm::vec3(0.0f));
+    for (size_t i = 0; i + 2 < model.Indices.size(); i += 3) {
+        uint32_t a = model.Indices[i], b = model.Indices[i + 1], c = model.Indices[i + 2];
+        // Unnormalized cross product weights by triangle area
+        glm::vec3 faceNormal = glm::cross(position(b) - position(a), position(c) - position(a));
+        sums[a] += faceNormal;
+        sums[b] += faceNormal;
+        sums[c] += faceNormal;
+    }
+
+    for (size_t v = 0; v < missing.size(); ++v) {
+        if (!missing[v]) continue;
+        float length = glm::length(sums[v]);
+        glm::vec3 normal = length > 0.0f ? sums[v] / length : glm::vec3(0.0f, 1.0f, 0.0f);
+        float* n = &model.Vertices[v * stride + normalOffset];
+        n[0] = normal.x;
+        n[1] = normal.y;
+        n[2] = normal.z;
+    }
+}
+
+// ============================================================================
+// OBJ
+// ============================================================================
+
+/**
+ * @brief A face corner: 0-based position/texcoord/normal indices (-1 = absent)
+ */
+struct ObjCorner {
+    int32_t Position;
+    int32_t TexCoord;
+    int32_t Normal;
+
+    bool operator==(const ObjCorner& other) const {
+        return Position == other.Position && TexCoord == other.TexCoord && Normal == other.Normal;
+    }
+};
+
+struct ObjCornerHash {
+    size_t operator()(const ObjCorner& corner) const {
+        uint64_t hash = uint64_t(uint32_t(corner.Position)) * 0x9E3779B97F4A7C15ull;
+        hash ^= uint64_t(uint32_t(corner.TexCoord)) * 0xC2B2AE3D27D4EB4Full + (hash << 6);
+        hash ^= uint64_t(uint32_t(corner.Normal)) * 0x165667B19E3779F9ull + (hash >> 2);
+        return static_cast<size_t>(hash);
+    }
+};
+
+const char* SkipSpaces(const char* p, const char* end) {
+    while (p < end && (*p == ' ' || *p == '\t' || *p == '\r')) ++p;
+    return p;
+}
+
+/**
+ * @brief Resolve a 1-based (or negative, relative) OBJ index; -1 if invalid
+ */
+int32_t ResolveObjIndex(long index, size_t count) {
+    if (index > 0 && static_cast<size_t>(index) <= count) return static_cast<int32_t>(index - 1);
+    if (index < 0 && static_cast<size_t>(-index) <= count) return static_cast<int32_t>(count + index);
+    return -1;
+}
+
+} // namespace
+
+bool ModelLoader::ImportOBJ(const std::string& filepath, ModelData& model) {
+    std::vector<uint8_t> bytes;
+    if (!ReadFile(filepath, bytes)) {
+        return false;
+    }
+    // Every line ends in a newline; the terminator stops strtof/strtol from
+    // skipping that newline past the end of the buffer
+    bytes.push_back('\n');
+    bytes.push_back('\0');
+
+    std::vector<glm::vec3> positions;
+    std::vector<glm::vec3> colors;
+    std::vector<glm::vec2> texCoords;
+    std::vector<glm::vec3> normals;
+    bool hasColors = false;
+
+    std::vector<ObjCorner> corners; // Three per triangle
+    std::vector<ModelSubMesh> subMeshes(1);
+    std::unordered_map<std::string, uint32_t> materials;
+
+    const char* p = reinterpret_cast<const char*>(bytes.data());
+    const char* end = p + bytes.size() - 1;
+    size_t lineNumber = 0;
+
+    while (p < end) {
+        const char* lineEnd = static_cast<const char*>(std::memchr(p, '\n', end - p));
+        ++lineNumber;
+        p = SkipSpaces(p, lineEnd);
+
+        auto readFloats = [&](float* out, int maxCount) {
+            int count = 0;
+            while (count < maxCount) {
+                const char* start = SkipSpaces(p, lineEnd);
+                if (start >= lineEnd) break;
+                char* next = nullptr;
+                float value = std::strtof(start, &next);
+                if (next == start || next > lineEnd) break;
+                out[count++] = value;
+                p = next;
+            }
+            return count;
+        };
+
+        if (p + 1 < lineEnd && p[0] == 'v' && (p[1] == ' ' || p[1] == '\t')) {
+            p += 2;
+            float values[6] = {};
+            int count = readFloats(values, 6);
+            if (count < 3) {
+                NILOS_ERROR(filepath, ":", lineNumber, ": vertex needs 3 coordinates");
+                return false;
+            }
+            positions.emplace_back(values[0], values[1], values[2]);
+            // Common extension: "v x y z r g b"
+            hasColors = hasColors || count == 6;
+            colors.push_back(count == 6 ? glm::vec3(values[3], values[4], values[5]) : glm::vec3(1.0f));
+        } else if (p + 2 < lineEnd && p[0] == 'v' && p[1] == 't' && (p[2] == ' ' || p[2] == '\t')) {
+            p += 3;
+            float values[3] = {};
+            readFloats(values, 3);
+            texCoords.emplace_back(values[0], values[1]);
+        } else if (p + 2 < lineEnd && p[0] == 'v' && p[1] == 'n' && (p[2] == ' ' || p[2] == '\t')) {
+            p += 3;
+            float values[3] = {};
+            if (readFloats(values, 3) < 3) {
+                NILOS_ERROR(filepath, ":", lineNumber, ": normal needs 3 coordinates");
+                return false;
+            }
+            normals.emplace_back(values[0], values[1], values[2]);
+        } else if (p + 1 < lineEnd && p[0] == 'f' && (p[1] == ' ' || p[1] == '\t')) {
+            p += 2;
+            ObjCorner polygon[64];
+            int count = 0;
+            while (true) {
+                p = SkipSpaces(p, lineEnd);
+                if (p >= lineEnd) break;
+
+                // p, p/t, p//n or p/t/n
+                char* next = nullptr;
+                long indices[3] = { 0, 0, 0 };
+                indices[0] = std::strtol(p, &next, 10);
+                if (next == p) break;
+                p = next;
+                for (int slot = 1; slot < 3 && p < lineEnd && *p == '/'; ++slot) {
+                    ++p;
+                    if (p >= lineEnd) break;
+                    indices[slot] = std::strtol(p, &next, 10);
+                    p = next;
+                }
+
+                ObjCorner corner;
+                corner.Position = ResolveObjIndex(indices[0], positions.size());
+                corner.TexCoord = indices[1] ? ResolveObjIndex(indices[1], texCoords.size()) : -1;
+                corner.Normal = indices[2] ? ResolveObjIndex(indices[2], normals.size()) : -1;
+                if (corner.Position < 0 || (indices[1] && corner.TexCoord < 0) || (indices[2] && corner.Normal < 0)) {
+                    NILOS_ERROR(filepath, ":", lineNumber, ": face index out of range");
+                    return false;
+                }
+                if (count == 64) {
+                    NILOS_ERROR(filepath, ":", lineNumber, ": face has more than 64 corners");
+                    return false;
+                }
+                polygon[count++] = corner;
+            }
+
+            // Fan triangulation (faces are expected to be convex)
+            for (int i = 2; i < count; ++i) {
+                corners.push_back(polygon[0]);
+                corners.push_back(polygon[i - 1]);
+                corners.push_back(polygon[i]);
+            }
+        } else if (lineEnd - p > 7 && std::strncmp(p, "usemtl", 6) == 0 && (p[6] == ' ' || p[6] == '\t')) {
+            const char* name = SkipSpaces(p + 7, lineEnd);
+            const char* nameEnd = lineEnd;
+            while (nameEnd > name && (nameEnd[-1] == ' ' || nameEnd[-1] == '\t' || nameEnd[-1] == '\r')) --nameEnd;
+            auto inserted = materials.emplace(std::string(name, nameEnd), static_cast<uint32_t>(materials.size()));
+
+            // Each material switch starts a new submesh
+            uint32_t firstIndex = static_cast<uint32_t>(corners.size());
+            if (subMeshes.back().FirstIndex == firstIndex) {
+                subMeshes.back().MaterialIndex = inserted.first->second;
+            } else {
+                subMeshes.push_back({ firstIndex, 0, inserted.first->second });
+            }
+        }
+        // Comments, groups, smoothing groups and mtllib are ignored
+
+        p = lineEnd + 1;
+    }
+
+    bool hasTexCoords = std::any_of(corners.begin(), corners.end(),
+                                    [](const ObjCorner& corner) { return corner.TexCoord >= 0; });
+
+    uint8_t mask = VertexLayout::Bit(VertexAttribute::Position) | VertexLayout::Bit(VertexAttribute::Normal);
+    if (hasColors) mask |= VertexLayout::Bit(VertexAttribute::Color);
+    if (hasTexCoords) mask |= VertexLayout::Bit(VertexAttribute::TexCoord);
+    model.Layout = VertexLayout{ mask };
+
+    // Weld identical corners into shared vertices
+    std::unordered_map<ObjCorner, uint32_t, ObjCornerHash> vertexByCorner;
+    std::vector<uint8_t> missingNormals;
+    model.Indices.reserve(corners.size());
+    for (const ObjCorner& corner : corners) {
+        auto found = vertexByCorner.find(corner);
+        if (found != vertexByCorner.end()) {
+            model.Indices.push_back(found->second);
+            continue;
+        }
+
+        ImportVertex vertex;
+        vertex.Position = positions[corner.Position];
+        vertex.Color = colors[corner.Position];
+        if (corner.TexCoord >= 0) vertex.TexCoord = texCoords[corner.TexCoord];
+        if (corner.Normal >= 0) vertex.Normal = normals[corner.Normal];
+
+        uint32_t index = static_cast<uint32_t>(missingNormals.size());
+        AppendVertex(model, vertex);
+        missingNormals.push_back(corner.Normal < 0 ? 1 : 0);
+        vertexByCorner.emplace(corner, index);
+        model.Indices.push_back(index);
+    }
+    GenerateMissingNormals(model, missingNormals);
+
+    // Close the submesh ranges and drop empty ones
+    for (size_t i = 0; i < subMeshes.size(); ++i) {
+        uint32_t next = i + 1 < subMeshes.size() ? subMeshes[i + 1].FirstIndex : static_cast<uint32_t>(corners.size());
+        subMeshes[i].IndexCount = next - subMeshes[i].FirstIndex;
+    }
+    subMeshes.erase(std::remove_if(subMeshes.begin(), subMeshes.end(),
+                                   [](const ModelSubMesh& subMesh) { return subMesh.IndexCount == 0; }),
+                    subMeshes.end());
+    model.SubMeshes = std::move(subMeshes);
+    return true;
+}
+
+// ============================================================================
+// glTF 2.0
+// ============================================================================
+
+namespace {
+
+/**
+ * @brief Minimal JSON document, enough for glTF
+ */
+struct JsonValue {
+    enum class Type : uint8_t { Null, Bool, Number, String, Array, Object };
+
+    Type Kind = Type::Null;
+    bool Bool = false;
+    double Number = 0.0;
+    std::string String;
+    std::vector<JsonValue> Elements;                        // Array
+    std::vector<std::pair<std::string, JsonValue>> Members; // Object
+
+    bool IsArray() const { return Kind == Type::Array; }
+    bool IsObject() const { return Kind == Type::Object; }
+    bool IsNumber() const { return Kind == Type::Number; }
+
+    const JsonValue* Find(const char* key) const {
+        for (const auto& member : Members) {
+            if (member.first == key) return &member.second;
+        }
+        return nullptr;
+    }
+
+    double GetNumber(const char* key, double fallback) const {
+        const JsonValue* value = Find(key);
+        return value && value->IsNumber() ? value->Number : fallback;
+    }
+
+    /**
+     * @brief Non-negative integer member (-1 if missing or not an index)
+     */
+    int64_t GetIndex(const char* key) const {
+        double value = GetNumber(key, -1.0);
+        return value >= 0.0 && value == std::floor(value) ? static_cast<int64_t>(value) : -1;
+    }
+
+    const std::string* GetString(const char* key) const {
+        const JsonValue* value = Find(key);
+        return value && value->Kind == Type::String ? &value->String : nullptr;
+    }
+};
+
+class JsonParser {
+public:
+    JsonParser(const char* begin, const char* end) : m_Cursor(begin), m_End(end) {}
+
+    bool Parse(JsonValue& value) {
+        if (!ParseValue(value, 0)) return false;
+        SkipWhitespace();
+        return m_Cursor == m_End;
+    }
+
+private:
+    static constexpr int MAX_DEPTH = 64;
+
+    void SkipWhitespace() {
+        while (m_Cursor < m_End && (*m_Cursor == ' ' || *m_Cursor == '\t' || *m_Cursor == '\n' || *m_Cursor == '\r')) {
+            ++m_Cursor;
+        }
+    }
+
+    bool Consume(const char* literal) {
+        size_t length = std::strlen(literal);
+        if (static_cast<size_t>(m_End - m_Cursor) < length || std::strncmp(m_Cursor, literal, length) != 0) {
+            return false;
+        }
+        m_Cursor += length;
+        return true;
+    }
+
+    bool ParseValue(JsonValue& value, int depth) {
+        if (depth > MAX_DEPTH) return false;
+        SkipWhitespace();
+        if (m_Cursor >= m_End) return false;
+
+        switch (*m_Cursor) {
+        case '{': return ParseObject(value, depth);
+        case '[': return ParseArray(value, depth);
+        case '"': value.Kind = JsonValue::Type::String; return ParseString(value.String);
+        case 't': value.Kind = JsonValue::Type::Bool; value.Bool = true; return Consume("true");
+        case 'f': value.Kind = JsonValue::Type::Bool; value.Bool = false; return Consume("false");
+        case 'n': value.Kind = JsonValue::Type::Null; return Consume("null");
+        default: return ParseNumber(value);
+        }
+    }
+
+    bool ParseObject(JsonValue& value, int depth) {
+        value.Kind = JsonValue::Type::Object;
+        ++m_Cursor; // '{'
+        SkipWhitespace();
+        if (m_Cursor < m_End && *m_Cursor == '}') { ++m_Cursor; return true; }
+
+        while (true) {
+            SkipWhitespace();
+            std::pair<std::string, JsonValue> member;
+            if (m_Cursor >= m_End || *m_Cursor != '"' || !ParseString(member.first)) return false;
+            SkipWhitespace();
+            if (m_Cursor >= m_End || *m_Cursor != ':') return false;
+            ++m_Cursor;
+            if (!ParseValue(member.second, depth + 1)) return false;
+            value.Members.push_back(std::move(member));
+
+            SkipWhitespace();
+            if (m_Cursor >= m_End) return false;
+            if (*m_Cursor == '}') { ++m_Cursor; return true; }
+            if (*m_Cursor != ',') return false;
+            ++m_Cursor;
+        }
+    }
+
+    bool ParseArray(JsonValue& value, int depth) {
+        value.Kind = JsonValue::Type::Array;
+        ++m_Cursor; // '['
+        SkipWhitespace();
+        if (m_Cursor < m_End && *m_Cursor == ']') { ++m_Cursor; return true; }
+
+        while (true) {
+            value.Elements.emplace_back();
+            if (!ParseValue(value.Elements.back(), depth + 1)) return false;
+
+            SkipWhitespace();
+            if (m_Cursor >= m_End) return false;
+            if (*m_Cursor == ']') { ++m_Cursor; return true; }
+            if (*m_Cursor != ',') return false;
+            ++m_Cursor;
+        }
+    }
+
+    bool ParseString(std::string& out) {
+        ++m_Cursor; // '"'
+        while (m_Cursor < m_End && *m_Cursor != '"') {
+            char c = *m_Cursor++;
+            if (c != '\\') {
+                out.push_back(c);
+                continue;
+            }
+            if (m_Cursor >= m_End) return false;
+            char escape = *m_Cursor++;
+            switch (escape) {
+            case '"': case '\\': case '/': out.push_back(escape); break;
+            case 'b': out.push_back('\b'); break;
+            case 'f': out.push_back('\f'); break;
+            case 'n': out.push_back('\n'); break;
+            case 'r': out.push_back('\r'); break;
+            case 't': out.push_back('\t'); break;
+            case 'u': {
+                // Basic multilingual plane only; encoded as UTF-8
+                if (m_End - m_Cursor < 4) return false;
+                char digits[5] = { m_Cursor[0], m_Cursor[1], m_Cursor[2], m_Cursor[3], 0 };
+                char* digitsEnd = nullptr;
+                unsigned long code = std::strtoul(digits, &digitsEnd, 16);
+                if (digitsEnd != digits + 4) return false;
+                m_Cursor += 4;
+                if (code < 0x80) {
+                    out.push_back(static_cast<char>(code));
+                } else if (code < 0x800) {
+                    out.push_back(static_cast<char>(0xC0 | (code >> 6)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                } else {
+                    out.push_back(static_cast<char>(0xE0 | (code >> 12)));
+                    out.push_back(static_cast<char>(0x80 | ((code >> 6) & 0x3F)));
+                    out.push_back(static_cast<char>(0x80 | (code & 0x3F)));
+                }
+                break;
+            }
+            default: return false;
+            }
+        }
+        if (m_Cursor >= m_End) return false;
+        ++m_Cursor; // '"'
+        return true;
+    }
+
+    bool ParseNumber(JsonValue& value) {
+        // strtod needs a terminated buffer; numbers are short
+        char buffer[64];
+        size_t length = 0;
+        while (m_Cursor + length < m_End && length < sizeof(buffer) - 1 &&
+               std::strchr("+-0123456789.eE", m_Cursor[length])) {
+            buffer[length] = m_Cursor[length];
+            ++length;
+        }
+        buffer[length] = 0;
+
+        char* end = nullptr;
+        value.Number = std::strtod(buffer, &end);
+        if (length == 0 || end != buffer + length) return false;
+        value.Kind = JsonValue::Type::Number;
+        m_Cursor += length;
+        return true;
+    }
+
+    const char* m_Cursor;
+    const char* m_End;
+};
+
+bool DecodeBase64(const char* begin, const char* end, std::vector<uint8_t>& out) {
+    auto decode = [](char c) -> int {
+        if (c >= 'A' && c <= 'Z') return c - 'A';
+        if (c >= 'a' && c <= 'z') return c - 'a' + 26;
+        if (c >= '0' && c <= '9') return c - '0' + 52;
+        if (c == '+' || c == '-') return 62;
+        if (c == '/' || c == '_') return 63;
+        return -1;
+    };
+
+    uint32_t bits = 0;
+    int bitCount = 0;
+    for (const char* p = begin; p < end && *p != '='; ++p) {
+        int value = decode(*p);
+        if (value < 0) return false;
+        bits = (bits << 6) | static_cast<uint32_t>(value);
+        bitCount += 6;
+        if (bitCount >= 8) {
+            bitCount -= 8;
+            out.push_back(static_cast<uint8_t>(bits >> bitCount));
+        }
+    }
+    return true;
+}
+
+enum GltfComponentType {
+    GLTF_BYTE = 5120,
+    GLTF_UNSIGNED_BYTE = 5121,
+    GLTF_SHORT = 5122,
+    GLTF_UNSIGNED_SHORT = 5123,
+    GLTF_UNSIGNED_INT = 5125,
+    GLTF_FLOAT = 5126
+};
+
+constexpr int GLTF_MODE_TRIANGLES = 4;
+
+uint32_t ComponentSize(int64_t componentType) {
+    switch (componentType) {
+    case GLTF_BYTE: case GLTF_UNSIGNED_BYTE: return 1;
+    case GLTF_SHORT: case GLTF_UNSIGNED_SHORT: return 2;
+    case GLTF_UNSIGNED_INT: case GLTF_FLOAT: return 4;
+    default: return 0;
+    }
+}
+
+uint32_t ComponentCount(const std::string& type) {
+    if (type == "SCALAR") return 1;
+    if (type == "VEC2") return 2;
+    if (type == "VEC3") return 3;
+    if (type == "VEC4") return 4;
+    return 0;
+}
+
+/**
+ * @brief Bounds-checked view of a glTF accessor
+ */
+struct GltfAccessor {
+    const uint8_t* Data = nullptr;
+    size_t Count = 0;
+    size_t Stride = 0;
+    int64_t ComponentType = 0;
+    uint32_t Components = 0;
+    bool Normalized = false;
+
+    /**
+     * @brief Element i as floats (normalized integers mapped to [0,1] / [-1,1])
+     */
+    void Read(size_t i, float* out) const {
+        const uint8_t* element = Data + i * Stride;
+        for (uint32_t c = 0; c < Components; ++c) {
+            const uint8_t* p = element + c * ComponentSize(ComponentType);
+            float value = 0.0f;
+            switch (ComponentType) {
+            case GLTF_FLOAT: std::memcpy(&value, p, 4); break;
+            case GLTF_BYTE: {
+                int8_t v; std::memcpy(&v, p, 1);
+                value = Normalized ? std::max(v / 127.0f, -1.0f) : v;
+                break;
+            }
+            case GLTF_UNSIGNED_BYTE: value = Normalized ? *p / 255.0f : *p; break;
+            case GLTF_SHORT: {
+                int16_t v; std::memcpy(&v, p, 2);
+                value = Normalized ? std::max(v / 32767.0f, -1.0f) : v;
+                break;
+            }
+            case GLTF_UNSIGNED_SHORT: {
+                uint16_t v; std::memcpy(&v, p, 2);
+                value = Normalized ? v / 65535.0f : v;
+                break;
+            }
+            case GLTF_UNSIGNED_INT: {
+                uint32_t v; std::memcpy(&v, p, 4);
+                value = static_cast<float>(v);
+                break;
+            }
+            }
+            out[c] = value;
+        }
+    }
+
+    uint32_t ReadIndex(size_t i) const {
+        const uint8_t* p = Data + i * Stride;
+        switch (ComponentType) {
+        case GLTF_UNSIGNED_BYTE: return *p;
+        case GLTF_UNSIGNED_SHORT: { uint16_t v; std::memcpy(&v, p, 2); return v; }
+        case GLTF_UNSIGNED_INT: { uint32_t v; std::memcpy(&v, p, 4); return v; }
+        default: return INVALID_INDEX;
+        }
+    }
+};
+
+/**
+ * @brief Parsed glTF document with its buffers loaded
+ */
+class GltfDocument {
+public:
+    bool Load(const std::string& filepath) {
+        m_Path = filepath;
+        std::vector<uint8_t> bytes;
+        if (!ReadFile(filepath, bytes)) {
+            return false;
+        }
+
+        // Binary container: 12-byte header, then a JSON chunk and an optional BIN chunk
+        const char* jsonBegin = reinterpret_cast<const char*>(bytes.data());
+        const char* jsonEnd = jsonBegin + bytes.size();
+        std::vector<uint8_t> binChunk;
+        bool hasBinChunk = false;
+        if (bytes.size() >= 12 && std::memcmp(bytes.data(), "glTF", 4) == 0) {
+            uint32_t header[3];
+            std::memcpy(header, bytes.data(), sizeof(header));
+            if (header[1] != 2 || header[2] > bytes.size()) {
+                return Fail("unsupported or truncated .glb container");
+            }
+
+            size_t offset = 12;
+            bool hasJson = false;
+            while (offset + 8 <= header[2]) {
+                uint32_t chunk[2]; // Length, type
+                std::memcpy(chunk, bytes.data() + offset, sizeof(chunk));
+                offset += 8;
+                if (chunk[0] > header[2] - offset) {
+                    return Fail("truncated .glb chunk");
+                }
+                if (chunk[1] == 0x4E4F534A && !hasJson) {        // "JSON"
+                    jsonBegin = reinterpret_cast<const char*>(bytes.data() + offset);
+                    jsonEnd = jsonBegin + chunk[0];
+                    hasJson = true;
+                } else if (chunk[1] == 0x004E4942 && !hasBinChunk) { // "BIN\0"
+                    binChunk.assign(bytes.begin() + offset, bytes.begin() + offset + chunk[0]);
+                    hasBinChunk = true;
+                }
+                offset += (chunk[0] + 3) & ~3u;
+            }
+            if (!hasJson) {
+                return Fail(".glb has no JSON chunk");
+            }
+        }
+
+        JsonParser parser(jsonBegin, jsonEnd);
+        if (!parser.Parse(m_Root) || !m_Root.IsObject()) {
+            return Fail("malformed JSON");
+        }
+
+        const JsonValue* asset = m_Root.Find("asset");
+        const std::string* version = asset ? asset->GetString("version") : nullptr;
+        if (!version || version->empty() || (*version)[0] != '2') {
+            return Fail("not a glTF 2.0 file");
+        }
+
+        // Buffers: the .glb BIN chunk, data URIs or external files
+        const JsonValue* buffers = m_Root.Find("buffers");
+        if (buffers && buffers->IsArray()) {
+            m_Buffers.resize(buffers->Elements.size());
+            for (size_t i = 0; i < buffers->Elements.size(); ++i) {
+                const JsonValue& buffer = buffers->Elements[i];
+                const std::string* uri = buffer.GetString("uri");
+                std::vector<uint8_t>& data = m_Buffers[i];
+
+                if (!uri) {
+                    if (i != 0 || !hasBinChunk) {
+                        return Fail("buffer without uri or .glb BIN chunk");
+                    }
+                    data = std::move(binChunk);
+                } else if (uri->compare(0, 5, "data:") == 0) {
+                    size_t comma = uri->find(";base64,");
+                    if (comma == std::string::npos ||
+                        !DecodeBase64(uri->data() + comma + 8, uri->data() + uri->size(), data)) {
+                        return Fail("unsupported data URI");
+                    }
+                } else if (!ReadFile(GetDirectory(filepath) + *uri, data)) {
+                    return false;
+                }
+
+                double byteLength = buffer.GetNumber("byteLength", 0.0);
+                if (byteLength > data.size()) {
+                    return Fail("buffer shorter than its byteLength");
+                }
+            }
+        }
+        return true;
+    }
+
+    const JsonValue& GetRoot() const { return m_Root; }
+
+    /**
+     * @brief Element of a top-level array ("meshes", "nodes", ...), nullptr if out of range
+     */
+    const JsonValue* GetElement(const char* array, int64_t index) const {
+        const JsonValue* values = m_Root.Find(array);
+        if (!values || !values->IsArray() || index < 0 || static_cast<size_t>(index) >= values->Elements.size()) {
+            return nullptr;
+        }
+        return &values->Elements[index];
+    }
+
+    bool GetAccessor(int64_t index, GltfAccessor& out) const {
+        const JsonValue* accessor = GetElement("accessors", index);
+        if (!accessor) return Fail("accessor index out of range");
+        if (accessor->Find("sparse")) return Fail("sparse accessors are not supported");
+
+        const std::string* type = accessor->GetString("type");
+        out.ComponentType = accessor->GetIndex("componentType");
+        out.Components = type ? ComponentCount(*type) : 0;
+        out.Count = static_cast<size_t>(std::max<int64_t>(accessor->GetIndex("count"), 0));
+        const JsonValue* normalized = accessor->Find("normalized");
+        out.Normalized = normalized && normalized->Kind == JsonValue::Type::Bool && normalized->Bool;
+
+        uint32_t componentSize = ComponentSize(out.ComponentType);
+        if (componentSize == 0 || out.Components == 0 || out.Count == 0) {
+            return Fail("unsupported accessor type");
+        }
+
+        const JsonValue* view = GetElement("bufferViews", accessor->GetIndex("bufferView"));
+        if (!view) return Fail("accessor without a valid bufferView");
+        int64_t bufferIndex = view->GetIndex("buffer");
+        if (bufferIndex < 0 || static_cast<size_t>(bufferIndex) >= m_Buffers.size()) {
+            return Fail("bufferView buffer index out of range");
+        }
+        const std::vector<uint8_t>& buffer = m_Buffers[bufferIndex];
+
+        uint64_t viewOffset = static_cast<uint64_t>(std::max<int64_t>(view->GetIndex("byteOffset"), 0));
+        uint64_t viewLength = static_cast<uint64_t>(std::max<int64_t>(view->GetIndex("byteLength"), 0));
+        uint64_t offset = static_cast<uint64_t>(std::max<int64_t>(accessor->GetIndex("byteOffset"), 0));
+        uint64_t elementSize = uint64_t(componentSize) * out.Components;
+        int64_t byteStride = view->GetIndex("byteStride");
+        out.Stride = byteStride > 0 ? static_cast<size_t>(byteStride) : static_cast<size_t>(elementSize);
+
+        uint64_t lastByte = offset + uint64_t(out.Stride) * (out.Count - 1) + elementSize;
+        if (viewOffset + viewLength > buffer.size() || lastByte > viewLength) {
+            return Fail("accessor reads past its buffer");
+        }
+        out.Data = buffer.data() + viewOffset + offset;
+        return true;
+    }
+
+    bool Fail(const char* reason) const {
+        NILOS_ERROR("Invalid glTF ", m_Path, ": ", reason);
+        return false;
+    }
+
+private:
+    std::string m_Path;
+    JsonValue m_Root;
+    std::vector<std::vector<uint8_t>> m_Buffers;
+};
+
+/**
+ * @brief Local transform of a node (matrix, or translation * rotation * scale)
+ */
+glm::mat4 GetNodeTransform(const JsonValue& node) {
+    const JsonValue* matrix = node.Find("matrix");
+    if (matrix && matrix->IsArray() && matrix->Elements.size() == 16) {
+        glm::mat4 result(1.0f);
+        for (int column = 0; column < 4; ++column) {
+            for (int row = 0; row < 4; ++row) {
+                result[column][row] = static_cast<float>(matrix->Elements[column * 4 + row].Number);
+            }
+        }
+        return result;
+    }
+
+    auto readVector = [&node](const char* key, float* out, size_t count) {
+        const JsonValue* value = node.Find(key);
+        if (value && value->IsArray() && value->Elements.size() == count) {
+            for (size_t i = 0; i < count; ++i) out[i] = static_cast<float>(value->Elements[i].Number);
+        }
+    };
+    float t[3] = { 0.0f, 0.0f, 0.0f };
+    float r[4] = { 0.0f, 0.0f, 0.0f, 1.0f }; // x, y, z, w
+    float s[3] = { 1.0f, 1.0f, 1.0f };
+    readVector("translation", t, 3);
+    readVector("rotation", r, 4);
+    readVector("scale", s, 3);
+
+    // Rotation matrix of the unit quaternion, columns scaled
+    float x = r[0], y = r[1], z = r[2], w = r[3];
+    glm::mat4 result(1.0f);
+    result[0] = glm::vec4(1.0f - 2.0f * (y * y + z * z), 2.0f * (x * y + z * w), 2.0f * (x * z - y * w), 0.0f) * s[0];
+    result[1] = glm::vec4(2.0f * (x * y - z * w), 1.0f - 2.0f * (x * x + z * z), 2.0f * (y * z + x * w), 0.0f) * s[1];
+    result[2] = glm::vec4(2.0f * (x * z + y * w), 2.0f * (y * z - x * w), 1.0f - 2.0f * (x * x + y * y), 0.0f) * s[2];
+    result[3] = glm::vec4(t[0], t[1], t[2], 1.0f);
+    return result;
+}
+
+/**
+ * @brief Appends glTF primitives to a ModelData, baking node transforms
+ */
+class GltfMeshBuilder {
+public:
+    GltfMeshBuilder(const GltfDocument& document, ModelData& model) : m_Document(document), m_Model(model) {}
+
+    bool AddMesh(int64_t meshIndex, const glm::mat4& transform) {
+        const JsonValue* mesh = m_Document.GetElement("meshes", meshIndex);
+        const JsonValue* primitives = mesh ? mesh->Find("primitives") : nullptr;
+        if (!primitives || !primitives->IsArray()) {
+            return m_Document.Fail("node references an invalid mesh");
+        }
+
+        glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(transform)));
+        for (const JsonValue& primitive : primitives->Elements) {
+            if (primitive.GetNumber("mode", GLTF_MODE_TRIANGLES) != GLTF_MODE_TRIANGLES) {
+                NILOS_WARNING("Skipping non-triangle glTF primitive");
+                continue;
+            }
+            if (!AddPrimitive(primitive, transform, normalMatrix)) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    bool AddNode(int64_t nodeIndex, const glm::mat4& parentTransform, int depth) {
+        const JsonValue* node = m_Document.GetElement("nodes", nodeIndex);
+        if (!node || depth > 64) {
+            return m_Document.Fail("invalid node hierarchy");
+        }
+
+        glm::mat4 transform = parentTransform * GetNodeTransform(*node);
+        if (node->Find("mesh") && !AddMesh(node->GetIndex("mesh"), transform)) {
+            return false;
+        }
+
+        const JsonValue* children = node->Find("children");
+        if (children && children->IsArray()) {
+            for (const JsonValue& child : children->Elements) {
+                if (!AddNode(child.IsNumber() ? static_cast<int64_t>(child.Number) : -1, transform, depth + 1)) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    void Finish() {
+        GenerateMissingNormals(m_Model, m_MissingNormals);
+    }
+
+private:
+    bool AddPrimitive(const JsonValue& primitive, const glm::mat4& transform, const glm::mat3& normalMatrix) {
+        const JsonValue* attributes = primitive.Find("attributes");
+        if (!attributes || !attributes->Find("POSITION")) {
+            return m_Document.Fail("primitive without POSITION");
+        }
+
+        GltfAccessor positions, normals, colors, texCoords;
+        if (!m_Document.GetAccessor(attributes->GetIndex("POSITION"), positions)) return false;
+        bool hasNormals = attributes->Find("NORMAL") != nullptr;
+        bool hasColors = attributes->Find("COLOR_0") != nullptr;
+        bool hasTexCoords = attributes->Find("TEXCOORD_0") != nullptr;
+        if ((hasNormals && !m_Document.GetAccessor(attributes->GetIndex("NORMAL"), normals)) ||
+            (hasColors && !m_Document.GetAccessor(attributes->GetIndex("COLOR_0"), colors)) ||
+            (hasTexCoords && !m_Document.GetAccessor(attributes->GetIndex("TEXCOORD_0"), texCoords))) {
+            return false;
+        }
+        if ((hasNormals && normals.Count != positions.Count) || (hasColors && colors.Count != positions.Count) ||
+            (hasTexCoords && texCoords.Count != positions.Count) || positions.Components != 3) {
+            return m_Document.Fail("mismatched primitive attributes");
+        }
+
+        uint32_t baseVertex = static_cast<uint32_t>(m_MissingNormals.size());
+        for (size_t i = 0; i < positions.Count; ++i) {
+            float values[4] = { 0.0f, 0.0f, 0.0f, 1.0f };
+            ImportVertex vertex;
+
+            positions.Read(i, values);
+            vertex.Position = glm::vec3(transform * glm::vec4(values[0], values[1], values[2], 1.0f));
+            if (hasNormals) {
+                normals.Read(i, values);
+                glm::vec3 normal = normalMatrix * glm::vec3(values[0], values[1], values[2]);
+                float length = glm::length(normal);
+                vertex.Normal = length > 0.0f ? normal / length : glm::vec3(0.0f, 1.0f, 0.0f);
+            }
+            if (hasColors) {
+                colors.Read(i, values);
+                vertex.Color = glm::vec3(values[0], values[1], values[2]);
+            }
+            if (hasTexCoords) {
+                // glTF puts the uv origin at the top left, the engine (like OpenGL) at the bottom left
+                texCoords.Read(i, values);
+                vertex.TexCoord = glm::vec2(values[0], 1.0f - values[1]);
+            }
+
+            AppendVertex(m_Model, vertex);
+            m_MissingNormals.push_back(hasNormals ? 0 : 1);
+        }
+
+        ModelSubMesh subMesh;
+        subMesh.FirstIndex = static_cast<uint32_t>(m_Model.Indices.size());
+        subMesh.MaterialIndex = static_cast<uint32_t>(std::max<int64_t>(primitive.GetIndex("material"), 0));
+
+        if (primitive.Find("indices")) {
+            GltfAccessor indices;
+            if (!m_Document.GetAccessor(primitive.GetIndex("indices"), indices)) return false;
+            if (indices.Components != 1) return m_Document.Fail("indices must be scalars");
+            for (size_t i = 0; i + 2 < indices.Count; i += 3) {
+                for (size_t corner = 0; corner < 3; ++corner) {
+                    uint32_t index = indices.ReadIndex(i + corner);
+                    if (index >= positions.Count) return m_Document.Fail("index out of range");
+                    m_Model.Indices.push_back(baseVertex + index);
+                }
+            }
+        } else {
+            for (size_t i = 0; i + 2 < positions.Count; i += 3) {
+                m_Model.Indices.insert(m_Model.Indices.end(), { baseVertex + uint32_t(i), baseVertex + uint32_t(i + 1),
+                                                                 baseVertex + uint32_t(i + 2) });
+            }
+        }
+
+        subMesh.IndexCount = static_cast<uint32_t>(m_Model.Indices.size()) - subMesh.FirstIndex;
+        if (subMesh.IndexCount > 0) {
+            m_Model.SubMeshes.push_back(subMesh);
+        }
+        return true;
+    }
+
+    const GltfDocument& m_Document;
+    ModelData& m_Model;
+    std::vector<uint8_t> m_MissingNormals;
+};
+
+} // namespace
+
+bool ModelLoader::ImportGLTF(const std::string& filepath, ModelData& model) {
+    GltfDocument document;
+    if (!document.Load(filepath)) {
+        return false;
+    }
+    const JsonValue& root = document.GetRoot();
+
+    // Pick the layout from what any primitive provides; normals are always
+    // present (generated when missing)
+    uint8_t mask = VertexLayout::Bit(VertexAttribute::Position) | VertexLayout::Bit(VertexAttribute::Normal);
+    const JsonValue* meshes = root.Find("meshes");
+    if (meshes && meshes->IsArray()) {
+        for (const JsonValue& mesh : meshes->Elements) {
+            const JsonValue* primitives = mesh.Find("primitives");
+            if (!primitives || !primitives->IsArray()) continue;
+            for (const JsonValue& primitive : primitives->Elements) {
+                const JsonValue* attributes = primitive.Find("attributes");
+                if (!attributes) continue;
+                if (attributes->Find("COLOR_0")) mask |= VertexLayout::Bit(VertexAttribute::Color);
+                if (attributes->Find("TEXCOORD_0")) mask |= VertexLayout::Bit(VertexAttribute::TexCoord);
+            }
+        }
+    }
+    model.Layout = VertexLayout{ mask };
+
+    GltfMeshBuilder builder(document, model);
+    const JsonValue* scene = document.GetElement("scenes", std::max<int64_t>(root.GetIndex("scene"), 0));
+    const JsonValue* sceneNodes = scene ? scene->Find("nodes") : nullptr;
+    if (sceneNodes && sceneNodes->IsArray()) {
+        for (const JsonValue& node : sceneNodes->Elements) {
+            if (!builder.AddNode(node.IsNumber() ? static_cast<int64_t>(node.Number) : -1, glm::mat4(1.0f), 0)) {
+                return false;
+            }
+        }
+    } else if (meshes && meshes->IsArray()) {
+        // No scene: meshes as authored
+        for (size_t i = 0; i < meshes->Elements.size(); ++i) {
+            if (!builder.AddMesh(static_cast<int64_t>(i), glm::mat4(1.0f))) {
+                return false;
+            }
+        }
+    }
+    builder.Finish();
+    return true;
+}
+
+} // namespace Nilos
@@ -1,36 +1,225 @@
 #include "ModelLoader.h"
+#include "CookedMesh.h"
+#include "MeshManager.h"
 #include "../Core/Logger.h"
 
-// Assimp will be included when vcpkg installation completes
-// For now, provide a stub implementation
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <fstream>
+#include <limits>
 
 namespace Nilos {
 
+namespace {
+
+std::string GetExtension(const std::string& filepath) {
+    size_t dot = filepath.find_last_of('.');
+    if (dot == std::string::npos) {
+        return "";
+    }
+    std::string extension = filepath.substr(dot);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension;
+}
+
+uint64_t AlignUp(uint64_t value, uint64_t alignment) {
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+/**
+ * @brief Bounds of the positions referenced by a range of indices
+ */
+void ComputeBounds(const ModelData& model, uint32_t firstIndex, uint32_t indexCount,
+                   float center[3], float extents[3]) {
+    size_t stride = model.Layout.GetStride();
+    size_t offset = model.Layout.GetOffset(VertexAttribute::Position);
+
+    float min[3] = { std::numeric_limits<float>::max(), std::numeric_limits<float>::max(),
+                     std::numeric_limits<float>::max() };
+    float max[3] = { -std::numeric_limits<float>::max(), -std::numeric_limits<float>::max(),
+                     -std::numeric_limits<float>::max() };
+    for (uint32_t i = firstIndex; i < firstIndex + indexCount; ++i) {
+        const float* position = &model.Vertices[model.Indices[i] * stride + offset];
+        for (int axis = 0; axis < 3; ++axis) {
+            min[axis] = std::min(min[axis], position[axis]);
+            max[axis] = std::max(max[axis], position[axis]);
+        }
+    }
+    for (int axis = 0; axis < 3; ++axis) {
+        center[axis] = (min[axis] + max[axis]) * 0.5f;
+        extents[axis] = (max[axis] - min[axis]) * 0.5f;
+    }
+}
+
+} // namespace
+
 std::vector<MeshComponent> ModelLoader::LoadModel(const std::string& filepath) {
     std::vector<MeshComponent> meshes;
-    
-    // TODO: Implement with Assimp once installed
-    NILOS_WARNING("Model loading not yet implemented (Assimp installing...)");
-    NILOS_WARNING("Requested file: ", filepath);
-    
-    // Return empty cube as placeholder
-    MeshComponent placeholder;
-    placeholder.CreateCube();
-    meshes.push_back(placeholder);
-    
+
+    if (GetExtension(filepath) == ".nmesh") {
+        for (MeshHandle handle : MeshManager::Get().LoadCooked(filepath)) {
+            MeshComponent component;
+            component.SetMesh(handle);
+            meshes.push_back(std::move(component));
+        }
+        return meshes;
+    }
+
+    // Development fallback: parse the source file now
+    ModelData model;
+    if (!Import(filepath, model)) {
+        return meshes;
+    }
+    NILOS_WARNING("Loading uncooked model ", filepath, " (cook it with NilosMeshCooker for fast loads)");
+
+    // One compacted asset per submesh
+    size_t stride = model.Layout.GetStride();
+    std::vector<uint32_t> remap(model.Vertices.size() / stride);
+    for (const ModelSubMesh& subMesh : model.SubMeshes) {
+        std::fill(remap.begin(), remap.end(), UINT32_MAX);
+        std::vector<float> vertices;
+        std::vector<uint32_t> indices;
+        indices.reserve(subMesh.IndexCount);
+
+        for (uint32_t i = subMesh.FirstIndex; i < subMesh.FirstIndex + subMesh.IndexCount; ++i) {
+            uint32_t index = model.Indices[i];
+            if (remap[index] == UINT32_MAX) {
+                remap[index] = static_cast<uint32_t>(vertices.size() / stride);
+                vertices.insert(vertices.end(), model.Vertices.begin() + index * stride,
+                                model.Vertices.begin() + (index + 1) * stride);
+            }
+            indices.push_back(remap[index]);
+        }
+
+        MeshComponent component;
+        component.SetMesh(MeshManager::Get().Create(std::move(vertices), std::move(indices), model.Layout));
+        meshes.push_back(std::move(component));
+    }
     return meshes;
 }
 
-void ModelLoader::ProcessNode(void* node, void* scene, std::vector<MeshComponent>& meshes) {
-    // TODO: Implement with Assimp
+bool ModelLoader::Import(const std::string& filepath, ModelData& model) {
+    model = ModelData();
+
+    std::string extension = GetExtension(filepath);
+    bool imported = false;
+    if (extension == ".obj") {
+        imported = ImportOBJ(filepath, model);
+    } else if (extension == ".gltf" || extension == ".glb") {
+        imported = ImportGLTF(filepath, model);
+    } else {
+        NILOS_ERROR("Unsupported model format: ", filepath);
+        return false;
+    }
+    if (!imported) {
+        return false;
+    }
+
+    if (model.Indices.empty()) {
+        NILOS_ERROR("Model has no triangles: ", filepath);
+        return false;
+    }
+
+    NILOS_INFO("Model imported: ", filepath, " (", model.Vertices.size() / model.Layout.GetStride(),
+               " vertices, ", model.Indices.size() / 3, " triangles, ", model.SubMeshes.size(), " submeshes)");
+    return true;
 }
 
-MeshComponent ModelLoader::ProcessMesh(void* mesh, void* scene) {
-    // TODO: Implement with Assimp
-    MeshComponent component;
-    component.CreateCube();
-    return component;
+bool ModelLoader::Cook(const ModelData& model, const std::string& outputPath) {
+    size_t stride = model.Layout.GetStride();
+    if (!model.Layout.Has(VertexAttribute::Position) || model.Vertices.empty() || model.Indices.empty()) {
+        NILOS_ERROR("Cannot cook a model without positions or triangles");
+        return false;
+    }
+
+    size_t vertexCount = model.Vertices.size() / stride;
+    if (vertexCount > UINT32_MAX ||
+        std::any_of(model.Indices.begin(), model.Indices.end(),
+                    [vertexCount](uint32_t index) { return index >= vertexCount; })) {
+        NILOS_ERROR("Cannot cook a model with out-of-range indices");
+        return false;
+    }
+
+    // A model without a submesh table is one submesh
+    std::vector<ModelSubMesh> subMeshes = model.SubMeshes;
+    if (subMeshes.empty()) {
+        subMeshes.push_back({ 0, static_cast<uint32_t>(model.Indices.size()), 0 });
+    }
+
+    PackedVertexFormat format = VertexPacking::ChooseFormat(model.Vertices.data(), vertexCount, model.Layout);
+    std::vector<uint8_t> vertexData;
+    VertexPacking::Encode(model.Vertices.data(), vertexCount, model.Layout, format, vertexData);
+
+    bool shortIndices = vertexCount <= 65536;
+    std::vector<uint8_t> indexData(model.Indices.size() * (shortIndices ? sizeof(uint16_t) : sizeof(uint32_t)));
+    if (shortIndices) {
+        for (size_t i = 0; i < model.Indices.size(); ++i) {
+            uint16_t index = static_cast<uint16_t>(model.Indices[i]);
+            std::memcpy(&indexData[i * sizeof(uint16_t)], &index, sizeof(index));
+        }
+    } else {
+        std::memcpy(indexData.data(), model.Indices.data(), indexData.size());
+    }
+
+    std::vector<CookedMesh::SubMesh> table;
+    for (const ModelSubMesh& subMesh : subMeshes) {
+        if (subMesh.IndexCount == 0 || subMesh.FirstIndex + uint64_t(subMesh.IndexCount) > model.Indices.size()) {
+            NILOS_ERROR("Cannot cook a model with an invalid submesh range");
+            return false;
+        }
+        CookedMesh::SubMesh entry = {};
+        entry.FirstIndex = subMesh.FirstIndex;
+        entry.IndexCount = subMesh.IndexCount;
+        entry.MaterialIndex = subMesh.MaterialIndex;
+        ComputeBounds(model, subMesh.FirstIndex, subMesh.IndexCount, entry.BoundsCenter, entry.BoundsExtents);
+        table.push_back(entry);
+    }
+
+    CookedMesh::Header header = {};
+    header.Magic = CookedMesh::MAGIC;
+    header.Version = CookedMesh::VERSION;
+    header.LayoutMask = model.Layout.Mask;
+    header.Flags = (format.HalfPositions ? CookedMesh::HalfPositions : 0u) |
+                   (format.UNormTexCoords ? CookedMesh::UNormTexCoords : 0u);
+    header.VertexStride = format.Stride;
+    header.IndexSize = shortIndices ? 2 : 4;
+    header.VertexCount = static_cast<uint32_t>(vertexCount);
+    header.IndexCount = static_cast<uint32_t>(model.Indices.size());
+    header.SubMeshCount = static_cast<uint32_t>(table.size());
+    ComputeBounds(model, 0, header.IndexCount, header.BoundsCenter, header.BoundsExtents);
+    header.SubMeshOffset = AlignUp(sizeof(header), CookedMesh::ALIGNMENT);
+    header.VertexDataOffset = AlignUp(header.SubMeshOffset + table.size() * sizeof(CookedMesh::SubMesh),
+                                      CookedMesh::ALIGNMENT);
+    header.IndexDataOffset = AlignUp(header.VertexDataOffset + vertexData.size(), CookedMesh::ALIGNMENT);
+
+    std::ofstream file(outputPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        NILOS_ERROR("Failed to open for writing: ", outputPath);
+        return false;
+    }
+
+    auto writeAt = [&file](uint64_t offset, const void* data, size_t size) {
+        static const char padding[CookedMesh::ALIGNMENT] = {};
+        uint64_t position = static_cast<uint64_t>(file.tellp());
+        file.write(padding, static_cast<std::streamsize>(offset - position));
+        file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+    };
+    writeAt(0, &header, sizeof(header));
+    writeAt(header.SubMeshOffset, table.data(), table.size() * sizeof(CookedMesh::SubMesh));
+    writeAt(header.VertexDataOffset, vertexData.data(), vertexData.size());
+    writeAt(header.IndexDataOffset, indexData.data(), indexData.size());
+
+    if (!file.good()) {
+        NILOS_ERROR("Failed to write cooked mesh: ", outputPath);
+        return false;
+    }
+
+    NILOS_INFO("Cooked mesh written: ", outputPath, " (", header.VertexCount, " vertices x ",
+               format.Stride, " bytes, ", header.IndexSize * 8, "-bit indices, ",
+               header.SubMeshCount, " submeshes)");
+    return true;
 }
 
 } // namespace Nilos
-
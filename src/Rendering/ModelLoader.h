@@ -3,44 +3,82 @@
 #include "../ECS/Component.h"
 #include <string>
 #include <vector>
-#include <memory>
 
 namespace Nilos {
 
 /**
- * @brief Simple model loader using Assimp
- * 
- * Loads OBJ and GLTF files into MeshComponent format.
- * Phase 3: Basic loading without animations.
+ * @brief Range of ModelData::Indices drawn with one material
+ */
+struct ModelSubMesh {
+    uint32_t FirstIndex = 0;
+    uint32_t IndexCount = 0;
+    uint32_t MaterialIndex = 0; // Order of the material in the source file
+};
+
+/**
+ * @brief Imported model: one interleaved vertex array shared by all submeshes
+ *
+ * Vertices are described by Layout, as in MeshComponent. Indices are
+ * absolute into Vertices.
+ */
+struct ModelData {
+    VertexLayout Layout = VertexLayout::Standard();
+    std::vector<float> Vertices;
+    std::vector<uint32_t> Indices;
+    std::vector<ModelSubMesh> SubMeshes;
+};
+
+/**
+ * @brief Model importer and cooked mesh loader
+ *
+ * Source formats (OBJ, glTF 2.0 .gltf/.glb) are imported offline with
+ * Import and written as cooked .nmesh files with Cook (tools/MeshCooker
+ * does both). At runtime LoadModel memory-maps the cooked file and uploads
+ * it without parsing (see CookedMesh.h).
+ *
+ * glTF support covers triangle primitives with POSITION, NORMAL,
+ * TEXCOORD_0 and COLOR_0, node transforms of the default scene baked into
+ * the vertices, embedded (.glb, data URIs) and external buffers. Sparse
+ * accessors, skins and morph targets are not supported.
  */
 class ModelLoader {
 public:
     /**
      * @brief Load a model from file
-     * @param filepath Path to model file (OBJ, GLTF, FBX, etc.)
-     * @return Vector of mesh components (one per submesh)
+     *
+     * Cooked files (.nmesh) are the runtime path. Source files are
+     * imported on the spot as a development fallback, with a warning.
+     *
+     * Call from the simulation thread (the one recording draws), never
+     * while the render thread prepares a frame: the MeshManager is not
+     * thread-safe. No GL calls are made; the geometry is uploaded by the
+     * next Renderer::PrepareFrame.
+     * @param filepath Path to model file (.nmesh, .obj, .gltf, .glb)
+     * @return Vector of mesh components (one per submesh), empty on error
      */
     static std::vector<MeshComponent> LoadModel(const std::string& filepath);
 
     /**
-     * @brief Load model and create entity
-     * @param filepath Path to model file
-     * @param world ECS world to create entity in
-     * @return Entity ID of created model
+     * @brief Import a source model (format picked by extension)
+     * @return False if the file cannot be read or is malformed
+     */
+    static bool Import(const std::string& filepath, ModelData& model);
+
+    /**
+     * @brief Write a model as a cooked .nmesh file
      */
-    // static Entity LoadModelAsEntity(const std::string& filepath, World* world);
+    static bool Cook(const ModelData& model, const std::string& outputPath);
 
 private:
     /**
-     * @brief Process Assimp node recursively
+     * @brief Wavefront OBJ (v/vt/vn/f, one submesh per usemtl)
      */
-    static void ProcessNode(void* node, void* scene, std::vector<MeshComponent>& meshes);
+    static bool ImportOBJ(const std::string& filepath, ModelData& model);
 
     /**
-     * @brief Convert Assimp mesh to MeshComponent
+     * @brief glTF 2.0, JSON (.gltf) or binary (.glb)
      */
-    static MeshComponent ProcessMesh(void* mesh, void* scene);
+    static bool ImportGLTF(const std::string& filepath, ModelData& model);
 };
 
 } // namespace Nilos
-
@@ -0,0 +1,163 @@
+#include "RenderThread.h"
+#include "Renderer.h"
+#include "../Core/Logger.h"
+#include "../Core/Profiler.h"
+#include "../Window/Window.h"
+
+namespace Nilos {
+
+RenderThread::~RenderThread() {
+    Shutdown();
+}
+
+void RenderThread::Initialize(Renderer* renderer, Window* window, bool threaded) {
+    Shutdown();
+    m_Renderer = renderer;
+    m_Window = window;
+    m_State = State::Idle;
+    m_Quit = false;
+
+    if (!threaded) {
+        NILOS_INFO("Rendering on the main thread");
+        return;
+    }
+
+    // A context is current on one thread at a time
+    m_Window->DetachContext();
+    m_Thread = std::thread(&RenderThread::ThreadMain, this);
+    m_ThreadId = m_Thread.get_id();
+    NILOS_INFO("Render thread started");
+}
+
+void RenderThread::Shutdown() {
+    if (m_Thread.joinable()) {
+        {
+            std::lock_guard<std::mutex> lock(m_Mutex);
+            m_Quit = true;
+        }
+        m_WakeRender.notify_one();
+        m_Thread.join();
+        m_ThreadId = std::thread::id();
+
+        // GL objects are destroyed on the shutting down thread
+        m_Window->MakeContextCurrent();
+        NILOS_INFO("Render thread stopped");
+    }
+    m_Renderer = nullptr;
+    m_Window = nullptr;
+}
+
+bool RenderThread::IsRenderThread() const {
+    return !m_Thread.joinable() || std::this_thread::get_id() == m_ThreadId;
+}
+
+void RenderThread::Submit() {
+    if (!m_Renderer) {
+        return;
+    }
+
+    if (!m_Thread.joinable()) {
+        m_Renderer->SwapCommandLists();
+        m_Renderer->PrepareFrame();
+        ExecuteFrame();
+        return;
+    }
+
+    NILOS_PROFILE_SCOPE("RenderSync");
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_WakeSubmitter.wait(lock, [this] { return m_State == State::Idle; });
+
+    // Neither thread touches the renderer until the render thread picks this up
+    m_Renderer->SwapCommandLists();
+    m_State = State::Preparing;
+    m_WakeRender.notify_one();
+
+    // Uploads read simulation state (meshes, texture streams): wait for them
+    m_WakeSubmitter.wait(lock, [this] { return m_State != State::Preparing; });
+}
+
+void RenderThread::WaitIdle() {
+    if (!m_Thread.joinable()) {
+        return;
+    }
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_WakeSubmitter.wait(lock, [this] { return m_State == State::Idle; });
+}
+
+void RenderThread::Invoke(const Task& task) {
+    if (IsRenderThread()) {
+        task();
+        return;
+    }
+
+    PendingTask pending = { &task, false };
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    m_Tasks.push_back(&pending);
+    m_WakeRender.notify_one();
+    m_WakeSubmitter.wait(lock, [&pending] { return pending.Done; });
+}
+
+void RenderThread::RunTasks(std::unique_lock<std::mutex>& lock) {
+    while (!m_Tasks.empty()) {
+        PendingTask* pending = m_Tasks.front();
+        m_Tasks.erase(m_Tasks.begin());
+
+        // The caller is blocked in Invoke until Done, so its data stays put
+        lock.unlock();
+        (*pending->Function)();
+        lock.lock();
+
+        pending->Done = true;
+        m_WakeSubmitter.notify_all();
+    }
+}
+
+void RenderThread::ThreadMain() {
+    m_Window->MakeContextCurrent();
+    Profiler::Get().SetThreadName("Render");
+
+    std::unique_lock<std::mutex> lock(m_Mutex);
+    while (true) {
+        m_WakeRender.wait(lock, [this] { return m_Quit || m_State == State::Preparing || !m_Tasks.empty(); });
+        RunTasks(lock);
+
+        if (m_State == State::Preparing) {
+            // The submitter is blocked until the state changes
+            lock.unlock();
+            m_Renderer->PrepareFrame();
+            lock.lock();
+            m_State = State::Executing;
+            m_WakeSubmitter.notify_all();
+
+            lock.unlock();
+            ExecuteFrame();
+            lock.lock();
+            m_State = State::Idle;
+            m_WakeSubmitter.notify_all();
+            continue;
+        }
+
+        if (m_Quit) {
+            break;
+        }
+    }
+    RunTasks(lock);
+    lock.unlock();
+
+    m_Window->DetachContext();
+}
+
+void RenderThread::ExecuteFrame() {
+    Profiler::Get().BeginGpuFrame();
+    {
+        NILOS_PROFILE_SCOPE("RenderExecute");
+        m_Renderer->ExecuteFrame();
+    }
+    Profiler::Get().EndGpuFrame();
+
+    // Waits for vsync or a busy GPU
+    NILOS_PROFILE_SCOPE("SwapBuffers");
+    m_Window->SwapBuffers();
+}
+
+} // namespace Nilos
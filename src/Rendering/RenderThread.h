@@ -0,0 +1,136 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace Nilos {
+
+class Renderer;
+class Window;
+
+/**
+ * @brief Runs the renderer's GL work on a thread of its own
+ *
+ * The thread owns the window's GL context. Each frame the simulation
+ * records a command list (Renderer::BeginFrame/RenderMesh/EndFrame) and
+ * calls Submit, the one sync point between the two threads:
+ *
+ *   simulation   | record N |Submit|     record N+1      |Submit| ...
+ *   render                   |prep N| execute N + swap |    |prep N+1| ...
+ *
+ * Submit waits until frame N-1 has been executed and swapped, hands the
+ * recorded list over and waits while the render thread runs
+ * Renderer::PrepareFrame (the uploads that need both GL and simulation
+ * state), then returns; drawing and SwapBuffers overlap the next frame's
+ * simulation. The render thread is never more than one frame behind, so
+ * with VSync the swap paces both threads to the display and without it
+ * the slower of the two sets the frame rate.
+ *
+ * GL calls on other threads are not allowed while the thread runs. Code
+ * that must create or destroy GL objects at runtime (e.g. TextureManager)
+ * goes through Invoke, which runs it on the render thread and waits.
+ *
+ * Without a thread (Initialize with threaded = false, or before Initialize)
+ * Submit renders inline and Invoke runs the task directly, so tools and
+ * single-threaded configurations work unchanged.
+ *
+ * Usage:
+ *   RenderThread::Get().Initialize(renderer, window, true);  // On the context's thread
+ *   renderer->BeginFrame(camera, cameraTransform);
+ *   renderer->RenderMesh(mesh, transform);
+ *   renderer->EndFrame();
+ *   RenderThread::Get().Submit();
+ */
+class RenderThread {
+public:
+    using Task = std::function<void()>;
+
+    static RenderThread& Get() {
+        static RenderThread instance;
+        return instance;
+    }
+
+    ~RenderThread();
+
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+
+    /**
+     * @brief Attach the renderer and window (call on the thread the context is current on)
+     * @param threaded Start the render thread and hand it the context; false renders inline
+     */
+    void Initialize(Renderer* renderer, Window* window, bool threaded);
+
+    /**
+     * @brief Finish the frame in flight, stop the thread and make the context current on the caller again
+     */
+    void Shutdown();
+
+    /**
+     * @brief Whether frames execute on the render thread
+     */
+    bool IsThreaded() const { return m_Thread.joinable(); }
+
+    /**
+     * @brief Whether the calling thread may issue GL calls right now
+     */
+    bool IsRenderThread() const;
+
+    /**
+     * @brief Hand the recorded frame to the GL thread (the sync point)
+     */
+    void Submit();
+
+    /**
+     * @brief Block until the frame in flight has been executed and swapped
+     */
+    void WaitIdle();
+
+    /**
+     * @brief Run a task on the GL thread and wait for it
+     *
+     * The task runs between frames, so the calling thread's data is safe
+     * to touch from it. Runs inline when called on the GL thread.
+     */
+    void Invoke(const Task& task);
+
+private:
+    RenderThread() = default;
+
+    enum class State {
+        Idle,       // Waiting for a frame
+        Preparing,  // PrepareFrame, the simulation waits
+        Executing   // Drawing and swapping, the simulation runs
+    };
+
+    void ThreadMain();
+
+    /**
+     * @brief Run queued tasks (render thread, lock held on entry and exit)
+     */
+    void RunTasks(std::unique_lock<std::mutex>& lock);
+
+    void ExecuteFrame();
+
+    Renderer* m_Renderer = nullptr;
+    Window* m_Window = nullptr;
+
+    std::thread m_Thread;
+    std::thread::id m_ThreadId;
+    std::mutex m_Mutex;
+    std::condition_variable m_WakeRender;     // Frame submitted, task queued or quit
+    std::condition_variable m_WakeSubmitter;  // State changed or task finished
+    State m_State = State::Idle;
+    bool m_Quit = false;
+
+    struct PendingTask {
+        const Task* Function;
+        bool Done;
+    };
+    std::vector<PendingTask*> m_Tasks;
+};
+
+} // namespace Nilos
@@ -1,11 +1,26 @@
 #include "Renderer.h"
+#include "Texture.h"
 #include "../Core/Logger.h"
+#include "../Core/Profiler.h"
 
 #include <glad/glad.h>
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
 
 namespace Nilos {
 
+namespace {
+
+constexpr UniformName U_MATERIAL_DIFFUSE("uMaterialDiffuse");
+constexpr UniformName U_MATERIAL_SPECULAR("uMaterialSpecular");
+constexpr UniformName U_MATERIAL_SHININESS("uMaterialShininess");
+constexpr UniformName U_USE_DIFFUSE_MAP("uUseDiffuseMap");
+constexpr UniformName U_DIFFUSE_MAP("uDiffuseMap");
+
+} // namespace
+
 Renderer::~Renderer() {
     Shutdown();
 }
@@ -31,6 +46,32 @@ bool Renderer::Initialize() {
     m_AmbientLight.Color = glm::vec3(0.15f, 0.2f, 0.25f);
     m_AmbientLight.Intensity = 0.3f;
 
+    m_PhongShader->BindUniformBlock("FrameData", FRAME_DATA_BINDING);
+    m_Shaders = { m_PhongShader.get() };
+
+    // Per-frame camera/light block, written in ExecuteFrame
+    glGenBuffers(1, &m_FrameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, m_FrameUBO);
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(FrameUniforms), nullptr, GL_DYNAMIC_DRAW);
+    glBindBufferBase(GL_UNIFORM_BUFFER, FRAME_DATA_BINDING, m_FrameUBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // Material 0: the default every mesh used before materials existed
+    m_Materials.clear();
+    Material defaultMaterial;
+    defaultMaterial.Diffuse = glm::vec3(1.0f);
+    defaultMaterial.Specular = glm::vec3(0.3f);
+    defaultMaterial.Shininess = 32.0f;
+    m_Materials.push_back(defaultMaterial);
+
+    // Values of vertex attributes a mesh layout leaves out
+    glVertexAttrib3f(1, 0.0f, 1.0f, 0.0f); // Normal
+    glVertexAttrib3f(2, 1.0f, 1.0f, 1.0f); // Color
+    glVertexAttrib2f(3, 0.0f, 0.0f);       // TexCoord
+
+    // Instance buffer shared by all geometry (grown in DrawPackets)
+    glGenBuffers(1, &m_InstanceVBO);
+
     NILOS_INFO("Renderer initialized successfully");
     return true;
 }
@@ -40,12 +81,112 @@ void Renderer::Shutdown() {
         m_PhongShader->Delete();
         m_PhongShader.reset();
     }
+    m_Shaders.clear();
+    for (CommandList& list : m_Lists) {
+        list = CommandList();
+    }
+
+    // Mesh arenas are GL objects and must go before the context does
+    MeshManager::Get().Clear();
+
+    if (m_InstanceVBO) {
+        glDeleteBuffers(1, &m_InstanceVBO);
+        m_InstanceVBO = 0;
+        m_InstanceCapacity = 0;
+    }
+
+    if (m_FrameUBO) {
+        glDeleteBuffers(1, &m_FrameUBO);
+        m_FrameUBO = 0;
+    }
     NILOS_INFO("Renderer shutdown");
 }
 
-void Renderer::BeginFrame() {
+void Renderer::BeginFrame(const CameraComponent& camera, const TransformComponent& cameraTransform) {
+    m_ViewPosition = cameraTransform.Position;
+    m_ViewForward = camera.Front;
+    m_FarPlane = camera.Far;
+
+    // Everything that is constant for the frame, uploaded in one go when it executes
+    CommandList& list = m_Lists[m_RecordList];
+    list.Recorded = true;
+    list.ClearColor = m_ClearColor;
+    list.ViewportWidth = m_ViewportWidth;
+    list.ViewportHeight = m_ViewportHeight;
+
+    FrameUniforms& frame = list.Frame;
+    frame = {};
+    frame.View = camera.GetViewMatrix(cameraTransform.Position);
+    frame.Projection = camera.ProjectionMatrix;
+    frame.LightDir = m_DirectionalLight.Direction;
+    frame.LightIntensity = m_DirectionalLight.Intensity;
+    frame.LightColor = m_DirectionalLight.Color;
+    frame.AmbientLight = m_AmbientLight.Color * m_AmbientLight.Intensity;
+    frame.ViewPos = cameraTransform.Position;
+}
+
+void Renderer::EndFrame() {
+    // Materials may be edited through GetMaterial while the frame executes
+    m_Lists[m_RecordList].Materials = m_Materials;
+}
+
+void Renderer::SwapCommandLists() {
+    m_RecordList ^= 1;
+
+    // Keep capacity for the next frame
+    CommandList& list = m_Lists[m_RecordList];
+    list.Recorded = false;
+    list.Packets.clear();
+    list.Instances.clear();
+    list.PendingMeshes.clear();
+}
+
+void Renderer::PrepareFrame() {
+    // Finish streamed texture uploads within this frame's budget
+    TextureManager::Get().Update();
+
+    // Cooked meshes loaded by the simulation since the last frame
+    MeshManager::Get().UploadStaged();
+
+    CommandList& list = m_Lists[m_RecordList ^ 1];
+    if (list.PendingMeshes.empty()) {
+        return;
+    }
+
+    // First draw of these meshes: upload them now that GL is available
+    MeshManager& meshes = MeshManager::Get();
+    bool dropped = false;
+    for (const PendingMesh& pending : list.PendingMeshes) {
+        DrawPacket& packet = list.Packets[pending.Packet];
+        if (!meshes.MakeResident(pending.Mesh) || !SetGeometry(packet, *meshes.GetMesh(pending.Mesh))) {
+            packet.IndexCount = 0;
+            dropped = true;
+        }
+    }
+    list.PendingMeshes.clear();
+
+    if (dropped) {
+        list.Packets.erase(std::remove_if(list.Packets.begin(), list.Packets.end(),
+                                          [](const DrawPacket& packet) { return packet.IndexCount == 0; }),
+                           list.Packets.end());
+    }
+}
+
+void Renderer::ExecuteFrame() {
+    CommandList& list = m_Lists[m_RecordList ^ 1];
+    if (!list.Recorded) {
+        m_DrawCallCount.store(0, std::memory_order_relaxed);
+        m_StateChangeCount.store(0, std::memory_order_relaxed);
+        return;
+    }
+    NILOS_PROFILE_GPU_SCOPE("Scene");
+
+    if (list.ViewportWidth > 0 && list.ViewportHeight > 0) {
+        glViewport(0, 0, static_cast<GLsizei>(list.ViewportWidth), static_cast<GLsizei>(list.ViewportHeight));
+    }
+
     // Clear both color and depth buffers
-    glClearColor(m_ClearColor.r, m_ClearColor.g, m_ClearColor.b, m_ClearColor.a);
+    glClearColor(list.ClearColor.r, list.ClearColor.g, list.ClearColor.b, list.ClearColor.a);
     glClearDepth(1.0); // Clear depth to far plane
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     
@@ -59,106 +200,211 @@ void Renderer::BeginFrame() {
     
     // Disable blending (opaque rendering)
     glDisable(GL_BLEND);
+
+    glBindBuffer(GL_UNIFORM_BUFFER, m_FrameUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(FrameUniforms), &list.Frame);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    DrawPackets(list);
 }
 
-void Renderer::EndFrame() {
-    // Nothing to do here for now
-    // Future: flush render queue, finalize post-processing, etc.
-}
-
-void Renderer::RenderMesh(MeshComponent& mesh, 
-                          const TransformComponent& transform,
-                          const CameraComponent& camera,
-                          const TransformComponent& cameraTransform) {
-    // Initialize mesh buffers if not done yet
-    if (!mesh.IsInitialized()) {
-        InitializeMeshBuffers(mesh);
-    }
-
-    // Use shader
-    m_PhongShader->Use();
-
-    // Set matrices
-    glm::mat4 model = transform.GetModelMatrix();
-    glm::mat4 view = camera.GetViewMatrix(cameraTransform.Position);
-    glm::mat4 projection = camera.ProjectionMatrix;
-    glm::mat3 normalMatrix = glm::transpose(glm::inverse(glm::mat3(model)));
-
-    m_PhongShader->SetMat4("uModel", model);
-    m_PhongShader->SetMat4("uView", view);
-    m_PhongShader->SetMat4("uProjection", projection);
-    m_PhongShader->SetMat3("uNormalMatrix", normalMatrix);
-
-    // Set material (simple default)
-    m_PhongShader->SetVec3("uMaterialDiffuse", glm::vec3(1.0f));
-    m_PhongShader->SetVec3("uMaterialSpecular", glm::vec3(0.3f));
-    m_PhongShader->SetFloat("uMaterialShininess", 32.0f);
-    m_PhongShader->SetInt("uUseDiffuseMap", 0);
-
-    // Set lighting
-    m_PhongShader->SetVec3("uLightDir", m_DirectionalLight.Direction);
-    m_PhongShader->SetVec3("uLightColor", m_DirectionalLight.Color);
-    m_PhongShader->SetFloat("uLightIntensity", m_DirectionalLight.Intensity);
-    m_PhongShader->SetVec3("uAmbientLight", m_AmbientLight.Color * m_AmbientLight.Intensity);
-    m_PhongShader->SetVec3("uViewPos", cameraTransform.Position);
-
-    // Bind VAO and draw
-    glBindVertexArray(mesh.VAO);
-    glDrawElements(GL_TRIANGLES, static_cast<GLsizei>(mesh.Indices.size()), GL_UNSIGNED_INT, 0);
+void Renderer::DrawPackets(CommandList& list) {
+    uint32_t drawCalls = 0;
+    uint32_t stateChanges = 0;
+    std::vector<DrawPacket>& packets = list.Packets;
+
+    if (!packets.empty()) {
+        // Sort by shader, material, arena, mesh, then front to back
+        std::sort(packets.begin(), packets.end(),
+                  [](const DrawPacket& a, const DrawPacket& b) { return a.SortKey < b.SortKey; });
+
+        // Lay the instances out in draw order so every batch is a contiguous slice
+        m_SortedInstances.clear();
+        for (const DrawPacket& packet : packets) {
+            m_SortedInstances.push_back(list.Instances[packet.Instance]);
+        }
+
+        // Orphan the instance buffer (growing it if needed) so the driver does
+        // not stall on last frame's draws, then upload everything at once
+        glBindBuffer(GL_ARRAY_BUFFER, m_InstanceVBO);
+        if (m_SortedInstances.size() > m_InstanceCapacity) {
+            m_InstanceCapacity = std::max(m_SortedInstances.size(), m_InstanceCapacity * 2);
+        }
+        glBufferData(GL_ARRAY_BUFFER, m_InstanceCapacity * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, m_SortedInstances.size() * sizeof(InstanceData),
+                        m_SortedInstances.data());
+    }
+
+    uint32_t boundShader = UINT32_MAX;
+    uint32_t boundMaterial = UINT32_MAX;
+    uint32_t boundArena = UINT32_MAX;
+
+    size_t first = 0;
+    while (first < packets.size()) {
+        // A batch is the run of packets that differ only in depth
+        uint64_t state = packets[first].SortKey & ~SORT_DEPTH_MASK;
+        size_t last = first + 1;
+        while (last < packets.size() && (packets[last].SortKey & ~SORT_DEPTH_MASK) == state) {
+            ++last;
+        }
+
+        uint32_t shaderIndex = static_cast<uint32_t>(state >> SORT_SHADER_SHIFT);
+        uint32_t materialId = static_cast<uint32_t>((state >> SORT_MATERIAL_SHIFT) & SORT_MATERIAL_MASK);
+        uint32_t arenaIndex = static_cast<uint32_t>((state >> SORT_ARENA_SHIFT) & SORT_ARENA_MASK);
+        Shader& shader = *m_Shaders[shaderIndex];
+        const DrawPacket& mesh = packets[first];
+
+        // Only touch state that differs from the previous batch
+        if (shaderIndex != boundShader) {
+            shader.Use(); // Camera and lights come from the frame UBO
+            boundShader = shaderIndex;
+            boundMaterial = UINT32_MAX; // Material uniforms live in the program
+            ++stateChanges;
+        }
+        if (materialId != boundMaterial) {
+            BindMaterial(shader, list.Materials[materialId]);
+            boundMaterial = materialId;
+            ++stateChanges;
+        }
+        if (arenaIndex != boundArena) {
+            glBindVertexArray(mesh.VAO);
+            // Arena VAOs only describe the mesh attributes; this buffer
+            // feeds the per-instance ones
+            for (uint32_t location = 4; location <= 8; ++location) {
+                glEnableVertexAttribArray(location);
+                glVertexAttribDivisor(location, 1);
+            }
+            boundArena = arenaIndex;
+            ++stateChanges;
+        }
+
+        // GL 3.3 has no base instance, so point the instance attributes
+        // at this batch's slice of the buffer
+        size_t base = first * sizeof(InstanceData);
+        size_t stride = sizeof(InstanceData);
+        for (uint32_t column = 0; column < 4; ++column) {
+            glVertexAttribPointer(4 + column, 4, GL_FLOAT, GL_FALSE, stride,
+                                  (void*)(base + column * sizeof(glm::vec4)));
+        }
+        glVertexAttribPointer(8, 4, GL_FLOAT, GL_FALSE, stride,
+                              (void*)(base + offsetof(InstanceData, Color)));
+
+        glDrawElementsInstancedBaseVertex(GL_TRIANGLES, static_cast<GLsizei>(mesh.IndexCount), mesh.IndexType,
+                                          (void*)mesh.IndexOffset, static_cast<GLsizei>(last - first),
+                                          mesh.BaseVertex);
+        ++drawCalls;
+
+        first = last;
+    }
+
     glBindVertexArray(0);
-}
 
-void Renderer::SetClearColor(float r, float g, float b, float a) {
-    m_ClearColor = glm::vec4(r, g, b, a);
+    m_DrawCallCount.store(drawCalls, std::memory_order_relaxed);
+    m_StateChangeCount.store(stateChanges, std::memory_order_relaxed);
 }
 
-void Renderer::InitializeMeshBuffers(MeshComponent& mesh) {
-    // Generate buffers
-    glGenVertexArrays(1, &mesh.VAO);
-    glGenBuffers(1, &mesh.VBO);
-    glGenBuffers(1, &mesh.EBO);
+void Renderer::BindMaterial(Shader& shader, const Material& material) {
+    shader.SetVec3(U_MATERIAL_DIFFUSE, material.Diffuse);
+    shader.SetVec3(U_MATERIAL_SPECULAR, material.Specular);
+    shader.SetFloat(U_MATERIAL_SHININESS, material.Shininess);
+    shader.SetInt(U_USE_DIFFUSE_MAP, material.HasDiffuseMap() ? 1 : 0);
 
-    // Bind VAO
-    glBindVertexArray(mesh.VAO);
+    if (material.HasDiffuseMap()) {
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, material.DiffuseMap);
+        shader.SetInt(U_DIFFUSE_MAP, 0);
+    }
+}
 
-    // Upload vertex data
-    glBindBuffer(GL_ARRAY_BUFFER, mesh.VBO);
-    glBufferData(GL_ARRAY_BUFFER, 
-                 mesh.Vertices.size() * sizeof(float), 
-                 mesh.Vertices.data(), 
-                 GL_STATIC_DRAW);
+void Renderer::RenderMesh(MeshComponent& mesh, const TransformComponent& transform) {
+    const MeshAsset* asset = RegisterMesh(mesh);
+    if (!asset) {
+        return;
+    }
 
-    // Upload index data
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.EBO);
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, 
-                 mesh.Indices.size() * sizeof(uint32_t), 
-                 mesh.Indices.data(), 
-                 GL_STATIC_DRAW);
+    // Unknown materials fall back to the default
+    uint32_t materialId = mesh.MaterialID < m_Materials.size() ? mesh.MaterialID : 0;
+
+    // View depth of the object's origin, quantized to the low 20 bits
+    float depth = glm::dot(transform.GetWorldPosition() - m_ViewPosition, m_ViewForward) / m_FarPlane;
+    uint64_t depthBits = static_cast<uint64_t>(glm::clamp(depth, 0.0f, 1.0f) * static_cast<float>(SORT_DEPTH_MASK));
+
+    CommandList& list = m_Lists[m_RecordList];
+
+    // Arena bits are filled in with the geometry
+    DrawPacket packet = {};
+    packet.SortKey = (uint64_t(0) << SORT_SHADER_SHIFT) |
+                     ((uint64_t(materialId) & SORT_MATERIAL_MASK) << SORT_MATERIAL_SHIFT) |
+                     ((uint64_t(mesh.Mesh) & SORT_MESH_MASK) << SORT_MESH_SHIFT) |
+                     depthBits;
+    packet.Instance = static_cast<uint32_t>(list.Instances.size());
+
+    if (asset->Resident) {
+        if (!SetGeometry(packet, *asset)) {
+            return;
+        }
+    } else {
+        list.PendingMeshes.push_back({ static_cast<uint32_t>(list.Packets.size()), mesh.Mesh });
+    }
 
-    // Vertex format: Position(3) + Normal(3) + Color(3) + TexCoord(2) = 11 floats
-    size_t stride = 11 * sizeof(float);
+    list.Instances.push_back({ transform.WorldMatrix, glm::vec4(mesh.Color, 1.0f) });
+    list.Packets.push_back(packet);
+}
 
-    // Position (location = 0)
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, stride, (void*)0);
-    glEnableVertexAttribArray(0);
+uint32_t Renderer::CreateMaterial(const Material& material) {
+    if (m_Materials.size() > SORT_MATERIAL_MASK) {
+        NILOS_ERROR("Material limit reached (", SORT_MATERIAL_MASK + 1, ")");
+        return 0;
+    }
+    m_Materials.push_back(material);
+    return static_cast<uint32_t>(m_Materials.size() - 1);
+}
 
-    // Normal (location = 1)
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, stride, (void*)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+Material* Renderer::GetMaterial(uint32_t id) {
+    return id < m_Materials.size() ? &m_Materials[id] : nullptr;
+}
 
-    // Color (location = 2)
-    glVertexAttribPointer(2, 3, GL_FLOAT, GL_FALSE, stride, (void*)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+void Renderer::SetClearColor(float r, float g, float b, float a) {
+    m_ClearColor = glm::vec4(r, g, b, a);
+}
 
-    // TexCoord (location = 3)
-    glVertexAttribPointer(3, 2, GL_FLOAT, GL_FALSE, stride, (void*)(9 * sizeof(float)));
-    glEnableVertexAttribArray(3);
+void Renderer::SetViewport(uint32_t width, uint32_t height) {
+    m_ViewportWidth = width;
+    m_ViewportHeight = height;
+}
 
-    // Unbind
-    glBindVertexArray(0);
+const MeshAsset* Renderer::RegisterMesh(MeshComponent& mesh) {
+    MeshManager& meshes = MeshManager::Get();
+
+    // Inline geometry becomes a shared asset (identical data dedups to one)
+    if (!meshes.IsValid(mesh.Mesh)) {
+        if (mesh.Vertices.empty()) {
+            return nullptr;
+        }
+        if (mesh.KeepCPUData) {
+            mesh.Mesh = meshes.Create(mesh.Vertices, mesh.Indices, mesh.Layout, true);
+        } else {
+            mesh.Mesh = meshes.Create(std::move(mesh.Vertices), std::move(mesh.Indices), mesh.Layout);
+            mesh.Vertices.clear();
+            mesh.Indices.clear();
+        }
+    }
+    return meshes.GetMesh(mesh.Mesh);
+}
 
-    NILOS_DEBUG("Mesh buffers initialized (VAO: ", mesh.VAO, ")");
+bool Renderer::SetGeometry(DrawPacket& packet, const MeshAsset& asset) {
+    // The arena index must fit its sort key field
+    if (asset.Arena > SORT_ARENA_MASK) {
+        NILOS_ERROR("Mesh arena limit reached (", SORT_ARENA_MASK + 1, "), mesh not drawn");
+        return false;
+    }
+    packet.SortKey |= (uint64_t(asset.Arena) & SORT_ARENA_MASK) << SORT_ARENA_SHIFT;
+    packet.VAO = MeshManager::Get().GetArena(asset.Arena).VAO;
+    packet.IndexCount = asset.IndexCount;
+    packet.IndexType = asset.IndexType;
+    packet.IndexOffset = asset.IndexOffset;
+    packet.BaseVertex = asset.BaseVertex;
+    return asset.IndexCount > 0;
 }
 
 } // namespace Nilos
-
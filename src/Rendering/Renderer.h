@@ -3,7 +3,11 @@
 #include "../ECS/Component.h"
 #include "Shader.h"
 #include "Light.h"
+#include "Material.h"
+#include "MeshManager.h"
+#include <atomic>
 #include <memory>
+#include <vector>
 
 namespace Nilos {
 
@@ -15,12 +19,33 @@ namespace Nilos {
  * - Uploads mesh data to GPU
  * - Renders entities with mesh components
  * - Handles render state
+ *
+ * Geometry lives in the MeshManager's shared arenas, so meshes with the
+ * same vertex format share one VAO. RenderMesh only queues a draw packet
+ * with a 64-bit sort key:
+ *
+ *   [63..60 shader][59..48 material][47..40 arena][39..20 mesh][19..0 depth]
+ *
+ * EndFrame sorts the packets, merges runs with the same shader, material and
+ * mesh into one glDrawElementsInstancedBaseVertex (instances front to back)
+ * and only rebinds state that actually changes between batches, so 10k
+ * crates cost one draw call and one shader/material setup instead of 10k,
+ * and switching between meshes of one arena costs no VAO bind.
+ *
+ * Camera and lighting live in a std140 uniform buffer (FrameData, binding
+ * FRAME_DATA_BINDING) written once per frame and shared by every shader.
+ *
+ * THREADING:
+ * BeginFrame, RenderMesh and EndFrame only record into a command list
+ * (camera, lights, draw packets, instances) and never call GL, so the
+ * simulation can run them while the GL thread still draws the previous
+ * frame. Two lists alternate: at the sync point (RenderThread::Submit)
+ * SwapCommandLists hands the recorded one over, PrepareFrame runs the GL
+ * uploads the recording deferred (meshes drawn for the first time,
+ * streamed textures) while the simulation waits, and ExecuteFrame draws.
  * 
  * Future enhancements:
- * - Render queue sorting (by material, distance, etc.)
  * - Multi-pass rendering (shadows, post-processing)
- * - Instanced rendering
- * - Frustum culling
  */
 class Renderer {
 public:
@@ -38,22 +63,49 @@ public:
     void Shutdown();
 
     /**
-     * @brief Begin a new frame
+     * @brief Begin recording a frame seen through camera
+     *
+     * Records the camera and current lights; the framebuffer is cleared
+     * when the frame executes.
      */
-    void BeginFrame();
+    void BeginFrame(const CameraComponent& camera, const TransformComponent& cameraTransform);
 
     /**
-     * @brief End the current frame
+     * @brief Finish recording (snapshots the materials the frame draws with)
      */
     void EndFrame();
 
     /**
-     * @brief Render a mesh with transform and camera
+     * @brief Queue a draw packet for the mesh, drawn sorted when the frame executes
+     *
+     * Inline Vertices/Indices are registered with the MeshManager first;
+     * the upload of a mesh drawn for the first time waits for PrepareFrame.
+     * Depth is measured from the BeginFrame camera. Draws with the cached
+     * transform.WorldMatrix (see TransformHierarchy).
      */
-    void RenderMesh(MeshComponent& mesh, 
-                    const TransformComponent& transform,
-                    const CameraComponent& camera,
-                    const TransformComponent& cameraTransform);
+    void RenderMesh(MeshComponent& mesh, const TransformComponent& transform);
+
+    /**
+     * @brief Make the recorded frame the one to execute and start recording a fresh one
+     *
+     * Only at the sync point, while neither thread touches the renderer.
+     */
+    void SwapCommandLists();
+
+    /**
+     * @brief GL uploads the recorded frame needs (GL thread, simulation waiting)
+     */
+    void PrepareFrame();
+
+    /**
+     * @brief Clear the framebuffer and draw the frame handed over by SwapCommandLists (GL thread)
+     */
+    void ExecuteFrame();
+
+    /**
+     * @brief Viewport size in pixels, applied from the next recorded frame
+     */
+    void SetViewport(uint32_t width, uint32_t height);
 
     /**
      * @brief Set clear color
@@ -70,14 +122,153 @@ public:
      */
     void SetAmbientLight(const AmbientLight& light) { m_AmbientLight = light; }
 
+    /**
+     * @brief Register a material for MeshComponent::MaterialID
+     * @return Material ID (0 is the built-in default material)
+     */
+    uint32_t CreateMaterial(const Material& material);
+
+    /**
+     * @brief Get a material by ID (nullptr if unknown)
+     */
+    Material* GetMaterial(uint32_t id);
+
+    /**
+     * @brief Draw calls issued by the last ExecuteFrame
+     */
+    uint32_t GetDrawCallCount() const { return m_DrawCallCount.load(std::memory_order_relaxed); }
+
+    /**
+     * @brief Shader, material and arena VAO binds issued by the last ExecuteFrame
+     */
+    uint32_t GetStateChangeCount() const { return m_StateChangeCount.load(std::memory_order_relaxed); }
+
 private:
     /**
-     * @brief Initialize mesh buffers (VAO, VBO, EBO)
+     * @brief Per-instance vertex data (attribute locations 4-7 model, 8 color)
      */
-    void InitializeMeshBuffers(MeshComponent& mesh);
+    struct InstanceData {
+        glm::mat4 Model;
+        glm::vec4 Color;
+    };
+
+    /**
+     * @brief Per-frame uniform block, std140 layout (matches FrameData in phong.vert/.frag)
+     */
+    struct FrameUniforms {
+        glm::mat4 View;
+        glm::mat4 Projection;
+        glm::vec3 LightDir;
+        float LightIntensity;
+        glm::vec3 LightColor;
+        float Padding0;
+        glm::vec3 AmbientLight;
+        float Padding1;
+        glm::vec3 ViewPos;
+        float Padding2;
+    };
+    static_assert(sizeof(FrameUniforms) == 192, "FrameUniforms must match the std140 FrameData block");
+
+    static constexpr uint32_t FRAME_DATA_BINDING = 0;
+
+    /**
+     * @brief One queued mesh instance, with the geometry it draws
+     *
+     * The mesh's placement is copied in while recording (or in PrepareFrame
+     * for meshes that were not resident yet), so executing the frame never
+     * reads the MeshManager the simulation may be changing.
+     */
+    struct DrawPacket {
+        uint64_t SortKey;
+        size_t IndexOffset;   // Bytes into the arena's index buffer
+        uint32_t Instance;    // Index into CommandList::Instances
+        uint32_t VAO;         // Arena vertex array
+        uint32_t IndexCount;  // 0 = dropped in PrepareFrame
+        uint32_t IndexType;
+        int32_t BaseVertex;
+    };
+
+    /**
+     * @brief A packet whose mesh is uploaded by PrepareFrame
+     */
+    struct PendingMesh {
+        uint32_t Packet;
+        MeshHandle Mesh;
+    };
+
+    /**
+     * @brief Everything one frame draws
+     */
+    struct CommandList {
+        bool Recorded = false;  // BeginFrame was called
+        FrameUniforms Frame = {};
+        glm::vec4 ClearColor = glm::vec4(0.0f);
+        uint32_t ViewportWidth = 0;
+        uint32_t ViewportHeight = 0;
+        std::vector<DrawPacket> Packets;
+        std::vector<InstanceData> Instances;
+        std::vector<PendingMesh> PendingMeshes;
+        std::vector<Material> Materials;  // As of EndFrame
+    };
+
+    // Sort key layout (see class comment)
+    static constexpr uint32_t SORT_SHADER_SHIFT = 60;
+    static constexpr uint32_t SORT_MATERIAL_SHIFT = 48;
+    static constexpr uint32_t SORT_ARENA_SHIFT = 40;
+    static constexpr uint32_t SORT_MESH_SHIFT = 20;
+    static constexpr uint64_t SORT_DEPTH_MASK = (1ull << 20) - 1;
+    static constexpr uint64_t SORT_MATERIAL_MASK = (1ull << 12) - 1;
+    static constexpr uint64_t SORT_ARENA_MASK = (1ull << 8) - 1;
+    static constexpr uint64_t SORT_MESH_MASK = (1ull << 20) - 1; // Handle index bits
+
+    /**
+     * @brief Upload a material's uniforms and textures to the bound shader
+     */
+    void BindMaterial(Shader& shader, const Material& material);
+
+    /**
+     * @brief Resolve the mesh's asset, registering inline data with the MeshManager
+     * @return nullptr if the mesh has no geometry
+     */
+    const MeshAsset* RegisterMesh(MeshComponent& mesh);
+
+    /**
+     * @brief Copy a resident mesh's placement into a packet
+     * @return False if the arena does not fit the sort key
+     */
+    static bool SetGeometry(DrawPacket& packet, const MeshAsset& asset);
+
+    /**
+     * @brief Sort, batch and draw a list's packets
+     */
+    void DrawPackets(CommandList& list);
 
     std::unique_ptr<Shader> m_PhongShader;
     glm::vec4 m_ClearColor;
+
+    // Shaders addressable from the sort key (index 0 = Phong)
+    std::vector<Shader*> m_Shaders;
+    std::vector<Material> m_Materials;
+
+    // m_Lists[m_RecordList] is recorded, the other one executed (storage reused between frames)
+    CommandList m_Lists[2];
+    uint32_t m_RecordList = 0;
+    uint32_t m_ViewportWidth = 0;
+    uint32_t m_ViewportHeight = 0;
+
+    // GL thread
+    std::vector<InstanceData> m_SortedInstances;
+    uint32_t m_InstanceVBO = 0;
+    size_t m_InstanceCapacity = 0; // In instances
+    uint32_t m_FrameUBO = 0;
+
+    std::atomic<uint32_t> m_DrawCallCount{0};
+    std::atomic<uint32_t> m_StateChangeCount{0};
+
+    // Camera of the frame being recorded
+    glm::vec3 m_ViewPosition = glm::vec3(0.0f);
+    glm::vec3 m_ViewForward = glm::vec3(0.0f, 0.0f, -1.0f);
+    float m_FarPlane = 100.0f;
     
     // Lighting
     DirectionalLight m_DirectionalLight;
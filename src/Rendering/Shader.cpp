@@ -1,18 +1,43 @@
 #include "Shader.h"
+#include "ShaderCache.h"
 #include "../Core/Logger.h"
 
 #include <glad/glad.h>
 #include <fstream>
 #include <sstream>
-#include <unordered_map>
 
 namespace Nilos {
 
+namespace {
+
+/**
+ * @brief Insert defines after the #version directive, which must stay the first line
+ */
+std::string InsertDefines(const std::string& source, const std::string& defines) {
+    if (defines.empty()) {
+        return source;
+    }
+
+    size_t versionPos = source.find("#version");
+    if (versionPos == std::string::npos) {
+        return defines + "\n" + source;
+    }
+
+    size_t lineEnd = source.find('\n', versionPos);
+    if (lineEnd == std::string::npos) {
+        return source + "\n" + defines + "\n";
+    }
+    return source.substr(0, lineEnd + 1) + defines + "\n" + source.substr(lineEnd + 1);
+}
+
+} // anonymous namespace
+
 Shader::~Shader() {
     Delete();
 }
 
-bool Shader::LoadFromFiles(const std::string& vertexPath, const std::string& fragmentPath) {
+bool Shader::LoadFromFiles(const std::string& vertexPath, const std::string& fragmentPath,
+                           const std::string& defines) {
     // Read vertex shader
     std::ifstream vertexFile(vertexPath);
     if (!vertexFile.is_open()) {
@@ -35,10 +60,28 @@ bool Shader::LoadFromFiles(const std::string& vertexPath, const std::string& fra
     std::string fragmentSource = fragmentStream.str();
     fragmentFile.close();
 
-    return LoadFromSource(vertexSource, fragmentSource);
+    return LoadFromSource(vertexSource, fragmentSource, defines);
 }
 
-bool Shader::LoadFromSource(const std::string& vertexSource, const std::string& fragmentSource) {
+bool Shader::LoadFromSource(const std::string& vertexSourceIn, const std::string& fragmentSourceIn,
+                            const std::string& defines) {
+    Delete();
+
+    std::string vertexSource = InsertDefines(vertexSourceIn, defines);
+    std::string fragmentSource = InsertDefines(fragmentSourceIn, defines);
+
+    // Cached binary from an earlier launch
+    ShaderCache& cache = ShaderCache::Get();
+    bool useCache = cache.IsEnabled();
+    uint64_t cacheKey = useCache ? cache.ComputeKey(vertexSource, fragmentSource) : 0;
+    if (useCache) {
+        m_ProgramId = cache.LoadProgram(cacheKey);
+        if (m_ProgramId != 0) {
+            CacheUniformLocations();
+            return true;
+        }
+    }
+
     // Compile vertex shader
     uint32_t vertexShader = CompileShader(vertexSource, GL_VERTEX_SHADER);
     if (vertexShader == 0) {
@@ -59,6 +102,9 @@ bool Shader::LoadFromSource(const std::string& vertexSource, const std::string&
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
 
+    if (success && useCache) {
+        cache.StoreProgram(cacheKey, m_ProgramId);
+    }
     return success;
 }
 
@@ -77,6 +123,17 @@ void Shader::Delete() {
         glDeleteProgram(m_ProgramId);
         m_ProgramId = 0;
     }
+    m_UniformLocations.clear();
+}
+
+bool Shader::BindUniformBlock(const char* blockName, uint32_t bindingPoint) const {
+    GLuint blockIndex = glGetUniformBlockIndex(m_ProgramId, blockName);
+    if (blockIndex == GL_INVALID_INDEX) {
+        NILOS_WARNING("Shader has no uniform block '", blockName, "'");
+        return false;
+    }
+    glUniformBlockBinding(m_ProgramId, blockIndex, bindingPoint);
+    return true;
 }
 
 uint32_t Shader::CompileShader(const std::string& source, uint32_t type) {
@@ -104,6 +161,10 @@ bool Shader::LinkProgram(uint32_t vertexShader, uint32_t fragmentShader) {
     m_ProgramId = glCreateProgram();
     glAttachShader(m_ProgramId, vertexShader);
     glAttachShader(m_ProgramId, fragmentShader);
+    if (ShaderCache::Get().IsEnabled()) {
+        // Some drivers only keep a retrievable binary when asked before linking
+        glProgramParameteri(m_ProgramId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
     glLinkProgram(m_ProgramId);
 
     // Check linking
@@ -118,12 +179,50 @@ bool Shader::LinkProgram(uint32_t vertexShader, uint32_t fragmentShader) {
         return false;
     }
 
+    CacheUniformLocations();
     return true;
 }
 
+void Shader::CacheUniformLocations() {
+    m_UniformLocations.clear();
+
+    int uniformCount = 0;
+    glGetProgramiv(m_ProgramId, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+    for (int i = 0; i < uniformCount; ++i) {
+        char nameBuffer[256];
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(m_ProgramId, static_cast<GLuint>(i), sizeof(nameBuffer), &length, &size, &type, nameBuffer);
+
+        // Members of uniform blocks have no location
+        int location = glGetUniformLocation(m_ProgramId, nameBuffer);
+        if (location < 0) {
+            continue;
+        }
+
+        // Arrays are reported as "name[0]"; make them reachable as "name" too
+        std::string name(nameBuffer, static_cast<size_t>(length));
+        if (name.size() > 3 && name.compare(name.size() - 3, 3, "[0]") == 0) {
+            m_UniformLocations[UniformName::HashString(name.substr(0, name.size() - 3).c_str())] = location;
+        }
+
+        uint32_t hash = UniformName::HashString(name.c_str());
+        if (m_UniformLocations.count(hash)) {
+            NILOS_WARNING("Uniform name hash collision: ", name);
+        }
+        m_UniformLocations[hash] = location;
+    }
+}
+
+int Shader::GetUniformLocation(UniformName name) const {
+    auto it = m_UniformLocations.find(name.Hash);
+    return it != m_UniformLocations.end() ? it->second : -1;
+}
+
 int Shader::GetUniformLocation(const std::string& name) const {
-    // Simple caching could be added here for performance
-    return glGetUniformLocation(m_ProgramId, name.c_str());
+    return GetUniformLocation(UniformName(name.c_str()));
 }
 
 // ============================================================================
@@ -158,5 +257,33 @@ void Shader::SetMat4(const std::string& name, const glm::mat4& value) const {
     glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &value[0][0]);
 }
 
+void Shader::SetInt(UniformName name, int value) const {
+    glUniform1i(GetUniformLocation(name), value);
+}
+
+void Shader::SetFloat(UniformName name, float value) const {
+    glUniform1f(GetUniformLocation(name), value);
+}
+
+void Shader::SetVec2(UniformName name, const glm::vec2& value) const {
+    glUniform2fv(GetUniformLocation(name), 1, &value[0]);
+}
+
+void Shader::SetVec3(UniformName name, const glm::vec3& value) const {
+    glUniform3fv(GetUniformLocation(name), 1, &value[0]);
+}
+
+void Shader::SetVec4(UniformName name, const glm::vec4& value) const {
+    glUniform4fv(GetUniformLocation(name), 1, &value[0]);
+}
+
+void Shader::SetMat3(UniformName name, const glm::mat3& value) const {
+    glUniformMatrix3fv(GetUniformLocation(name), 1, GL_FALSE, &value[0][0]);
+}
+
+void Shader::SetMat4(UniformName name, const glm::mat4& value) const {
+    glUniformMatrix4fv(GetUniformLocation(name), 1, GL_FALSE, &value[0][0]);
+}
+
 } // namespace Nilos
 
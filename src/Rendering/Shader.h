@@ -3,14 +3,42 @@
 #include <string>
 #include <glm/glm.hpp>
 #include <cstdint>
+#include <unordered_map>
 
 namespace Nilos {
 
+/**
+ * @brief Uniform name hashed at compile time (FNV-1a, 32 bit)
+ *
+ * Declare once and reuse so hot loops never touch strings:
+ *   constexpr UniformName U_MODEL("uModel");
+ *   shader.SetMat4(U_MODEL, model);
+ */
+struct UniformName {
+    uint32_t Hash;
+
+    explicit constexpr UniformName(const char* name) : Hash(HashString(name)) {}
+
+    static constexpr uint32_t HashString(const char* name) {
+        uint32_t hash = 2166136261u;
+        while (*name) {
+            hash = (hash ^ static_cast<uint8_t>(*name++)) * 16777619u;
+        }
+        return hash;
+    }
+};
+
 /**
  * @brief Shader program management
  * 
  * Loads, compiles, and links vertex and fragment shaders.
  * Provides utilities to set uniform values.
+ *
+ * Uniform locations are queried once after linking and stored by name
+ * hash; setters never call glGetUniformLocation.
+ *
+ * Linked programs are stored in the ShaderCache, so later launches load
+ * the driver's binary instead of compiling the GLSL again.
  */
 class Shader {
 public:
@@ -19,13 +47,17 @@ public:
 
     /**
      * @brief Load and compile shader from file paths
+     * @param defines Lines inserted after each stage's #version line (e.g. "#define SHADOWS 1\n")
      */
-    bool LoadFromFiles(const std::string& vertexPath, const std::string& fragmentPath);
+    bool LoadFromFiles(const std::string& vertexPath, const std::string& fragmentPath,
+                       const std::string& defines = "");
 
     /**
      * @brief Load and compile shader from source strings
+     * @param defines Lines inserted after each stage's #version line
      */
-    bool LoadFromSource(const std::string& vertexSource, const std::string& fragmentSource);
+    bool LoadFromSource(const std::string& vertexSource, const std::string& fragmentSource,
+                        const std::string& defines = "");
 
     /**
      * @brief Use/activate this shader program
@@ -52,6 +84,12 @@ public:
      */
     uint32_t GetProgramId() const { return m_ProgramId; }
 
+    /**
+     * @brief Attach a uniform block of this program to a UBO binding point
+     * @return false if the program has no such block
+     */
+    bool BindUniformBlock(const char* blockName, uint32_t bindingPoint) const;
+
     // ========================================================================
     // Uniform Setters
     // ========================================================================
@@ -64,6 +102,14 @@ public:
     void SetMat3(const std::string& name, const glm::mat3& value) const;
     void SetMat4(const std::string& name, const glm::mat4& value) const;
 
+    void SetInt(UniformName name, int value) const;
+    void SetFloat(UniformName name, float value) const;
+    void SetVec2(UniformName name, const glm::vec2& value) const;
+    void SetVec3(UniformName name, const glm::vec3& value) const;
+    void SetVec4(UniformName name, const glm::vec4& value) const;
+    void SetMat3(UniformName name, const glm::mat3& value) const;
+    void SetMat4(UniformName name, const glm::mat4& value) const;
+
 private:
     /**
      * @brief Compile a shader stage
@@ -76,11 +122,18 @@ private:
     bool LinkProgram(uint32_t vertexShader, uint32_t fragmentShader);
 
     /**
-     * @brief Get uniform location (cached)
+     * @brief Fill the location table from the program's active uniforms
+     */
+    void CacheUniformLocations();
+
+    /**
+     * @brief Get uniform location from the table (-1 if not an active uniform)
      */
+    int GetUniformLocation(UniformName name) const;
     int GetUniformLocation(const std::string& name) const;
 
     uint32_t m_ProgramId = 0;
+    std::unordered_map<uint32_t, int> m_UniformLocations; // Name hash -> location
 };
 
 } // namespace Nilos
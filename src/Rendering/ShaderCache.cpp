@@ -0,0 +1,219 @@
+#include "ShaderCache.h"
+#include "../Core/Logger.h"
+#include "../Core/MappedFile.h"
+#include "../Core/Profiler.h"
+
+#include <glad/glad.h>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <system_error>
+#include <vector>
+
+namespace Nilos {
+
+namespace {
+
+constexpr uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+constexpr uint64_t FNV_PRIME = 1099511628211ull;
+
+void HashBytes(uint64_t& hash, const void* data, size_t size) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (size_t i = 0; i < size; ++i) {
+        hash = (hash ^ bytes[i]) * FNV_PRIME;
+    }
+}
+
+/**
+ * @brief Hash a string followed by its length, so adjacent strings cannot alias
+ */
+void HashString(uint64_t& hash, const std::string& text) {
+    HashBytes(hash, text.data(), text.size());
+    uint64_t length = text.size();
+    HashBytes(hash, &length, sizeof(length));
+}
+
+std::string GetGLString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+} // anonymous namespace
+
+void ShaderCache::SetDirectory(const std::string& directory) {
+    m_Directory = directory;
+    m_DirectoryCreated = false;
+}
+
+void ShaderCache::Initialize() {
+    m_Initialized = true;
+    m_Driver = GetGLString(GL_VENDOR) + "\n" + GetGLString(GL_RENDERER) + "\n" + GetGLString(GL_VERSION);
+
+    if (!GLAD_GL_VERSION_4_1 && !GLAD_GL_ARB_get_program_binary) {
+        NILOS_INFO("Shader cache disabled: program binaries not supported");
+        return;
+    }
+
+    // Drivers may support the entry points but no formats at all
+    GLint formatCount = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formatCount);
+    if (formatCount <= 0) {
+        NILOS_INFO("Shader cache disabled: driver offers no program binary formats");
+        return;
+    }
+    m_Supported = true;
+}
+
+bool ShaderCache::IsEnabled() {
+    if (m_Directory.empty()) {
+        return false;
+    }
+    if (!m_Initialized) {
+        Initialize();
+    }
+    return m_Supported;
+}
+
+uint64_t ShaderCache::ComputeKey(const std::string& vertexSource, const std::string& fragmentSource) {
+    if (!m_Initialized) {
+        Initialize();
+    }
+
+    uint64_t hash = FNV_OFFSET_BASIS;
+    HashBytes(hash, &VERSION, sizeof(VERSION));
+    HashString(hash, m_Driver);
+    HashString(hash, vertexSource);
+    HashString(hash, fragmentSource);
+    return hash;
+}
+
+std::string ShaderCache::GetEntryPath(uint64_t key) const {
+    char name[24];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return m_Directory + "/" + name;
+}
+
+uint32_t ShaderCache::LoadProgram(uint64_t key) {
+    if (!IsEnabled()) {
+        return 0;
+    }
+    NILOS_PROFILE_FUNCTION();
+
+    ++m_Misses;  // Undone on success
+
+    std::string path = GetEntryPath(key);
+    std::error_code error;
+    if (!std::filesystem::exists(path, error)) {
+        return 0;
+    }
+
+    MappedFile file;
+    if (!file.Open(path)) {
+        return 0;
+    }
+
+    FileHeader header;
+    if (file.GetSize() < sizeof(header)) {
+        NILOS_WARNING("Shader cache entry truncated: ", path);
+        return 0;
+    }
+    std::memcpy(&header, file.GetData(), sizeof(header));
+
+    const uint8_t* binary = file.GetData() + sizeof(header);
+    if (header.Magic != MAGIC || header.Version != VERSION || header.Key != key
+        || header.Length == 0 || header.Length != file.GetSize() - sizeof(header)) {
+        NILOS_WARNING("Shader cache entry invalid: ", path);
+        return 0;
+    }
+
+    uint64_t checksum = FNV_OFFSET_BASIS;
+    HashBytes(checksum, binary, header.Length);
+    if (checksum != header.Checksum) {
+        NILOS_WARNING("Shader cache entry corrupt: ", path);
+        return 0;
+    }
+
+    uint32_t program = glCreateProgram();
+    glProgramBinary(program, header.BinaryFormat, binary, static_cast<GLsizei>(header.Length));
+
+    // The driver may reject binaries from another build even with an identical version string
+    GLint linked = 0;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        NILOS_INFO("Shader cache entry rejected by driver, recompiling: ", path);
+        glDeleteProgram(program);
+        return 0;
+    }
+
+    --m_Misses;
+    ++m_Hits;
+    return program;
+}
+
+void ShaderCache::StoreProgram(uint64_t key, uint32_t program) {
+    if (!IsEnabled() || program == 0) {
+        return;
+    }
+    NILOS_PROFILE_FUNCTION();
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) {
+        return;
+    }
+
+    std::vector<uint8_t> bytes(sizeof(FileHeader) + static_cast<size_t>(length));
+    GLsizei written = 0;
+    GLenum format = 0;
+    glGetProgramBinary(program, length, &written, &format, bytes.data() + sizeof(FileHeader));
+    if (written <= 0) {
+        return;
+    }
+    bytes.resize(sizeof(FileHeader) + static_cast<size_t>(written));
+
+    FileHeader header = {};
+    header.Magic = MAGIC;
+    header.Version = VERSION;
+    header.Key = key;
+    header.BinaryFormat = format;
+    header.Length = static_cast<uint32_t>(written);
+    header.Checksum = FNV_OFFSET_BASIS;
+    HashBytes(header.Checksum, bytes.data() + sizeof(FileHeader), header.Length);
+    std::memcpy(bytes.data(), &header, sizeof(header));
+
+    if (!m_DirectoryCreated) {
+        std::error_code error;
+        std::filesystem::create_directories(m_Directory, error);
+        if (error) {
+            NILOS_WARNING("Failed to create shader cache directory: ", m_Directory, " (", error.message(), ")");
+            return;
+        }
+        m_DirectoryCreated = true;
+    }
+
+    // Write then rename so an interrupted write never leaves a truncated entry behind
+    std::string path = GetEntryPath(key);
+    std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            NILOS_WARNING("Failed to open for writing: ", tempPath);
+            return;
+        }
+        file.write(reinterpret_cast<const char*>(bytes.data()), static_cast<std::streamsize>(bytes.size()));
+        if (!file.good()) {
+            NILOS_WARNING("Failed to write shader cache entry: ", tempPath);
+            return;
+        }
+    }
+
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        NILOS_WARNING("Failed to store shader cache entry: ", path, " (", error.message(), ")");
+        std::filesystem::remove(tempPath, error);
+    }
+}
+
+} // namespace Nilos
@@ -0,0 +1,101 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+namespace Nilos {
+
+/**
+ * @brief On-disk cache of linked shader programs (glGetProgramBinary)
+ *
+ * Shader::LoadFromSource looks a program up here before compiling and
+ * stores it after a successful link, so later launches skip compilation.
+ * Entries are keyed by a 64-bit FNV-1a hash of the final vertex and
+ * fragment sources (defines included) and the GL vendor, renderer and
+ * version strings, so a driver update or an edited shader simply misses.
+ *
+ * Each entry is one file, <directory>/<key>.bin:
+ *   ShaderCache::FileHeader  (magic, version, key, binary format, length, checksum)
+ *   program binary
+ * A file that fails validation, or a binary the driver rejects, is
+ * ignored and the program is compiled from source (and stored again).
+ *
+ * Disabled when the directory is empty or the driver offers no binary
+ * formats (needs GL 4.1 or ARB_get_program_binary).
+ *
+ * Usage:
+ *   ShaderCache::Get().SetDirectory("cache/shaders");  // Before loading shaders
+ */
+class ShaderCache {
+public:
+    static ShaderCache& Get() {
+        static ShaderCache instance;
+        return instance;
+    }
+
+    ShaderCache(const ShaderCache&) = delete;
+    ShaderCache& operator=(const ShaderCache&) = delete;
+
+    /**
+     * @brief Set where entries are stored (created on first store); empty disables the cache
+     */
+    void SetDirectory(const std::string& directory);
+    const std::string& GetDirectory() const { return m_Directory; }
+
+    /**
+     * @brief Whether programs are looked up and stored (needs a current GL context)
+     */
+    bool IsEnabled();
+
+    /**
+     * @brief Cache key of a program built from these sources with the current driver
+     */
+    uint64_t ComputeKey(const std::string& vertexSource, const std::string& fragmentSource);
+
+    /**
+     * @brief Create a program from a cached binary
+     * @return Linked program, or 0 on a miss (no entry, invalid entry, binary rejected)
+     */
+    uint32_t LoadProgram(uint64_t key);
+
+    /**
+     * @brief Store a linked program's binary (link it with GL_PROGRAM_BINARY_RETRIEVABLE_HINT)
+     */
+    void StoreProgram(uint64_t key, uint32_t program);
+
+    uint32_t GetHitCount() const { return m_Hits; }
+    uint32_t GetMissCount() const { return m_Misses; }
+
+private:
+    ShaderCache() = default;
+
+    static constexpr uint32_t MAGIC = 0x48535053; // "SPSH"
+    static constexpr uint32_t VERSION = 1;
+
+    struct FileHeader {
+        uint32_t Magic;
+        uint32_t Version;
+        uint64_t Key;
+        uint32_t BinaryFormat;
+        uint32_t Length;    // Bytes of binary after the header
+        uint64_t Checksum;  // FNV-1a of the binary
+    };
+    static_assert(sizeof(FileHeader) == 32, "ShaderCache::FileHeader layout changed; bump VERSION");
+
+    /**
+     * @brief Query driver support and identity once a context exists
+     */
+    void Initialize();
+
+    std::string GetEntryPath(uint64_t key) const;
+
+    std::string m_Directory = "cache/shaders";
+    std::string m_Driver;  // Vendor, renderer and version strings
+    bool m_Initialized = false;
+    bool m_Supported = false;
+    bool m_DirectoryCreated = false;
+    uint32_t m_Hits = 0;
+    uint32_t m_Misses = 0;
+};
+
+} // namespace Nilos
@@ -1,18 +1,45 @@
 #include "Texture.h"
+#include "TextureContainer.h"
+#include "RenderThread.h"
 #include "../Core/Logger.h"
 
 #include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
 
 #define STB_IMAGE_IMPLEMENTATION
 #include "../../external/stb/stb_image.h"
 
 namespace Nilos {
 
+namespace {
+
+/**
+ * @brief Bytes of an uncompressed texture and its full mip chain
+ */
+size_t EstimateMemorySize(int width, int height, size_t bytesPerTexel, bool mipmaps) {
+    size_t total = 0;
+    while (true) {
+        total += size_t(width) * size_t(height) * bytesPerTexel;
+        if (!mipmaps || (width == 1 && height == 1)) {
+            return total;
+        }
+        width = std::max(1, width / 2);
+        height = std::max(1, height / 2);
+    }
+}
+
+} // namespace
+
 Texture2D::~Texture2D() {
     Delete();
 }
 
 bool Texture2D::LoadFromFile(const std::string& filepath, bool generateMipmaps) {
+    if (TextureContainer::IsContainerFile(filepath)) {
+        return LoadContainer(filepath);
+    }
+
     // Flip textures on load (OpenGL expects bottom-left origin)
     stbi_set_flip_vertically_on_load(true);
 
@@ -48,6 +75,11 @@ bool Texture2D::LoadFromFile(const std::string& filepath, bool generateMipmaps)
 
 bool Texture2D::CreateFromData(const unsigned char* data, int width, int height, 
                                 TextureFormat format, bool generateMipmaps) {
+    if (IsCompressedFormat(format)) {
+        NILOS_ERROR("CreateFromData takes uncompressed pixels; load compressed textures from .dds/.ktx2");
+        return false;
+    }
+
     m_Width = width;
     m_Height = height;
     m_Format = format;
@@ -77,9 +109,135 @@ bool Texture2D::CreateFromData(const unsigned char* data, int width, int height,
 
     glBindTexture(GL_TEXTURE_2D, 0);
 
+    // RGB8 is padded to 4 bytes by most drivers
+    m_MemorySize = EstimateMemorySize(width, height, 4, generateMipmaps);
     return true;
 }
 
+bool Texture2D::LoadContainer(const std::string& filepath) {
+    MappedFile file;
+    if (!file.Open(filepath)) {
+        return false;
+    }
+
+    TextureContainerImage image;
+    std::string error;
+    if (!TextureContainer::Parse(file.GetData(), file.GetSize(), image, error)) {
+        NILOS_ERROR("Failed to load texture: ", filepath, " (", error, ")");
+        return false;
+    }
+
+    m_Filepath = filepath;
+    if (!UploadCompressed(image, file.GetData(), 0)) {
+        return false;
+    }
+
+    NILOS_DEBUG("Texture loaded: ", filepath, " (", m_Width, "x", m_Height, ", compressed, ",
+                image.Levels.size(), " levels)");
+    return true;
+}
+
+bool Texture2D::UploadCompressed(const TextureContainerImage& image, const uint8_t* data, size_t dataBegin) {
+    if (!IsFormatSupported(image.Format)) {
+        NILOS_ERROR("Compressed texture format not supported by this GPU: ", m_Filepath);
+        return false;
+    }
+
+    uint32_t internalFormat, dataFormat, dataType;
+    FormatToGL(image.Format, internalFormat, dataFormat, dataType);
+
+    if (m_TextureID == 0) {
+        glGenTextures(1, &m_TextureID);
+    }
+    glBindTexture(GL_TEXTURE_2D, m_TextureID);
+
+    m_MemorySize = 0;
+    for (size_t level = 0; level < image.Levels.size(); ++level) {
+        const TextureMipLevel& mip = image.Levels[level];
+        // With an unpack buffer bound the pointer is an offset into it
+        const void* levelData = reinterpret_cast<const void*>(
+            reinterpret_cast<uintptr_t>(data) + (mip.Offset - dataBegin));
+        glCompressedTexImage2D(GL_TEXTURE_2D, static_cast<GLint>(level), internalFormat,
+                               mip.Width, mip.Height, 0, static_cast<GLsizei>(mip.Size), levelData);
+        m_MemorySize += mip.Size;
+    }
+
+    // Sample only the levels the file provides (a partial chain is otherwise incomplete)
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_BASE_LEVEL, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, static_cast<GLint>(image.Levels.size()) - 1);
+    if (image.Levels.size() > 1) {
+        SetFilter(TextureFilter::LinearMipmapLinear, TextureFilter::Linear);
+    } else {
+        SetFilter(TextureFilter::Linear, TextureFilter::Linear);
+    }
+    SetWrap(TextureWrap::Repeat, TextureWrap::Repeat);
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_Width = image.Width;
+    m_Height = image.Height;
+    m_Channels = image.Format == TextureFormat::BC5 ? 2 : 4;
+    m_Format = image.Format;
+    m_State = TextureState::Ready;
+    return true;
+}
+
+bool Texture2D::IsFormatSupported(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1:
+        case TextureFormat::BC3:
+            return GLAD_GL_EXT_texture_compression_s3tc != 0;
+        case TextureFormat::BC1_SRGB:
+        case TextureFormat::BC3_SRGB:
+            // The sRGB S3TC formats come from EXT_texture_sRGB, not the S3TC extension
+            return GLAD_GL_EXT_texture_compression_s3tc && GLAD_GL_EXT_texture_sRGB;
+        case TextureFormat::BC7:
+        case TextureFormat::BC7_SRGB:
+            return GLAD_GL_VERSION_4_2 || GLAD_GL_ARB_texture_compression_bptc;
+        default:
+            return true; // RGTC (BC5) is core since OpenGL 3.0
+    }
+}
+
+void Texture2D::CreatePlaceholder(const std::string& filepath) {
+    m_Filepath = filepath;
+    m_Width = 1;
+    m_Height = 1;
+    m_Channels = 4;
+    m_Format = TextureFormat::RGBA;
+    m_State = TextureState::Loading;
+    m_MemorySize = 4;
+
+    const unsigned char grey[4] = { 128, 128, 128, 255 };
+    glGenTextures(1, &m_TextureID);
+    glBindTexture(GL_TEXTURE_2D, m_TextureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, 1, 1, 0, GL_RGBA, GL_UNSIGNED_BYTE, grey);
+    SetFilter(TextureFilter::Linear, TextureFilter::Linear);
+    SetWrap(TextureWrap::Repeat, TextureWrap::Repeat);
+    glBindTexture(GL_TEXTURE_2D, 0);
+}
+
+void Texture2D::UploadFromUnpackBuffer(int width, int height, bool generateMipmaps) {
+    m_Width = width;
+    m_Height = height;
+    m_Channels = 4;
+    m_Format = TextureFormat::RGBA;
+
+    // Data pointer is an offset into the bound unpack buffer
+    glBindTexture(GL_TEXTURE_2D, m_TextureID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+
+    if (generateMipmaps) {
+        glGenerateMipmap(GL_TEXTURE_2D);
+        SetFilter(TextureFilter::LinearMipmapLinear, TextureFilter::Linear);
+    } else {
+        SetFilter(TextureFilter::Linear, TextureFilter::Linear);
+    }
+    glBindTexture(GL_TEXTURE_2D, 0);
+
+    m_MemorySize = EstimateMemorySize(width, height, 4, generateMipmaps);
+    m_State = TextureState::Ready;
+}
+
 void Texture2D::Bind(uint32_t unit) const {
     glActiveTexture(GL_TEXTURE0 + unit);
     glBindTexture(GL_TEXTURE_2D, m_TextureID);
@@ -94,6 +252,7 @@ void Texture2D::Delete() {
         glDeleteTextures(1, &m_TextureID);
         m_TextureID = 0;
     }
+    m_MemorySize = 0;
 }
 
 void Texture2D::SetFilter(TextureFilter minFilter, TextureFilter magFilter) {
@@ -153,6 +312,16 @@ void Texture2D::FormatToGL(TextureFormat format, uint32_t& internalFormat,
             dataFormat = GL_DEPTH_STENCIL;
             dataType = GL_UNSIGNED_INT_24_8;
             break;
+        case TextureFormat::BC1: internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT1_EXT; break;
+        case TextureFormat::BC1_SRGB: internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT1_EXT; break;
+        case TextureFormat::BC3: internalFormat = GL_COMPRESSED_RGBA_S3TC_DXT5_EXT; break;
+        case TextureFormat::BC3_SRGB: internalFormat = GL_COMPRESSED_SRGB_ALPHA_S3TC_DXT5_EXT; break;
+        case TextureFormat::BC5: internalFormat = GL_COMPRESSED_RG_RGTC2; break;
+        case TextureFormat::BC7: internalFormat = GL_COMPRESSED_RGBA_BPTC_UNORM; break;
+        case TextureFormat::BC7_SRGB: internalFormat = GL_COMPRESSED_SRGB_ALPHA_BPTC_UNORM; break;
+    }
+    if (IsCompressedFormat(format)) {
+        dataFormat = 0; // Unused by glCompressedTexImage2D
     }
 }
 
@@ -160,6 +329,9 @@ void Texture2D::FormatToGL(TextureFormat format, uint32_t& internalFormat,
 // TextureManager
 // ============================================================================
 
+TextureManager::TextureManager() = default;
+TextureManager::~TextureManager() = default;
+
 Texture2D* TextureManager::Load(const std::string& filepath, bool generateMipmaps) {
     // Check if already loaded
     auto it = m_Textures.find(filepath);
@@ -169,7 +341,9 @@ Texture2D* TextureManager::Load(const std::string& filepath, bool generateMipmap
 
     // Load new texture
     auto texture = std::make_unique<Texture2D>();
-    if (!texture->LoadFromFile(filepath, generateMipmaps)) {
+    bool loaded = false;
+    RenderThread::Get().Invoke([&] { loaded = texture->LoadFromFile(filepath, generateMipmaps); });
+    if (!loaded) {
         return nullptr;
     }
 
@@ -183,13 +357,235 @@ Texture2D* TextureManager::GetTexture(const std::string& filepath) {
     return (it != m_Textures.end()) ? it->second.get() : nullptr;
 }
 
+size_t TextureManager::GetMemoryUsage() const {
+    size_t total = 0;
+    for (const auto& entry : m_Textures) {
+        total += entry.second->GetMemorySize();
+    }
+    return total;
+}
+
+Texture2D* TextureManager::LoadAsync(const std::string& filepath, bool generateMipmaps) {
+    // Check if already loaded (or streaming)
+    auto it = m_Textures.find(filepath);
+    if (it != m_Textures.end()) {
+        return it->second.get();
+    }
+
+    auto texture = std::make_unique<Texture2D>();
+    RenderThread::Get().Invoke([&] { texture->CreatePlaceholder(filepath); });
+
+    auto request = std::make_unique<StreamRequest>();
+    request->Texture = texture.get();
+    request->Filepath = filepath;
+    request->GenerateMipmaps = generateMipmaps;
+
+    // Decode off the render thread; the request outlives the job (see Clear)
+    StreamRequest* pending = request.get();
+    m_Streams.push_back(std::move(request));
+    JobSystem::Get().Execute([pending] {
+        bool decoded = false;
+        if (TextureContainer::IsContainerFile(pending->Filepath)) {
+            // Block data is uploaded as stored: only the header is parsed
+            auto image = std::make_unique<TextureContainerImage>();
+            if (pending->File.Open(pending->Filepath) &&
+                TextureContainer::Parse(pending->File.GetData(), pending->File.GetSize(), *image, pending->Error)) {
+                size_t begin = image->GetDataBegin();
+                pending->Source = pending->File.GetData() + begin;
+                pending->SourceSize = image->GetDataEnd() - begin;
+                pending->Width = image->Width;
+                pending->Height = image->Height;
+                pending->Container = std::move(image);
+                decoded = true;
+            }
+        } else {
+            // Per-thread flag: decodes on other workers are unaffected
+            stbi_set_flip_vertically_on_load_thread(1);
+            int channels = 0;
+            pending->Pixels = stbi_load(pending->Filepath.c_str(), &pending->Width, &pending->Height, &channels, 4);
+            if (pending->Pixels) {
+                pending->Source = pending->Pixels;
+                pending->SourceSize = size_t(pending->Width) * size_t(pending->Height) * 4;
+                decoded = true;
+            } else {
+                pending->Error = stbi_failure_reason();
+            }
+        }
+        pending->DecodeStatus.store(decoded ? StreamRequest::Decoded : StreamRequest::Failed,
+                                    std::memory_order_release);
+    }, &m_DecodeJobs);
+
+    Texture2D* ptr = texture.get();
+    m_Textures[filepath] = std::move(texture);
+    return ptr;
+}
+
+void TextureManager::Update() {
+    if (m_Streams.empty()) {
+        return;
+    }
+
+    // Drop requests that failed to decode or were unloaded meanwhile
+    for (auto it = m_Streams.begin(); it != m_Streams.end();) {
+        StreamRequest& request = **it;
+        int status = request.DecodeStatus.load(std::memory_order_acquire);
+        if (status == StreamRequest::Decoded && request.Container &&
+            !Texture2D::IsFormatSupported(request.Container->Format)) {
+            // Not worth staging: the upload would be rejected
+            request.Error = "compressed format not supported by this GPU";
+            status = StreamRequest::Failed;
+        }
+        if (status != StreamRequest::Decoding && (!request.Texture || status == StreamRequest::Failed)) {
+            if (request.Texture) {
+                request.Texture->m_State = TextureState::Failed;
+                NILOS_ERROR("Failed to load texture: ", request.Filepath,
+                            request.Error.empty() ? "" : " (" + request.Error + ")");
+            }
+            ReleaseRequest(request);
+            it = m_Streams.erase(it);
+        } else {
+            ++it;
+        }
+    }
+
+    size_t budget = m_UploadBudget;
+    bool unpackBound = false;
+    while (budget > 0) {
+        // Finish the image being staged before starting the next decoded
+        // one, so at most one staging buffer is mapped
+        auto next = std::find_if(m_Streams.begin(), m_Streams.end(),
+                                 [](const std::unique_ptr<StreamRequest>& request) { return request->Mapped != nullptr; });
+        if (next == m_Streams.end()) {
+            next = std::find_if(m_Streams.begin(), m_Streams.end(), [](const std::unique_ptr<StreamRequest>& request) {
+                return request->DecodeStatus.load(std::memory_order_acquire) == StreamRequest::Decoded;
+            });
+        }
+        if (next == m_Streams.end()) {
+            break;
+        }
+
+        StreamRequest& request = **next;
+        size_t size = request.SourceSize;
+        unpackBound = true;
+        if (!request.Mapped && !BeginStaging(request, size)) {
+            request.Texture->m_State = TextureState::Failed;
+            ReleaseRequest(request);
+            m_Streams.erase(next);
+            continue;
+        }
+
+        size_t bytes = std::min(budget, size - request.BytesCopied);
+        std::memcpy(request.Mapped + request.BytesCopied, request.Source + request.BytesCopied, bytes);
+        request.BytesCopied += bytes;
+        budget -= bytes;
+
+        if (request.BytesCopied < size) {
+            break; // Budget spent, continue next frame
+        }
+
+        // Whole image staged: hand it to the driver
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, request.PixelBuffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        request.Mapped = nullptr;
+        if (request.Container) {
+            // The buffer holds the file range starting at the first level
+            if (!request.Texture->UploadCompressed(*request.Container, nullptr, request.Container->GetDataBegin())) {
+                request.Texture->m_State = TextureState::Failed;
+            }
+        } else {
+            glPixelStorei(GL_UNPACK_ALIGNMENT, 4); // RGBA rows are always 4-byte aligned
+            request.Texture->UploadFromUnpackBuffer(request.Width, request.Height, request.GenerateMipmaps);
+        }
+
+        if (request.Texture->IsReady()) {
+            NILOS_DEBUG("Texture streamed: ", request.Filepath, " (", request.Width, "x", request.Height, ")");
+        }
+        ReleaseRequest(request);
+        m_Streams.erase(next);
+    }
+
+    if (unpackBound) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+    }
+}
+
+bool TextureManager::BeginStaging(StreamRequest& request, size_t size) {
+    size_t slot = m_NextPixelBuffer;
+    m_NextPixelBuffer = (m_NextPixelBuffer + 1) % PIXEL_BUFFER_COUNT;
+
+    if (!m_PixelBuffers[slot]) {
+        glGenBuffers(1, &m_PixelBuffers[slot]);
+    }
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, m_PixelBuffers[slot]);
+    if (m_PixelBufferSizes[slot] < size) {
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, size, nullptr, GL_STREAM_DRAW);
+        m_PixelBufferSizes[slot] = size;
+    }
+
+    // Invalidating lets the driver hand out fresh memory if an earlier
+    // upload from this buffer has not finished yet
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, size,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (!mapped) {
+        NILOS_ERROR("Failed to map texture upload buffer for ", request.Filepath);
+        return false;
+    }
+
+    request.PixelBuffer = m_PixelBuffers[slot];
+    request.Mapped = static_cast<unsigned char*>(mapped);
+    request.BytesCopied = 0;
+    return true;
+}
+
+void TextureManager::ReleaseRequest(StreamRequest& request) {
+    if (request.Mapped) {
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, request.PixelBuffer);
+        glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        request.Mapped = nullptr;
+    }
+    if (request.Pixels) {
+        stbi_image_free(request.Pixels);
+        request.Pixels = nullptr;
+    }
+    request.File.Close();
+    request.Source = nullptr;
+}
+
 void TextureManager::Clear() {
-    m_Textures.clear();
+    // Decode jobs still write into their requests
+    JobSystem::Get().Wait(m_DecodeJobs);
+    for (auto& request : m_Streams) {
+        ReleaseRequest(*request);
+    }
+    m_Streams.clear();
+
+    RenderThread::Get().Invoke([this] {
+        for (size_t i = 0; i < PIXEL_BUFFER_COUNT; ++i) {
+            if (m_PixelBuffers[i]) {
+                glDeleteBuffers(1, &m_PixelBuffers[i]);
+                m_PixelBuffers[i] = 0;
+                m_PixelBufferSizes[i] = 0;
+            }
+        }
+        m_Textures.clear();
+    });
     NILOS_INFO("All textures unloaded");
 }
 
 void TextureManager::Unload(const std::string& filepath) {
-    m_Textures.erase(filepath);
+    auto it = m_Textures.find(filepath);
+    if (it == m_Textures.end()) {
+        return;
+    }
+
+    // A streaming request is dropped by Update once its decode has finished
+    for (auto& request : m_Streams) {
+        if (request->Texture == it->second.get()) {
+            request->Texture = nullptr;
+        }
+    }
+    RenderThread::Get().Invoke([&] { m_Textures.erase(it); });
 }
 
 } // namespace Nilos
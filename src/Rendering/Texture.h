@@ -1,9 +1,14 @@
 #pragma once
 
+#include "../Core/JobSystem.h"
+#include "../Core/MappedFile.h"
+
+#include <atomic>
 #include <string>
 #include <cstdint>
 #include <memory>
 #include <unordered_map>
+#include <vector>
 
 namespace Nilos {
 
@@ -31,12 +36,33 @@ enum class TextureWrap {
 
 /**
  * @brief Texture format
+ *
+ * BCn formats are block compressed (4x4 texels per block) and only come
+ * from container files (.dds, .ktx2) with their mip chain baked in.
  */
 enum class TextureFormat {
     RGB,
     RGBA,
     DepthComponent,
-    DepthStencil
+    DepthStencil,
+    BC1,       // RGB + 1-bit alpha, 8 bytes per block (DXT1)
+    BC1_SRGB,
+    BC3,       // RGBA, 16 bytes per block (DXT5)
+    BC3_SRGB,
+    BC5,       // Two channels, 16 bytes per block (normal maps)
+    BC7,       // High quality RGBA, 16 bytes per block
+    BC7_SRGB
+};
+
+struct TextureContainerImage;
+
+/**
+ * @brief Streaming state of a texture (see TextureManager::LoadAsync)
+ */
+enum class TextureState {
+    Loading,  // Placeholder shown, real image still decoding or uploading
+    Ready,
+    Failed    // Placeholder kept
 };
 
 /**
@@ -52,7 +78,10 @@ public:
 
     /**
      * @brief Load texture from file
-     * @param filepath Path to image file (PNG, JPG, TGA, etc.)
+     *
+     * .dds and .ktx2 files are uploaded compressed with the mip levels
+     * they contain; generateMipmaps only applies to other images.
+     * @param filepath Path to image file (PNG, JPG, TGA, DDS, KTX2, etc.)
      * @param generateMipmaps Whether to generate mipmaps
      * @return True if loaded successfully
      */
@@ -101,14 +130,61 @@ public:
     int GetHeight() const { return m_Height; }
     bool IsValid() const { return m_TextureID != 0; }
     const std::string& GetFilepath() const { return m_Filepath; }
+    TextureFormat GetFormat() const { return m_Format; }
+    bool IsCompressed() const { return IsCompressedFormat(m_Format); }
+
+    /**
+     * @brief GPU memory used by all mip levels (estimated for uncompressed formats)
+     */
+    size_t GetMemorySize() const { return m_MemorySize; }
+
+    static bool IsCompressedFormat(TextureFormat format) { return format >= TextureFormat::BC1; }
+
+    /**
+     * @brief Whether the driver exposes a compressed format (S3TC for BC1/BC3, plus EXT_texture_sRGB for their sRGB variants, BPTC for BC7)
+     */
+    static bool IsFormatSupported(TextureFormat format);
+    TextureState GetState() const { return m_State; }
+    bool IsReady() const { return m_State == TextureState::Ready; }
 
 private:
+    friend class TextureManager;
+
+    /**
+     * @brief Create the GL texture with a 1x1 placeholder pixel (state Loading)
+     *
+     * The texture ID stays the same when the real image replaces the
+     * placeholder, so materials can reference it right away.
+     */
+    void CreatePlaceholder(const std::string& filepath);
+
+    /**
+     * @brief Replace the contents with RGBA8 pixels from the bound GL_PIXEL_UNPACK_BUFFER (offset 0)
+     */
+    void UploadFromUnpackBuffer(int width, int height, bool generateMipmaps);
+
+    /**
+     * @brief Upload every level of a compressed image
+     *
+     * Level i is read from data + (Levels[i].Offset - dataBegin): data is
+     * the mapped file with dataBegin 0, or null with a bound unpack buffer
+     * holding the file range starting at dataBegin.
+     */
+    bool UploadCompressed(const TextureContainerImage& image, const uint8_t* data, size_t dataBegin);
+
+    /**
+     * @brief Load a .dds/.ktx2 file through a memory mapping
+     */
+    bool LoadContainer(const std::string& filepath);
+
     uint32_t m_TextureID = 0;
     int m_Width = 0;
     int m_Height = 0;
     int m_Channels = 0;
     TextureFormat m_Format = TextureFormat::RGBA;
     std::string m_Filepath;
+    TextureState m_State = TextureState::Ready;
+    size_t m_MemorySize = 0;
 
     /**
      * @brief Convert TextureFilter enum to OpenGL constant
@@ -121,7 +197,7 @@ private:
     static uint32_t WrapToGL(TextureWrap wrap);
 
     /**
-     * @brief Convert TextureFormat enum to OpenGL constants
+     * @brief Convert TextureFormat enum to OpenGL constants (compressed formats only set internalFormat)
      */
     static void FormatToGL(TextureFormat format, uint32_t& internalFormat, 
                           uint32_t& dataFormat, uint32_t& dataType);
@@ -131,6 +207,22 @@ private:
  * @brief Texture manager for caching and reusing textures
  * 
  * Prevents loading the same texture multiple times.
+ *
+ * Block compressed containers (.dds, .ktx2) stream the same way: the
+ * decode job maps the file and parses its header, and Update copies the
+ * compressed mip chain as is.
+ *
+ * LoadAsync returns immediately with a texture showing a grey placeholder.
+ * The image is decoded (always to RGBA8) on a JobSystem worker. Update,
+ * called once per frame on the render thread, copies decoded pixels into
+ * a pixel buffer object within the per-frame upload budget, then issues
+ * the texture upload from that buffer (a DMA the driver runs
+ * asynchronously) and marks the texture Ready. Large images are copied
+ * over several frames; the placeholder stays until the whole image is in.
+ *
+ * While a RenderThread runs, the GL work of Load, LoadAsync, Unload and
+ * Clear is done on it through RenderThread::Invoke (the caller waits), and
+ * Renderer::PrepareFrame calls Update.
  */
 class TextureManager {
 public:
@@ -145,13 +237,40 @@ public:
      */
     Texture2D* Load(const std::string& filepath, bool generateMipmaps = true);
 
+    /**
+     * @brief Start streaming a texture (cached), returns without blocking
+     * @return Texture with a placeholder image until it becomes Ready
+     */
+    Texture2D* LoadAsync(const std::string& filepath, bool generateMipmaps = true);
+
+    /**
+     * @brief Advance streaming uploads (GL thread, once per frame)
+     */
+    void Update();
+
+    /**
+     * @brief Bytes copied into upload buffers per Update (default 8 MB)
+     */
+    void SetUploadBudget(size_t bytesPerFrame) { m_UploadBudget = bytesPerFrame > 0 ? bytesPerFrame : 1; }
+    size_t GetUploadBudget() const { return m_UploadBudget; }
+
+    /**
+     * @brief Textures still decoding or uploading
+     */
+    size_t GetPendingCount() const { return m_Streams.size(); }
+
+    /**
+     * @brief GPU memory used by all loaded textures, in bytes
+     */
+    size_t GetMemoryUsage() const;
+
     /**
      * @brief Get cached texture by filepath
      */
     Texture2D* GetTexture(const std::string& filepath);
 
     /**
-     * @brief Unload all textures
+     * @brief Unload all textures (waits for decodes in flight)
      */
     void Clear();
 
@@ -161,8 +280,63 @@ public:
     void Unload(const std::string& filepath);
 
 private:
-    TextureManager() = default;
+    // Out of line: StreamRequest holds an incomplete TextureContainerImage here
+    TextureManager();
+    ~TextureManager();
+
+    /**
+     * @brief One texture being streamed in
+     */
+    struct StreamRequest {
+        enum Status : int { Decoding, Decoded, Failed };
+
+        Texture2D* Texture = nullptr;  // Null once unloaded (request is dropped)
+        std::string Filepath;
+        bool GenerateMipmaps = true;
+
+        // Written by the decode job, published through DecodeStatus.
+        // Source/SourceSize is what gets staged: decoded RGBA8 pixels, or
+        // the mip chain range of a mapped container file
+        unsigned char* Pixels = nullptr;
+        MappedFile File;
+        std::unique_ptr<TextureContainerImage> Container;
+        const unsigned char* Source = nullptr;
+        size_t SourceSize = 0;
+        std::string Error;
+        int Width = 0;
+        int Height = 0;
+        std::atomic<int> DecodeStatus{ Decoding };
+
+        // Render thread upload progress
+        uint32_t PixelBuffer = 0;      // Mapped PBO while copying
+        unsigned char* Mapped = nullptr;
+        size_t BytesCopied = 0;
+    };
+
+    /**
+     * @brief Take a pixel buffer with room for size bytes and map it for writing
+     */
+    bool BeginStaging(StreamRequest& request, size_t size);
+
+    /**
+     * @brief Free a request's decoded pixels or file and release its staging buffer
+     */
+    void ReleaseRequest(StreamRequest& request);
+
+    static constexpr size_t DEFAULT_UPLOAD_BUDGET = 8 * 1024 * 1024;
+    static constexpr size_t PIXEL_BUFFER_COUNT = 2;
+
     std::unordered_map<std::string, std::unique_ptr<Texture2D>> m_Textures;
+
+    // In submission order; uploaded front to back
+    std::vector<std::unique_ptr<StreamRequest>> m_Streams;
+    JobCounter m_DecodeJobs;
+    size_t m_UploadBudget = DEFAULT_UPLOAD_BUDGET;
+
+    // Staging buffers used round robin so an upload in flight is not overwritten
+    uint32_t m_PixelBuffers[PIXEL_BUFFER_COUNT] = {};
+    size_t m_PixelBufferSizes[PIXEL_BUFFER_COUNT] = {};
+    size_t m_NextPixelBuffer = 0;
 };
 
 } // namespace Nilos
@@ -0,0 +1,304 @@
+#include "TextureContainer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+
+namespace Nilos {
+
+namespace {
+
+constexpr int MAX_TEXTURE_SIZE = 16384;
+
+uint32_t ReadU32(const uint8_t* data, size_t offset) {
+    uint32_t value;
+    std::memcpy(&value, data + offset, sizeof(value));
+    return value;
+}
+
+uint64_t ReadU64(const uint8_t* data, size_t offset) {
+    uint64_t value;
+    std::memcpy(&value, data + offset, sizeof(value));
+    return value;
+}
+
+constexpr uint32_t FourCC(char a, char b, char c, char d) {
+    return uint32_t(uint8_t(a)) | (uint32_t(uint8_t(b)) << 8) |
+           (uint32_t(uint8_t(c)) << 16) | (uint32_t(uint8_t(d)) << 24);
+}
+
+/**
+ * @brief Fill in mip sizes for levels stored back to back from offset
+ */
+bool BuildLevels(TextureContainerImage& image, uint32_t levelCount, size_t offset, size_t fileSize,
+                 std::string& error) {
+    image.Levels.clear();
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        TextureMipLevel mip;
+        mip.Width = std::max(1, image.Width >> level);
+        mip.Height = std::max(1, image.Height >> level);
+        mip.Offset = offset;
+        mip.Size = TextureContainer::GetLevelSize(image.Format, mip.Width, mip.Height);
+        if (mip.Offset + mip.Size > fileSize) {
+            error = "mip level " + std::to_string(level) + " is truncated";
+            return false;
+        }
+        offset += mip.Size;
+        image.Levels.push_back(mip);
+    }
+    return true;
+}
+
+/**
+ * @brief Number of levels down to 1x1, the most a chain can have
+ */
+uint32_t FullChainLength(int width, int height) {
+    uint32_t levels = 1;
+    for (int size = std::max(width, height); size > 1; size >>= 1) {
+        ++levels;
+    }
+    return levels;
+}
+
+bool CheckDimensions(TextureContainerImage& image, std::string& error) {
+    if (image.Width <= 0 || image.Height <= 0 ||
+        image.Width > MAX_TEXTURE_SIZE || image.Height > MAX_TEXTURE_SIZE) {
+        error = "invalid size " + std::to_string(image.Width) + "x" + std::to_string(image.Height);
+        return false;
+    }
+    return true;
+}
+
+// ----------------------------------------------------------------------------
+// DDS
+// ----------------------------------------------------------------------------
+
+constexpr uint32_t DDS_MAGIC = FourCC('D', 'D', 'S', ' ');
+constexpr size_t DDS_HEADER_SIZE = 124;
+constexpr size_t DDS_DX10_HEADER_SIZE = 20;
+constexpr uint32_t DDSD_MIPMAPCOUNT = 0x20000;
+constexpr uint32_t DDPF_FOURCC = 0x4;
+constexpr uint32_t DDSCAPS2_CUBEMAP = 0x200;
+constexpr uint32_t DDSCAPS2_VOLUME = 0x200000;
+constexpr uint32_t DDS_DIMENSION_TEXTURE2D = 3;
+constexpr uint32_t DDS_MISC_TEXTURECUBE = 0x4;
+
+bool FormatFromDXGI(uint32_t dxgiFormat, TextureFormat& format) {
+    switch (dxgiFormat) {
+        case 71: format = TextureFormat::BC1; return true;       // DXGI_FORMAT_BC1_UNORM
+        case 72: format = TextureFormat::BC1_SRGB; return true;  // DXGI_FORMAT_BC1_UNORM_SRGB
+        case 77: format = TextureFormat::BC3; return true;       // DXGI_FORMAT_BC3_UNORM
+        case 78: format = TextureFormat::BC3_SRGB; return true;  // DXGI_FORMAT_BC3_UNORM_SRGB
+        case 83: format = TextureFormat::BC5; return true;       // DXGI_FORMAT_BC5_UNORM
+        case 98: format = TextureFormat::BC7; return true;       // DXGI_FORMAT_BC7_UNORM
+        case 99: format = TextureFormat::BC7_SRGB; return true;  // DXGI_FORMAT_BC7_UNORM_SRGB
+        default: return false;
+    }
+}
+
+bool ParseDDS(const uint8_t* data, size_t size, TextureContainerImage& image, std::string& error) {
+    // Offsets are from the start of the file (magic included)
+    if (size < 4 + DDS_HEADER_SIZE || ReadU32(data, 4) != DDS_HEADER_SIZE) {
+        error = "truncated DDS header";
+        return false;
+    }
+
+    uint32_t flags = ReadU32(data, 8);
+    image.Height = static_cast<int>(ReadU32(data, 12));
+    image.Width = static_cast<int>(ReadU32(data, 16));
+    uint32_t mipCount = (flags & DDSD_MIPMAPCOUNT) ? ReadU32(data, 28) : 1;
+    uint32_t pixelFlags = ReadU32(data, 80);
+    uint32_t fourCC = ReadU32(data, 84);
+    uint32_t caps2 = ReadU32(data, 112);
+
+    if (caps2 & (DDSCAPS2_CUBEMAP | DDSCAPS2_VOLUME)) {
+        error = "DDS cubemaps and volume textures are not supported";
+        return false;
+    }
+    if (!(pixelFlags & DDPF_FOURCC)) {
+        error = "uncompressed DDS files are not supported";
+        return false;
+    }
+
+    size_t dataOffset = 4 + DDS_HEADER_SIZE;
+    if (fourCC == FourCC('D', 'X', 'T', '1')) {
+        image.Format = TextureFormat::BC1;
+    } else if (fourCC == FourCC('D', 'X', 'T', '5')) {
+        image.Format = TextureFormat::BC3;
+    } else if (fourCC == FourCC('A', 'T', 'I', '2') || fourCC == FourCC('B', 'C', '5', 'U')) {
+        image.Format = TextureFormat::BC5;
+    } else if (fourCC == FourCC('D', 'X', '1', '0')) {
+        if (size < dataOffset + DDS_DX10_HEADER_SIZE) {
+            error = "truncated DDS DX10 header";
+            return false;
+        }
+        uint32_t dxgiFormat = ReadU32(data, dataOffset);
+        uint32_t dimension = ReadU32(data, dataOffset + 4);
+        uint32_t miscFlags = ReadU32(data, dataOffset + 8);
+        uint32_t arraySize = ReadU32(data, dataOffset + 12);
+        if (dimension != DDS_DIMENSION_TEXTURE2D || (miscFlags & DDS_MISC_TEXTURECUBE) || arraySize > 1) {
+            error = "only single 2D DDS textures are supported";
+            return false;
+        }
+        if (!FormatFromDXGI(dxgiFormat, image.Format)) {
+            error = "unsupported DXGI format " + std::to_string(dxgiFormat);
+            return false;
+        }
+        dataOffset += DDS_DX10_HEADER_SIZE;
+    } else {
+        error = "unsupported DDS FourCC";
+        return false;
+    }
+
+    if (!CheckDimensions(image, error)) {
+        return false;
+    }
+    mipCount = std::min(std::max(mipCount, 1u), FullChainLength(image.Width, image.Height));
+    return BuildLevels(image, mipCount, dataOffset, size, error);
+}
+
+// ----------------------------------------------------------------------------
+// KTX2
+// ----------------------------------------------------------------------------
+
+constexpr uint8_t KTX2_IDENTIFIER[12] = { 0xAB, 'K', 'T', 'X', ' ', '2', '0', 0xBB, '\r', '\n', 0x1A, '\n' };
+constexpr size_t KTX2_HEADER_SIZE = 80;   // Identifier, header and index
+constexpr size_t KTX2_LEVEL_ENTRY_SIZE = 24;
+
+bool FormatFromVulkan(uint32_t vkFormat, TextureFormat& format) {
+    switch (vkFormat) {
+        case 131:                                                // VK_FORMAT_BC1_RGB_UNORM_BLOCK
+        case 133: format = TextureFormat::BC1; return true;      // VK_FORMAT_BC1_RGBA_UNORM_BLOCK
+        case 132:                                                // VK_FORMAT_BC1_RGB_SRGB_BLOCK
+        case 134: format = TextureFormat::BC1_SRGB; return true; // VK_FORMAT_BC1_RGBA_SRGB_BLOCK
+        case 137: format = TextureFormat::BC3; return true;      // VK_FORMAT_BC3_UNORM_BLOCK
+        case 138: format = TextureFormat::BC3_SRGB; return true; // VK_FORMAT_BC3_SRGB_BLOCK
+        case 141: format = TextureFormat::BC5; return true;      // VK_FORMAT_BC5_UNORM_BLOCK
+        case 145: format = TextureFormat::BC7; return true;      // VK_FORMAT_BC7_UNORM_BLOCK
+        case 146: format = TextureFormat::BC7_SRGB; return true; // VK_FORMAT_BC7_SRGB_BLOCK
+        default: return false;
+    }
+}
+
+bool ParseKTX2(const uint8_t* data, size_t size, TextureContainerImage& image, std::string& error) {
+    if (size < KTX2_HEADER_SIZE) {
+        error = "truncated KTX2 header";
+        return false;
+    }
+
+    uint32_t vkFormat = ReadU32(data, 12);
+    image.Width = static_cast<int>(ReadU32(data, 20));
+    image.Height = static_cast<int>(ReadU32(data, 24));
+    uint32_t depth = ReadU32(data, 28);
+    uint32_t layerCount = ReadU32(data, 32);
+    uint32_t faceCount = ReadU32(data, 36);
+    uint32_t levelCount = ReadU32(data, 40);
+    uint32_t supercompression = ReadU32(data, 44);
+
+    if (depth > 1 || layerCount > 1 || faceCount != 1) {
+        error = "only single 2D KTX2 textures are supported";
+        return false;
+    }
+    if (supercompression != 0) {
+        error = "supercompressed KTX2 files are not supported";
+        return false;
+    }
+    if (!FormatFromVulkan(vkFormat, image.Format)) {
+        error = "unsupported KTX2 vkFormat " + std::to_string(vkFormat);
+        return false;
+    }
+    if (!CheckDimensions(image, error)) {
+        return false;
+    }
+
+    // levelCount 0 asks the loader to generate mips, which block formats cannot
+    levelCount = std::max(levelCount, 1u);
+    if (levelCount > FullChainLength(image.Width, image.Height) ||
+        size < KTX2_HEADER_SIZE + size_t(levelCount) * KTX2_LEVEL_ENTRY_SIZE) {
+        error = "invalid KTX2 level index";
+        return false;
+    }
+
+    // The level index lists level 0 (largest) first, whatever the file order
+    image.Levels.clear();
+    for (uint32_t level = 0; level < levelCount; ++level) {
+        size_t entry = KTX2_HEADER_SIZE + size_t(level) * KTX2_LEVEL_ENTRY_SIZE;
+        uint64_t offset = ReadU64(data, entry);
+        uint64_t length = ReadU64(data, entry + 8);
+
+        TextureMipLevel mip;
+        mip.Width = std::max(1, image.Width >> level);
+        mip.Height = std::max(1, image.Height >> level);
+        mip.Size = TextureContainer::GetLevelSize(image.Format, mip.Width, mip.Height);
+        if (length < mip.Size || offset > size || size - offset < mip.Size) {
+            error = "KTX2 mip level " + std::to_string(level) + " is truncated";
+            return false;
+        }
+        mip.Offset = static_cast<size_t>(offset);
+        image.Levels.push_back(mip);
+    }
+    return true;
+}
+
+} // namespace
+
+size_t TextureContainerImage::GetDataBegin() const {
+    size_t begin = SIZE_MAX;
+    for (const TextureMipLevel& level : Levels) {
+        begin = std::min(begin, level.Offset);
+    }
+    return Levels.empty() ? 0 : begin;
+}
+
+size_t TextureContainerImage::GetDataEnd() const {
+    size_t end = 0;
+    for (const TextureMipLevel& level : Levels) {
+        end = std::max(end, level.Offset + level.Size);
+    }
+    return end;
+}
+
+namespace TextureContainer {
+
+bool IsContainerFile(const std::string& filepath) {
+    size_t dot = filepath.find_last_of('.');
+    if (dot == std::string::npos) {
+        return false;
+    }
+    std::string extension = filepath.substr(dot);
+    std::transform(extension.begin(), extension.end(), extension.begin(),
+                   [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return extension == ".dds" || extension == ".ktx2";
+}
+
+bool Parse(const uint8_t* data, size_t size, TextureContainerImage& image, std::string& error) {
+    image = TextureContainerImage();
+    if (size >= 4 && ReadU32(data, 0) == DDS_MAGIC) {
+        return ParseDDS(data, size, image, error);
+    }
+    if (size >= sizeof(KTX2_IDENTIFIER) && std::memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0) {
+        return ParseKTX2(data, size, image, error);
+    }
+    error = "not a DDS or KTX2 file";
+    return false;
+}
+
+size_t GetBlockSize(TextureFormat format) {
+    switch (format) {
+        case TextureFormat::BC1:
+        case TextureFormat::BC1_SRGB:
+            return 8;
+        default:
+            return 16;
+    }
+}
+
+size_t GetLevelSize(TextureFormat format, int width, int height) {
+    size_t blocksX = (size_t(std::max(width, 1)) + 3) / 4;
+    size_t blocksY = (size_t(std::max(height, 1)) + 3) / 4;
+    return blocksX * blocksY * GetBlockSize(format);
+}
+
+} // namespace TextureContainer
+
+} // namespace Nilos
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "Texture.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief One mip level stored in a texture container file
+ */
+struct TextureMipLevel {
+    int Width = 0;
+    int Height = 0;
+    size_t Offset = 0;  // From the start of the file
+    size_t Size = 0;    // Bytes of block data
+};
+
+/**
+ * @brief Block-compressed 2D image described by a DDS or KTX2 header
+ *
+ * Levels are ordered largest first and point into the file the header was
+ * parsed from, so the data can be uploaded straight from a MappedFile.
+ */
+struct TextureContainerImage {
+    TextureFormat Format = TextureFormat::BC1;
+    int Width = 0;
+    int Height = 0;
+    std::vector<TextureMipLevel> Levels;
+
+    /**
+     * @brief Smallest file range holding every level
+     */
+    size_t GetDataBegin() const;
+    size_t GetDataEnd() const;
+};
+
+/**
+ * @brief Readers for GPU-ready texture containers (.dds, .ktx2)
+ *
+ * Supported: single 2D images (no arrays, cubemaps or volumes) in BC1,
+ * BC3, BC5 and BC7, unorm or sRGB, with the mip chain baked by the
+ * texture tool. DDS files use the legacy DXT1/DXT5/ATI2 FourCCs or a DX10
+ * header; KTX2 files must not be supercompressed (no Basis/zstd).
+ */
+namespace TextureContainer {
+
+/**
+ * @brief True for file extensions handled here (.dds, .ktx2)
+ */
+bool IsContainerFile(const std::string& filepath);
+
+/**
+ * @brief Parse a container held in memory
+ *
+ * Does not log (it runs on decode workers); the reason for a failure is
+ * returned in error for the caller to report.
+ * @return False if the file is malformed or the format is unsupported
+ */
+bool Parse(const uint8_t* data, size_t size, TextureContainerImage& image, std::string& error);
+
+/**
+ * @brief Bytes per 4x4 block (8 for BC1, 16 for the others)
+ */
+size_t GetBlockSize(TextureFormat format);
+
+/**
+ * @brief Bytes of one level of the given size
+ */
+size_t GetLevelSize(TextureFormat format, int width, int height);
+
+} // namespace TextureContainer
+
+} // namespace Nilos
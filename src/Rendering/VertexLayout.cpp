@@ -0,0 +1,203 @@
+#include "VertexLayout.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace Nilos {
+namespace VertexPacking {
+
+namespace {
+
+uint32_t PackNormal(const float* n) {
+    auto snorm10 = [](float v) {
+        int32_t q = static_cast<int32_t>(std::lround(std::clamp(v, -1.0f, 1.0f) * 511.0f));
+        return static_cast<uint32_t>(q) & 0x3ffu;
+    };
+    return snorm10(n[0]) | (snorm10(n[1]) << 10) | (snorm10(n[2]) << 20);
+}
+
+uint8_t PackUNorm8(float v) {
+    return static_cast<uint8_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 255.0f));
+}
+
+uint16_t PackUNorm16(float v) {
+    return static_cast<uint16_t>(std::lround(std::clamp(v, 0.0f, 1.0f) * 65535.0f));
+}
+
+} // namespace
+
+uint16_t FloatToHalf(float value) {
+    uint32_t bits;
+    std::memcpy(&bits, &value, sizeof(bits));
+
+    uint32_t sign = (bits >> 16) & 0x8000u;
+    uint32_t rawExponent = (bits >> 23) & 0xffu;
+    uint32_t mantissa = bits & 0x7fffffu;
+
+    if (rawExponent == 0xffu) {
+        return static_cast<uint16_t>(sign | 0x7c00u | (mantissa ? 0x200u : 0u)); // Inf / NaN
+    }
+
+    int32_t exponent = static_cast<int32_t>(rawExponent) - 127 + 15;
+    if (exponent >= 31) {
+        return static_cast<uint16_t>(sign | 0x7c00u); // Overflow to infinity
+    }
+
+    if (exponent <= 0) {
+        // Subnormal half (or zero)
+        if (exponent < -10) {
+            return static_cast<uint16_t>(sign);
+        }
+        mantissa |= 0x800000u;
+        uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        uint32_t remainder = mantissa & ((1u << shift) - 1u);
+        uint32_t halfway = 1u << (shift - 1u);
+        if (remainder > halfway || (remainder == halfway && (half & 1u))) {
+            ++half;
+        }
+        return static_cast<uint16_t>(sign | half);
+    }
+
+    uint32_t half = sign | (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    uint32_t remainder = mantissa & 0x1fffu;
+    if (remainder > 0x1000u || (remainder == 0x1000u && (half & 1u))) {
+        ++half; // A carry into the exponent is still the correctly rounded value
+    }
+    return static_cast<uint16_t>(half);
+}
+
+float HalfToFloat(uint16_t value) {
+    uint32_t sign = static_cast<uint32_t>(value & 0x8000u) << 16;
+    uint32_t exponent = (value >> 10) & 0x1fu;
+    uint32_t mantissa = value & 0x3ffu;
+
+    uint32_t bits;
+    if (exponent == 0) {
+        if (mantissa == 0) {
+            bits = sign;
+        } else {
+            // Normalize the subnormal
+            exponent = 127 - 15 + 1;
+            while ((mantissa & 0x400u) == 0) {
+                mantissa <<= 1;
+                --exponent;
+            }
+            bits = sign | (exponent << 23) | ((mantissa & 0x3ffu) << 13);
+        }
+    } else if (exponent == 31) {
+        bits = sign | 0x7f800000u | (mantissa << 13);
+    } else {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float result;
+    std::memcpy(&result, &bits, sizeof(result));
+    return result;
+}
+
+PackedVertexFormat ChooseFormat(const float* vertices, size_t vertexCount, VertexLayout layout) {
+    PackedVertexFormat format;
+    uint32_t stride = layout.GetStride();
+
+    if (layout.Has(VertexAttribute::Position)) {
+        uint32_t offset = layout.GetOffset(VertexAttribute::Position);
+        format.HalfPositions = true;
+        for (size_t v = 0; v < vertexCount && format.HalfPositions; ++v) {
+            for (uint32_t c = 0; c < 3; ++c) {
+                float p = vertices[v * stride + offset + c];
+                if (std::abs(HalfToFloat(FloatToHalf(p)) - p) > HALF_POSITION_TOLERANCE) {
+                    format.HalfPositions = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    if (layout.Has(VertexAttribute::TexCoord)) {
+        uint32_t offset = layout.GetOffset(VertexAttribute::TexCoord);
+        format.UNormTexCoords = true;
+        for (size_t v = 0; v < vertexCount && format.UNormTexCoords; ++v) {
+            for (uint32_t c = 0; c < 2; ++c) {
+                float uv = vertices[v * stride + offset + c];
+                if (uv < 0.0f || uv > 1.0f) {
+                    format.UNormTexCoords = false;
+                    break;
+                }
+            }
+        }
+    }
+
+    return MakeFormat(layout, format.HalfPositions, format.UNormTexCoords);
+}
+
+PackedVertexFormat MakeFormat(VertexLayout layout, bool halfPositions, bool unormTexCoords) {
+    PackedVertexFormat format;
+    format.HalfPositions = halfPositions && layout.Has(VertexAttribute::Position);
+    format.UNormTexCoords = unormTexCoords && layout.Has(VertexAttribute::TexCoord);
+
+    // Every packed attribute is a multiple of 4 bytes, so all stay aligned
+    uint32_t bytes = 0;
+    for (uint32_t i = 0; i < static_cast<uint32_t>(VertexAttribute::Count); ++i) {
+        VertexAttribute attribute = static_cast<VertexAttribute>(i);
+        if (!layout.Has(attribute)) continue;
+
+        format.Offsets[i] = bytes;
+        if (attribute == VertexAttribute::Position) {
+            bytes += format.HalfPositions ? 8 : 12;
+        } else {
+            bytes += 4;
+        }
+    }
+    format.Stride = bytes;
+    return format;
+}
+
+void Encode(const float* vertices, size_t vertexCount, VertexLayout layout,
+            const PackedVertexFormat& format, std::vector<uint8_t>& out) {
+    out.assign(vertexCount * format.Stride, 0);
+
+    uint32_t stride = layout.GetStride();
+    for (size_t v = 0; v < vertexCount; ++v) {
+        const float* src = vertices + v * stride;
+        uint8_t* dst = out.data() + v * format.Stride;
+
+        if (layout.Has(VertexAttribute::Position)) {
+            const float* p = src + layout.GetOffset(VertexAttribute::Position);
+            uint8_t* target = dst + format.Offsets[static_cast<size_t>(VertexAttribute::Position)];
+            if (format.HalfPositions) {
+                uint16_t halves[4] = { FloatToHalf(p[0]), FloatToHalf(p[1]), FloatToHalf(p[2]), 0 };
+                std::memcpy(target, halves, sizeof(halves));
+            } else {
+                std::memcpy(target, p, 3 * sizeof(float));
+            }
+        }
+
+        if (layout.Has(VertexAttribute::Normal)) {
+            uint32_t packed = PackNormal(src + layout.GetOffset(VertexAttribute::Normal));
+            std::memcpy(dst + format.Offsets[static_cast<size_t>(VertexAttribute::Normal)], &packed, sizeof(packed));
+        }
+
+        if (layout.Has(VertexAttribute::Color)) {
+            const float* c = src + layout.GetOffset(VertexAttribute::Color);
+            uint8_t* target = dst + format.Offsets[static_cast<size_t>(VertexAttribute::Color)];
+            target[0] = PackUNorm8(c[0]);
+            target[1] = PackUNorm8(c[1]);
+            target[2] = PackUNorm8(c[2]);
+            target[3] = 255;
+        }
+
+        if (layout.Has(VertexAttribute::TexCoord)) {
+            const float* uv = src + layout.GetOffset(VertexAttribute::TexCoord);
+            uint16_t packed[2];
+            for (int c = 0; c < 2; ++c) {
+                packed[c] = format.UNormTexCoords ? PackUNorm16(uv[c]) : FloatToHalf(uv[c]);
+            }
+            std::memcpy(dst + format.Offsets[static_cast<size_t>(VertexAttribute::TexCoord)], packed, sizeof(packed));
+        }
+    }
+}
+
+} // namespace VertexPacking
+} // namespace Nilos
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace Nilos {
+
+/**
+ * @brief Vertex attributes, in interleaving order (value = shader location)
+ */
+enum class VertexAttribute : uint8_t {
+    Position = 0,  // 3 floats
+    Normal = 1,    // 3 floats
+    Color = 2,     // 3 floats
+    TexCoord = 3,  // 2 floats
+    Count
+};
+
+/**
+ * @brief Describes the interleaved float data in MeshComponent::Vertices
+ *
+ * A layout is the set of attributes present; they are always stored in
+ * VertexAttribute order with a fixed float count each, so offsets and the
+ * stride follow from the mask:
+ *
+ *   VertexLayout::Standard()       P3 N3 C3 T2 (11 floats, the default)
+ *   VertexLayout::PositionColor()  P3 C3       (6 floats)
+ *
+ * Attributes missing from a mesh read as normal (0,1,0), white and uv (0,0).
+ */
+struct VertexLayout {
+    uint8_t Mask = 0; // Bit i = VertexAttribute i present
+
+    static constexpr uint32_t ComponentCount(VertexAttribute attribute) {
+        return attribute == VertexAttribute::TexCoord ? 2u : 3u;
+    }
+
+    static constexpr uint8_t Bit(VertexAttribute attribute) {
+        return static_cast<uint8_t>(1u << static_cast<uint32_t>(attribute));
+    }
+
+    static constexpr VertexLayout Standard() {
+        return { static_cast<uint8_t>(Bit(VertexAttribute::Position) | Bit(VertexAttribute::Normal) |
+                                      Bit(VertexAttribute::Color) | Bit(VertexAttribute::TexCoord)) };
+    }
+
+    static constexpr VertexLayout PositionColor() {
+        return { static_cast<uint8_t>(Bit(VertexAttribute::Position) | Bit(VertexAttribute::Color)) };
+    }
+
+    static constexpr VertexLayout PositionNormalColor() {
+        return { static_cast<uint8_t>(Bit(VertexAttribute::Position) | Bit(VertexAttribute::Normal) |
+                                      Bit(VertexAttribute::Color)) };
+    }
+
+    constexpr bool Has(VertexAttribute attribute) const { return (Mask & Bit(attribute)) != 0; }
+
+    /**
+     * @brief Offset of attribute in floats (only meaningful if Has(attribute))
+     */
+    constexpr uint32_t GetOffset(VertexAttribute attribute) const {
+        uint32_t offset = 0;
+        for (uint32_t i = 0; i < static_cast<uint32_t>(attribute); ++i) {
+            if (Has(static_cast<VertexAttribute>(i))) {
+                offset += ComponentCount(static_cast<VertexAttribute>(i));
+            }
+        }
+        return offset;
+    }
+
+    /**
+     * @brief Floats per vertex
+     */
+    constexpr uint32_t GetStride() const { return GetOffset(VertexAttribute::Count); }
+
+    constexpr bool operator==(const VertexLayout& other) const { return Mask == other.Mask; }
+    constexpr bool operator!=(const VertexLayout& other) const { return Mask != other.Mask; }
+};
+
+/**
+ * @brief Compact GPU encoding of a mesh's vertices
+ *
+ * - Position: 4 halves (xyz + pad, 8 bytes) when the round-trip error stays
+ *   below HALF_POSITION_TOLERANCE, otherwise 3 floats (12 bytes)
+ * - Normal: signed normalized 10:10:10:2 (4 bytes)
+ * - Color: RGBA8 normalized (4 bytes)
+ * - TexCoord: unsigned normalized 16-bit when all uvs are in [0,1],
+ *   otherwise 2 halves (4 bytes)
+ *
+ * The standard 44-byte vertex packs into 20 bytes (24 with float positions).
+ */
+struct PackedVertexFormat {
+    bool HalfPositions = false;
+    bool UNormTexCoords = false;
+    uint32_t Stride = 0;                                                   // Bytes
+    uint32_t Offsets[static_cast<size_t>(VertexAttribute::Count)] = {};    // Bytes
+};
+
+namespace VertexPacking {
+
+    // Largest position error accepted for half-float positions (mesh units)
+    constexpr float HALF_POSITION_TOLERANCE = 0.001f;
+
+    /**
+     * @brief Convert to IEEE half precision (round to nearest even)
+     */
+    uint16_t FloatToHalf(float value);
+
+    /**
+     * @brief Convert from IEEE half precision
+     */
+    float HalfToFloat(uint16_t value);
+
+    /**
+     * @brief Pick the most compact format that represents the data faithfully
+     */
+    PackedVertexFormat ChooseFormat(const float* vertices, size_t vertexCount, VertexLayout layout);
+
+    /**
+     * @brief Offsets and stride of the format with the given encoding choices
+     */
+    PackedVertexFormat MakeFormat(VertexLayout layout, bool halfPositions, bool unormTexCoords);
+
+    /**
+     * @brief Encode vertices into format (out is resized to vertexCount * format.Stride)
+     */
+    void Encode(const float* vertices, size_t vertexCount, VertexLayout layout,
+                const PackedVertexFormat& format, std::vector<uint8_t>& out);
+
+} // namespace VertexPacking
+
+} // namespace Nilos
@@ -18,10 +18,8 @@ static void GLFWWindowCloseCallback(GLFWwindow* window) {
 }
 
 static void GLFWWindowSizeCallback(GLFWwindow* window, int width, int height) {
+    // The renderer sets the viewport each frame, on the thread that owns the context
     EventManager::Get().Dispatch(WindowResizeEvent(width, height));
-    
-    // Update OpenGL viewport
-    glViewport(0, 0, width, height);
 }
 
 static void GLFWKeyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
@@ -148,6 +146,14 @@ void Window::SwapBuffers() {
     glfwSwapBuffers(m_Window);
 }
 
+void Window::MakeContextCurrent() {
+    glfwMakeContextCurrent(m_Window);
+}
+
+void Window::DetachContext() {
+    glfwMakeContextCurrent(nullptr);
+}
+
 void Window::Shutdown() {
     if (m_Window) {
         glfwDestroyWindow(m_Window);
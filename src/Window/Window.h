@@ -42,10 +42,23 @@ public:
     void PollEvents();
 
     /**
-     * @brief Swap front and back buffers
+     * @brief Swap front and back buffers (any thread; waits for vsync when enabled)
      */
     void SwapBuffers();
 
+    /**
+     * @brief Make the OpenGL context current on the calling thread
+     *
+     * A context is current on at most one thread: DetachContext on the old
+     * thread first (see RenderThread).
+     */
+    void MakeContextCurrent();
+
+    /**
+     * @brief Release the OpenGL context from the calling thread
+     */
+    void DetachContext();
+
     /**
      * @brief Shutdown and destroy the window
      */
@@ -70,7 +83,7 @@ public:
     GLFWwindow* GetNativeWindow() const { return m_Window; }
 
     /**
-     * @brief Set VSync on/off
+     * @brief Set VSync on/off (on the thread the context is current on)
      */
     void SetVSync(bool enabled);
 
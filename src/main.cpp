@@ -18,6 +18,9 @@
 #include "Core/Engine.h"
 #include "Core/Logger.h"
 
+#include <cstdlib>
+#include <cstring>
+
 int main(int argc, char** argv) {
     // Configure engine
     Nilos::EngineConfig config;
@@ -27,6 +30,20 @@ int main(int argc, char** argv) {
     config.VSync = true;
     config.ShowFPS = true;
 
+    // --headless: simulate without a window; --fast: don't sleep between
+    // headless frames; --frames=N: exit after N frames
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--headless") == 0) {
+            config.Headless = true;
+        } else if (std::strcmp(argv[i], "--fast") == 0) {
+            config.HeadlessRealtime = false;
+        } else if (std::strncmp(argv[i], "--frames=", 9) == 0) {
+            config.MaxFrames = std::strtoull(argv[i] + 9, nullptr, 10);
+        } else {
+            NILOS_WARNING("Unknown argument: ", argv[i]);
+        }
+    }
+
     // Create and initialize engine
     Nilos::Engine engine(config);
     
@@ -37,12 +54,14 @@ int main(int argc, char** argv) {
 
     // Run the engine
     NILOS_INFO("=== Nilos Engine Running ===");
-    NILOS_INFO("Controls:");
-    NILOS_INFO("  W/A/S/D - Move camera forward/left/backward/right");
-    NILOS_INFO("  Q/E - Move camera down/up");
-    NILOS_INFO("  Right Mouse Button + Move - Look around");
-    NILOS_INFO("  ESC - Exit");
-    NILOS_INFO("");
+    if (!config.Headless) {
+        NILOS_INFO("Controls:");
+        NILOS_INFO("  W/A/S/D - Move camera forward/left/backward/right");
+        NILOS_INFO("  Q/E - Move camera down/up");
+        NILOS_INFO("  Right Mouse Button + Move - Look around");
+        NILOS_INFO("  ESC - Exit");
+        NILOS_INFO("");
+    }
     
     engine.Run();
 
@@ -0,0 +1,801 @@
+/**
+ * @file main.cpp
+ * @brief Headless benchmark suite for the engine's hot paths
+ *
+ * Usage:
+ *   NilosBenchmarks [--filter=<text>] [--out=<results.json>] [--min-time=<seconds>]
+ *                   [--threads=<workers>] [--map=<file.map>]... [--quick]
+ *
+ * Runs without a window or GL context: ECS add/get/iterate/remove at
+ * 1k-1M entities, PhysicsWorld::Update and Raycast across body counts,
+ * Pathfinding::FindPath on maze, room and random maps (plus any Moving AI
+ * .map files given with --map), frustum culling, scene snapshot save/load
+ * and event delivery.
+ *
+ * Each benchmark repeats until it has been timed for --min-time seconds
+ * (and at least 3 times); setup is not timed. A table goes to stdout and
+ * --out writes JSON in the layout of Google Benchmark's
+ * --benchmark_format=json (per benchmark: real_time per iteration in ns,
+ * items_per_second), so releases can be compared with existing tools.
+ */
+
+#include "Core/JobSystem.h"
+#include "Core/Logger.h"
+#include "Core/SceneSerializer.h"
+#include "AI/NavGrid.h"
+#include "AI/Pathfinding.h"
+#include "ECS/World.h"
+#include "ECS/Component.h"
+#include "ECS/TransformHierarchy.h"
+#include "Events/Event.h"
+#include "Events/EventManager.h"
+#include "Physics/Collision.h"
+#include "Physics/PhysicsWorld.h"
+#include "Rendering/Frustum.h"
+#include "Rendering/FrustumCuller.h"
+
+#include <glm/gtc/matrix_transform.hpp>
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <functional>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace Nilos;
+
+namespace {
+
+constexpr uint32_t MIN_ITERATIONS = 3;
+constexpr uint32_t RANDOM_SEED = 1234;
+
+const char* const GROUPS[] = { "ECS/", "Physics/", "Path/", "Culling/", "Scene/", "Events/" };
+
+struct Options {
+    std::string Filter;
+    std::string OutputPath;
+    double MinTime = 0.5;  // Seconds timed per benchmark
+    int Threads = -1;      // JobSystem workers, -1 = hardware threads - 1
+    bool Quick = false;    // Smaller sizes, for a smoke run
+    std::vector<std::string> Maps;
+};
+
+struct Result {
+    std::string Name;
+    uint64_t Iterations = 0;
+    uint64_t Items = 0;     // Per iteration
+    double MeanNs = 0.0;    // Per iteration
+    double MedianNs = 0.0;
+    double MinNs = 0.0;
+    double StdDevNs = 0.0;
+};
+
+int64_t Now() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/**
+ * @brief Time a callable, in nanoseconds
+ */
+template<typename F>
+int64_t Time(F&& func) {
+    int64_t begin = Now();
+    func();
+    return Now() - begin;
+}
+
+volatile char g_Sink;
+
+/**
+ * @brief Keeps the optimizer from dropping a computed value
+ */
+template<typename T>
+void DoNotOptimize(const T& value) {
+    g_Sink = *reinterpret_cast<const volatile char*>(&value);
+}
+
+/**
+ * @brief Runs benchmarks and collects their results
+ */
+class Runner {
+public:
+    explicit Runner(const Options& options) : m_Options(options) {}
+
+    /**
+     * @brief Whether a group ("Physics/") may hold benchmarks passing the filter
+     *
+     * Lets groups skip their setup. A filter naming a group ("Phys",
+     * "Physics/Update") selects only that group; any other filter may match
+     * in every group.
+     */
+    bool Wants(const std::string& group) const {
+        auto selects = [this](const std::string& name) {
+            return name.find(m_Options.Filter) != std::string::npos || m_Options.Filter.find(name) == 0;
+        };
+        if (m_Options.Filter.empty()) {
+            return true;
+        }
+        if (std::any_of(std::begin(GROUPS), std::end(GROUPS), selects)) {
+            return selects(group);
+        }
+        return true;
+    }
+
+    /**
+     * @brief Run one benchmark
+     * @param items Work items per iteration (entities, rays, events, ...)
+     * @param body One iteration; does its own setup and returns the nanoseconds of the timed part
+     */
+    void Measure(const std::string& name, uint64_t items, const std::function<int64_t()>& body) {
+        if (!m_Options.Filter.empty() && name.find(m_Options.Filter) == std::string::npos) {
+            return;
+        }
+
+        body();  // Warm-up: caches, allocations, lazy initialization
+
+        std::vector<double> samples;
+        double timed = 0.0;
+        int64_t wallBegin = Now();
+        int64_t maxWall = static_cast<int64_t>(m_Options.MinTime * 10.0 * 1e9);
+        while ((timed < m_Options.MinTime * 1e9 || samples.size() < MIN_ITERATIONS) &&
+               !(samples.size() >= 1 && Now() - wallBegin > maxWall)) {
+            samples.push_back(static_cast<double>(body()));
+            timed += samples.back();
+        }
+
+        Result result;
+        result.Name = name;
+        result.Iterations = samples.size();
+        result.Items = items;
+        result.MeanNs = timed / static_cast<double>(samples.size());
+        double variance = 0.0;
+        for (double sample : samples) {
+            variance += (sample - result.MeanNs) * (sample - result.MeanNs);
+        }
+        result.StdDevNs = std::sqrt(variance / static_cast<double>(samples.size()));
+        std::sort(samples.begin(), samples.end());
+        result.MinNs = samples.front();
+        result.MedianNs = samples[samples.size() / 2];
+
+        double itemsPerSecond = result.Items * 1e9 / result.MeanNs;
+        std::printf("%-40s %10.3f ms %10.3f ms %8llu %14.0f items/s\n", name.c_str(), result.MeanNs * 1e-6,
+                    result.MedianNs * 1e-6, static_cast<unsigned long long>(result.Iterations), itemsPerSecond);
+        std::fflush(stdout);
+        m_Results.push_back(std::move(result));
+    }
+
+    const std::vector<Result>& GetResults() const { return m_Results; }
+    const Options& GetOptions() const { return m_Options; }
+
+private:
+    const Options& m_Options;
+    std::vector<Result> m_Results;
+};
+
+/**
+ * @brief JSON string body (names and paths only contain printable text)
+ */
+std::string Escape(const std::string& text) {
+    std::string escaped;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            escaped += '\\';
+        }
+        escaped += c;
+    }
+    return escaped;
+}
+
+bool WriteJson(const Runner& runner, const std::string& path, uint32_t workers) {
+    FILE* file = std::fopen(path.c_str(), "w");
+    if (!file) {
+        NILOS_ERROR("Failed to open ", path);
+        return false;
+    }
+
+    char date[32];
+    std::time_t now = std::time(nullptr);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    #ifdef NDEBUG
+        const char* buildType = "release";
+    #else
+        const char* buildType = "debug";
+    #endif
+
+    std::fprintf(file, "{\n  \"context\": {\n");
+    std::fprintf(file, "    \"date\": \"%s\",\n", date);
+    std::fprintf(file, "    \"executable\": \"NilosBenchmarks\",\n");
+    std::fprintf(file, "    \"num_cpus\": %u,\n", std::thread::hardware_concurrency());
+    std::fprintf(file, "    \"worker_threads\": %u,\n", workers);
+    std::fprintf(file, "    \"library_build_type\": \"%s\"\n", buildType);
+    std::fprintf(file, "  },\n  \"benchmarks\": [");
+
+    const std::vector<Result>& results = runner.GetResults();
+    for (size_t i = 0; i < results.size(); ++i) {
+        const Result& result = results[i];
+        std::string name = Escape(result.Name);
+        std::fprintf(file, "%s\n    {\n", i == 0 ? "" : ",");
+        std::fprintf(file, "      \"name\": \"%s\",\n", name.c_str());
+        std::fprintf(file, "      \"run_name\": \"%s\",\n", name.c_str());
+        std::fprintf(file, "      \"run_type\": \"iteration\",\n");
+        std::fprintf(file, "      \"iterations\": %llu,\n", static_cast<unsigned long long>(result.Iterations));
+        std::fprintf(file, "      \"real_time\": %.1f,\n", result.MeanNs);
+        std::fprintf(file, "      \"median_time\": %.1f,\n", result.MedianNs);
+        std::fprintf(file, "      \"min_time\": %.1f,\n", result.MinNs);
+        std::fprintf(file, "      \"stddev_time\": %.1f,\n", result.StdDevNs);
+        std::fprintf(file, "      \"time_unit\": \"ns\",\n");
+        std::fprintf(file, "      \"items_per_iteration\": %llu,\n", static_cast<unsigned long long>(result.Items));
+        std::fprintf(file, "      \"items_per_second\": %.1f\n", result.Items * 1e9 / result.MeanNs);
+        std::fprintf(file, "    }");
+    }
+    std::fprintf(file, "\n  ]\n}\n");
+    std::fclose(file);
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// ECS
+// -----------------------------------------------------------------------------
+
+void FillWorld(World& world, std::vector<Entity>& entities, size_t count) {
+    entities.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        entities[i] = world.CreateEntity();
+        world.AddComponent<TransformComponent>(entities[i])->Position = glm::vec3(static_cast<float>(i));
+        world.AddComponent<RigidbodyComponent>(entities[i])->Velocity = glm::vec3(1.0f);
+    }
+}
+
+void BenchmarkECS(Runner& runner, const std::vector<size_t>& sizes) {
+    if (!runner.Wants("ECS/")) {
+        return;
+    }
+    for (size_t count : sizes) {
+        std::string suffix = "/" + std::to_string(count);
+
+        runner.Measure("ECS/CreateEntity" + suffix, count, [count]() {
+            World world;
+            return Time([&]() {
+                for (size_t i = 0; i < count; ++i) {
+                    DoNotOptimize(world.CreateEntity());
+                }
+            });
+        });
+
+        runner.Measure("ECS/AddComponent" + suffix, count, [count]() {
+            World world;
+            std::vector<Entity> entities(count);
+            for (Entity& entity : entities) {
+                entity = world.CreateEntity();
+            }
+            return Time([&]() {
+                for (Entity entity : entities) {
+                    world.AddComponent<TransformComponent>(entity);
+                }
+            });
+        });
+
+        // Fixture shared by the read-only benchmarks
+        World world;
+        std::vector<Entity> entities;
+        FillWorld(world, entities, count);
+        std::vector<Entity> shuffled = entities;
+        std::shuffle(shuffled.begin(), shuffled.end(), std::mt19937(RANDOM_SEED));
+
+        runner.Measure("ECS/GetComponent" + suffix, count, [&]() {
+            return Time([&]() {
+                float sum = 0.0f;
+                for (Entity entity : shuffled) {
+                    sum += world.GetComponent<TransformComponent>(entity)->Position.x;
+                }
+                DoNotOptimize(sum);
+            });
+        });
+
+        runner.Measure("ECS/Iterate2" + suffix, count, [&]() {
+            return Time([&]() {
+                world.Each<TransformComponent, RigidbodyComponent>(
+                    [](Entity, TransformComponent& transform, RigidbodyComponent& rigidbody) {
+                        transform.Position += rigidbody.Velocity * 0.016f;
+                    });
+            });
+        });
+
+        // Cached world matrices: nothing moved, then everything moved
+        TransformHierarchy hierarchy;
+        hierarchy.Update(world);
+        runner.Measure("ECS/TransformsStatic" + suffix, count, [&]() {
+            return Time([&]() { hierarchy.Update(world); });
+        });
+
+        runner.Measure("ECS/TransformsMoving" + suffix, count, [&]() {
+            for (TransformComponent& transform : *world.GetComponentPool<TransformComponent>()) {
+                transform.Rotation.y += 1.0f;
+            }
+            return Time([&]() { hierarchy.Update(world); });
+        });
+
+        runner.Measure("ECS/RemoveComponent" + suffix, count, [&]() {
+            World scratch;
+            std::vector<Entity> scratchEntities;
+            FillWorld(scratch, scratchEntities, count);
+            std::shuffle(scratchEntities.begin(), scratchEntities.end(), std::mt19937(RANDOM_SEED));
+            return Time([&]() {
+                for (Entity entity : scratchEntities) {
+                    scratch.RemoveComponent<RigidbodyComponent>(entity);
+                }
+            });
+        });
+
+        runner.Measure("ECS/DestroyEntity" + suffix, count, [&]() {
+            World scratch;
+            std::vector<Entity> scratchEntities;
+            FillWorld(scratch, scratchEntities, count);
+            return Time([&]() {
+                for (Entity entity : scratchEntities) {
+                    scratch.DestroyEntity(entity);
+                }
+            });
+        });
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Physics
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Ground plus count boxes dropped in a square, already settled
+ */
+struct PhysicsScene {
+    World SceneWorld;
+    PhysicsWorld Physics{&SceneWorld};
+    float HalfSize = 0.0f;
+
+    explicit PhysicsScene(size_t count) {
+        HalfSize = std::max(10.0f, std::sqrt(static_cast<float>(count)) * 1.5f);
+
+        Entity ground = SceneWorld.CreateEntity();
+        auto* groundTransform = SceneWorld.AddComponent<TransformComponent>(ground);
+        groundTransform->Position = glm::vec3(0.0f, -0.5f, 0.0f);
+        groundTransform->Scale = glm::vec3(HalfSize * 2.0f + 10.0f, 1.0f, HalfSize * 2.0f + 10.0f);
+        SceneWorld.AddComponent<ColliderComponent>(ground)->ColliderType = ColliderComponent::Type::Box;
+        Physics.RegisterStaticCollider(ground);
+
+        std::mt19937 random(RANDOM_SEED);
+        std::uniform_real_distribution<float> horizontal(-HalfSize, HalfSize);
+        std::uniform_real_distribution<float> height(0.5f, 8.0f);
+        for (size_t i = 0; i < count; ++i) {
+            Entity body = SceneWorld.CreateEntity();
+            SceneWorld.AddComponent<TransformComponent>(body)->Position =
+                glm::vec3(horizontal(random), height(random), horizontal(random));
+            auto* rigidbody = SceneWorld.AddComponent<RigidbodyComponent>(body);
+            rigidbody->SetMass(1.0f);
+            rigidbody->AllowSleep = false;  // Measure the fully active case
+            SceneWorld.AddComponent<ColliderComponent>(body)->ColliderType = ColliderComponent::Type::Box;
+            Physics.RegisterRigidbody(body);
+        }
+
+        for (int step = 0; step < 60; ++step) {
+            Physics.Update(1.0f / 60.0f);
+        }
+    }
+};
+
+void BenchmarkPhysics(Runner& runner, const std::vector<size_t>& sizes) {
+    constexpr size_t RAYS = 1024;
+    if (!runner.Wants("Physics/")) {
+        return;
+    }
+
+    for (size_t count : sizes) {
+        std::string suffix = "/" + std::to_string(count);
+        PhysicsScene scene(count);
+
+        runner.Measure("Physics/Update" + suffix, count, [&]() {
+            return Time([&]() { scene.Physics.Update(1.0f / 60.0f); });
+        });
+
+        std::mt19937 random(RANDOM_SEED);
+        std::uniform_real_distribution<float> horizontal(-scene.HalfSize, scene.HalfSize);
+        std::vector<Ray> rays;
+        rays.reserve(RAYS);
+        for (size_t i = 0; i < RAYS; ++i) {
+            // Mostly downward from above the pile, some grazing
+            glm::vec3 origin(horizontal(random), 20.0f, horizontal(random));
+            glm::vec3 target(horizontal(random), 0.0f, horizontal(random));
+            rays.emplace_back(origin, target - origin);
+        }
+
+        runner.Measure("Physics/Raycast" + suffix, RAYS, [&]() {
+            return Time([&]() {
+                glm::vec3 point;
+                Entity entity;
+                uint32_t hits = 0;
+                for (const Ray& ray : rays) {
+                    hits += scene.Physics.Raycast(ray, 100.0f, point, entity) ? 1 : 0;
+                }
+                DoNotOptimize(hits);
+            });
+        });
+
+        std::vector<RaycastHit> hits(RAYS);
+        runner.Measure("Physics/RaycastBatch" + suffix, RAYS, [&]() {
+            return Time([&]() { scene.Physics.RaycastBatch(rays.data(), rays.size(), 100.0f, hits.data()); });
+        });
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Pathfinding
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Perfect maze with 1-cell corridors (depth-first carving)
+ */
+void BuildMaze(NavGrid& grid, int size) {
+    grid.Resize(size, size);
+    for (int z = 0; z < size; ++z) {
+        for (int x = 0; x < size; ++x) {
+            grid.SetBlocked(x, z, true);
+        }
+    }
+
+    int cells = (size - 1) / 2;
+    std::vector<bool> visited(static_cast<size_t>(cells) * cells, false);
+    std::vector<int> stack = { 0 };
+    visited[0] = true;
+    grid.SetBlocked(1, 1, false);
+    std::mt19937 random(RANDOM_SEED);
+
+    const int offsets[4][2] = { {1, 0}, {-1, 0}, {0, 1}, {0, -1} };
+    while (!stack.empty()) {
+        int cell = stack.back();
+        int cx = cell % cells;
+        int cz = cell / cells;
+
+        int options[4];
+        int optionCount = 0;
+        for (int i = 0; i < 4; ++i) {
+            int nx = cx + offsets[i][0];
+            int nz = cz + offsets[i][1];
+            if (nx >= 0 && nz >= 0 && nx < cells && nz < cells && !visited[nz * cells + nx]) {
+                options[optionCount++] = i;
+            }
+        }
+        if (optionCount == 0) {
+            stack.pop_back();
+            continue;
+        }
+
+        int direction = options[random() % optionCount];
+        int nx = cx + offsets[direction][0];
+        int nz = cz + offsets[direction][1];
+        grid.SetBlocked(cx * 2 + 1 + offsets[direction][0], cz * 2 + 1 + offsets[direction][1], false);
+        grid.SetBlocked(nx * 2 + 1, nz * 2 + 1, false);
+        visited[nz * cells + nx] = true;
+        stack.push_back(nz * cells + nx);
+    }
+}
+
+/**
+ * @brief Square rooms joined by one doorway per wall
+ */
+void BuildRooms(NavGrid& grid, int size, int roomSize) {
+    grid.Resize(size, size);
+    std::mt19937 random(RANDOM_SEED);
+    for (int z = 0; z < size; ++z) {
+        for (int x = 0; x < size; ++x) {
+            grid.SetBlocked(x, z, x % roomSize == 0 || z % roomSize == 0);
+        }
+    }
+    for (int z = 0; z < size; z += roomSize) {
+        for (int x = 0; x < size; x += roomSize) {
+            if (x > 0) {
+                grid.SetBlocked(x, z + 1 + static_cast<int>(random() % (roomSize - 1)), false);
+            }
+            if (z > 0) {
+                grid.SetBlocked(x + 1 + static_cast<int>(random() % (roomSize - 1)), z, false);
+            }
+        }
+    }
+}
+
+void BuildRandom(NavGrid& grid, int size, float density) {
+    grid.Resize(size, size);
+    std::mt19937 random(RANDOM_SEED);
+    std::uniform_real_distribution<float> chance(0.0f, 1.0f);
+    for (int z = 0; z < size; ++z) {
+        for (int x = 0; x < size; ++x) {
+            grid.SetBlocked(x, z, chance(random) < density);
+        }
+    }
+}
+
+/**
+ * @brief Load a Moving AI benchmark map ('.', 'G' and 'S' are walkable)
+ */
+bool LoadMovingAIMap(const std::string& path, NavGrid& grid) {
+    std::ifstream file(path);
+    if (!file) {
+        NILOS_ERROR("Failed to open map: ", path);
+        return false;
+    }
+
+    std::string token;
+    int width = 0;
+    int height = 0;
+    while (file >> token && token != "map") {
+        if (token == "width") file >> width;
+        else if (token == "height") file >> height;
+    }
+    if (width <= 0 || height <= 0) {
+        NILOS_ERROR("Not a Moving AI map: ", path);
+        return false;
+    }
+
+    grid.Resize(width, height);
+    std::string row;
+    for (int z = 0; z < height && file >> row; ++z) {
+        for (int x = 0; x < width && x < static_cast<int>(row.size()); ++x) {
+            char c = row[x];
+            grid.SetBlocked(x, z, c != '.' && c != 'G' && c != 'S');
+        }
+    }
+    return true;
+}
+
+void BenchmarkPathfinding(Runner& runner, int size) {
+    constexpr size_t QUERIES = 32;
+    if (!runner.Wants("Path/")) {
+        return;
+    }
+
+    std::vector<std::pair<std::string, NavGrid>> maps;
+    maps.emplace_back("Path/FindPath/maze" + std::to_string(size), NavGrid());
+    BuildMaze(maps.back().second, size - 1);
+    maps.emplace_back("Path/FindPath/rooms" + std::to_string(size), NavGrid());
+    BuildRooms(maps.back().second, size, 32);
+    maps.emplace_back("Path/FindPath/random" + std::to_string(size) + "-25", NavGrid());
+    BuildRandom(maps.back().second, size, 0.25f);
+    for (const std::string& path : runner.GetOptions().Maps) {
+        NavGrid grid;
+        if (LoadMovingAIMap(path, grid)) {
+            size_t slash = path.find_last_of("/\\");
+            maps.emplace_back("Path/FindPath/" + path.substr(slash == std::string::npos ? 0 : slash + 1),
+                              std::move(grid));
+        }
+    }
+
+    for (const auto& [name, grid] : maps) {
+        // Fixed walkable start/goal pairs
+        std::vector<int> walkable;
+        for (int cell = 0; cell < grid.GetCellCount(); ++cell) {
+            if (!grid.IsBlocked(cell)) {
+                walkable.push_back(cell);
+            }
+        }
+        if (walkable.size() < 2) {
+            continue;
+        }
+        std::mt19937 random(RANDOM_SEED);
+        std::vector<std::pair<int, int>> queries(QUERIES);
+        for (auto& query : queries) {
+            query.first = walkable[random() % walkable.size()];
+            query.second = walkable[random() % walkable.size()];
+        }
+
+        std::vector<int> cells;
+        runner.Measure(name, QUERIES, [&]() {
+            return Time([&]() {
+                for (const auto& query : queries) {
+                    Pathfinding::FindPath(grid, query.first, query.second, cells);
+                }
+            });
+        });
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Culling
+// -----------------------------------------------------------------------------
+
+void BenchmarkCulling(Runner& runner, const std::vector<size_t>& sizes) {
+    if (!runner.Wants("Culling/")) {
+        return;
+    }
+
+    for (size_t count : sizes) {
+        // Unit boxes scattered over a square, camera looking across it
+        World world;
+        std::mt19937 random(RANDOM_SEED);
+        float halfSize = std::sqrt(static_cast<float>(count)) * 2.0f;
+        std::uniform_real_distribution<float> horizontal(-halfSize, halfSize);
+        for (size_t i = 0; i < count; ++i) {
+            Entity entity = world.CreateEntity();
+            world.AddComponent<TransformComponent>(entity)->Position =
+                glm::vec3(horizontal(random), 0.0f, horizontal(random));
+            auto* mesh = world.AddComponent<MeshComponent>(entity);
+            mesh->BoundsExtents = glm::vec3(0.5f);
+            mesh->HasBounds = true;
+        }
+
+        glm::mat4 projection = glm::perspective(glm::radians(70.0f), 16.0f / 9.0f, 0.1f, halfSize);
+        glm::mat4 view = glm::lookAt(glm::vec3(0.0f, 10.0f, halfSize), glm::vec3(0.0f), glm::vec3(0.0f, 1.0f, 0.0f));
+        Frustum frustum = Frustum::FromMatrix(projection * view);
+
+        TransformHierarchy hierarchy;
+        hierarchy.Update(world);
+
+        FrustumCuller culler;
+        runner.Measure("Culling/Cull/" + std::to_string(count), count, [&]() {
+            return Time([&]() { DoNotOptimize(culler.Cull(world, frustum).size()); });
+        });
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Scene snapshots
+// -----------------------------------------------------------------------------
+
+void BenchmarkScene(Runner& runner, const std::vector<size_t>& sizes) {
+    if (!runner.Wants("Scene/")) {
+        return;
+    }
+
+    for (size_t count : sizes) {
+        std::string suffix = "/" + std::to_string(count);
+
+        // Physics bodies, every fourth one carrying a child
+        World world;
+        std::vector<Entity> entities(count);
+        world.CreateEntities(count, entities.data());
+        for (size_t i = 0; i < count; ++i) {
+            auto* transform = world.AddComponent<TransformComponent>(entities[i]);
+            transform->Position = glm::vec3(static_cast<float>(i), 0.0f, 0.0f);
+            if (i % 4 == 1) {
+                transform->Parent = entities[i - 1];
+            } else {
+                world.AddComponent<RigidbodyComponent>(entities[i]);
+                world.AddComponent<ColliderComponent>(entities[i]);
+            }
+        }
+
+        std::vector<uint8_t> snapshot;
+        runner.Measure("Scene/SaveToMemory" + suffix, count, [&]() {
+            return Time([&]() { SceneSerializer::Get().SaveToMemory(world, snapshot); });
+        });
+
+        runner.Measure("Scene/LoadFromMemory" + suffix, count, [&]() {
+            World loaded;
+            return Time([&]() {
+                DoNotOptimize(SceneSerializer::Get().LoadFromMemory(loaded, snapshot.data(), snapshot.size()));
+            });
+        });
+    }
+}
+
+// -----------------------------------------------------------------------------
+// Events
+// -----------------------------------------------------------------------------
+
+void BenchmarkEvents(Runner& runner, size_t count) {
+    if (!runner.Wants("Events/")) {
+        return;
+    }
+    EventManager& events = EventManager::Get();
+    std::string suffix = "/" + std::to_string(count);
+    uint32_t received = 0;
+
+    uint32_t subscription = events.Subscribe<CollisionEvent>([&received](const CollisionEvent& event) {
+        received += event.EntityA;
+    });
+    runner.Measure("Events/Dispatch" + suffix, count, [&]() {
+        return Time([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                events.Dispatch(CollisionEvent(1, static_cast<uint32_t>(i), glm::vec3(0.0f)));
+            }
+        });
+    });
+    runner.Measure("Events/QueueAndProcess" + suffix, count, [&]() {
+        return Time([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                events.QueueEvent(CollisionEvent(1, static_cast<uint32_t>(i), glm::vec3(0.0f)));
+            }
+            events.ProcessQueue();
+        });
+    });
+    events.Unsubscribe(subscription);
+
+    subscription = events.SubscribeBatch<CollisionEvent>([&received](const CollisionEvent* batch, size_t size) {
+        for (size_t i = 0; i < size; ++i) {
+            received += batch[i].EntityA;
+        }
+    });
+    runner.Measure("Events/QueueAndProcessBatch" + suffix, count, [&]() {
+        return Time([&]() {
+            for (size_t i = 0; i < count; ++i) {
+                events.QueueEvent(CollisionEvent(1, static_cast<uint32_t>(i), glm::vec3(0.0f)));
+            }
+            events.ProcessQueue();
+        });
+    });
+    events.Unsubscribe(subscription);
+
+    DoNotOptimize(received);
+}
+
+bool ParseOptions(int argc, char** argv, Options& options) {
+    for (int i = 1; i < argc; ++i) {
+        std::string argument = argv[i];
+        size_t equals = argument.find('=');
+        std::string key = argument.substr(0, equals);
+        std::string value = equals == std::string::npos ? std::string() : argument.substr(equals + 1);
+
+        if (key == "--filter") options.Filter = value;
+        else if (key == "--out") options.OutputPath = value;
+        else if (key == "--min-time") options.MinTime = std::atof(value.c_str());
+        else if (key == "--threads") options.Threads = std::atoi(value.c_str());
+        else if (key == "--map") options.Maps.push_back(value);
+        else if (key == "--quick") options.Quick = true;
+        else {
+            NILOS_ERROR("Unknown option: ", argument);
+            NILOS_ERROR("Usage: NilosBenchmarks [--filter=<text>] [--out=<results.json>] [--min-time=<seconds>] "
+                        "[--threads=<workers>] [--map=<file.map>]... [--quick]");
+            return false;
+        }
+    }
+    return options.MinTime > 0.0;
+}
+
+} // namespace
+
+int main(int argc, char** argv) {
+    Options options;
+    if (!ParseOptions(argc, argv, options)) {
+        return 1;
+    }
+    Logger::Get().SetLogLevel(LogLevel::Warning);
+
+    uint32_t workers = 0;
+    if (options.Threads >= 0) {
+        workers = static_cast<uint32_t>(options.Threads);
+    } else {
+        unsigned int hardwareThreads = std::thread::hardware_concurrency();
+        workers = hardwareThreads > 1 ? hardwareThreads - 1 : 0;
+    }
+    JobSystem::Get().Initialize(workers);
+    EventManager::Get().Initialize();
+
+    std::printf("%-40s %13s %13s %8s %22s\n", "Benchmark", "Mean", "Median", "Iters", "Throughput");
+
+    Runner runner(options);
+    if (options.Quick) {
+        BenchmarkECS(runner, { 1000, 10000, 100000 });
+        BenchmarkPhysics(runner, { 100, 1000 });
+        BenchmarkPathfinding(runner, 256);
+        BenchmarkCulling(runner, { 10000 });
+        BenchmarkScene(runner, { 10000 });
+        BenchmarkEvents(runner, 10000);
+    } else {
+        BenchmarkECS(runner, { 1000, 10000, 100000, 1000000 });
+        BenchmarkPhysics(runner, { 100, 1000, 10000 });
+        BenchmarkPathfinding(runner, 512);
+        BenchmarkCulling(runner, { 10000, 100000 });
+        BenchmarkScene(runner, { 10000, 100000 });
+        BenchmarkEvents(runner, 100000);
+    }
+
+    bool written = options.OutputPath.empty() || WriteJson(runner, options.OutputPath, workers);
+
+    EventManager::Get().Shutdown();
+    JobSystem::Get().Shutdown();
+    return written ? 0 : 1;
+}
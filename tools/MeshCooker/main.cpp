@@ -0,0 +1,42 @@
+/**
+ * @file main.cpp
+ * @brief Offline mesh cooker: converts OBJ / glTF 2.0 models to .nmesh
+ *
+ * Usage:
+ *   NilosMeshCooker <input.obj|.gltf|.glb> [output.nmesh]
+ *
+ * The output defaults to the input path with its extension replaced. Load
+ * the result at runtime with ModelLoader::LoadModel("....nmesh").
+ */
+
+#include "Core/Logger.h"
+#include "Rendering/ModelLoader.h"
+
+#include <string>
+
+int main(int argc, char** argv) {
+    if (argc < 2 || argc > 3) {
+        NILOS_ERROR("Usage: NilosMeshCooker <input.obj|.gltf|.glb> [output.nmesh]");
+        return 1;
+    }
+
+    std::string input = argv[1];
+    std::string output;
+    if (argc == 3) {
+        output = argv[2];
+    } else {
+        size_t dot = input.find_last_of('.');
+        size_t slash = input.find_last_of("/\\");
+        bool hasExtension = dot != std::string::npos && (slash == std::string::npos || dot > slash);
+        output = (hasExtension ? input.substr(0, dot) : input) + ".nmesh";
+    }
+
+    Nilos::ModelData model;
+    if (!Nilos::ModelLoader::Import(input, model)) {
+        return 1;
+    }
+    if (!Nilos::ModelLoader::Cook(model, output)) {
+        return 1;
+    }
+    return 0;
+}